@@ -0,0 +1,128 @@
+#pragma once
+
+#include "PerfCounters.h"
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+    namespace bench
+    {
+
+        /**
+         * @struct RunConfig
+         * @brief Количество прогонов замера.
+         */
+        struct RunConfig
+        {
+            unsigned warmup = 2;       ///< Прогревочных прогонов (не учитываются)
+            unsigned repetitions = 10; ///< Учитываемых прогонов
+            PerfCounters *counters = nullptr; ///< Аппаратные счётчики учитываемых прогонов; nullptr — не собирать
+        };
+
+        /**
+         * @struct SampleStats
+         * @brief Сводная статистика выборки замеров.
+         */
+        struct SampleStats
+        {
+            std::vector<double> samples; ///< Замеры в порядке выполнения
+            double min = 0.0;
+            double median = 0.0;
+            double p95 = 0.0; ///< 95-й процентиль (по ближайшему рангу)
+            double max = 0.0;
+            double mean = 0.0;
+            double stddev = 0.0; ///< Выборочное стандартное отклонение
+        };
+
+        /**
+         * @struct Measurement
+         * @brief Результат замера: реальное и процессорное время прогонов.
+         *
+         * Процессорное время учитывает все потоки процесса, поэтому для
+         * параллельного кода оно превышает реальное примерно во столько раз,
+         * сколько ядер было занято.
+         */
+        struct Measurement
+        {
+            SampleStats wallMs; ///< Реальное время, мс
+            SampleStats cpuMs;  ///< Процессорное время процесса, мс
+            PerfCounts counters; ///< Среднее значение счётчиков на прогон (если заданы RunConfig::counters)
+        };
+
+        /**
+         * @brief Вычисляет статистику выборки.
+         * @param samples Замеры.
+         * @return Статистика; для пустой выборки все значения равны нулю.
+         */
+        SampleStats summarize(std::vector<double> samples);
+
+        /**
+         * @brief Получает процессорное время процесса (все потоки).
+         * @return Время в миллисекундах от произвольной точки отсчёта.
+         */
+        double processCpuMs();
+
+        /**
+         * @brief Замеряет функцию: сначала прогревочные прогоны, затем учитываемые.
+         *
+         * Перед каждым прогоном вызывается setup, время которого не учитывается,
+         * например, для восстановления исходного состояния контейнера.
+         * Если заданы config.counters, аппаратные счётчики собираются только
+         * на время учитываемых вызовов fn.
+         *
+         * @param config Количество прогонов.
+         * @param setup Подготовка прогона без аргументов.
+         * @param fn Замеряемая функция без аргументов.
+         * @return Статистика реального и процессорного времени учитываемых прогонов.
+         */
+        template <typename Setup, typename Fn>
+        Measurement measure(const RunConfig &config, Setup &&setup, Fn &&fn)
+        {
+            for (unsigned i = 0; i < config.warmup; ++i)
+            {
+                setup();
+                fn();
+            }
+            std::vector<double> wall;
+            std::vector<double> cpu;
+            std::vector<PerfCounts> counts;
+            wall.reserve(config.repetitions);
+            cpu.reserve(config.repetitions);
+            for (unsigned i = 0; i < config.repetitions; ++i)
+            {
+                setup();
+                if (config.counters != nullptr)
+                {
+                    config.counters->start();
+                }
+                double cpuStart = processCpuMs();
+                auto wallStart = std::chrono::steady_clock::now();
+                fn();
+                auto wallEnd = std::chrono::steady_clock::now();
+                cpu.push_back(processCpuMs() - cpuStart);
+                wall.push_back(std::chrono::duration<double, std::milli>(wallEnd - wallStart).count());
+                if (config.counters != nullptr)
+                {
+                    counts.push_back(config.counters->stop());
+                }
+            }
+            return {summarize(std::move(wall)), summarize(std::move(cpu)), averageCounts(counts)};
+        }
+
+        /**
+         * @brief Замеряет функцию: сначала прогревочные прогоны, затем учитываемые.
+         * @param config Количество прогонов.
+         * @param fn Замеряемая функция без аргументов.
+         * @return Статистика реального и процессорного времени учитываемых прогонов.
+         */
+        template <typename Fn>
+        Measurement measure(const RunConfig &config, Fn &&fn)
+        {
+            return measure(config, []() {}, std::forward<Fn>(fn));
+        }
+
+    } // namespace bench
+} // namespace university
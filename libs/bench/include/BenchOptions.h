@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BenchHarness.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace university
+{
+    namespace bench
+    {
+
+        /**
+         * @struct BenchOptions
+         * @brief Параметры запуска бенчмарка из командной строки.
+         *
+         * Пустой список threads или suites означает значения по умолчанию:
+         * 1, 2, 4, ... до числа ядер и все наборы замеров соответственно.
+         */
+        struct BenchOptions
+        {
+            std::vector<size_t> sizes;          ///< --sizes: объёмы реестра
+            std::vector<std::string> modes;     ///< --modes: режимы вычисления
+            std::vector<unsigned> threads;      ///< --threads: числа потоков
+            std::vector<uint64_t> seeds = {42}; ///< --seeds: зёрна генерации данных
+            std::vector<std::string> suites;    ///< --suites: наборы замеров
+            RunConfig run;                      ///< --warmup, --repetitions
+            std::filesystem::path outputDirectory = "../docs"; ///< --output: каталог результатов
+            bool counters = false;              ///< --counters: собирать аппаратные счётчики
+            bool help = false;                  ///< --help: вывести справку и завершиться
+
+            /**
+             * @brief Проверяет, выбран ли набор замеров.
+             * @param suite Имя набора.
+             * @return true, если набор указан в --suites или список пуст.
+             */
+            [[nodiscard]] bool selected(std::string_view suite) const;
+
+            /**
+             * @brief Получает числа потоков с учётом значения по умолчанию.
+             * @return Значения --threads или 1, 2, 4, ... до числа ядер.
+             */
+            [[nodiscard]] std::vector<unsigned> threadCounts() const;
+        };
+
+        /**
+         * @brief Разбирает аргументы командной строки.
+         *
+         * Списки задаются через запятую: --sizes 1000,100000 --modes single.
+         *
+         * @param argc Количество аргументов.
+         * @param argv Аргументы (argv[0] — имя программы).
+         * @param defaults Значения по умолчанию, дополняемые аргументами.
+         * @param knownSuites Допустимые имена наборов замеров.
+         * @param knownModes Допустимые режимы.
+         * @return Параметры запуска.
+         * @throw std::invalid_argument при неизвестном ключе или некорректном значении.
+         */
+        BenchOptions parseBenchOptions(int argc, const char *const *argv, BenchOptions defaults,
+                                       const std::vector<std::string> &knownSuites,
+                                       const std::vector<std::string> &knownModes);
+
+        /**
+         * @brief Формирует справку по ключам командной строки.
+         * @param program Имя программы.
+         * @param knownSuites Допустимые имена наборов замеров.
+         * @param knownModes Допустимые режимы.
+         * @return Текст справки.
+         */
+        std::string benchUsage(std::string_view program, const std::vector<std::string> &knownSuites,
+                               const std::vector<std::string> &knownModes);
+
+    } // namespace bench
+} // namespace university
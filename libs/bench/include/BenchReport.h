@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BenchHarness.h"
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+    namespace bench
+    {
+
+        /**
+         * @brief Параметры одного замера: имя и значение, например {"Students", "1000"}.
+         */
+        using BenchParameters = std::vector<std::pair<std::string, std::string>>;
+
+        /**
+         * @struct BenchRecord
+         * @brief Замер с параметрами, при которых он выполнен.
+         */
+        struct BenchRecord
+        {
+            BenchParameters parameters;
+            Measurement measurement;
+        };
+
+        /**
+         * @class BenchReport
+         * @brief Результаты одного бенчмарка и их запись в CSV и JSON.
+         *
+         * Все замеры отчёта должны иметь одинаковые имена параметров в одном
+         * порядке: они становятся первыми столбцами CSV.
+         */
+        class BenchReport
+        {
+        public:
+            /**
+             * @brief Конструирует пустой отчёт.
+             * @param benchmark Имя бенчмарка.
+             * @param config Количество прогонов, с которым выполнялись замеры.
+             */
+            BenchReport(std::string benchmark, RunConfig config);
+
+            /**
+             * @brief Добавляет замер.
+             * @param parameters Параметры замера.
+             * @param measurement Результат замера.
+             */
+            void add(BenchParameters parameters, Measurement measurement);
+
+            /**
+             * @brief Получает добавленные замеры.
+             * @return Замеры в порядке добавления.
+             */
+            [[nodiscard]] const std::vector<BenchRecord> &records() const { return records_; }
+
+            /**
+             * @brief Записывает отчёт в CSV: параметры, затем min/median/p95/max/mean/stddev
+             *        реального и процессорного времени и, если они собраны, средние
+             *        значения аппаратных счётчиков на прогон и IPC.
+             * @param path Путь к файлу (перезаписывается).
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void writeCsv(const std::filesystem::path &path) const;
+
+            /**
+             * @brief Записывает отчёт в JSON вместе со всеми замерами каждого прогона
+             *        и доступными аппаратными счётчиками.
+             * @param path Путь к файлу (перезаписывается).
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void writeJson(const std::filesystem::path &path) const;
+
+        private:
+            std::string benchmark_;
+            RunConfig config_;
+            std::vector<BenchRecord> records_;
+        };
+
+    } // namespace bench
+} // namespace university
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace university
+{
+    namespace bench
+    {
+
+        /**
+         * @class LatencyHistogram
+         * @brief Гистограмма задержек с логарифмически-линейными корзинами (в духе HdrHistogram).
+         *
+         * Значения до 2^SUB_BUCKET_BITS хранятся точно; каждый следующий интервал
+         * [2^k, 2^(k+1)) делится на 2^SUB_BUCKET_BITS равных корзин, поэтому
+         * относительная погрешность процентилей не превышает 1/128 при любом
+         * диапазоне значений. Запись — O(1) без выделения памяти; гистограммы
+         * потоков сливаются после замера. Экземпляр не потокобезопасен.
+         */
+        class LatencyHistogram
+        {
+        public:
+            static constexpr unsigned SUB_BUCKET_BITS = 7;
+            static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+
+            /**
+             * @brief Конструирует пустую гистограмму.
+             */
+            LatencyHistogram();
+
+            /**
+             * @brief Добавляет значение.
+             * @param value Значение (например, задержка в наносекундах).
+             */
+            void record(uint64_t value);
+
+            /**
+             * @brief Добавляет все значения другой гистограммы.
+             * @param other Гистограмма.
+             */
+            void merge(const LatencyHistogram &other);
+
+            /**
+             * @brief Получает значение процентиля.
+             * @param percentile Процентиль от 0 до 100, например 99.9.
+             * @return Верхняя граница корзины, содержащей значение с этим рангом (не больше max()); 0 для пустой гистограммы.
+             */
+            [[nodiscard]] uint64_t percentile(double percentile) const;
+
+            [[nodiscard]] uint64_t count() const { return count_; }
+            [[nodiscard]] uint64_t min() const { return count_ != 0 ? min_ : 0; }
+            [[nodiscard]] uint64_t max() const { return max_; }
+
+            /**
+             * @brief Получает среднее значение (по точным значениям, без округления до корзин).
+             * @return Среднее или 0 для пустой гистограммы.
+             */
+            [[nodiscard]] double mean() const;
+
+        private:
+            static size_t bucketIndex(uint64_t value);
+            static uint64_t bucketUpperBound(size_t index);
+
+            std::vector<uint64_t> counts_;
+            uint64_t count_ = 0;
+            uint64_t min_ = UINT64_MAX;
+            uint64_t max_ = 0;
+            long double sum_ = 0.0L;
+        };
+
+    } // namespace bench
+} // namespace university
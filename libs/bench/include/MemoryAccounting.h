@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+namespace university
+{
+    namespace bench
+    {
+
+        /**
+         * @struct AllocationStats
+         * @brief Счётчики глобального распределителя памяти.
+         *
+         * Размеры блоков берутся у распределителя (malloc_usable_size), поэтому
+         * включают округление, но не служебный заголовок блока.
+         */
+        struct AllocationStats
+        {
+            uint64_t allocations = 0;   ///< Вызовов operator new
+            uint64_t deallocations = 0; ///< Вызовов operator delete
+            uint64_t bytesAllocated = 0;
+            uint64_t bytesFreed = 0;
+
+            /**
+             * @brief Получает прирост занятой памяти.
+             * @return Выделено минус освобождено, байт (может быть отрицательным для разности снимков).
+             */
+            [[nodiscard]] int64_t liveBytes() const
+            {
+                return static_cast<int64_t>(bytesAllocated) - static_cast<int64_t>(bytesFreed);
+            }
+        };
+
+        /**
+         * @brief Получает счётчики выделений памяти с начала работы процесса.
+         *
+         * Глобальные operator new/delete заменяются счётными в той же единице
+         * трансляции, поэтому замена подключается только к программам, которые
+         * вызывают эту функцию (бенчмарк и тесты); приложение её не использует.
+         *
+         * @return Текущие значения счётчиков всех потоков.
+         */
+        AllocationStats allocationStats();
+
+        /**
+         * @brief Вычисляет разность счётчиков.
+         * @param after Более поздний снимок.
+         * @param before Более ранний снимок.
+         * @return Счётчики за интервал между снимками.
+         */
+        AllocationStats operator-(const AllocationStats &after, const AllocationStats &before);
+
+        /**
+         * @class AllocationScope
+         * @brief Считает выделения памяти, выполненные всеми потоками с момента создания.
+         */
+        class AllocationScope
+        {
+        public:
+            AllocationScope() : start_(allocationStats()) {}
+
+            /**
+             * @brief Получает счётчики с момента создания.
+             * @return Разность текущих счётчиков и счётчиков при создании.
+             */
+            [[nodiscard]] AllocationStats delta() const
+            {
+                return allocationStats() - start_;
+            }
+
+        private:
+            AllocationStats start_;
+        };
+
+        /**
+         * @struct ProcessMemory
+         * @brief Резидентная память процесса.
+         */
+        struct ProcessMemory
+        {
+            uint64_t rssBytes = 0;     ///< Текущий размер резидентной памяти (VmRSS)
+            uint64_t peakRssBytes = 0; ///< Пиковый размер резидентной памяти (VmHWM)
+        };
+
+        /**
+         * @brief Получает резидентную память процесса из /proc/self/status.
+         * @return Текущий и пиковый размер; нули, если сведения недоступны.
+         */
+        ProcessMemory processMemory();
+
+        /**
+         * @brief Сбрасывает пиковый размер резидентной памяти до текущего.
+         *
+         * Позволяет измерять пик отдельно для каждого этапа; требует Linux 4.0+.
+         *
+         * @return true, если сброс выполнен.
+         */
+        bool resetPeakRss();
+
+    } // namespace bench
+} // namespace university
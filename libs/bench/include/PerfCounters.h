@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace university
+{
+    namespace bench
+    {
+
+        /**
+         * @enum PerfEvent
+         * @brief Аппаратные счётчики, собираемые PerfCounters.
+         */
+        enum class PerfEvent : size_t
+        {
+            CYCLES,
+            INSTRUCTIONS,
+            L1D_MISSES,    ///< Промахи кэша данных первого уровня при чтении
+            LLC_MISSES,    ///< Промахи кэша последнего уровня
+            BRANCH_MISSES, ///< Неверно предсказанные переходы
+            COUNT
+        };
+
+        inline constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::COUNT);
+
+        /**
+         * @brief Получает имя счётчика для отчётов.
+         * @param event Счётчик.
+         * @return Имя, например "cycles".
+         */
+        std::string_view perfEventName(PerfEvent event);
+
+        /**
+         * @struct PerfCounts
+         * @brief Значения счётчиков за замеренный участок.
+         *
+         * Счётчик, который не удалось открыть (нет прав, виртуальная машина,
+         * не Linux), помечается недоступным; остальные значения действительны.
+         * При мультиплексировании значения масштабируются по времени работы счётчика.
+         */
+        struct PerfCounts
+        {
+            std::array<uint64_t, PERF_EVENT_COUNT> values{};
+            std::array<bool, PERF_EVENT_COUNT> valid{};
+
+            [[nodiscard]] bool has(PerfEvent event) const { return valid[static_cast<size_t>(event)]; }
+            [[nodiscard]] uint64_t get(PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+
+            /**
+             * @brief Вычисляет число инструкций за такт.
+             * @return IPC или 0, если циклы или инструкции недоступны.
+             */
+            [[nodiscard]] double ipc() const;
+
+            /**
+             * @brief Вычисляет значение счётчика на один обработанный элемент.
+             * @param event Счётчик.
+             * @param items Количество элементов (студентов, операций).
+             * @return Среднее на элемент или -1, если счётчик недоступен.
+             */
+            [[nodiscard]] double perItem(PerfEvent event, size_t items) const;
+
+            /**
+             * @brief Проверяет, действителен ли хотя бы один счётчик.
+             */
+            [[nodiscard]] bool any() const;
+        };
+
+        /**
+         * @brief Усредняет значения счётчиков нескольких прогонов.
+         * @param samples Значения каждого прогона.
+         * @return Среднее на прогон; счётчик действителен, только если он действителен во всех прогонах.
+         */
+        PerfCounts averageCounts(const std::vector<PerfCounts> &samples);
+
+        /**
+         * @class PerfCounters
+         * @brief Набор аппаратных счётчиков процесса на основе perf_event_open.
+         *
+         * Считаются только события пользовательского режима вызывающего потока
+         * и потоков, созданных после открытия (параллельные обходы создают
+         * потоки на каждый вызов, поэтому они учитываются). Конструктор не
+         * бросает исключений: при недоступности счётчиков available() возвращает
+         * false, а замеры возвращают пустые PerfCounts.
+         */
+        class PerfCounters
+        {
+        public:
+            PerfCounters();
+            ~PerfCounters();
+
+            PerfCounters(const PerfCounters &) = delete;
+            PerfCounters &operator=(const PerfCounters &) = delete;
+
+            /**
+             * @brief Проверяет, открыт ли хотя бы один счётчик.
+             */
+            [[nodiscard]] bool available() const;
+
+            /**
+             * @brief Получает причину недоступности счётчиков.
+             * @return Описание ошибки perf_event_open первого неоткрытого счётчика или пустая строка.
+             */
+            [[nodiscard]] const std::string &unavailableReason() const { return reason_; }
+
+            /**
+             * @brief Обнуляет и запускает счётчики.
+             */
+            void start();
+
+            /**
+             * @brief Останавливает счётчики и читает значения.
+             * @return Значения с момента start().
+             */
+            PerfCounts stop();
+
+        private:
+            std::array<int, PERF_EVENT_COUNT> fds_;
+            std::string reason_;
+        };
+
+        /**
+         * @class PerfScope
+         * @brief Замеряет счётчики на участке кода: запуск в конструкторе, остановка в stop() или деструкторе.
+         */
+        class PerfScope
+        {
+        public:
+            explicit PerfScope(PerfCounters &counters) : counters_(counters) { counters_.start(); }
+            ~PerfScope()
+            {
+                if (!stopped_)
+                {
+                    counters_.stop();
+                }
+            }
+
+            PerfScope(const PerfScope &) = delete;
+            PerfScope &operator=(const PerfScope &) = delete;
+
+            /**
+             * @brief Останавливает замер.
+             * @return Значения счётчиков участка.
+             */
+            PerfCounts stop()
+            {
+                stopped_ = true;
+                return counters_.stop();
+            }
+
+        private:
+            PerfCounters &counters_;
+            bool stopped_ = false;
+        };
+
+        /**
+         * @brief Форматирует IPC и счётчики на элемент для вывода в консоль.
+         * @param counts Значения счётчиков.
+         * @param items Количество элементов.
+         * @return Строка вида "IPC 1.85, L1D-промахов/эл. 2.1, ..." или пометка о недоступности.
+         */
+        std::string formatPerfCounts(const PerfCounts &counts, size_t items);
+
+    } // namespace bench
+} // namespace university
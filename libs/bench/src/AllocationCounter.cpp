@@ -0,0 +1,117 @@
+#include "MemoryAccounting.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+// Замена глобальных operator new/delete. Находится в одной единице трансляции
+// с allocationStats(), поэтому компоновщик подключает её только вместе с ней.
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytesAllocated{0};
+    std::atomic<uint64_t> bytesFreed{0};
+
+    void *countedAllocate(std::size_t size, std::size_t alignment) noexcept
+    {
+        size = size == 0 ? 1 : size;
+        void *pointer = alignment <= alignof(std::max_align_t)
+                            ? std::malloc(size)
+                            : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (pointer != nullptr)
+        {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            bytesAllocated.fetch_add(malloc_usable_size(pointer), std::memory_order_relaxed);
+        }
+        return pointer;
+    }
+
+    void *countedAllocateOrThrow(std::size_t size, std::size_t alignment)
+    {
+        while (true)
+        {
+            if (void *pointer = countedAllocate(size, alignment))
+            {
+                return pointer;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void countedFree(void *pointer) noexcept
+    {
+        if (pointer != nullptr)
+        {
+            deallocations.fetch_add(1, std::memory_order_relaxed);
+            bytesFreed.fetch_add(malloc_usable_size(pointer), std::memory_order_relaxed);
+            std::free(pointer);
+        }
+    }
+
+    constexpr std::size_t DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+} // namespace
+
+void *operator new(std::size_t size) { return countedAllocateOrThrow(size, DEFAULT_ALIGNMENT); }
+void *operator new[](std::size_t size) { return countedAllocateOrThrow(size, DEFAULT_ALIGNMENT); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size, DEFAULT_ALIGNMENT); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size, DEFAULT_ALIGNMENT); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { countedFree(pointer); }
+
+namespace university
+{
+    namespace bench
+    {
+
+        AllocationStats allocationStats()
+        {
+            AllocationStats stats;
+            stats.allocations = allocations.load(std::memory_order_relaxed);
+            stats.deallocations = deallocations.load(std::memory_order_relaxed);
+            stats.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+            stats.bytesFreed = bytesFreed.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        AllocationStats operator-(const AllocationStats &after, const AllocationStats &before)
+        {
+            AllocationStats delta;
+            delta.allocations = after.allocations - before.allocations;
+            delta.deallocations = after.deallocations - before.deallocations;
+            delta.bytesAllocated = after.bytesAllocated - before.bytesAllocated;
+            delta.bytesFreed = after.bytesFreed - before.bytesFreed;
+            return delta;
+        }
+
+    } // namespace bench
+} // namespace university
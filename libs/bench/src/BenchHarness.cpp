@@ -0,0 +1,48 @@
+#include "BenchHarness.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <numeric>
+
+namespace university
+{
+    namespace bench
+    {
+
+        SampleStats summarize(std::vector<double> samples)
+        {
+            SampleStats stats;
+            stats.samples = samples;
+            if (samples.empty())
+            {
+                return stats;
+            }
+
+            std::sort(samples.begin(), samples.end());
+            size_t n = samples.size();
+            stats.min = samples.front();
+            stats.max = samples.back();
+            stats.median = n % 2 != 0 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+            stats.p95 = samples[(n * 95 + 99) / 100 - 1];
+            stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(n);
+            if (n > 1)
+            {
+                double squares = 0.0;
+                for (double sample : samples)
+                {
+                    squares += (sample - stats.mean) * (sample - stats.mean);
+                }
+                stats.stddev = std::sqrt(squares / static_cast<double>(n - 1));
+            }
+            return stats;
+        }
+
+        double processCpuMs()
+        {
+            timespec time{};
+            clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+            return static_cast<double>(time.tv_sec) * 1000.0 + static_cast<double>(time.tv_nsec) / 1e6;
+        }
+
+    } // namespace bench
+} // namespace university
@@ -0,0 +1,182 @@
+#include "BenchOptions.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <thread>
+
+namespace university
+{
+    namespace bench
+    {
+        namespace
+        {
+            std::vector<std::string_view> splitList(std::string_view text)
+            {
+                std::vector<std::string_view> items;
+                while (true)
+                {
+                    size_t comma = text.find(',');
+                    items.push_back(text.substr(0, comma));
+                    if (comma == std::string_view::npos)
+                    {
+                        return items;
+                    }
+                    text.remove_prefix(comma + 1);
+                }
+            }
+
+            template <typename T>
+            T parseNumber(std::string_view option, std::string_view text)
+            {
+                T value{};
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (text.empty() || error != std::errc() || end != text.data() + text.size())
+                {
+                    throw std::invalid_argument("Некорректное число для " + std::string(option) + ": " + std::string(text));
+                }
+                return value;
+            }
+
+            template <typename T>
+            std::vector<T> parseNumbers(std::string_view option, std::string_view text)
+            {
+                std::vector<T> values;
+                for (auto item : splitList(text))
+                {
+                    values.push_back(parseNumber<T>(option, item));
+                }
+                return values;
+            }
+
+            std::vector<std::string> parseNames(std::string_view option, std::string_view text, const std::vector<std::string> &known)
+            {
+                std::vector<std::string> names;
+                for (auto item : splitList(text))
+                {
+                    if (std::find(known.begin(), known.end(), item) == known.end())
+                    {
+                        throw std::invalid_argument("Неизвестное значение для " + std::string(option) + ": " + std::string(item));
+                    }
+                    names.emplace_back(item);
+                }
+                return names;
+            }
+
+            std::string joinNames(const std::vector<std::string> &names)
+            {
+                std::string result;
+                for (const auto &name : names)
+                {
+                    result += (result.empty() ? "" : ",") + name;
+                }
+                return result;
+            }
+
+        } // namespace
+
+        bool BenchOptions::selected(std::string_view suite) const
+        {
+            return suites.empty() || std::find(suites.begin(), suites.end(), suite) != suites.end();
+        }
+
+        std::vector<unsigned> BenchOptions::threadCounts() const
+        {
+            if (!threads.empty())
+            {
+                return threads;
+            }
+            std::vector<unsigned> counts;
+            unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned count = 1; count < maxThreads; count *= 2)
+            {
+                counts.push_back(count);
+            }
+            counts.push_back(maxThreads);
+            return counts;
+        }
+
+        BenchOptions parseBenchOptions(int argc, const char *const *argv, BenchOptions defaults,
+                                       const std::vector<std::string> &knownSuites,
+                                       const std::vector<std::string> &knownModes)
+        {
+            BenchOptions options = std::move(defaults);
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string_view option = argv[i];
+                if (option == "--help" || option == "-h")
+                {
+                    options.help = true;
+                    continue;
+                }
+                if (option == "--counters")
+                {
+                    options.counters = true;
+                    continue;
+                }
+                if (i + 1 >= argc)
+                {
+                    throw std::invalid_argument("Не указано значение для " + std::string(option));
+                }
+                std::string_view value = argv[++i];
+                if (option == "--sizes")
+                {
+                    options.sizes = parseNumbers<size_t>(option, value);
+                }
+                else if (option == "--modes")
+                {
+                    options.modes = parseNames(option, value, knownModes);
+                }
+                else if (option == "--threads")
+                {
+                    options.threads = parseNumbers<unsigned>(option, value);
+                    if (std::find(options.threads.begin(), options.threads.end(), 0u) != options.threads.end())
+                    {
+                        throw std::invalid_argument("Число потоков должно быть положительным");
+                    }
+                }
+                else if (option == "--seeds")
+                {
+                    options.seeds = parseNumbers<uint64_t>(option, value);
+                }
+                else if (option == "--suites")
+                {
+                    options.suites = parseNames(option, value, knownSuites);
+                }
+                else if (option == "--warmup")
+                {
+                    options.run.warmup = parseNumber<unsigned>(option, value);
+                }
+                else if (option == "--repetitions")
+                {
+                    options.run.repetitions = std::max(1u, parseNumber<unsigned>(option, value));
+                }
+                else if (option == "--output")
+                {
+                    options.outputDirectory = value;
+                }
+                else
+                {
+                    throw std::invalid_argument("Неизвестный ключ: " + std::string(option));
+                }
+            }
+            return options;
+        }
+
+        std::string benchUsage(std::string_view program, const std::vector<std::string> &knownSuites,
+                               const std::vector<std::string> &knownModes)
+        {
+            std::string usage = "Использование: " + std::string(program) + " [ключи]\n";
+            usage += "  --sizes N,...        объёмы реестра\n";
+            usage += "  --modes M,...        режимы (" + joinNames(knownModes) + ")\n";
+            usage += "  --threads N,...      числа потоков (по умолчанию 1, 2, 4, ... до числа ядер)\n";
+            usage += "  --seeds N,...        зёрна генерации данных\n";
+            usage += "  --suites S,...       наборы замеров (" + joinNames(knownSuites) + ")\n";
+            usage += "  --warmup N           прогревочных прогонов\n";
+            usage += "  --repetitions N      учитываемых прогонов\n";
+            usage += "  --output DIR         каталог результатов\n";
+            usage += "  --counters           собирать аппаратные счётчики (perf_event_open)\n";
+            return usage;
+        }
+
+    } // namespace bench
+} // namespace university
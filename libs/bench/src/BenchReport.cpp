@@ -0,0 +1,212 @@
+#include "BenchReport.h"
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+namespace university
+{
+    namespace bench
+    {
+        namespace
+        {
+            constexpr const char *STAT_NAMES[] = {"Min", "Median", "P95", "Max", "Mean", "Stddev"};
+
+            std::ofstream openOutput(const std::filesystem::path &path)
+            {
+                std::ofstream file(path);
+                if (!file)
+                {
+                    throw std::runtime_error("Не удалось открыть файл результатов: " + path.string());
+                }
+                return file;
+            }
+
+            void finishOutput(std::ofstream &file, const std::filesystem::path &path)
+            {
+                file.flush();
+                if (!file)
+                {
+                    throw std::runtime_error("Ошибка записи файла результатов: " + path.string());
+                }
+            }
+
+            void writeStatValues(std::ostream &out, const SampleStats &stats)
+            {
+                for (double value : {stats.min, stats.median, stats.p95, stats.max, stats.mean, stats.stddev})
+                {
+                    out << ',' << value;
+                }
+            }
+
+            bool isNumber(const std::string &text)
+            {
+                double value = 0.0;
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+                return !text.empty() && error == std::errc() && end == text.data() + text.size();
+            }
+
+            void writeJsonString(std::ostream &out, const std::string &text)
+            {
+                out << '"';
+                for (char c : text)
+                {
+                    if (c == '"' || c == '\\')
+                    {
+                        out << '\\';
+                    }
+                    out << c;
+                }
+                out << '"';
+            }
+
+            bool hasCounters(const std::vector<BenchRecord> &records)
+            {
+                for (const auto &record : records)
+                {
+                    if (record.measurement.counters.any())
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void writeJsonStats(std::ostream &out, const SampleStats &stats)
+            {
+                out << "{\"min\": " << stats.min << ", \"median\": " << stats.median << ", \"p95\": " << stats.p95
+                    << ", \"max\": " << stats.max << ", \"mean\": " << stats.mean << ", \"stddev\": " << stats.stddev
+                    << ", \"samples\": [";
+                for (size_t i = 0; i < stats.samples.size(); ++i)
+                {
+                    out << (i != 0 ? ", " : "") << stats.samples[i];
+                }
+                out << "]}";
+            }
+
+        } // namespace
+
+        BenchReport::BenchReport(std::string benchmark, RunConfig config)
+            : benchmark_(std::move(benchmark)), config_(config) {}
+
+        void BenchReport::add(BenchParameters parameters, Measurement measurement)
+        {
+            records_.push_back({std::move(parameters), std::move(measurement)});
+        }
+
+        void BenchReport::writeCsv(const std::filesystem::path &path) const
+        {
+            auto file = openOutput(path);
+            bool counters = hasCounters(records_);
+            if (!records_.empty())
+            {
+                for (const auto &[name, value] : records_.front().parameters)
+                {
+                    file << name << ',';
+                }
+                file << "Repetitions";
+                for (const char *clock : {"Wall", "Cpu"})
+                {
+                    for (const char *stat : STAT_NAMES)
+                    {
+                        file << ',' << clock << stat << "(ms)";
+                    }
+                }
+                if (counters)
+                {
+                    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+                    {
+                        file << ',' << perfEventName(static_cast<PerfEvent>(i));
+                    }
+                    file << ",IPC";
+                }
+                file << '\n';
+            }
+            for (const auto &record : records_)
+            {
+                for (const auto &[name, value] : record.parameters)
+                {
+                    file << value << ',';
+                }
+                file << record.measurement.wallMs.samples.size();
+                writeStatValues(file, record.measurement.wallMs);
+                writeStatValues(file, record.measurement.cpuMs);
+                if (counters)
+                {
+                    // Недоступные счётчики оставляют пустые ячейки
+                    const auto &counts = record.measurement.counters;
+                    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+                    {
+                        file << ',';
+                        if (counts.valid[i])
+                        {
+                            file << counts.values[i];
+                        }
+                    }
+                    file << ',';
+                    if (counts.ipc() > 0.0)
+                    {
+                        file << counts.ipc();
+                    }
+                }
+                file << '\n';
+            }
+            finishOutput(file, path);
+        }
+
+        void BenchReport::writeJson(const std::filesystem::path &path) const
+        {
+            auto file = openOutput(path);
+            file << "{\n  \"benchmark\": ";
+            writeJsonString(file, benchmark_);
+            file << ",\n  \"warmup\": " << config_.warmup << ",\n  \"repetitions\": " << config_.repetitions
+                 << ",\n  \"results\": [";
+            for (size_t i = 0; i < records_.size(); ++i)
+            {
+                const auto &record = records_[i];
+                file << (i != 0 ? ",\n" : "\n") << "    {\"parameters\": {";
+                for (size_t j = 0; j < record.parameters.size(); ++j)
+                {
+                    const auto &[name, value] = record.parameters[j];
+                    file << (j != 0 ? ", " : "");
+                    writeJsonString(file, name);
+                    file << ": ";
+                    if (isNumber(value))
+                    {
+                        file << value;
+                    }
+                    else
+                    {
+                        writeJsonString(file, value);
+                    }
+                }
+                file << "},\n     \"wall_ms\": ";
+                writeJsonStats(file, record.measurement.wallMs);
+                file << ",\n     \"cpu_ms\": ";
+                writeJsonStats(file, record.measurement.cpuMs);
+                if (const auto &counts = record.measurement.counters; counts.any())
+                {
+                    file << ",\n     \"counters\": {";
+                    bool first = true;
+                    for (size_t j = 0; j < PERF_EVENT_COUNT; ++j)
+                    {
+                        if (counts.valid[j])
+                        {
+                            file << (first ? "" : ", ") << '"' << perfEventName(static_cast<PerfEvent>(j))
+                                 << "\": " << counts.values[j];
+                            first = false;
+                        }
+                    }
+                    if (counts.ipc() > 0.0)
+                    {
+                        file << ", \"ipc\": " << counts.ipc();
+                    }
+                    file << '}';
+                }
+                file << '}';
+            }
+            file << "\n  ]\n}\n";
+            finishOutput(file, path);
+        }
+
+    } // namespace bench
+} // namespace university
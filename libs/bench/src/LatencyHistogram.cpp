@@ -0,0 +1,89 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace university
+{
+    namespace bench
+    {
+        namespace
+        {
+            // Интервалы [2^k, 2^(k+1)) для k = SUB_BUCKET_BITS .. 63 и точные значения до 2^SUB_BUCKET_BITS
+            constexpr size_t BUCKET_COUNT = (64 - LatencyHistogram::SUB_BUCKET_BITS + 1) * LatencyHistogram::SUB_BUCKETS;
+        } // namespace
+
+        LatencyHistogram::LatencyHistogram() : counts_(BUCKET_COUNT, 0)
+        {
+        }
+
+        size_t LatencyHistogram::bucketIndex(uint64_t value)
+        {
+            if (value < SUB_BUCKETS)
+            {
+                return static_cast<size_t>(value);
+            }
+            unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - SUB_BUCKET_BITS;
+            return (shift + 1) * SUB_BUCKETS + static_cast<size_t>((value >> shift) - SUB_BUCKETS);
+        }
+
+        uint64_t LatencyHistogram::bucketUpperBound(size_t index)
+        {
+            if (index < SUB_BUCKETS)
+            {
+                return index;
+            }
+            unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS - 1);
+            uint64_t mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+            return ((mantissa + 1) << shift) - 1;
+        }
+
+        void LatencyHistogram::record(uint64_t value)
+        {
+            ++counts_[bucketIndex(value)];
+            ++count_;
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+            sum_ += static_cast<long double>(value);
+        }
+
+        void LatencyHistogram::merge(const LatencyHistogram &other)
+        {
+            for (size_t i = 0; i < counts_.size(); ++i)
+            {
+                counts_[i] += other.counts_[i];
+            }
+            count_ += other.count_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+            sum_ += other.sum_;
+        }
+
+        uint64_t LatencyHistogram::percentile(double percentile) const
+        {
+            if (count_ == 0)
+            {
+                return 0;
+            }
+            // Ближайший ранг, как у SampleStats::p95
+            auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count_)));
+            rank = std::max<uint64_t>(rank, 1);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts_.size(); ++i)
+            {
+                seen += counts_[i];
+                if (seen >= rank)
+                {
+                    return std::min(bucketUpperBound(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        double LatencyHistogram::mean() const
+        {
+            return count_ != 0 ? static_cast<double>(sum_ / static_cast<long double>(count_)) : 0.0;
+        }
+
+    } // namespace bench
+} // namespace university
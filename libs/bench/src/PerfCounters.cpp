@@ -0,0 +1,232 @@
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace university
+{
+    namespace bench
+    {
+        namespace
+        {
+            constexpr std::array<std::string_view, PERF_EVENT_COUNT> EVENT_NAMES = {
+                "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+
+#if defined(__linux__)
+            perf_event_attr eventAttributes(PerfEvent event)
+            {
+                perf_event_attr attributes;
+                std::memset(&attributes, 0, sizeof(attributes));
+                attributes.size = sizeof(attributes);
+                attributes.disabled = 1;
+                attributes.inherit = 1; // Потоки, созданные во время замера
+                attributes.exclude_kernel = 1;
+                attributes.exclude_hv = 1;
+                attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                switch (event)
+                {
+                case PerfEvent::CYCLES:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+                    break;
+                case PerfEvent::INSTRUCTIONS:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+                    break;
+                case PerfEvent::L1D_MISSES:
+                    attributes.type = PERF_TYPE_HW_CACHE;
+                    attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                    break;
+                case PerfEvent::LLC_MISSES:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+                    break;
+                case PerfEvent::BRANCH_MISSES:
+                case PerfEvent::COUNT:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+                    break;
+                }
+                return attributes;
+            }
+#endif
+
+        } // namespace
+
+        std::string_view perfEventName(PerfEvent event)
+        {
+            return EVENT_NAMES[static_cast<size_t>(event)];
+        }
+
+        double PerfCounts::ipc() const
+        {
+            if (!has(PerfEvent::CYCLES) || !has(PerfEvent::INSTRUCTIONS) || get(PerfEvent::CYCLES) == 0)
+            {
+                return 0.0;
+            }
+            return static_cast<double>(get(PerfEvent::INSTRUCTIONS)) / static_cast<double>(get(PerfEvent::CYCLES));
+        }
+
+        double PerfCounts::perItem(PerfEvent event, size_t items) const
+        {
+            if (!has(event))
+            {
+                return -1.0;
+            }
+            return static_cast<double>(get(event)) / static_cast<double>(items == 0 ? 1 : items);
+        }
+
+        bool PerfCounts::any() const
+        {
+            for (bool value : valid)
+            {
+                if (value)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        PerfCounts averageCounts(const std::vector<PerfCounts> &samples)
+        {
+            PerfCounts average;
+            if (samples.empty())
+            {
+                return average;
+            }
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                uint64_t sum = 0;
+                bool valid = true;
+                for (const auto &sample : samples)
+                {
+                    sum += sample.values[i];
+                    valid = valid && sample.valid[i];
+                }
+                average.values[i] = valid ? sum / samples.size() : 0;
+                average.valid[i] = valid;
+            }
+            return average;
+        }
+
+        PerfCounters::PerfCounters()
+        {
+            fds_.fill(-1);
+#if defined(__linux__)
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                auto attributes = eventAttributes(static_cast<PerfEvent>(i));
+                fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+                if (fds_[i] < 0 && reason_.empty())
+                {
+                    reason_ = std::string(EVENT_NAMES[i]) + ": " + std::strerror(errno);
+                }
+            }
+#else
+            reason_ = "perf_event_open доступен только в Linux";
+#endif
+        }
+
+        PerfCounters::~PerfCounters()
+        {
+#if defined(__linux__)
+            for (int fd : fds_)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+#endif
+        }
+
+        bool PerfCounters::available() const
+        {
+            for (int fd : fds_)
+            {
+                if (fd >= 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void PerfCounters::start()
+        {
+#if defined(__linux__)
+            for (int fd : fds_)
+            {
+                if (fd >= 0)
+                {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        PerfCounts PerfCounters::stop()
+        {
+            PerfCounts counts;
+#if defined(__linux__)
+            for (int fd : fds_)
+            {
+                if (fd >= 0)
+                {
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                // value, time_enabled, time_running
+                uint64_t data[3] = {};
+                if (fds_[i] < 0 || read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+                {
+                    continue;
+                }
+                double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+                counts.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * scale);
+                counts.valid[i] = true;
+            }
+#endif
+            return counts;
+        }
+
+        std::string formatPerfCounts(const PerfCounts &counts, size_t items)
+        {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(2);
+            bool any = false;
+            if (counts.ipc() > 0.0)
+            {
+                text << "IPC " << counts.ipc();
+                any = true;
+            }
+            const std::pair<PerfEvent, const char *> perItem[] = {{PerfEvent::CYCLES, "тактов"},
+                                                                   {PerfEvent::L1D_MISSES, "L1D-промахов"},
+                                                                   {PerfEvent::LLC_MISSES, "LLC-промахов"},
+                                                                   {PerfEvent::BRANCH_MISSES, "ошибок предсказания"}};
+            for (const auto &[event, label] : perItem)
+            {
+                if (counts.has(event))
+                {
+                    text << (any ? ", " : "") << label << "/эл. " << counts.perItem(event, items);
+                    any = true;
+                }
+            }
+            return any ? text.str() : "аппаратные счётчики недоступны";
+        }
+
+    } // namespace bench
+} // namespace university
@@ -0,0 +1,44 @@
+#include "MemoryAccounting.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace university
+{
+    namespace bench
+    {
+
+        ProcessMemory processMemory()
+        {
+            ProcessMemory memory;
+            std::ifstream status("/proc/self/status");
+            std::string line;
+            while (std::getline(status, line))
+            {
+                // Строки вида "VmRSS:	  123456 kB"
+                std::istringstream fields(line);
+                std::string key;
+                uint64_t kibibytes = 0;
+                fields >> key >> kibibytes;
+                if (key == "VmRSS:")
+                {
+                    memory.rssBytes = kibibytes * 1024;
+                }
+                else if (key == "VmHWM:")
+                {
+                    memory.peakRssBytes = kibibytes * 1024;
+                }
+            }
+            return memory;
+        }
+
+        bool resetPeakRss()
+        {
+            std::ofstream clearRefs("/proc/self/clear_refs");
+            clearRefs << "5";
+            clearRefs.flush();
+            return static_cast<bool>(clearRefs);
+        }
+
+    } // namespace bench
+} // namespace university
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "Controller.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @class OperationCancelled
+     * @brief Исключение, которым завершается future отменённой асинхронной операции.
+     */
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        OperationCancelled() : std::runtime_error("Операция отменена") {}
+    };
+
+    /**
+     * @class AsyncController
+     * @brief Асинхронный интерфейс Controller: операции выполняются в собственном пуле потоков.
+     *
+     * Каждый метод ставит операцию в очередь и сразу возвращает std::future,
+     * поэтому несколько потоков вызывающего кода могут держать в работе много
+     * запросов одновременно; одновременность ограничена числом потоков пула.
+     * Операции одного вызывающего потока могут выполняться не в порядке
+     * вызова: если порядок важен, следующую операцию ставят после получения
+     * результата предыдущей или объединяют изменения в applyBatchAsync.
+     *
+     * Операцию отменяет запрос остановки у переданного std::stop_token или
+     * cancelAll(). Отменённая до начала операция не выполняется, а её future
+     * выбрасывает OperationCancelled; findIdsAsync проверяет отмену и во время
+     * сканирования. Начатое изменение реестра не прерывается.
+     */
+    class AsyncController
+    {
+    public:
+        /**
+         * @brief Запускает пул потоков над реестром.
+         * @param controller Реестр; должен существовать дольше AsyncController.
+         * @param threads Количество потоков (0 — по числу ядер).
+         */
+        explicit AsyncController(Controller &controller, unsigned threads = 0);
+
+        /**
+         * @brief Отменяет ожидающие операции и дожидается выполняемых.
+         */
+        ~AsyncController();
+
+        AsyncController(const AsyncController &) = delete;
+        AsyncController &operator=(const AsyncController &) = delete;
+
+        /**
+         * @brief Ищет студента по ID.
+         * @return Запись студента или nullptr, если студент не найден.
+         */
+        std::future<std::shared_ptr<const Student>> findAsync(int id, std::stop_token stop = {});
+
+        /**
+         * @brief Добавляет студента.
+         * @return ID добавленного студента.
+         */
+        std::future<int> addAsync(std::unique_ptr<Student> student, std::stop_token stop = {});
+
+        /**
+         * @brief Удаляет студента.
+         * @return true, если студент был удалён.
+         */
+        std::future<bool> removeAsync(int id, std::stop_token stop = {});
+
+        /**
+         * @brief Переводит студента в другую группу.
+         * @return true, если студент найден.
+         */
+        std::future<bool> setGroupAsync(int id, std::string groupIndex, std::stop_token stop = {});
+
+        /**
+         * @brief Применяет пакет изменений (см. Controller::applyBatch).
+         */
+        std::future<MutationBatchResult> applyBatchAsync(std::vector<MutationCommand> commands, std::stop_token stop = {});
+
+        /**
+         * @brief Вычисляет средние оценки по группам (через кэш результатов).
+         */
+        std::future<std::shared_ptr<const std::map<std::string, double>>> averagesByGroupAsync(std::stop_token stop = {});
+
+        /**
+         * @brief Находит k студентов с наибольшим средним баллом (через кэш результатов).
+         */
+        std::future<std::shared_ptr<const std::vector<RankedStudent>>> topStudentsAsync(size_t k, std::stop_token stop = {});
+
+        /**
+         * @brief Находит ID студентов, удовлетворяющих предикату, по снимку таблицы.
+         *
+         * Сканирование выполняется одним потоком пула блоками слотов таблицы;
+         * между блоками проверяется отмена. Снимок удерживается до конца
+         * сканирования, поэтому первое изменение реестра за это время копирует
+         * таблицу (O(n) копий указателей на записи); при частых
+         * изменениях параллельный Controller::findStudentIds держит снимок меньше.
+         *
+         * @param predicate Предикат; копируется в операцию.
+         * @return ID в порядке возрастания.
+         * @throw std::logic_error (через future) если реестр открыт только для чтения.
+         */
+        template <query::Predicate P>
+        std::future<std::vector<int>> findIdsAsync(P predicate, std::stop_token stop = {});
+
+        /**
+         * @brief Отменяет все поставленные к этому моменту операции; последующие выполняются.
+         */
+        void cancelAll();
+
+        /**
+         * @brief Получает количество потоков пула.
+         */
+        [[nodiscard]] size_t threads() const { return pool_.size(); }
+
+    private:
+        static constexpr size_t SCAN_BLOCK = 4096; // Слотов таблицы между проверками отмены
+
+        /**
+         * @brief Признак отмены операции: токен вызывающего и токен cancelAll на момент постановки.
+         */
+        struct Cancellation
+        {
+            std::stop_token caller;
+            std::stop_token owner;
+
+            [[nodiscard]] bool requested() const { return caller.stop_requested() || owner.stop_requested(); }
+
+            void throwIfRequested() const
+            {
+                if (requested())
+                {
+                    throw OperationCancelled();
+                }
+            }
+        };
+
+        /**
+         * @brief Ставит в пул операцию fn(const Cancellation &) и возвращает future её результата.
+         */
+        template <typename Fn>
+        auto submit(std::stop_token stop, Fn fn) -> std::future<std::invoke_result_t<Fn &, const Cancellation &>>;
+
+        Controller &controller_;
+        std::mutex mutex_;
+        std::stop_source cancelSource_; // Заменяется новым при каждом cancelAll
+        WorkerPool pool_;               // Последним: потоки останавливаются до уничтожения остальных полей
+    };
+
+    template <typename Fn>
+    auto AsyncController::submit(std::stop_token stop, Fn fn) -> std::future<std::invoke_result_t<Fn &, const Cancellation &>>
+    {
+        using Result = std::invoke_result_t<Fn &, const Cancellation &>;
+
+        // std::function требует копируемой задачи, а fn может владеть unique_ptr
+        struct Operation
+        {
+            std::promise<Result> promise;
+            Fn fn;
+            Cancellation cancellation;
+        };
+        auto operation = std::make_shared<Operation>(Operation{std::promise<Result>(), std::move(fn), Cancellation{std::move(stop), {}}});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            operation->cancellation.owner = cancelSource_.get_token();
+        }
+        auto future = operation->promise.get_future();
+        pool_.submit([operation]()
+                     {
+            try
+            {
+                operation->cancellation.throwIfRequested();
+                if constexpr (std::is_void_v<Result>)
+                {
+                    operation->fn(operation->cancellation);
+                    operation->promise.set_value();
+                }
+                else
+                {
+                    operation->promise.set_value(operation->fn(operation->cancellation));
+                }
+            }
+            catch (...)
+            {
+                operation->promise.set_exception(std::current_exception());
+            } });
+        return future;
+    }
+
+    template <query::Predicate P>
+    std::future<std::vector<int>> AsyncController::findIdsAsync(P predicate, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, predicate = std::move(predicate)](const Cancellation &cancellation)
+                      {
+            auto snapshot = controller_.takeSnapshot();
+            if (snapshot.mapped())
+            {
+                // Таблица отображаемого реестра пуста: без проверки результат был бы пустым
+                throw std::logic_error("Реестр открыт только для чтения.");
+            }
+            const auto &table = snapshot.table();
+            std::vector<int> ids;
+            for (size_t first = 0; first < table.bucketCount(); first += SCAN_BLOCK)
+            {
+                cancellation.throwIfRequested();
+                table.forEachInRange(first, first + SCAN_BLOCK, [&](int id, const std::shared_ptr<const Student> &student)
+                                     {
+                    if (predicate(*student))
+                    {
+                        ids.push_back(id);
+                    } });
+            }
+            std::sort(ids.begin(), ids.end());
+            return ids; });
+    }
+
+} // namespace university
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Controller.h"
+#include "SeniorStudent.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @brief Вид команды сценария.
+     */
+    enum class ScriptCommandType
+    {
+        ADD,    ///< ADD <строка CSV в формате storage::CSV_COLUMNS>
+        FIND,   ///< FIND <id>
+        REMOVE, ///< REMOVE <id>
+        GROUP,  ///< GROUP <id> <группа>
+        WORK,   ///< WORK <id> <оценка руководителя>,<оценка комиссии>,<тема>,<место> — УИР старшекурсника
+        AVG     ///< AVG <группа>
+    };
+
+    /**
+     * @struct ScriptCommand
+     * @brief Разобранная команда сценария; argument ссылается на строку сценария.
+     */
+    struct ScriptCommand
+    {
+        ScriptCommandType type = ScriptCommandType::FIND;
+        int id = 0;                ///< ID для FIND, REMOVE, GROUP и WORK
+        std::string_view argument; ///< Строка студента для ADD, группа для GROUP и AVG, поля УИР для WORK
+    };
+
+    /**
+     * @brief Разбирает поля УИР команды WORK.
+     * @param text Поля через запятую: оценка руководителя, оценка комиссии, тема, место.
+     * @return УИР.
+     * @throw std::invalid_argument если полей не четыре или оценка не число.
+     */
+    ResearchWork parseResearchWork(std::string_view text);
+
+    /**
+     * @brief Разбирает строку сценария.
+     * @param line Строка без перевода строки, не пустая и не комментарий.
+     * @return Команда.
+     * @throw std::invalid_argument если команда неизвестна или аргументы некорректны.
+     */
+    ScriptCommand parseScriptCommand(std::string_view line);
+
+    /**
+     * @struct ScriptOptions
+     * @brief Настройки выполнения сценария.
+     */
+    struct ScriptOptions
+    {
+        size_t chunkSize = size_t{1} << 20; ///< Размер читаемого блока, байт
+        size_t maxBatch = 4096;             ///< Наибольшее число изменений в одном пакете Controller::applyBatch
+    };
+
+    /**
+     * @struct ScriptReport
+     * @brief Итоги выполнения сценария.
+     */
+    struct ScriptReport
+    {
+        size_t commands = 0; ///< Выполнено команд (без пустых строк и комментариев)
+        size_t errors = 0;   ///< Ответов ERROR
+        double seconds = 0.0;
+
+        /**
+         * @brief Вычисляет скорость выполнения.
+         * @return Команд в секунду.
+         */
+        [[nodiscard]] double commandsPerSecond() const
+        {
+            return seconds > 0.0 ? static_cast<double>(commands) / seconds : 0.0;
+        }
+    };
+
+    /**
+     * @class CommandSession
+     * @brief Выполняет команды сценария по строке и накапливает ответы в буфере.
+     *
+     * Подряд идущие ADD, REMOVE, GROUP и WORK накапливаются и применяются одним пакетом
+     * Controller::applyBatch (при ошибке в пакете — по одной команде, чтобы она не
+     * отменяла соседние); FIND, AVG и ошибка разбора сначала применяют накопленное,
+     * поэтому ответы идут в порядке команд. Ответ — строка с полями через
+     * табуляцию: OK [...], NOT_FOUND или ERROR <номер строки>: <причина>;
+     * отклонённое изменение отвечает ERROR с причиной "not senior" (WORK не
+     * старшекурснику) или "invalid".
+     * Экземпляр не потокобезопасен.
+     */
+    class CommandSession
+    {
+    public:
+        /**
+         * @brief Конструирует сеанс.
+         * @param controller Контроллер реестра.
+         * @param options Настройки (используется maxBatch).
+         */
+        explicit CommandSession(Controller &controller, const ScriptOptions &options = {})
+            : controller_(controller), maxBatch_(options.maxBatch) {}
+
+        /**
+         * @brief Выполняет команду или откладывает её до применения пакета.
+         * @param line Непустая строка команды без перевода строки.
+         * @param lineNumber Номер строки для ответа ERROR.
+         * @throw std::runtime_error при ошибке журнала изменений.
+         */
+        void execute(std::string_view line, size_t lineNumber);
+
+        /**
+         * @brief Выполняет строки текста; пустые строки и строки, начинающиеся с '#', пропускаются.
+         * @param text Строки через '\n'; последняя может не заканчиваться переводом строки.
+         * @param firstLineNumber Номер первой строки.
+         * @return Номер строки, следующей за последней.
+         * @throw std::runtime_error при ошибке журнала изменений.
+         */
+        size_t executeLines(std::string_view text, size_t firstLineNumber);
+
+        /**
+         * @brief Применяет накопленные изменения и дописывает их ответы в буфер.
+         * @throw std::runtime_error при ошибке журнала изменений.
+         */
+        void flush();
+
+        /**
+         * @brief Получает буфер ответов; вызывающий забирает и очищает его.
+         */
+        std::string &output() { return output_; }
+
+        [[nodiscard]] size_t commands() const { return commands_; }
+        [[nodiscard]] size_t errors() const { return errors_; }
+
+    private:
+        void queue(MutationCommand command, size_t lineNumber);
+        void writeResults(const std::vector<MutationResult> &results, size_t first);
+        void find(int id);
+        void average(std::string_view group);
+        void writeError(size_t lineNumber, const char *message);
+
+        template <typename T>
+        void appendNumber(T value);
+
+        Controller &controller_;
+        size_t maxBatch_;
+        std::vector<MutationCommand> pending_;
+        std::vector<size_t> pendingLines_; // Номера строк накопленных изменений
+        std::string output_;
+        size_t commands_ = 0;
+        size_t errors_ = 0;
+    };
+
+    /**
+     * @brief Выполняет сценарий команд без диалога с пользователем.
+     *
+     * Вход читается блоками по chunkSize и разбирается целиком командами
+     * CommandSession; ответы записываются в out по одному разу на блок.
+     * Пустые строки и строки, начинающиеся с '#', пропускаются.
+     *
+     * @param controller Контроллер реестра.
+     * @param in Сценарий.
+     * @param out Поток ответов.
+     * @param options Настройки.
+     * @return Отчёт о выполнении.
+     */
+    ScriptReport runCommandScript(Controller &controller, std::istream &in, std::ostream &out, const ScriptOptions &options = {});
+
+} // namespace university
@@ -3,10 +3,30 @@
 #include "View.h"
 #include "HashTable.h"
 #include "Student.h"
+#include "StudentTable.h"
+#include "StudentSnapshot.h"
+#include "StudentCursor.h"
+#include "GroupingAggregation.h"
+#include "ParallelScan.h"
+#include "StudentQuery.h"
+#include "TopK.h"
+#include "MutationBatch.h"
+#include "QueryCache.h"
+#include "WriteAheadLog.h"
+#include "StudentCsv.h"
+#include "RegistryExport.h"
+#include "Trace.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <map>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
 
 namespace university
 {
@@ -17,6 +37,12 @@ namespace university
      *
      * Класс Controller координирует поток приложения,
      * обрабатывая пользовательский ввод из View и манипулируя данными в Model.
+     *
+     * Таблица разделяется со снимками (копирование при записи): пока жив хотя
+     * бы один снимок, первое изменение копирует таблицу — O(n) копий указателей
+     * на записи и память под вторую таблицу (счётчик university_table_copies_total).
+     * Поэтому снимки держат только на время обхода, а кэшированная аналитика
+     * при попадании в кэш сверяет версию таблицы без снимка.
      */
     class Controller
     {
@@ -33,15 +59,279 @@ namespace university
 
         /**
          * @brief Получает ссылку на таблицу студентов (для бенчмарка).
+         *
+         * Изменения через ссылку выполняются без блокировки, поэтому метод
+         * предназначен только для однопоточного заполнения таблицы. Ранее
+         * взятые снимки при этом не меняются.
+         *
          * @return Ссылка на таблицу студентов.
          */
-        HashTable<int, std::unique_ptr<Student>>& getStudentTable();
+        StudentTable& getStudentTable();
+
+        /**
+         * @brief Берёт согласованный снимок таблицы студентов.
+         *
+         * Снимок берётся за O(1) под разделяемой блокировкой; дальнейшее чтение
+         * снимка выполняется без блокировок и не задерживает писателей.
+         *
+         * @return Снимок текущей версии таблицы.
+         */
+        [[nodiscard]] StudentSnapshot takeSnapshot() const;
+
+        /**
+         * @brief Открывает курсор постраничного обхода студентов.
+         *
+         * Курсор работает по снимку, взятому при открытии: между страницами
+         * блокировки не удерживаются, и изменения реестра в курсоре не видны.
+         *
+         * @return Курсор, указывающий на первую страницу.
+         */
+        [[nodiscard]] StudentCursor openStudentCursor() const;
+
+        /**
+         * @brief Задаёт количество студентов на странице при просмотре реестра.
+         * @param pageSize Размер страницы (0 — все студенты на одной странице).
+         */
+        void setPageSize(size_t pageSize);
+
+        /**
+         * @brief Получает текущую версию таблицы.
+         *
+         * Версия монотонно увеличивается при каждом изменении реестра.
+         *
+         * @return Номер версии.
+         */
+        [[nodiscard]] uint64_t getTableVersion() const;
+
+        /**
+         * @brief Получает запись студента по ID (операция чтения).
+         *
+         * Запись неизменяема и остаётся действительной после изменения или удаления студента.
+         *
+         * @param id ID студента.
+         * @return Запись студента или nullptr, если студент не найден.
+         */
+        [[nodiscard]] std::shared_ptr<const Student> getStudent(int id) const;
 
         /**
-         * @brief Очищает таблицу студентов (для бенчмарка).
+         * @brief Очищает таблицу студентов и отключает хранилище (для бенчмарка).
          */
         void clearStudentTable();
 
+        /**
+         * @brief Сохраняет реестр в двоичный файл снимка.
+         *
+         * Запись выполняется по снимку таблицы без удержания блокировки, поэтому
+         * изменения во время сохранения не блокируются и в файл не попадают.
+         *
+         * @param path Путь к файлу.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         */
+        void save(const std::filesystem::path &path) const;
+
+        /**
+         * @brief Заменяет содержимое реестра данными из файла снимка.
+         *
+         * Файл разбирается без блокировки; таблица подменяется целиком под
+         * блокировкой на запись. При ошибке реестр не изменяется. Открытое
+         * хранилище (openStorage) отключается.
+         *
+         * @param path Путь к файлу, созданному save().
+         * @throw std::runtime_error если файл недоступен или повреждён.
+         */
+        void load(const std::filesystem::path &path);
+
+        /**
+         * @brief Сохраняет реестр в файл, пригодный для отображения в память (см. openReadOnly).
+         * @param path Путь к файлу.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        void saveMapped(const std::filesystem::path &path) const;
+
+        /**
+         * @brief Переводит контроллер в режим только для чтения над отображённым файлом реестра.
+         *
+         * Файл отображается в память за время, не зависящее от его размера; объекты
+         * студентов не создаются. Поиск по ID, просмотр оценок и средние по группам
+         * отвечаются прямо из файла; куб, рейтинги и отбор по предикатам работают
+         * только с реестром в памяти. Изменения реестра запрещены до вызова load()
+         * или clearStudentTable(). Открытое хранилище (openStorage) отключается.
+         *
+         * @param path Путь к файлу, созданному saveMapped().
+         * @throw std::runtime_error если файл недоступен или повреждён.
+         */
+        void openReadOnly(const std::filesystem::path &path);
+
+        /**
+         * @brief Открывает долговременное хранилище реестра в каталоге и восстанавливает его состояние.
+         *
+         * Загружается последняя контрольная точка (registry.snapshot), поверх неё
+         * применяется журнал изменений (registry.wal), после чего все операции
+         * записи добавляются в журнал. Содержимое реестра в памяти заменяется.
+         * Вызывается до начала работы с реестром из нескольких потоков.
+         *
+         * Запись журнала добавляется под блокировкой на запись, а ожидание
+         * fdatasync выполняется после её снятия. Поэтому даже в режиме
+         * EVERY_OPERATION изменение видно читателям до того, как вызвавшая его
+         * операция вернётся и запись окажется на диске; при сбое в этот момент
+         * изменение, которое уже прочитал другой поток, может быть потеряно.
+         *
+         * @param directory Каталог хранилища (создаётся при необходимости).
+         * @param options Режим сохранности журнала.
+         * @throw std::runtime_error если файлы хранилища недоступны или повреждены.
+         */
+        void openStorage(const std::filesystem::path &directory, storage::WalOptions options = {});
+
+        /**
+         * @brief Записывает контрольную точку и отбрасывает покрытую ею часть журнала.
+         *
+         * Снимок записывается без удержания блокировки во временный файл, сбрасывается
+         * на диск и атомарно заменяет предыдущую контрольную точку. Записи журнала,
+         * добавленные во время записи снимка, сохраняются.
+         * Изменения реестра во время контрольной точки не останавливаются; при
+         * замене файла журнала они кратко ждут (см. WriteAheadLog::discardBefore).
+         *
+         * @throw std::logic_error если хранилище не открыто.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         */
+        void checkpoint();
+
+        /**
+         * @brief Получает счётчики журнала изменений.
+         * @return Счётчики или нули, если хранилище не открыто.
+         */
+        [[nodiscard]] storage::WalStats getWalStats() const;
+
+        /**
+         * @brief Проверяет, открыт ли реестр только для чтения.
+         * @return True в режиме openReadOnly.
+         */
+        [[nodiscard]] bool isReadOnly() const;
+
+        /**
+         * @brief Добавляет студента в реестр (операция записи).
+         * @param student Новый студент.
+         * @return Присвоенный студенту ID.
+         * @throw std::invalid_argument если student пустой.
+         * @throw std::logic_error если реестр открыт только для чтения (относится ко всем операциям записи).
+         */
+        int insertStudent(std::unique_ptr<Student> student);
+
+        /**
+         * @brief Добавляет пакет студентов под одной блокировкой на запись.
+         *
+         * Таблица заранее резервируется под весь пакет; студенты получают
+         * последовательные ID в порядке вектора. В журнал пакет пишется одной
+         * записью и после сбоя восстанавливается целиком или не восстанавливается.
+         *
+         * @param students Новые студенты.
+         * @return ID первого студента пакета.
+         * @throw std::invalid_argument если один из студентов пустой (реестр не изменяется).
+         */
+        int insertStudents(std::vector<std::unique_ptr<Student>> students);
+
+        /**
+         * @brief Импортирует студентов из CSV/TSV файла (формат — storage::CSV_COLUMNS).
+         *
+         * Файл разбирается параллельно блоками; каждый блок добавляется пакетом
+         * через insertStudents, поэтому блокировка снимается между блоками.
+         *
+         * @param path Путь к файлу.
+         * @param options Настройки импорта.
+         * @return Отчёт: количество строк, скорость и некорректные строки.
+         * @throw std::runtime_error если файл недоступен.
+         */
+        storage::CsvImportReport importCsv(const std::filesystem::path &path, const storage::CsvImportOptions &options = {});
+
+        /**
+         * @brief Выгружает всех студентов в CSV или JSON (см. storage::exportStudents).
+         *
+         * Выгрузка идёт по снимку таблицы без удержания блокировки: изменения во
+         * время выгрузки не блокируются и в файл не попадают.
+         *
+         * @param path Путь к файлу.
+         * @param options Формат, разделитель и число потоков.
+         * @return Отчёт: количество записей, байт и время.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        storage::ExportReport exportStudents(const std::filesystem::path &path, const storage::ExportOptions &options = {}) const;
+
+        /**
+         * @brief Выгружает средние оценки по группам в CSV или JSON.
+         *
+         * Средние берутся из кэша результатов (getAverageGradesByGroupCached).
+         *
+         * @param path Путь к файлу.
+         * @param options Формат и разделитель.
+         * @return Отчёт о выгрузке.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         */
+        storage::ExportReport exportAverageGradesByGroup(const std::filesystem::path &path, const storage::ExportOptions &options = {});
+
+        /**
+         * @brief Удаляет студента из реестра (операция записи).
+         * @param id ID студента.
+         * @return True, если студент был удалён, false, если не найден.
+         */
+        bool eraseStudent(int id);
+
+        /**
+         * @brief Изменяет группу студента (операция записи).
+         * @param id ID студента.
+         * @param groupIndex Новый индекс группы.
+         * @return True, если группа изменена, false, если студент не найден.
+         */
+        bool setStudentGroup(int id, const std::string &groupIndex);
+
+        /**
+         * @brief Изменяет исследовательскую работу старшекурсника (операция записи).
+         * @param id ID студента.
+         * @param work Новые данные УИР.
+         * @return True, если работа изменена, false, если студент не найден или не старшекурсник.
+         */
+        bool setStudentResearchWork(int id, const ResearchWork &work);
+
+        /**
+         * @brief Заменяет запись студента, сохраняя его ID (операция записи, например перевод в другую категорию).
+         * @param id ID студента.
+         * @param student Новая запись студента.
+         * @return True, если запись заменена, false, если студент не найден.
+         * @throw std::invalid_argument если student пустой.
+         */
+        bool replaceStudent(int id, std::unique_ptr<Student> student);
+
+        /**
+         * @brief Применяет пакет изменений под одним захватом блокировки на запись.
+         *
+         * Команды проверяются последовательно с учётом предыдущих команд пакета
+         * (например, удалённого ранее в пакете студента нельзя перевести в другую
+         * группу); добавляемые студенты получают последовательные ID. Если хотя бы
+         * одна команда некорректна, реестр не изменяется. Таблица заранее
+         * резервируется под все добавления, а читатели видят либо состояние до
+         * пакета, либо после него целиком. В журнал пакет пишется одной записью
+         * (WalOperation::BATCH), поэтому восстановление после сбоя тоже не
+         * применяет его частично.
+         *
+         * @param commands Команды в порядке применения.
+         * @return Признак применения и результаты команд.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        MutationBatchResult applyBatch(const std::vector<MutationCommand> &commands);
+
+        /**
+         * @brief Передаёт студента с заданным ID в функцию под разделяемой блокировкой (операция чтения).
+         *
+         * Точечные поиски не ждут друг друга и длинные аналитические запросы.
+         *
+         * @param id ID студента.
+         * @param fn Функция, вызываемая как fn(const Student &student).
+         * @return True, если студент найден.
+         */
+        template <typename Fn>
+        bool visitStudent(int id, Fn &&fn) const;
+
         /**
          * @brief Вычисляет средние оценки для каждой группы (однопоточная версия).
          * @return Карта индекса группы к средней оценке.
@@ -50,9 +340,123 @@ namespace university
 
         /**
          * @brief Вычисляет средние оценки для каждой группы (многопоточная версия).
+         *
+         * Слоты таблицы делятся между потоками поровну; каждый поток накапливает
+         * сводки своих групп локально, после чего сводки сливаются. Для маленьких
+         * таблиц число потоков уменьшается (см. effectiveWorkerCount).
+         *
+         * @param threads Количество потоков (0 — по числу ядер).
+         * @param profile Если не nullptr, заполняется временем вычисления и загрузкой каждого потока.
+         * @return Карта индекса группы к средней оценке.
+         */
+        std::map<std::string, double> calculateAverageGradesByGroupMultithreaded(unsigned threads = 0, ParallelProfile *profile = nullptr);
+
+        /**
+         * @brief Вычисляет агрегаты оценок сразу для нескольких наборов группировки (куб).
+         *
+         * Таблица обходится один раз параллельно: каждый поток накапливает самый
+         * детальный срез (кафедра, категория, группа) с локальными целочисленными
+         * кодами, после чего все запрошенные срезы сворачиваются из него.
+         *
+         * @param groupingSets Наборы группировки, например {GROUP, DEPARTMENT | CATEGORY, NONE}.
+         * @return Куб со словарями измерений и запрошенными срезами.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        GroupingCube calculateAverageGradesCube(const std::vector<GroupingDimension> &groupingSets);
+
+        /**
+         * @brief Находит K студентов с наибольшей средней оценкой по всему реестру.
+         *
+         * Каждый поток ведёт свою ограниченную кучу, затем кучи сливаются.
+         * Средняя оценка считается так же, как в calculateAverageGradesByGroup;
+         * студенты без оценок в рейтинг не попадают.
+         *
+         * @param k Размер рейтинга.
+         * @return Не более k студентов, от лучшего к худшему (при равенстве — по возрастанию ID).
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        std::vector<RankedStudent> calculateTopStudentsByAverage(size_t k);
+
+        /**
+         * @brief Находит K студентов с наибольшей средней оценкой в каждой группе.
+         *
+         * Память — O(K × количество групп) на поток, без копирования всех записей.
+         *
+         * @param k Размер рейтинга в каждой группе.
+         * @return Карта индекса группы к рейтингу группы.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        std::map<std::string, std::vector<RankedStudent>> calculateTopStudentsByAverageByGroup(size_t k);
+
+        /**
+         * @brief Получает средние оценки по группам из кэша результатов.
+         *
+         * Результат вычисляется заново только после изменения реестра; повторные
+         * запросы к той же версии таблицы отвечаются из памяти.
+         *
          * @return Карта индекса группы к средней оценке.
          */
-        std::map<std::string, double> calculateAverageGradesByGroupMultithreaded();
+        std::shared_ptr<const std::map<std::string, double>> getAverageGradesByGroupCached();
+
+        /**
+         * @brief Получает куб агрегатов из кэша результатов.
+         * @param groupingSets Наборы группировки (входят в ключ кэша).
+         * @return Куб со словарями измерений и запрошенными срезами.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        std::shared_ptr<const GroupingCube> getAverageGradesCubeCached(const std::vector<GroupingDimension> &groupingSets);
+
+        /**
+         * @brief Получает глобальный рейтинг K лучших студентов из кэша результатов.
+         * @param k Размер рейтинга (входит в ключ кэша).
+         * @return Не более k студентов, от лучшего к худшему.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        std::shared_ptr<const std::vector<RankedStudent>> getTopStudentsByAverageCached(size_t k);
+
+        /**
+         * @brief Получает рейтинги K лучших студентов по группам из кэша результатов.
+         * @param k Размер рейтинга в группе (входит в ключ кэша).
+         * @return Карта индекса группы к рейтингу группы.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        std::shared_ptr<const std::map<std::string, std::vector<RankedStudent>>> getTopStudentsByAverageByGroupCached(size_t k);
+
+        /**
+         * @brief Получает счётчики попаданий и промахов кэша результатов.
+         * @return Счётчики кэша.
+         */
+        [[nodiscard]] QueryCacheStats getQueryCacheStats() const;
+
+        /**
+         * @brief Находит ID студентов, удовлетворяющих предикату.
+         *
+         * Таблица обходится параллельно. Предикат собирается из типизированных
+         * условий пространства имён query, поэтому во внутреннем цикле нет
+         * виртуальной диспетчеризации, а дешёвые условия (категория, кафедра)
+         * проверяются раньше обращения к оценкам и данным УИР/ДП.
+         * Предикат вызывается одновременно из нескольких потоков.
+         *
+         * @param predicate Предикат, например query::CategoryIs{StudentCategory::SENIOR} && query::DepartmentIs{105}.
+         * @return ID подходящих студентов в порядке возрастания.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        template <query::Predicate P>
+        std::vector<int> findStudentIds(const P &predicate);
+
+        /**
+         * @brief Передаёт студентов, удовлетворяющих предикату, в функцию обратного вызова.
+         *
+         * Отбор выполняется параллельно по снимку таблицы, затем строки передаются
+         * последовательно в порядке возрастания ID без удержания блокировок.
+         *
+         * @param predicate Предикат отбора.
+         * @param fn Функция, вызываемая как fn(int id, const Student &student).
+         * @return Количество переданных студентов.
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        template <query::Predicate P, typename Fn>
+        size_t forEachMatchingStudent(const P &predicate, Fn &&fn);
 
     private:
         /**
@@ -105,10 +509,251 @@ namespace university
          */
         void showAverageGradesByGroupWithChoice();
 
+        /**
+         * @brief Вычисляет средние оценки по группам для таблицы снимка.
+         * @param table Неизменяемая таблица снимка.
+         * @return Карта индекса группы к средней оценке.
+         */
+        static std::map<std::string, double> averageGradesByGroup(const StudentTable &table);
+
+        /**
+         * @brief Вычисляет средние оценки по группам прямо по записям отображённого файла.
+         * @param registry Отображённый реестр.
+         * @param requestedWorkers Количество потоков (0 — по умолчанию).
+         * @param profile Профиль загрузки потоков или nullptr.
+         * @return Карта индекса группы к средней оценке.
+         */
+        static std::map<std::string, double> averageGradesByGroup(const storage::MappedRegistry &registry, unsigned requestedWorkers,
+                                                                  ParallelProfile *profile = nullptr);
+
+        /**
+         * @brief Вычисляет куб агрегатов для таблицы снимка.
+         * @param table Неизменяемая таблица снимка.
+         * @param groupingSets Наборы группировки.
+         * @return Куб агрегатов.
+         */
+        static GroupingCube averageGradesCube(const StudentTable &table, const std::vector<GroupingDimension> &groupingSets);
+
+        /**
+         * @brief Вычисляет глобальный рейтинг для таблицы снимка.
+         * @param table Неизменяемая таблица снимка.
+         * @param k Размер рейтинга.
+         * @return Рейтинг от лучшего к худшему.
+         */
+        static std::vector<RankedStudent> topStudentsByAverage(const StudentTable &table, size_t k);
+
+        /**
+         * @brief Вычисляет рейтинги по группам для таблицы снимка.
+         * @param table Неизменяемая таблица снимка.
+         * @param k Размер рейтинга в группе.
+         * @return Карта индекса группы к рейтингу.
+         */
+        static std::map<std::string, std::vector<RankedStudent>> topStudentsByAverageByGroup(const StudentTable &table, size_t k);
+
+        /**
+         * @brief Параллельно отбирает студентов снимка по предикату.
+         * @param snapshot Снимок таблицы; указатели действительны, пока он существует.
+         * @param predicate Предикат отбора.
+         * @return Пары (ID, студент), упорядоченные по ID.
+         */
+        template <query::Predicate P>
+        static std::vector<std::pair<int, const Student *>> collectMatches(const StudentSnapshot &snapshot, const P &predicate);
+
+        /**
+         * @brief Получает таблицу снимка для запросов, которые над отображаемым файлом не реализованы.
+         * @param snapshot Снимок реестра.
+         * @return Таблица студентов снимка.
+         * @throw std::logic_error если реестр открыт только для чтения из отображаемого файла.
+         */
+        static const StudentTable &inMemoryTable(const StudentSnapshot &snapshot);
+
+        /**
+         * @brief Подготавливает таблицу к изменению (вызывается под блокировкой на запись).
+         *
+         * Если текущую таблицу удерживает снимок, она копируется, и изменяется копия.
+         * Увеличивает версию таблицы.
+         *
+         * @return Ссылка на таблицу, которую можно изменять.
+         */
+        StudentTable &beginWrite();
+
+        /**
+         * @struct PendingCommit
+         * @brief Запись журнала, ожидающая фиксации после снятия блокировки.
+         */
+        struct PendingCommit
+        {
+            std::shared_ptr<storage::WriteAheadLog> wal;
+            uint64_t lsn = 0;
+        };
+
+        /**
+         * @brief Добавляет запись об изменении в журнал (вызывается под блокировкой на запись до изменения таблицы).
+         *
+         * Проверки, копирование записи, beginWrite и резервирование таблицы выполняются
+         * до вызова, а после него остаётся только изменение, не выбрасывающее исключений:
+         * в журнале не должно оказаться изменение, не применённое к таблице.
+         *
+         * @param entry Запись журнала.
+         * @return Данные для commitMutation; пустые, если хранилище не открыто.
+         */
+        PendingCommit logMutation(const storage::WalEntry &entry);
+
+        /**
+         * @brief Дожидается сохранности записи журнала согласно режиму (вызывается без блокировки).
+         *
+         * Ожидание вне блокировки позволяет нескольким писателям разделить один fdatasync.
+         *
+         * @param pending Результат logMutation.
+         */
+        static void commitMutation(const PendingCommit &pending);
+
+        /**
+         * @brief Отключает журнал: последующие изменения в хранилище не попадают (вызывается под блокировкой).
+         */
+        void detachStorage();
+
+        /**
+         * @brief Учитывает поиск студента по ID в метриках (попадание или промах).
+         * @param found Найден ли студент.
+         */
+        static void recordFind(bool found);
+
+        /**
+         * @brief Получает гистограмму длительности поиска по ID (операция "find"), общую с getStudent.
+         * @return Гистограмма из реестра метрик процесса.
+         */
+        static metrics::Histogram &findLatency();
+
+        /**
+         * @brief Захватывает мьютекс таблицы для изменения.
+         *
+         * Если мьютекс занят, ожидание записывается в трассировку как участок "wait_exclusive".
+         *
+         * @return Захваченная блокировка.
+         */
+        std::unique_lock<std::shared_mutex> lockExclusive() const;
+
+        /**
+         * @brief Возвращает результат запроса из кэша или вычисляет его по снимку таблицы.
+         *
+         * Попадание проверяется по версии таблицы под разделяемой блокировкой без
+         * снимка, поэтому не заставляет одновременное изменение копировать таблицу.
+         *
+         * @tparam Result Тип результата.
+         * @param key Ключ запроса в кэше.
+         * @param compute Функция compute(const StudentSnapshot &), возвращающая Result.
+         */
+        template <typename Result, typename Compute>
+        std::shared_ptr<const Result> cachedQuery(const std::string &key, Compute compute);
+
+        /**
+         * @brief Захватывает мьютекс таблицы для чтения; ожидание занятого мьютекса записывается как "wait_shared".
+         * @return Захваченная блокировка.
+         */
+        std::shared_lock<std::shared_mutex> lockShared() const;
+
+        /**
+         * @brief Запрещает изменение реестра в режиме только для чтения (вызывается под блокировкой).
+         * @throw std::logic_error если реестр открыт только для чтения.
+         */
+        void requireWritable() const;
+
         View view_;
-        HashTable<int, std::unique_ptr<Student>> studentTable_;
-        int nextId_ = 1;                // Следующий доступный ID
-        mutable std::mutex tableMutex_; // Мьютекс для синхронизации доступа к таблице
+        std::shared_ptr<StudentTable> studentTable_; // Текущая версия таблицы, разделяемая со снимками
+        uint64_t version_ = 0;                       // Версия таблицы, растёт при каждом изменении
+        std::shared_ptr<const storage::MappedRegistry> mappedRegistry_; // Файл реестра в режиме только для чтения
+        QueryCache queryCache_;                      // Результаты запросов, помеченные версией таблицы
+        std::shared_ptr<storage::WriteAheadLog> wal_;  // Журнал изменений, если открыто хранилище
+        std::filesystem::path storageDirectory_;       // Каталог контрольной точки и журнала
+        int nextId_ = 1;                             // Следующий доступный ID
+        size_t pageSize_ = 20;                       // Студентов на странице при просмотре реестра
+        // Операции чтения захватывают мьютекс в разделяемом режиме и не блокируют друг друга,
+        // операции изменения — в исключительном
+        mutable std::shared_mutex tableMutex_;
     };
 
+    template <typename Fn>
+    bool Controller::visitStudent(int id, Fn &&fn) const
+    {
+        // То же, что OperationScope(Operation::FIND) в getStudent: длительность и участок трассировки
+        metrics::ScopedTimer timer(findLatency());
+        UNIVERSITY_TRACE_SCOPE("controller", "find");
+        auto lock = lockShared();
+        const Student *student = nullptr;
+        std::unique_ptr<Student> materialized;
+        if (mappedRegistry_)
+        {
+            if (const auto *record = mappedRegistry_->find(id))
+            {
+                materialized = mappedRegistry_->materialize(*record);
+                student = materialized.get();
+            }
+        }
+        else if (auto stored = studentTable_->find(id))
+        {
+            student = stored->get().get();
+        }
+        recordFind(student != nullptr);
+        if (!student)
+        {
+            return false;
+        }
+        fn(*student);
+        return true;
+    }
+
+    template <query::Predicate P>
+    std::vector<std::pair<int, const Student *>> Controller::collectMatches(const StudentSnapshot &snapshot, const P &predicate)
+    {
+        const auto &table = inMemoryTable(snapshot);
+        unsigned numWorkers = effectiveWorkerCount(table.bucketCount(), 0);
+        std::vector<std::vector<std::pair<int, const Student *>>> partial(numWorkers);
+
+        parallelForSlots(table, numWorkers, [&](unsigned worker, size_t first, size_t last)
+                         {
+            auto &local = partial[worker];
+            table.forEachInRange(first, last, [&](int id, const std::shared_ptr<const Student> &student)
+                                         {
+                if (predicate(*student))
+                {
+                    local.emplace_back(id, student.get());
+                } }); });
+
+        std::vector<std::pair<int, const Student *>> matches;
+        for (auto &local : partial)
+        {
+            matches.insert(matches.end(), local.begin(), local.end());
+        }
+        std::sort(matches.begin(), matches.end(), [](const auto &lhs, const auto &rhs)
+                  { return lhs.first < rhs.first; });
+        return matches;
+    }
+
+    template <query::Predicate P>
+    std::vector<int> Controller::findStudentIds(const P &predicate)
+    {
+        auto snapshot = takeSnapshot();
+        auto matches = collectMatches(snapshot, predicate);
+        std::vector<int> ids;
+        ids.reserve(matches.size());
+        for (const auto &match : matches)
+        {
+            ids.push_back(match.first);
+        }
+        return ids;
+    }
+
+    template <query::Predicate P, typename Fn>
+    size_t Controller::forEachMatchingStudent(const P &predicate, Fn &&fn)
+    {
+        auto snapshot = takeSnapshot();
+        auto matches = collectMatches(snapshot, predicate);
+        for (const auto &[id, student] : matches)
+        {
+            fn(id, *student);
+        }
+        return matches.size();
+    }
+
 } // namespace university
\ No newline at end of file
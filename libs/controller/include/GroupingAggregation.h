@@ -0,0 +1,234 @@
+#pragma once
+
+#include "Student.h"
+#include "StudentGrades.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @enum GroupingDimension
+     * @brief Измерения, по которым может группироваться агрегация оценок.
+     *
+     * Значения являются битовыми флагами: набор группировки задаётся их
+     * объединением, например GroupingDimension::DEPARTMENT | GroupingDimension::CATEGORY.
+     * Пустой набор (NONE) соответствует итогу по всему реестру.
+     */
+    enum class GroupingDimension : unsigned
+    {
+        NONE = 0,
+        DEPARTMENT = 1u << 0,
+        CATEGORY = 1u << 1,
+        GROUP = 1u << 2
+    };
+
+    constexpr GroupingDimension operator|(GroupingDimension lhs, GroupingDimension rhs)
+    {
+        return static_cast<GroupingDimension>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+    }
+
+    /**
+     * @brief Проверяет, входит ли измерение в набор группировки.
+     * @param set Набор группировки.
+     * @param dimension Проверяемое измерение.
+     * @return True, если измерение входит в набор.
+     */
+    constexpr bool hasDimension(GroupingDimension set, GroupingDimension dimension)
+    {
+        return (static_cast<unsigned>(set) & static_cast<unsigned>(dimension)) != 0;
+    }
+
+    /**
+     * @brief Возвращает все 8 наборов группировки (полный куб).
+     * @return Наборы от NONE до DEPARTMENT | CATEGORY | GROUP.
+     */
+    std::vector<GroupingDimension> allGroupingSets();
+
+    /**
+     * @struct GroupingKey
+     * @brief Декодированный ключ ячейки куба.
+     *
+     * Заполнены только поля измерений, входящих в набор группировки.
+     */
+    struct GroupingKey
+    {
+        int departmentNumber = 0;
+        StudentCategory category = StudentCategory::JUNIOR;
+        std::string groupIndex;
+    };
+
+    /**
+     * @struct GroupAggregate
+     * @brief Агрегат одной ячейки: количество студентов и сводка их оценок.
+     */
+    struct GroupAggregate
+    {
+        size_t students = 0;
+        GradeSummary grades;
+
+        /**
+         * @brief Добавляет к агрегату другой агрегат.
+         * @param other Агрегат для объединения.
+         */
+        void merge(const GroupAggregate &other)
+        {
+            students += other.students;
+            grades.merge(other.grades);
+        }
+    };
+
+    /**
+     * @struct GroupingSetResult
+     * @brief Результат одного набора группировки (одного среза куба).
+     *
+     * Ячейки адресуются составным целочисленным кодом:
+     * code = (department * CATEGORY_COUNT + category) * groupCount + group,
+     * где измерения, не входящие в набор, имеют размер 1 и код 0. Срез не
+     * более чем по одному измерению хранится плотным массивом cells,
+     * индексируемым кодом. Число комбинаций нескольких измерений растёт как
+     * произведение их размеров, а заполнена обычно малая часть, поэтому такие
+     * срезы хранят только непустые ячейки в sparseCells по возрастанию кода.
+     */
+    struct GroupingSetResult
+    {
+        GroupingDimension dimensions = GroupingDimension::NONE;
+        std::vector<GroupAggregate> cells;                          // Плотный срез: ячейка с индексом code
+        std::vector<std::pair<size_t, GroupAggregate>> sparseCells; // Разреженный срез: (code, ячейка) по возрастанию code
+
+        /**
+         * @brief Проверяет, хранится ли срез плотным массивом.
+         * @param dimensions Набор группировки.
+         * @return True, если в набор входит не больше одного измерения.
+         */
+        static constexpr bool isDense(GroupingDimension dimensions)
+        {
+            auto mask = static_cast<unsigned>(dimensions);
+            return (mask & (mask - 1)) == 0;
+        }
+
+        /**
+         * @brief Находит ячейку по коду.
+         * @param code Составной код ячейки.
+         * @return Ячейка или nullptr, если она пуста.
+         */
+        [[nodiscard]] const GroupAggregate *find(size_t code) const;
+
+        /**
+         * @brief Обходит непустые ячейки в порядке возрастания кода.
+         * @param fn Функция, вызываемая как fn(size_t code, const GroupAggregate&).
+         */
+        template <typename Fn>
+        void forEachNonEmpty(Fn &&fn) const
+        {
+            for (size_t code = 0; code < cells.size(); ++code)
+            {
+                if (cells[code].students != 0)
+                {
+                    fn(code, cells[code]);
+                }
+            }
+            for (const auto &[code, cell] : sparseCells)
+            {
+                fn(code, cell);
+            }
+        }
+    };
+
+    /**
+     * @class GroupingCube
+     * @brief Результат многомерной группировки: словари измерений и срезы куба.
+     */
+    class GroupingCube
+    {
+    public:
+        /**
+         * @brief Количество категорий студентов (размер измерения CATEGORY).
+         */
+        static constexpr uint32_t CATEGORY_COUNT = 3;
+
+        /**
+         * @brief Конструирует куб по словарям измерений.
+         * @param departments Номера кафедр в порядке возрастания кодов.
+         * @param groups Индексы групп в порядке возрастания кодов.
+         */
+        GroupingCube(std::vector<int> departments, std::vector<std::string> groups);
+
+        /**
+         * @brief Вычисляет составной код ячейки для набора группировки.
+         * @param dimensions Набор группировки.
+         * @param department Код кафедры.
+         * @param category Код категории.
+         * @param group Код группы.
+         * @return Код ячейки: индекс в GroupingSetResult::cells или ключ в sparseCells.
+         */
+        [[nodiscard]] size_t encode(GroupingDimension dimensions, uint32_t department, uint32_t category, uint32_t group) const;
+
+        /**
+         * @brief Вычисляет количество возможных ячеек в срезе (диапазон кодов).
+         * @param dimensions Набор группировки.
+         * @return Произведение размеров входящих в набор измерений.
+         */
+        [[nodiscard]] size_t cellCount(GroupingDimension dimensions) const;
+
+        /**
+         * @brief Декодирует составной код ячейки в значения измерений.
+         * @param dimensions Набор группировки.
+         * @param code Индекс ячейки.
+         * @return Ключ ячейки.
+         */
+        [[nodiscard]] GroupingKey decode(GroupingDimension dimensions, size_t code) const;
+
+        /**
+         * @brief Добавляет пустой срез для набора группировки.
+         *
+         * Для плотного среза (GroupingSetResult::isDense) сразу выделяются все
+         * cellCount ячеек; разреженный срез заполняется вызывающим кодом.
+         *
+         * @param dimensions Набор группировки.
+         * @return Ссылка на созданный срез.
+         */
+        GroupingSetResult &addSet(GroupingDimension dimensions);
+
+        /**
+         * @brief Получает срез по порядковому номеру для заполнения.
+         * @param index Номер среза в порядке добавления.
+         * @return Ссылка на срез.
+         */
+        GroupingSetResult &setAt(size_t index) { return sets_.at(index); }
+
+        /**
+         * @brief Находит срез по набору группировки.
+         * @param dimensions Набор группировки.
+         * @return Срез куба.
+         * @throw std::out_of_range если набор не запрашивался.
+         */
+        [[nodiscard]] const GroupingSetResult &rollup(GroupingDimension dimensions) const;
+
+        /**
+         * @brief Обходит непустые ячейки среза.
+         * @param dimensions Набор группировки.
+         * @param fn Функция, вызываемая как fn(const GroupingKey&, const GroupAggregate&).
+         */
+        template <typename Fn>
+        void forEachCell(GroupingDimension dimensions, Fn &&fn) const
+        {
+            rollup(dimensions).forEachNonEmpty([&](size_t code, const GroupAggregate &cell)
+                                               { fn(decode(dimensions, code), cell); });
+        }
+
+        [[nodiscard]] const std::vector<int> &departments() const { return departments_; }
+        [[nodiscard]] const std::vector<std::string> &groups() const { return groups_; }
+        [[nodiscard]] const std::vector<GroupingSetResult> &sets() const { return sets_; }
+
+    private:
+        std::vector<int> departments_;
+        std::vector<std::string> groups_;
+        std::vector<GroupingSetResult> sets_;
+    };
+
+} // namespace university
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Student.h"
+#include "SeniorStudent.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @brief Вид команды пакетного изменения реестра.
+     */
+    enum class MutationType
+    {
+        ADD,               ///< Добавление студента с новым ID
+        REMOVE,            ///< Удаление студента
+        SET_GROUP,         ///< Перевод в другую группу
+        SET_RESEARCH_WORK, ///< Изменение УИР старшекурсника
+        REPLACE            ///< Замена записи с сохранением ID (перевод в другую категорию)
+    };
+
+    /**
+     * @struct MutationCommand
+     * @brief Команда пакетного изменения реестра; создаётся фабричными функциями.
+     */
+    struct MutationCommand
+    {
+        MutationType type = MutationType::ADD;
+        int id = 0;                             ///< ID студента; для ADD не используется
+        std::shared_ptr<const Student> student; ///< Запись для ADD и REPLACE
+        std::string groupIndex;                 ///< Группа для SET_GROUP
+        ResearchWork researchWork{};            ///< УИР для SET_RESEARCH_WORK
+
+        static MutationCommand add(std::unique_ptr<Student> student)
+        {
+            MutationCommand command;
+            command.type = MutationType::ADD;
+            command.student = std::move(student);
+            return command;
+        }
+
+        static MutationCommand remove(int id)
+        {
+            MutationCommand command;
+            command.type = MutationType::REMOVE;
+            command.id = id;
+            return command;
+        }
+
+        static MutationCommand setGroup(int id, std::string groupIndex)
+        {
+            MutationCommand command;
+            command.type = MutationType::SET_GROUP;
+            command.id = id;
+            command.groupIndex = std::move(groupIndex);
+            return command;
+        }
+
+        static MutationCommand setResearchWork(int id, ResearchWork work)
+        {
+            MutationCommand command;
+            command.type = MutationType::SET_RESEARCH_WORK;
+            command.id = id;
+            command.researchWork = std::move(work);
+            return command;
+        }
+
+        static MutationCommand replace(int id, std::unique_ptr<Student> student)
+        {
+            MutationCommand command;
+            command.type = MutationType::REPLACE;
+            command.id = id;
+            command.student = std::move(student);
+            return command;
+        }
+    };
+
+    /**
+     * @brief Результат проверки одной команды пакета.
+     */
+    enum class MutationStatus
+    {
+        APPLIED,     ///< Команда выполнена
+        NOT_APPLIED, ///< Команда корректна, но пакет отклонён из-за другой команды
+        NOT_FOUND,   ///< Студента с таким ID нет (с учётом предыдущих команд пакета)
+        NOT_SENIOR,  ///< УИР можно изменить только старшекурснику
+        INVALID      ///< Пустая запись студента
+    };
+
+    /**
+     * @struct MutationResult
+     * @brief Результат одной команды пакета.
+     */
+    struct MutationResult
+    {
+        MutationStatus status = MutationStatus::NOT_APPLIED;
+        int id = 0; ///< ID студента; для ADD — выданный ID или 0, если пакет не применён
+    };
+
+    /**
+     * @struct MutationBatchResult
+     * @brief Результат пакетного изменения: пакет применяется целиком или не применяется вовсе.
+     */
+    struct MutationBatchResult
+    {
+        bool applied = false;
+        std::vector<MutationResult> results; ///< В порядке команд пакета
+    };
+
+} // namespace university
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @brief Минимальное количество слотов таблицы на один рабочий поток.
+     *
+     * Для маленьких таблиц запуск потока обходится дороже самой работы,
+     * поэтому число потоков ограничивается объёмом данных.
+     */
+    inline constexpr size_t MIN_SLOTS_PER_WORKER = 4096;
+
+    /**
+     * @brief Получает количество рабочих потоков по умолчанию.
+     * @return Количество аппаратных потоков или 4, если его не удалось определить.
+     */
+    inline unsigned defaultWorkerCount()
+    {
+        unsigned numThreads = std::thread::hardware_concurrency();
+        return numThreads == 0 ? 4 : numThreads;
+    }
+
+    /**
+     * @brief Вычисляет количество потоков для обхода таблицы заданного размера.
+     * @param bucketCount Количество слотов таблицы.
+     * @param requested Запрошенное количество потоков (0 — по умолчанию).
+     * @return Количество потоков, не меньшее 1.
+     */
+    inline unsigned effectiveWorkerCount(size_t bucketCount, unsigned requested)
+    {
+        unsigned numThreads = requested == 0 ? defaultWorkerCount() : requested;
+        size_t bySize = std::max<size_t>(1, bucketCount / MIN_SLOTS_PER_WORKER);
+        return static_cast<unsigned>(std::min<size_t>(numThreads, bySize));
+    }
+
+    /**
+     * @struct WorkerStats
+     * @brief Загрузка одного рабочего потока параллельного обхода.
+     */
+    struct WorkerStats
+    {
+        size_t items = 0;    ///< Обработано записей
+        double busyMs = 0.0; ///< Время работы потока над своим диапазоном
+    };
+
+    /**
+     * @struct ParallelProfile
+     * @brief Профиль параллельного вычисления: общее время и загрузка каждого потока.
+     */
+    struct ParallelProfile
+    {
+        double wallMs = 0.0;              ///< Время всего вычисления, включая слияние результатов
+        std::vector<WorkerStats> workers; ///< Статистика потоков по номерам
+
+        /**
+         * @brief Вычисляет долю времени, которую потоки были заняты.
+         * @return Сумма времени работы потоков, делённая на wallMs × число потоков (1 — без простоев).
+         */
+        [[nodiscard]] double utilization() const
+        {
+            double busy = 0.0;
+            for (const auto &worker : workers)
+            {
+                busy += worker.busyMs;
+            }
+            return wallMs > 0.0 && !workers.empty() ? busy / (wallMs * static_cast<double>(workers.size())) : 0.0;
+        }
+
+        /**
+         * @brief Вычисляет дисбаланс нагрузки.
+         * @return Время самого медленного потока, делённое на среднее (1 — нагрузка равномерна).
+         */
+        [[nodiscard]] double imbalance() const
+        {
+            double busy = 0.0;
+            double slowest = 0.0;
+            for (const auto &worker : workers)
+            {
+                busy += worker.busyMs;
+                slowest = std::max(slowest, worker.busyMs);
+            }
+            return busy > 0.0 ? slowest * static_cast<double>(workers.size()) / busy : 1.0;
+        }
+    };
+
+    /**
+     * @brief Оборачивает обработчик диапазона так, чтобы записывать загрузку потоков в профиль.
+     *
+     * Обработчик вызывается как fn(worker, firstSlot, lastSlot) и возвращает
+     * количество обработанных записей; время и записи всех фрагментов потока
+     * суммируются. Если profile равен nullptr, замеры не выполняются.
+     *
+     * @param profile Профиль (workers заполняется по числу потоков) или nullptr.
+     * @param numWorkers Количество потоков.
+     * @param fn Обработчик диапазона.
+     * @return Функция для parallelForSlots.
+     */
+    template <typename Fn>
+    auto profileWorkers(ParallelProfile *profile, unsigned numWorkers, Fn &&fn)
+    {
+        if (profile != nullptr)
+        {
+            profile->workers.assign(std::max(1u, numWorkers), WorkerStats{});
+        }
+        return [profile, &fn](unsigned worker, size_t first, size_t last)
+        {
+            if (profile == nullptr)
+            {
+                fn(worker, first, last);
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            size_t items = fn(worker, first, last);
+            auto &stats = profile->workers[worker];
+            stats.items += items;
+            stats.busyMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+    }
+
+    /**
+     * @brief Количество фрагментов слотов на один рабочий поток.
+     *
+     * Занятые слоты распределены по таблице неравномерно (последовательные ID
+     * занимают её начало), поэтому слоты делятся на фрагменты мельче доли потока,
+     * а освободившийся поток берёт следующий фрагмент.
+     */
+    inline constexpr size_t CHUNKS_PER_WORKER = 8;
+
+    /**
+     * @brief Параллельно обходит слоты хеш-таблицы, разбивая их на непересекающиеся диапазоны.
+     *
+     * Функция вызывается как fn(worker, firstSlot, lastSlot) для каждого фрагмента;
+     * один поток может обработать несколько фрагментов. Каждый поток получает свой
+     * номер, поэтому может накапливать результат в локальном состоянии без мьютексов.
+     * Исключения из потоков пробрасываются вызывающему.
+     *
+     * @param table Таблица с методом bucketCount().
+     * @param numWorkers Количество потоков (результат effectiveWorkerCount).
+     * @param fn Функция обработки диапазона.
+     */
+    template <typename Table, typename Fn>
+    void parallelForSlots(const Table &table, unsigned numWorkers, Fn &&fn)
+    {
+        size_t slots = table.bucketCount();
+        numWorkers = std::max(1u, numWorkers);
+        if (numWorkers == 1)
+        {
+            UNIVERSITY_TRACE_SCOPE_ARG("parallel", "worker", "worker", 0);
+            fn(0u, size_t{0}, slots);
+            return;
+        }
+
+        size_t chunks = numWorkers * CHUNKS_PER_WORKER;
+        size_t slotsPerChunk = (slots + chunks - 1) / chunks;
+        std::atomic<size_t> nextChunk{0};
+        auto work = [&fn, &nextChunk, slots, slotsPerChunk](unsigned worker)
+        {
+            UNIVERSITY_TRACE_SCOPE_ARG("parallel", "worker", "worker", worker);
+            for (size_t first = nextChunk.fetch_add(1) * slotsPerChunk; first < slots; first = nextChunk.fetch_add(1) * slotsPerChunk)
+            {
+                fn(worker, first, std::min(slots, first + slotsPerChunk));
+            }
+        };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(numWorkers - 1);
+        for (unsigned t = 1; t < numWorkers; ++t)
+        {
+            futures.emplace_back(std::async(std::launch::async, work, t));
+        }
+        std::exception_ptr error;
+        try
+        {
+            work(0u);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        for (auto &future : futures)
+        {
+            future.get();
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+} // namespace university
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace university
+{
+
+    /**
+     * @struct QueryCacheStats
+     * @brief Счётчики кэша результатов запросов.
+     */
+    struct QueryCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+
+    /**
+     * @class QueryCache
+     * @brief Кэш результатов аналитических запросов, помеченных версией таблицы.
+     *
+     * Ключ — вид запроса и его параметры, например "top_k:10". Результат
+     * считается актуальным, только если он вычислен для той же версии таблицы,
+     * что и запрос; любое изменение реестра увеличивает версию и тем самым
+     * делает все сохранённые результаты устаревшими.
+     */
+    class QueryCache
+    {
+    public:
+        /**
+         * @brief Ищет результат, вычисленный для версии таблицы; попадание учитывается в счётчиках.
+         *
+         * Промах не учитывается: за ним обычно следует getOrCompute, который его и посчитает.
+         *
+         * @tparam Result Тип результата; должен однозначно определяться ключом.
+         * @param key Вид запроса и параметры.
+         * @param version Текущая версия таблицы.
+         * @return Результат или nullptr, если актуального результата нет.
+         */
+        template <typename Result>
+        std::shared_ptr<const Result> find(const std::string &key, uint64_t version)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it == entries_.end() || it->second.version != version)
+            {
+                return nullptr;
+            }
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return std::static_pointer_cast<const Result>(it->second.result);
+        }
+
+        /**
+         * @brief Возвращает результат из кэша или вычисляет и сохраняет его.
+         *
+         * Вычисление выполняется без удержания мьютекса кэша, поэтому два
+         * одновременных промаха по одному ключу могут вычислить результат дважды.
+         *
+         * @tparam Result Тип результата; должен однозначно определяться ключом.
+         * @param key Вид запроса и параметры.
+         * @param version Версия таблицы, по которой вычисляется результат.
+         * @param compute Функция без аргументов, возвращающая Result.
+         * @return Разделяемый неизменяемый результат.
+         */
+        template <typename Result, typename Compute>
+        std::shared_ptr<const Result> getOrCompute(const std::string &key, uint64_t version, Compute &&compute)
+        {
+            if (auto cached = find<Result>(key, version))
+            {
+                return cached;
+            }
+
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            auto result = std::make_shared<const Result>(compute());
+            store(key, version, result);
+            return result;
+        }
+
+        /**
+         * @brief Удаляет все сохранённые результаты.
+         */
+        void clear();
+
+        /**
+         * @brief Получает счётчики попаданий и промахов.
+         * @return Текущие счётчики.
+         */
+        [[nodiscard]] QueryCacheStats stats() const;
+
+    private:
+        struct Entry
+        {
+            uint64_t version = 0;
+            std::shared_ptr<const void> result;
+        };
+
+        /**
+         * @brief Сохраняет результат и удаляет результаты других версий.
+         * @param key Ключ запроса.
+         * @param version Версия таблицы результата.
+         * @param result Результат.
+         */
+        void store(const std::string &key, uint64_t version, std::shared_ptr<const void> result);
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, Entry> entries_;
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
+    };
+
+} // namespace university
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "StudentSnapshot.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @class StudentCursor
+     * @brief Постраничный обход студентов снимка таблицы.
+     *
+     * Курсор удерживает снимок и позицию — номер следующего слота таблицы или
+     * следующей записи отображённого файла. Каждая страница читается из снимка
+     * без блокировок, поэтому пока пользователь листает страницы, писатели
+     * реестра не ждут, а курсор видит согласованное состояние на момент открытия.
+     */
+    class StudentCursor
+    {
+    public:
+        /**
+         * @brief Конструирует курсор, указывающий на начало снимка.
+         * @param snapshot Снимок таблицы.
+         */
+        explicit StudentCursor(StudentSnapshot snapshot) : snapshot_(std::move(snapshot)) {}
+
+        /**
+         * @brief Получает следующую страницу студентов.
+         * @param pageSize Наибольшее количество студентов на странице (не меньше 1).
+         * @return Студенты страницы; пустой вектор, если обход завершён.
+         */
+        [[nodiscard]] std::vector<StudentRow> next(size_t pageSize)
+        {
+            pageSize = std::max<size_t>(pageSize, 1);
+            std::vector<StudentRow> page;
+            page.reserve(std::min(pageSize, total() - returned_));
+            if (const auto &mapped = snapshot_.mapped())
+            {
+                auto records = mapped->records();
+                for (; position_ < records.size() && page.size() < pageSize; ++position_)
+                {
+                    page.emplace_back(records[position_].id, mapped->materialize(records[position_]));
+                }
+            }
+            else
+            {
+                const auto &table = snapshot_.table();
+                size_t slots = table.bucketCount();
+                for (; position_ < slots && page.size() < pageSize; ++position_)
+                {
+                    table.forEachInRange(position_, position_ + 1, [&](int id, const std::shared_ptr<const Student> &student)
+                                         { page.emplace_back(id, student); });
+                }
+            }
+            returned_ += page.size();
+            return page;
+        }
+
+        /**
+         * @brief Проверяет, выданы ли все студенты снимка.
+         * @return true, если следующая страница будет пустой.
+         */
+        [[nodiscard]] bool done() const { return returned_ == total(); }
+
+        /**
+         * @brief Получает количество уже выданных студентов.
+         * @return Количество студентов на пройденных страницах.
+         */
+        [[nodiscard]] size_t returned() const { return returned_; }
+
+        /**
+         * @brief Получает общее количество студентов в снимке.
+         * @return Количество студентов.
+         */
+        [[nodiscard]] size_t total() const { return snapshot_.size(); }
+
+    private:
+        StudentSnapshot snapshot_;
+        size_t position_ = 0;
+        size_t returned_ = 0;
+    };
+
+} // namespace university
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "Student.h"
+#include "StudentGrades.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+#include <concepts>
+#include <string>
+#include <utility>
+
+namespace university
+{
+    namespace query
+    {
+
+        /**
+         * @brief Стоимость проверки полей, доступных без приведения типа студента.
+         */
+        inline constexpr int COST_FIELD = 0;
+
+        /**
+         * @brief Стоимость сравнения строковых полей базового класса.
+         */
+        inline constexpr int COST_STRING = 1;
+
+        /**
+         * @brief Стоимость проверки оценок (приведение типа и обход вектора оценок).
+         */
+        inline constexpr int COST_GRADES = 2;
+
+        /**
+         * @brief Стоимость сравнения строк в данных УИР или ДП.
+         */
+        inline constexpr int COST_PAYLOAD = 3;
+
+        /**
+         * @concept Predicate
+         * @brief Типизированный предикат запроса: вызываемый объект со статической стоимостью.
+         *
+         * Стоимость используется комбинаторами для того, чтобы сначала проверять
+         * дешёвые условия и не обращаться к тяжёлым данным студента без необходимости.
+         */
+        template <typename P>
+        concept Predicate = requires(const P &predicate, const Student &student) {
+            { P::COST } -> std::convertible_to<int>;
+            { predicate(student) } -> std::same_as<bool>;
+        };
+
+        /**
+         * @struct CategoryIs
+         * @brief Студент относится к заданной категории.
+         */
+        struct CategoryIs
+        {
+            static constexpr int COST = COST_FIELD;
+            StudentCategory category;
+
+            bool operator()(const Student &student) const { return student.getCategory() == category; }
+        };
+
+        /**
+         * @struct DepartmentIs
+         * @brief Студент учится на заданной кафедре.
+         */
+        struct DepartmentIs
+        {
+            static constexpr int COST = COST_FIELD;
+            int departmentNumber;
+
+            bool operator()(const Student &student) const { return student.getDepartmentNumber() == departmentNumber; }
+        };
+
+        /**
+         * @struct GroupIs
+         * @brief Студент учится в заданной группе.
+         */
+        struct GroupIs
+        {
+            static constexpr int COST = COST_STRING;
+            std::string groupIndex;
+
+            bool operator()(const Student &student) const { return student.getGroupIndex() == groupIndex; }
+        };
+
+        /**
+         * @struct AverageGradeBelow
+         * @brief Средняя оценка студента строго меньше порога.
+         *
+         * Средняя считается так же, как в Controller::calculateAverageGradesByGroup.
+         * Студенты без оценок условию не удовлетворяют.
+         */
+        struct AverageGradeBelow
+        {
+            static constexpr int COST = COST_GRADES;
+            double threshold;
+
+            bool operator()(const Student &student) const
+            {
+                auto grades = summarizeGrades(student);
+                return grades.count != 0 && grades.average() < threshold;
+            }
+        };
+
+        /**
+         * @struct AverageGradeAtLeast
+         * @brief Средняя оценка студента не меньше порога.
+         */
+        struct AverageGradeAtLeast
+        {
+            static constexpr int COST = COST_GRADES;
+            double threshold;
+
+            bool operator()(const Student &student) const
+            {
+                auto grades = summarizeGrades(student);
+                return grades.count != 0 && grades.average() >= threshold;
+            }
+        };
+
+        /**
+         * @struct CommissionGradeBelow
+         * @brief Оценка комиссии строго меньше порога.
+         *
+         * Для старшекурсников проверяется оценка комиссии за УИР, для выпускников —
+         * оценка ГЭК за ДП. Младшекурсники условию не удовлетворяют.
+         */
+        struct CommissionGradeBelow
+        {
+            static constexpr int COST = COST_GRADES;
+            int threshold;
+
+            bool operator()(const Student &student) const
+            {
+                switch (student.getCategory())
+                {
+                case StudentCategory::SENIOR:
+                    return dynamic_cast<const SeniorStudent &>(student).getResearchWork().commissionGrade < threshold;
+                case StudentCategory::GRADUATE:
+                    return dynamic_cast<const GraduateStudent &>(student).getDiplomaProject().stateCommissionGrade < threshold;
+                default:
+                    return false;
+                }
+            }
+        };
+
+        /**
+         * @struct ResearchPlaceIs
+         * @brief Старшекурсник выполняет УИР в заданном месте.
+         */
+        struct ResearchPlaceIs
+        {
+            static constexpr int COST = COST_PAYLOAD;
+            std::string place;
+
+            bool operator()(const Student &student) const
+            {
+                return student.getCategory() == StudentCategory::SENIOR &&
+                       dynamic_cast<const SeniorStudent &>(student).getResearchWork().place == place;
+            }
+        };
+
+        /**
+         * @struct And
+         * @brief Конъюнкция предикатов; более дешёвый операнд проверяется первым.
+         */
+        template <Predicate Lhs, Predicate Rhs>
+        struct And
+        {
+            static constexpr int COST = Lhs::COST > Rhs::COST ? Lhs::COST : Rhs::COST;
+            Lhs lhs;
+            Rhs rhs;
+
+            bool operator()(const Student &student) const
+            {
+                if constexpr (Lhs::COST <= Rhs::COST)
+                {
+                    return lhs(student) && rhs(student);
+                }
+                else
+                {
+                    return rhs(student) && lhs(student);
+                }
+            }
+        };
+
+        /**
+         * @struct Or
+         * @brief Дизъюнкция предикатов; более дешёвый операнд проверяется первым.
+         */
+        template <Predicate Lhs, Predicate Rhs>
+        struct Or
+        {
+            static constexpr int COST = Lhs::COST > Rhs::COST ? Lhs::COST : Rhs::COST;
+            Lhs lhs;
+            Rhs rhs;
+
+            bool operator()(const Student &student) const
+            {
+                if constexpr (Lhs::COST <= Rhs::COST)
+                {
+                    return lhs(student) || rhs(student);
+                }
+                else
+                {
+                    return rhs(student) || lhs(student);
+                }
+            }
+        };
+
+        /**
+         * @struct Not
+         * @brief Отрицание предиката.
+         */
+        template <Predicate Inner>
+        struct Not
+        {
+            static constexpr int COST = Inner::COST;
+            Inner inner;
+
+            bool operator()(const Student &student) const { return !inner(student); }
+        };
+
+        /**
+         * @struct All
+         * @brief Предикат, которому удовлетворяет любой студент.
+         */
+        struct All
+        {
+            static constexpr int COST = COST_FIELD;
+
+            bool operator()(const Student &) const { return true; }
+        };
+
+        template <Predicate Lhs, Predicate Rhs>
+        And<Lhs, Rhs> operator&&(Lhs lhs, Rhs rhs)
+        {
+            return {std::move(lhs), std::move(rhs)};
+        }
+
+        template <Predicate Lhs, Predicate Rhs>
+        Or<Lhs, Rhs> operator||(Lhs lhs, Rhs rhs)
+        {
+            return {std::move(lhs), std::move(rhs)};
+        }
+
+        template <Predicate Inner>
+        Not<Inner> operator!(Inner inner)
+        {
+            return {std::move(inner)};
+        }
+
+    } // namespace query
+} // namespace university
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "StudentTable.h"
+#include "MappedRegistry.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace university
+{
+
+    /**
+     * @class StudentSnapshot
+     * @brief Согласованный снимок таблицы студентов на момент определённой версии.
+     *
+     * Снимок разделяет таблицу с контроллером до первого изменения: писатель,
+     * обнаружив, что таблицу удерживает снимок, копирует её (копируются только
+     * указатели на записи) и изменяет копию. Поэтому чтение снимка не требует
+     * блокировок и не мешает писателям, а старые версии таблицы и записей
+     * освобождаются, когда на них не остаётся ссылок.
+     *
+     * В режиме только для чтения (Controller::openReadOnly) снимок дополнительно
+     * удерживает отображённый файл реестра, а таблица в памяти пуста.
+     */
+    class StudentSnapshot
+    {
+    public:
+        /**
+         * @brief Конструирует снимок.
+         * @param table Таблица, которая больше не будет изменяться.
+         * @param version Версия таблицы на момент снимка.
+         * @param mapped Отображённый файл реестра или nullptr.
+         */
+        StudentSnapshot(std::shared_ptr<const StudentTable> table, uint64_t version,
+                        std::shared_ptr<const storage::MappedRegistry> mapped = nullptr)
+            : table_(std::move(table)), version_(version), mapped_(std::move(mapped)) {}
+
+        /**
+         * @brief Получает версию таблицы, соответствующую снимку.
+         * @return Номер версии.
+         */
+        [[nodiscard]] uint64_t version() const { return version_; }
+
+        /**
+         * @brief Получает таблицу снимка.
+         * @return Константная ссылка на таблицу.
+         */
+        [[nodiscard]] const StudentTable &table() const { return *table_; }
+
+        /**
+         * @brief Получает отображённый файл реестра, если снимок взят в режиме только для чтения.
+         * @return Отображённый реестр или nullptr.
+         */
+        [[nodiscard]] const std::shared_ptr<const storage::MappedRegistry> &mapped() const { return mapped_; }
+
+        /**
+         * @brief Получает количество студентов в снимке.
+         * @return Количество студентов.
+         */
+        [[nodiscard]] size_t size() const { return mapped_ ? mapped_->size() : table_->size(); }
+
+        /**
+         * @brief Находит студента в снимке.
+         * @param id ID студента.
+         * @return Запись студента или nullptr, если студента нет в снимке.
+         */
+        [[nodiscard]] std::shared_ptr<const Student> find(int id) const
+        {
+            if (mapped_)
+            {
+                const auto *record = mapped_->find(id);
+                return record ? std::shared_ptr<const Student>(mapped_->materialize(*record)) : nullptr;
+            }
+            auto student = table_->find(id);
+            return student ? student->get() : nullptr;
+        }
+
+    private:
+        std::shared_ptr<const StudentTable> table_;
+        uint64_t version_;
+        std::shared_ptr<const storage::MappedRegistry> mapped_;
+    };
+
+} // namespace university
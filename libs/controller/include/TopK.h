@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @struct RankedStudent
+     * @brief Студент в рейтинге по средней оценке.
+     */
+    struct RankedStudent
+    {
+        int id = 0;
+        double averageGrade = 0.0;
+
+        bool operator==(const RankedStudent &other) const = default;
+    };
+
+    /**
+     * @brief Определяет порядок рейтинга: выше средняя оценка, при равенстве — меньше ID.
+     * @param lhs Первый студент.
+     * @param rhs Второй студент.
+     * @return True, если lhs стоит в рейтинге раньше rhs.
+     */
+    inline bool rankedBefore(const RankedStudent &lhs, const RankedStudent &rhs)
+    {
+        if (lhs.averageGrade != rhs.averageGrade)
+        {
+            return lhs.averageGrade > rhs.averageGrade;
+        }
+        return lhs.id < rhs.id;
+    }
+
+    /**
+     * @class TopKHeap
+     * @brief Ограниченная куча, хранящая не более K лучших студентов.
+     *
+     * На вершине кучи находится худший из сохранённых студентов, поэтому
+     * новый кандидат сравнивается только с ним. Память — O(K) независимо
+     * от количества просмотренных студентов.
+     */
+    class TopKHeap
+    {
+    public:
+        /**
+         * @brief Конструирует пустую кучу.
+         * @param k Максимальное количество хранимых студентов.
+         */
+        explicit TopKHeap(size_t k = 0) : k_(k) {}
+
+        /**
+         * @brief Предлагает кандидата; он сохраняется, если входит в K лучших.
+         * @param candidate Кандидат.
+         */
+        void push(const RankedStudent &candidate)
+        {
+            if (heap_.size() < k_)
+            {
+                heap_.push_back(candidate);
+                std::push_heap(heap_.begin(), heap_.end(), rankedBefore);
+            }
+            else if (k_ != 0 && rankedBefore(candidate, heap_.front()))
+            {
+                std::pop_heap(heap_.begin(), heap_.end(), rankedBefore);
+                heap_.back() = candidate;
+                std::push_heap(heap_.begin(), heap_.end(), rankedBefore);
+            }
+        }
+
+        /**
+         * @brief Добавляет в кучу всех студентов другой кучи.
+         * @param other Куча другого потока.
+         */
+        void merge(const TopKHeap &other)
+        {
+            for (const auto &candidate : other.heap_)
+            {
+                push(candidate);
+            }
+        }
+
+        /**
+         * @brief Возвращает сохранённых студентов в порядке рейтинга.
+         * @return Не более K студентов, от лучшего к худшему.
+         */
+        [[nodiscard]] std::vector<RankedStudent> sorted() const
+        {
+            std::vector<RankedStudent> result = heap_;
+            std::sort(result.begin(), result.end(), rankedBefore);
+            return result;
+        }
+
+    private:
+        size_t k_;
+        std::vector<RankedStudent> heap_;
+    };
+
+} // namespace university
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace university
+{
+
+    /**
+     * @class WorkerPool
+     * @brief Пул потоков фиксированного размера с общей очередью задач.
+     *
+     * Задачи выполняются в порядке постановки (при нескольких потоках —
+     * одновременно). Задача не должна выбрасывать исключений.
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * @brief Запускает потоки.
+         * @param threads Количество потоков (0 — по числу ядер).
+         */
+        explicit WorkerPool(unsigned threads = 0);
+
+        /**
+         * @brief Выполняет оставшиеся задачи и останавливает потоки.
+         */
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        /**
+         * @brief Ставит задачу в очередь.
+         * @param task Задача.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief Ждёт, пока очередь опустеет и все начатые задачи завершатся.
+         */
+        void waitIdle();
+
+        [[nodiscard]] size_t size() const { return threads_.size(); }
+
+    private:
+        void work();
+
+        std::mutex mutex_;
+        std::condition_variable ready_; // Появилась задача или пул останавливается
+        std::condition_variable idle_;  // Очередь пуста и нет выполняемых задач
+        std::deque<std::function<void()>> tasks_;
+        size_t running_ = 0;
+        bool stopping_ = false;
+        std::vector<std::thread> threads_;
+    };
+
+} // namespace university
@@ -0,0 +1,65 @@
+#include "AsyncController.h"
+
+namespace university
+{
+
+    AsyncController::AsyncController(Controller &controller, unsigned threads)
+        : controller_(controller), pool_(threads)
+    {
+    }
+
+    AsyncController::~AsyncController()
+    {
+        cancelAll();
+    }
+
+    std::future<std::shared_ptr<const Student>> AsyncController::findAsync(int id, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, id](const Cancellation &)
+                      { return controller_.getStudent(id); });
+    }
+
+    std::future<int> AsyncController::addAsync(std::unique_ptr<Student> student, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, student = std::move(student)](const Cancellation &) mutable
+                      { return controller_.insertStudent(std::move(student)); });
+    }
+
+    std::future<bool> AsyncController::removeAsync(int id, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, id](const Cancellation &)
+                      { return controller_.eraseStudent(id); });
+    }
+
+    std::future<bool> AsyncController::setGroupAsync(int id, std::string groupIndex, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, id, groupIndex = std::move(groupIndex)](const Cancellation &)
+                      { return controller_.setStudentGroup(id, groupIndex); });
+    }
+
+    std::future<MutationBatchResult> AsyncController::applyBatchAsync(std::vector<MutationCommand> commands, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, commands = std::move(commands)](const Cancellation &)
+                      { return controller_.applyBatch(commands); });
+    }
+
+    std::future<std::shared_ptr<const std::map<std::string, double>>> AsyncController::averagesByGroupAsync(std::stop_token stop)
+    {
+        return submit(std::move(stop), [this](const Cancellation &)
+                      { return controller_.getAverageGradesByGroupCached(); });
+    }
+
+    std::future<std::shared_ptr<const std::vector<RankedStudent>>> AsyncController::topStudentsAsync(size_t k, std::stop_token stop)
+    {
+        return submit(std::move(stop), [this, k](const Cancellation &)
+                      { return controller_.getTopStudentsByAverageCached(k); });
+    }
+
+    void AsyncController::cancelAll()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelSource_.request_stop();
+        cancelSource_ = std::stop_source();
+    }
+
+} // namespace university
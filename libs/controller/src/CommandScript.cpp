@@ -0,0 +1,347 @@
+#include "CommandScript.h"
+#include "StudentCsv.h"
+#include "StudentGrades.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace university
+{
+    namespace
+    {
+        /**
+         * @brief Отделяет первое слово строки; остаток начинается после одного пробела.
+         */
+        std::string_view takeWord(std::string_view &rest)
+        {
+            size_t end = rest.find(' ');
+            std::string_view word = rest.substr(0, end);
+            rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 1);
+            return word;
+        }
+
+        int parseId(std::string_view text)
+        {
+            int id = 0;
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), id);
+            if (error != std::errc{} || end != text.data() + text.size())
+            {
+                throw std::invalid_argument("некорректный ID: " + std::string(text));
+            }
+            return id;
+        }
+
+    } // namespace
+
+    ResearchWork parseResearchWork(std::string_view text)
+    {
+        std::vector<std::string_view> fields;
+        size_t first = 0;
+        while (first <= text.size())
+        {
+            size_t comma = std::min(text.find(',', first), text.size());
+            fields.push_back(text.substr(first, comma - first));
+            first = comma + 1;
+        }
+        if (fields.size() != 4)
+        {
+            throw std::invalid_argument("ожидается 4 поля УИР через запятую");
+        }
+        auto grade = [](std::string_view field)
+        {
+            int value = 0;
+            auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+            if (field.empty() || error != std::errc{} || end != field.data() + field.size())
+            {
+                throw std::invalid_argument("некорректная оценка УИР: " + std::string(field));
+            }
+            return value;
+        };
+        return ResearchWork{grade(fields[0]), grade(fields[1]), std::string(fields[2]), std::string(fields[3])};
+    }
+
+    ScriptCommand parseScriptCommand(std::string_view line)
+    {
+        std::string_view rest = line;
+        std::string_view keyword = takeWord(rest);
+        ScriptCommand command;
+        if (keyword == "ADD")
+        {
+            command.type = ScriptCommandType::ADD;
+            command.argument = rest;
+        }
+        else if (keyword == "FIND" || keyword == "REMOVE")
+        {
+            command.type = keyword == "FIND" ? ScriptCommandType::FIND : ScriptCommandType::REMOVE;
+            command.id = parseId(rest);
+        }
+        else if (keyword == "GROUP" || keyword == "WORK")
+        {
+            command.type = keyword == "GROUP" ? ScriptCommandType::GROUP : ScriptCommandType::WORK;
+            command.id = parseId(takeWord(rest));
+            command.argument = rest;
+        }
+        else if (keyword == "AVG")
+        {
+            command.type = ScriptCommandType::AVG;
+            command.argument = rest;
+        }
+        else
+        {
+            throw std::invalid_argument("неизвестная команда: " + std::string(keyword));
+        }
+        if (command.argument.empty() && command.type != ScriptCommandType::FIND && command.type != ScriptCommandType::REMOVE)
+        {
+            throw std::invalid_argument("не указан аргумент команды " + std::string(keyword));
+        }
+        return command;
+    }
+
+    void CommandSession::execute(std::string_view line, size_t lineNumber)
+    {
+        ++commands_;
+        ScriptCommand command;
+        std::unique_ptr<Student> student;
+        ResearchWork work{};
+        try
+        {
+            command = parseScriptCommand(line);
+            if (command.type == ScriptCommandType::ADD)
+            {
+                student = storage::parseStudentRow(command.argument, ',');
+            }
+            else if (command.type == ScriptCommandType::WORK)
+            {
+                work = parseResearchWork(command.argument);
+            }
+        }
+        catch (const std::invalid_argument &error)
+        {
+            flush();
+            writeError(lineNumber, error.what());
+            return;
+        }
+
+        switch (command.type)
+        {
+        case ScriptCommandType::ADD:
+            queue(MutationCommand::add(std::move(student)), lineNumber);
+            break;
+        case ScriptCommandType::REMOVE:
+            queue(MutationCommand::remove(command.id), lineNumber);
+            break;
+        case ScriptCommandType::GROUP:
+            queue(MutationCommand::setGroup(command.id, std::string(command.argument)), lineNumber);
+            break;
+        case ScriptCommandType::WORK:
+            queue(MutationCommand::setResearchWork(command.id, std::move(work)), lineNumber);
+            break;
+        case ScriptCommandType::FIND:
+            flush();
+            find(command.id);
+            break;
+        case ScriptCommandType::AVG:
+            flush();
+            average(command.argument);
+            break;
+        }
+    }
+
+    size_t CommandSession::executeLines(std::string_view text, size_t firstLineNumber)
+    {
+        size_t lineNumber = firstLineNumber;
+        size_t first = 0;
+        while (first < text.size())
+        {
+            size_t last = std::min(text.find('\n', first), text.size());
+            std::string_view line = text.substr(first, last - first);
+            first = last + 1;
+            ++lineNumber;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            if (line.empty() || line.front() == '#')
+            {
+                continue;
+            }
+            execute(line, lineNumber - 1);
+        }
+        return lineNumber;
+    }
+
+    void CommandSession::flush()
+    {
+        if (pending_.empty())
+        {
+            return;
+        }
+        try
+        {
+            auto batch = controller_.applyBatch(pending_);
+            if (batch.applied)
+            {
+                writeResults(batch.results, 0);
+            }
+            else
+            {
+                // Неудачная команда не должна отменять соседние: применяем по одной
+                for (size_t i = 0; i < pending_.size(); ++i)
+                {
+                    writeResults(controller_.applyBatch({pending_[i]}).results, i);
+                }
+            }
+        }
+        catch (const std::logic_error &error)
+        {
+            for (size_t lineNumber : pendingLines_)
+            {
+                writeError(lineNumber, error.what());
+            }
+        }
+        pending_.clear();
+        pendingLines_.clear();
+    }
+
+    void CommandSession::queue(MutationCommand command, size_t lineNumber)
+    {
+        pending_.push_back(std::move(command));
+        pendingLines_.push_back(lineNumber);
+        if (pending_.size() >= maxBatch_)
+        {
+            flush();
+        }
+    }
+
+    void CommandSession::writeResults(const std::vector<MutationResult> &results, size_t first)
+    {
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &result = results[i];
+            switch (result.status)
+            {
+            case MutationStatus::APPLIED:
+                if (pending_[first + i].type == MutationType::ADD)
+                {
+                    output_ += "OK\t";
+                    appendNumber(result.id);
+                    output_ += '\n';
+                }
+                else
+                {
+                    output_ += "OK\n";
+                }
+                break;
+            case MutationStatus::NOT_FOUND:
+                output_ += "NOT_FOUND\n";
+                break;
+            case MutationStatus::NOT_SENIOR:
+                writeError(pendingLines_[first + i], "not senior");
+                break;
+            case MutationStatus::INVALID:
+                writeError(pendingLines_[first + i], "invalid");
+                break;
+            case MutationStatus::NOT_APPLIED:
+                // Команды применяются по одной после отказа пакета, поэтому сюда попасть нельзя
+                writeError(pendingLines_[first + i], "not applied");
+                break;
+            }
+        }
+    }
+
+    void CommandSession::find(int id)
+    {
+        bool found = controller_.visitStudent(id, [this, id](const Student &student)
+                                              {
+            output_ += "OK\t";
+            appendNumber(id);
+            output_ += '\t';
+            output_ += storage::CSV_CATEGORY_NAMES[static_cast<size_t>(student.getCategory())];
+            output_ += '\t';
+            output_ += student.getName();
+            output_ += '\t';
+            output_ += student.getGroupIndex();
+            output_ += '\t';
+            appendNumber(student.getDepartmentNumber());
+            output_ += '\t';
+            appendNumber(summarizeGrades(student).average());
+            output_ += '\n'; });
+        if (!found)
+        {
+            output_ += "NOT_FOUND\n";
+        }
+    }
+
+    void CommandSession::average(std::string_view group)
+    {
+        auto averages = controller_.getAverageGradesByGroupCached();
+        auto it = averages->find(std::string(group));
+        if (it == averages->end())
+        {
+            output_ += "NOT_FOUND\n";
+            return;
+        }
+        output_ += "OK\t";
+        appendNumber(it->second);
+        output_ += '\n';
+    }
+
+    void CommandSession::writeError(size_t lineNumber, const char *message)
+    {
+        ++errors_;
+        output_ += "ERROR ";
+        appendNumber(lineNumber);
+        output_ += ": ";
+        output_ += message;
+        output_ += '\n';
+    }
+
+    template <typename T>
+    void CommandSession::appendNumber(T value)
+    {
+        char text[32];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        output_.append(text, result.ptr);
+    }
+
+    ScriptReport runCommandScript(Controller &controller, std::istream &in, std::ostream &out, const ScriptOptions &options)
+    {
+        auto start = std::chrono::steady_clock::now();
+        CommandSession session(controller, options);
+        std::string buffer;
+        size_t lineNumber = 1;
+        bool finished = false;
+        while (!finished)
+        {
+            // Дочитываем блок; неполная последняя строка переносится в следующий
+            size_t carried = buffer.size();
+            buffer.resize(carried + options.chunkSize);
+            in.read(buffer.data() + carried, static_cast<std::streamsize>(options.chunkSize));
+            buffer.resize(carried + static_cast<size_t>(in.gcount()));
+            finished = !in;
+
+            size_t end = finished ? buffer.size() : buffer.rfind('\n') + 1;
+            if (!finished && end == 0)
+            {
+                continue; // Строка длиннее блока
+            }
+            lineNumber = session.executeLines(std::string_view(buffer).substr(0, end), lineNumber);
+
+            // Ответы блока записываются целиком, поэтому накопленные изменения применяются до записи
+            session.flush();
+            out.write(session.output().data(), static_cast<std::streamsize>(session.output().size()));
+            session.output().clear();
+            buffer.erase(0, end);
+        }
+        out.flush();
+        ScriptReport report;
+        report.commands = session.commands();
+        report.errors = session.errors();
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+} // namespace university
@@ -2,17 +2,234 @@
 #include "JuniorStudent.h"
 #include "SeniorStudent.h"
 #include "GraduateStudent.h"
+#include "ParallelScan.h"
+#include "StudentGrades.h"
+#include "BinarySnapshot.h"
+#include "MappedRegistry.h"
+#include "WriteAheadLog.h"
+#include "Metrics.h"
 #include <algorithm>
+#include <array>
+#include <iterator>
 #include <numeric>
 #include <chrono>
 #include <future>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <set>
+#include <stdexcept>
 #include <thread>
+#include <unordered_map>
 
 namespace university
 {
+    namespace
+    {
+        constexpr const char *SNAPSHOT_FILE = "registry.snapshot";
+        constexpr const char *WAL_FILE = "registry.wal";
+
+        /**
+         * @brief Операции Controller, для которых ведутся метрики и трассировка.
+         */
+        enum class Operation : size_t
+        {
+            INSERT,
+            INSERT_BATCH,
+            ERASE,
+            FIND,
+            SET_GROUP,
+            SET_RESEARCH_WORK,
+            REPLACE,
+            AVERAGES,
+            AVERAGES_MULTITHREADED,
+            AVERAGES_CUBE,
+            TOP_STUDENTS,
+            TOP_STUDENTS_BY_GROUP,
+            AVERAGES_CACHED,
+            AVERAGES_CUBE_CACHED,
+            TOP_STUDENTS_CACHED,
+            TOP_STUDENTS_BY_GROUP_CACHED,
+            IMPORT_CSV,
+            EXPORT_STUDENTS,
+            EXPORT_AVERAGES,
+            SAVE,
+            SAVE_MAPPED,
+            OPEN_READ_ONLY,
+            LOAD,
+            OPEN_STORAGE,
+            CHECKPOINT,
+            APPLY_BATCH,
+            COUNT
+        };
+
+        constexpr const char *OPERATION_NAMES[] = {
+            "insert",
+            "insert_batch",
+            "erase",
+            "find",
+            "set_group",
+            "set_research_work",
+            "replace",
+            "averages",
+            "averages_multithreaded",
+            "averages_cube",
+            "top_students",
+            "top_students_by_group",
+            "averages_cached",
+            "averages_cube_cached",
+            "top_students_cached",
+            "top_students_by_group_cached",
+            "import_csv",
+            "export_students",
+            "export_averages",
+            "save",
+            "save_mapped",
+            "open_read_only",
+            "load",
+            "open_storage",
+            "checkpoint",
+            "apply_batch"};
+        static_assert(std::size(OPERATION_NAMES) == static_cast<size_t>(Operation::COUNT));
+
+        /**
+         * @struct ControllerMetrics
+         * @brief Метрики Controller в реестре процесса; общие для всех экземпляров.
+         */
+        struct ControllerMetrics
+        {
+            std::array<metrics::Histogram *, static_cast<size_t>(Operation::COUNT)> latency{};
+            metrics::Counter &added;
+            metrics::Counter &removed;
+            metrics::Counter &findHits;
+            metrics::Counter &findMisses;
+            metrics::Counter &transfers;
+            metrics::Counter &groupChanges;
+            metrics::Counter &researchWorkChanges;
+            metrics::Counter &aggregations;
+            metrics::Counter &tableCopies;
+            metrics::Counter &exclusiveLocks;
+            metrics::Counter &sharedLocks;
+            metrics::Histogram &exclusiveLockWait;
+            metrics::Histogram &sharedLockWait;
+            metrics::Gauge &tableSize;
+        };
+
+        ControllerMetrics &controllerMetrics()
+        {
+            static ControllerMetrics *instance = []()
+            {
+                auto &registry = metrics::registry();
+                auto *result = new ControllerMetrics{
+                    {},
+                    registry.counter("university_students_added_total", "Добавлено студентов"),
+                    registry.counter("university_students_removed_total", "Удалено студентов"),
+                    registry.counter("university_student_finds_total", "Поисков студента по ID", "result=\"hit\""),
+                    registry.counter("university_student_finds_total", "Поисков студента по ID", "result=\"miss\""),
+                    registry.counter("university_student_transfers_total", "Замен записи студента (перевод в другую категорию)"),
+                    registry.counter("university_student_group_changes_total", "Изменений группы студента"),
+                    registry.counter("university_student_research_work_changes_total", "Изменений УИР старшекурсника"),
+                    registry.counter("university_aggregations_total", "Вычислений аналитики по всей таблице (без попаданий в кэш)"),
+                    registry.counter("university_table_copies_total", "Копирований таблицы при изменении, пока жив снимок"),
+                    registry.counter("university_table_lock_acquisitions_total", "Захватов мьютекса таблицы", "mode=\"exclusive\""),
+                    registry.counter("university_table_lock_acquisitions_total", "Захватов мьютекса таблицы", "mode=\"shared\""),
+                    registry.histogram("university_table_lock_wait_seconds", "Ожидание занятого мьютекса таблицы", "mode=\"exclusive\""),
+                    registry.histogram("university_table_lock_wait_seconds", "Ожидание занятого мьютекса таблицы", "mode=\"shared\""),
+                    registry.gauge("university_students", "Студентов в таблице")};
+                for (size_t i = 0; i < result->latency.size(); ++i)
+                {
+                    result->latency[i] = &registry.histogram("university_operation_duration_seconds", "Длительность операций Controller",
+                                                             std::string("operation=\"") + OPERATION_NAMES[i] + "\"");
+                }
+                return result;
+            }();
+            return *instance;
+        }
+
+        /**
+         * @class OperationScope
+         * @brief Замеряет операцию Controller: гистограмма длительности и участок трассировки.
+         */
+        class OperationScope
+        {
+        public:
+            explicit OperationScope(Operation operation)
+                : timer_(*controllerMetrics().latency[static_cast<size_t>(operation)])
+#if UNIVERSITY_TRACING
+                  ,
+                  span_("controller", OPERATION_NAMES[static_cast<size_t>(operation)])
+#endif
+            {
+            }
+
+        private:
+            metrics::ScopedTimer timer_;
+#if UNIVERSITY_TRACING
+            trace::Span span_;
+#endif
+        };
+
+        /**
+         * @brief Получает сессионные оценки студента (пусто для выпускника).
+         */
+        std::vector<int> sessionGradesOf(const Student &student)
+        {
+            switch (student.getCategory())
+            {
+            case StudentCategory::JUNIOR:
+                return dynamic_cast<const JuniorStudent &>(student).getSessionGrades();
+            case StudentCategory::SENIOR:
+                return dynamic_cast<const SeniorStudent &>(student).getSessionGrades();
+            default:
+                return {};
+            }
+        }
+
+        /**
+         * @brief Применяет запись журнала к таблице при восстановлении.
+         *
+         * Записи задают итоговое состояние, поэтому запись, уже отражённая
+         * в контрольной точке, применяется повторно без последствий.
+         */
+        void applyLogEntry(StudentTable &table, int &nextId, const storage::WalEntry &entry)
+        {
+            switch (entry.operation)
+            {
+            case storage::WalOperation::PUT:
+                table.remove(entry.id);
+                table.insert(entry.id, entry.student);
+                nextId = std::max(nextId, entry.id + 1);
+                break;
+            case storage::WalOperation::REMOVE:
+                table.remove(entry.id);
+                break;
+            case storage::WalOperation::SET_GROUP:
+                if (auto current = table.find(entry.id))
+                {
+                    auto updated = current->get()->clone();
+                    updated->setGroupIndex(entry.groupIndex);
+                    current->get() = std::move(updated);
+                }
+                break;
+            case storage::WalOperation::SET_RESEARCH_WORK:
+                if (auto current = table.find(entry.id); current && current->get()->getCategory() == StudentCategory::SENIOR)
+                {
+                    auto updated = current->get()->clone();
+                    dynamic_cast<SeniorStudent &>(*updated).setResearchWork(entry.researchWork);
+                    current->get() = std::move(updated);
+                }
+                break;
+            case storage::WalOperation::BATCH:
+                for (const auto &item : entry.entries)
+                {
+                    applyLogEntry(table, nextId, item);
+                }
+                break;
+            }
+        }
+    } // namespace
 
-    Controller::Controller() : studentTable_(16) {} // Начальная ёмкость
+    Controller::Controller() : studentTable_(std::make_shared<StudentTable>(16)) {} // Начальная ёмкость
 
     void Controller::run()
     {
@@ -20,6 +237,12 @@ namespace university
         while (running)
         {
             int choice = view_.showMenu();
+            bool mutating = choice == 1 || choice == 3 || choice == 5 || choice == 6 || choice == 9;
+            if (mutating && isReadOnly())
+            {
+                view_.showMessage("Реестр открыт только для чтения.");
+                continue;
+            }
             switch (choice)
             {
             case 1:
@@ -63,9 +286,7 @@ namespace university
         auto student = view_.getNewStudentInfo();
         if (student)
         {
-            std::lock_guard<std::mutex> lock(tableMutex_);
-            int id = nextId_++;
-            studentTable_.insert(id, std::move(student));
+            int id = insertStudent(std::move(student));
             view_.showMessage("Студент успешно добавлен с ID: " + std::to_string(id));
         }
         else
@@ -77,13 +298,9 @@ namespace university
     void Controller::findStudent()
     {
         int id = view_.getStudentId();
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        auto student = studentTable_.find(id);
-        if (student)
-        {
-            view_.showStudentInfo(*student->get());
-        }
-        else
+        bool found = visitStudent(id, [this](const Student &student)
+                                  { view_.showStudentInfo(student); });
+        if (!found)
         {
             view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
         }
@@ -92,8 +309,7 @@ namespace university
     void Controller::removeStudent()
     {
         int id = view_.getStudentId();
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        if (studentTable_.remove(id))
+        if (eraseStudent(id))
         {
             view_.showMessage("Студент с ID " + std::to_string(id) + " успешно удален.");
         }
@@ -105,32 +321,45 @@ namespace university
 
     void Controller::showAllStudents()
     {
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        view_.showStudentTable(studentTable_);
+        // Страницы читаются из снимка: пока пользователь листает, блокировки не удерживаются
+        auto cursor = openStudentCursor();
+        while (true)
+        {
+            size_t first = cursor.returned();
+            view_.showStudentPage(cursor.next(pageSize_), first, cursor.total());
+            if (cursor.done() || !view_.askNextPage())
+            {
+                break;
+            }
+        }
     }
 
     void Controller::changeStudentGroup()
     {
         int id = view_.getStudentId();
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        auto student = studentTable_.find(id);
-        if (!student)
+        if (!visitStudent(id, [](const Student &) {}))
         {
             view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
             return;
         }
 
+        // Ввод выполняется до захвата блокировки на запись
         std::string newGroup = view_.getNewGroupIndex();
-        student->get()->setGroupIndex(newGroup);
-        view_.showMessage("Группа студента успешно изменена.");
+        if (setStudentGroup(id, newGroup))
+        {
+            view_.showMessage("Группа студента успешно изменена.");
+        }
+        else
+        {
+            view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
+        }
     }
 
     void Controller::transferStudent()
     {
         int id = view_.getStudentId();
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        auto student = studentTable_.find(id);
-        if (!student)
+        auto current = getStudent(id);
+        if (!current)
         {
             view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
             return;
@@ -138,41 +367,51 @@ namespace university
 
         int newCategory = view_.getNewCategory();
         StudentCategory category = static_cast<StudentCategory>(newCategory - 1);
-
-        if (student->get()->getCategory() == category)
+        if (current->getCategory() == category)
         {
             view_.showMessage("Студент уже находится в этой категории.");
             return;
         }
 
-        // Создаём нового студента целевой категории
+        // Создаём нового студента целевой категории; ввод выполняется до захвата блокировки на запись.
+        // Сессионные оценки переносятся в пределах, допустимых для новой категории
+        auto grades = sessionGradesOf(*current);
         std::unique_ptr<Student> newStudent;
         switch (category)
         {
         case StudentCategory::JUNIOR:
+            grades.resize(std::min(grades.size(), JuniorStudent::MAX_SESSION_GRADES));
+            newStudent = std::make_unique<JuniorStudent>(current->getName(), current->getGroupIndex(),
+                                                         current->getDepartmentNumber(), std::move(grades));
+            break;
         case StudentCategory::SENIOR:
-        case StudentCategory::GRADUATE:
+            grades.resize(std::min(grades.size(), SeniorStudent::MAX_SESSION_GRADES));
+            newStudent = std::make_unique<SeniorStudent>(current->getName(), current->getGroupIndex(),
+                                                         current->getDepartmentNumber(), std::move(grades), view_.getNewResearchWork());
             break;
-        default:
+        case StudentCategory::GRADUATE:
+            newStudent = std::make_unique<GraduateStudent>(current->getName(), current->getGroupIndex(),
+                                                           current->getDepartmentNumber(), view_.getNewDiplomaProject());
             break;
         }
 
         // Заменяем старого студента новым
-        studentTable_.remove(id);
-        studentTable_.insert(id, std::move(newStudent));
-        view_.showMessage("Студент успешно переведен в новую категорию.");
+        if (replaceStudent(id, std::move(newStudent)))
+        {
+            view_.showMessage("Студент успешно переведен в новую категорию.");
+        }
+        else
+        {
+            view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
+        }
     }
 
     void Controller::showStudentGrades()
     {
         int id = view_.getStudentId();
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        auto student = studentTable_.find(id);
-        if (student)
-        {
-            view_.showStudentGrades(*student->get());
-        }
-        else
+        bool found = visitStudent(id, [this](const Student &student)
+                                  { view_.showStudentGrades(student); });
+        if (!found)
         {
             view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
         }
@@ -180,9 +419,8 @@ namespace university
 
     void Controller::showAverageGradesByGroup()
     {
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        auto averages = calculateAverageGradesByGroup();
-        view_.showAverageGradesByGroup(averages);
+        auto averages = getAverageGradesByGroupCached();
+        view_.showAverageGradesByGroup(*averages);
     }
 
     void Controller::showAverageGradesByGroupWithChoice()
@@ -194,7 +432,6 @@ namespace university
         std::map<std::string, double> averages;
         if (mode == 1)
         {
-            std::lock_guard<std::mutex> lock(tableMutex_);
             averages = calculateAverageGradesByGroup();
         }
         else
@@ -210,197 +447,1024 @@ namespace university
         view_.showAverageGradesByGroup(averages);
     }
 
-    std::map<std::string, double> Controller::calculateAverageGradesByGroup()
+    std::map<std::string, double> Controller::averageGradesByGroup(const StudentTable &table)
     {
-        std::map<std::string, std::vector<double>> groupGrades;
+        std::map<std::string, GradeSummary> groupGrades;
 
-        // Собираем все оценки по группам
-        for (auto it = studentTable_.begin(); it != studentTable_.end(); ++it)
+        // Собираем сводки оценок по группам
+        for (auto it = table.begin(); it != table.end(); ++it)
         {
             auto pair = *it;
             const auto &student = pair.second;
-            std::string group = student->getGroupIndex();
-
-            std::vector<double> grades;
+            groupGrades[student->getGroupIndex()].merge(summarizeGrades(*student));
+        }
 
-            switch (student->getCategory())
+        // Вычисляем средние значения
+        std::map<std::string, double> averages;
+        for (const auto &[group, grades] : groupGrades)
+        {
+            if (grades.count != 0)
             {
-            case StudentCategory::JUNIOR:
-            case StudentCategory::SENIOR:
-            case StudentCategory::GRADUATE:
-                break;
-            default:
-                break;
+                averages[group] = grades.average();
             }
+        }
 
-            switch (student->getCategory())
-            {
-            case StudentCategory::JUNIOR:
+        return averages;
+    }
+
+    std::map<std::string, double> Controller::averageGradesByGroup(const storage::MappedRegistry &registry, unsigned requestedWorkers,
+                                                                   ParallelProfile *profile)
+    {
+        // Сводки накапливаются по плотным кодам групп из файла, строки не сравниваются
+        unsigned numWorkers = effectiveWorkerCount(registry.bucketCount(), requestedWorkers);
+        std::vector<std::vector<GradeSummary>> partial(numWorkers, std::vector<GradeSummary>(registry.groupCount()));
+        auto records = registry.records();
+        parallelForSlots(registry, numWorkers, profileWorkers(profile, numWorkers, [&partial, records](unsigned worker, size_t first, size_t last)
+                                                              {
+            auto &groupGrades = partial[worker];
+            for (size_t index = first; index < last; ++index)
             {
-                const auto &junior = dynamic_cast<const JuniorStudent &>(*student);
-                for (int grade : junior.getSessionGrades())
+                const auto &record = records[index];
+                if (record.groupCode >= groupGrades.size())
                 {
-                    grades.push_back(static_cast<double>(grade));
+                    throw std::runtime_error("Повреждённый файл реестра: код группы вне таблицы групп");
                 }
-                break;
+                groupGrades[record.groupCode].merge(storage::summarizeGrades(record));
             }
-            case StudentCategory::SENIOR:
+            return last - first; }));
+
+        std::map<std::string, double> averages;
+        for (uint32_t code = 0; code < registry.groupCount(); ++code)
+        {
+            GradeSummary grades;
+            for (const auto &groupGrades : partial)
             {
-                const auto &senior = dynamic_cast<const SeniorStudent &>(*student);
-                for (int grade : senior.getSessionGrades())
-                {
-                    grades.push_back(static_cast<double>(grade));
-                }
-                const auto &work = senior.getResearchWork();
-                grades.push_back(static_cast<double>(work.supervisorGrade));
-                grades.push_back(static_cast<double>(work.commissionGrade));
-                break;
+                grades.merge(groupGrades[code]);
             }
-            case StudentCategory::GRADUATE:
+            if (grades.count != 0)
             {
-                const auto &graduate = dynamic_cast<const GraduateStudent &>(*student);
-                const auto &project = graduate.getDiplomaProject();
-                grades.push_back(static_cast<double>(project.supervisorGrade));
-                grades.push_back(static_cast<double>(project.reviewerGrade));
-                grades.push_back(static_cast<double>(project.stateCommissionGrade));
-                break;
-            }
+                averages[std::string(registry.groupName(code))] = grades.average();
             }
-
-            groupGrades[group].insert(groupGrades[group].end(), grades.begin(), grades.end());
         }
+        return averages;
+    }
 
-        // Вычисляем средние значения
+    std::map<std::string, double> Controller::calculateAverageGradesByGroupMultithreaded(unsigned threads, ParallelProfile *profile)
+    {
+        OperationScope operation(Operation::AVERAGES_MULTITHREADED);
+        controllerMetrics().aggregations.add();
+        auto start = std::chrono::steady_clock::now();
+        auto snapshot = takeSnapshot();
         std::map<std::string, double> averages;
-        for (const auto &[group, grades] : groupGrades)
+        if (snapshot.mapped())
         {
-            if (!grades.empty())
+            averages = averageGradesByGroup(*snapshot.mapped(), threads, profile);
+        }
+        else
+        {
+            // Каждый поток обходит свой диапазон слотов и копит сводки групп локально
+            const auto &table = snapshot.table();
+            unsigned numWorkers = effectiveWorkerCount(table.bucketCount(), threads);
+            std::vector<std::unordered_map<std::string, GradeSummary>> partial(numWorkers);
+            parallelForSlots(table, numWorkers, profileWorkers(profile, numWorkers, [&](unsigned worker, size_t first, size_t last)
+                                                               {
+                auto &groupGrades = partial[worker];
+                size_t items = 0;
+                table.forEachInRange(first, last, [&groupGrades, &items](int, const std::shared_ptr<const Student> &student)
+                                     {
+                    groupGrades[student->getGroupIndex()].merge(summarizeGrades(*student));
+                    ++items; });
+                return items; }));
+
+            std::map<std::string, GradeSummary> groupGrades;
+            for (const auto &local : partial)
             {
-                double sum = std::accumulate(grades.begin(), grades.end(), 0.0);
-                averages[group] = sum / grades.size();
+                for (const auto &[group, grades] : local)
+                {
+                    groupGrades[group].merge(grades);
+                }
+            }
+            for (const auto &[group, grades] : groupGrades)
+            {
+                if (grades.count != 0)
+                {
+                    averages[group] = grades.average();
+                }
             }
         }
-
+        if (profile != nullptr)
+        {
+            profile->wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
         return averages;
     }
 
-    std::map<std::string, double> Controller::calculateAverageGradesByGroupMultithreaded()
+    GroupingCube Controller::averageGradesCube(const StudentTable &table, const std::vector<GroupingDimension> &groupingSets)
     {
-        std::lock_guard<std::mutex> lock(tableMutex_);
 
-        // Сгруппировать студентов по группам
-        std::map<std::string, std::vector<const Student*>> groupMap;
-        for (auto it = studentTable_.begin(); it != studentTable_.end(); ++it)
+        // Локальное состояние потока: словари кодов и самый детальный срез
+        struct WorkerCuboid
         {
-            auto pair = *it;
-            groupMap[pair.second->getGroupIndex()].push_back(pair.second.get());
-        }
+            std::unordered_map<int, uint32_t> departmentCodes;
+            std::unordered_map<std::string, uint32_t> groupCodes;
+            std::unordered_map<uint64_t, GroupAggregate> cells;
+        };
 
-        std::map<std::string, double> averages;
-        std::mutex averagesMutex;
+        unsigned numWorkers = effectiveWorkerCount(table.bucketCount(), 0);
+        std::vector<WorkerCuboid> workers(numWorkers);
 
-        // Получить количество потоков (ядер)
-        unsigned int numThreads = std::thread::hardware_concurrency();
-        if (numThreads == 0) numThreads = 4; // fallback
+        parallelForSlots(table, numWorkers, [&](unsigned worker, size_t first, size_t last)
+                         {
+            auto &local = workers[worker];
+            table.forEachInRange(first, last, [&local](int, const std::shared_ptr<const Student> &student)
+                                         {
+                auto department = local.departmentCodes.try_emplace(student->getDepartmentNumber(),
+                                                                    static_cast<uint32_t>(local.departmentCodes.size())).first->second;
+                auto group = local.groupCodes.try_emplace(student->getGroupIndex(),
+                                                          static_cast<uint32_t>(local.groupCodes.size())).first->second;
+                auto category = static_cast<uint64_t>(student->getCategory());
+                uint64_t key = (static_cast<uint64_t>(department) << 34) | (category << 32) | group;
 
-        // Собрать все группы в вектор
-        std::vector<std::string> allGroups;
-        for (const auto& [group, _] : groupMap) allGroups.push_back(group);
+                auto &cell = local.cells[key];
+                cell.students += 1;
+                cell.grades.merge(summarizeGrades(*student)); }); });
 
-        size_t groupsPerThread = (allGroups.size() + numThreads - 1) / numThreads;
+        // Глобальные словари: отсортированные значения, код — позиция в словаре
+        std::set<int> departmentSet;
+        std::set<std::string> groupSet;
+        for (const auto &local : workers)
+        {
+            for (const auto &[department, _] : local.departmentCodes) departmentSet.insert(department);
+            for (const auto &[group, _] : local.groupCodes) groupSet.insert(group);
+        }
+        GroupingCube cube(std::vector<int>(departmentSet.begin(), departmentSet.end()),
+                          std::vector<std::string>(groupSet.begin(), groupSet.end()));
 
-        std::vector<std::future<void>> futures;
-        for (unsigned int t = 0; t < numThreads; ++t)
+        for (auto dimensions : groupingSets)
         {
-            size_t start = t * groupsPerThread;
-            size_t end = std::min(start + groupsPerThread, allGroups.size());
-            futures.emplace_back(std::async(std::launch::async, [&, start, end]() {
-                for (size_t i = start; i < end; ++i)
+            cube.addSet(dimensions);
+        }
+
+        // Сворачиваем локальные детальные срезы во все запрошенные наборы;
+        // ячейки срезов по нескольким измерениям копятся в словарях только для встреченных кодов
+        std::vector<std::unordered_map<size_t, GroupAggregate>> sparse(groupingSets.size());
+        for (const auto &local : workers)
+        {
+            std::vector<uint32_t> departmentRemap(local.departmentCodes.size());
+            for (const auto &[department, code] : local.departmentCodes)
+            {
+                auto position = std::lower_bound(cube.departments().begin(), cube.departments().end(), department);
+                departmentRemap[code] = static_cast<uint32_t>(position - cube.departments().begin());
+            }
+            std::vector<uint32_t> groupRemap(local.groupCodes.size());
+            for (const auto &[group, code] : local.groupCodes)
+            {
+                auto position = std::lower_bound(cube.groups().begin(), cube.groups().end(), group);
+                groupRemap[code] = static_cast<uint32_t>(position - cube.groups().begin());
+            }
+
+            for (const auto &[key, aggregate] : local.cells)
+            {
+                uint32_t department = departmentRemap[key >> 34];
+                auto category = static_cast<uint32_t>((key >> 32) & 0x3);
+                uint32_t group = groupRemap[key & 0xFFFFFFFFu];
+                for (size_t i = 0; i < groupingSets.size(); ++i)
                 {
-                    const auto& group = allGroups[i];
-                    const auto& students = groupMap[group];
-                    std::vector<double> grades;
-                    for (const auto* student : students)
+                    auto &set = cube.setAt(i);
+                    size_t code = cube.encode(set.dimensions, department, category, group);
+                    if (GroupingSetResult::isDense(set.dimensions))
                     {
-                        switch (student->getCategory())
-                        {
-                        case StudentCategory::JUNIOR:
-                        {
-                            const auto& junior = dynamic_cast<const JuniorStudent&>(*student);
-                            for (int grade : junior.getSessionGrades())
-                                grades.push_back(static_cast<double>(grade));
-                            break;
-                        }
-                        case StudentCategory::SENIOR:
-                        {
-                            const auto& senior = dynamic_cast<const SeniorStudent&>(*student);
-                            for (int grade : senior.getSessionGrades())
-                                grades.push_back(static_cast<double>(grade));
-                            const auto& work = senior.getResearchWork();
-                            grades.push_back(static_cast<double>(work.supervisorGrade));
-                            grades.push_back(static_cast<double>(work.commissionGrade));
-                            break;
-                        }
-                        case StudentCategory::GRADUATE:
-                        {
-                            const auto& graduate = dynamic_cast<const GraduateStudent&>(*student);
-                            const auto& project = graduate.getDiplomaProject();
-                            grades.push_back(static_cast<double>(project.supervisorGrade));
-                            grades.push_back(static_cast<double>(project.reviewerGrade));
-                            grades.push_back(static_cast<double>(project.stateCommissionGrade));
-                            break;
-                        }
-                        default:
-                            break;
-                        }
+                        set.cells[code].merge(aggregate);
                     }
-                    if (!grades.empty())
+                    else
                     {
-                        double sum = std::accumulate(grades.begin(), grades.end(), 0.0);
-                        double average = sum / grades.size();
-                        std::lock_guard<std::mutex> averagesLock(averagesMutex);
-                        averages[group] = average;
+                        sparse[i][code].merge(aggregate);
                     }
                 }
-            }));
+            }
         }
-        for (auto& future : futures) future.wait();
-        return averages;
+        for (size_t i = 0; i < groupingSets.size(); ++i)
+        {
+            auto &cells = cube.setAt(i).sparseCells;
+            cells.assign(sparse[i].begin(), sparse[i].end());
+            std::sort(cells.begin(), cells.end(), [](const auto &lhs, const auto &rhs)
+                      { return lhs.first < rhs.first; });
+        }
+
+        return cube;
+    }
+
+    std::vector<RankedStudent> Controller::topStudentsByAverage(const StudentTable &table, size_t k)
+    {
+
+        unsigned numWorkers = effectiveWorkerCount(table.bucketCount(), 0);
+        std::vector<TopKHeap> heaps(numWorkers, TopKHeap(k));
+
+        parallelForSlots(table, numWorkers, [&](unsigned worker, size_t first, size_t last)
+                         {
+            auto &heap = heaps[worker];
+            table.forEachInRange(first, last, [&heap](int id, const std::shared_ptr<const Student> &student)
+                                         {
+                auto grades = summarizeGrades(*student);
+                if (grades.count != 0)
+                {
+                    heap.push({id, grades.average()});
+                } }); });
+
+        TopKHeap result(k);
+        for (const auto &heap : heaps)
+        {
+            result.merge(heap);
+        }
+        return result.sorted();
+    }
+
+    std::map<std::string, std::vector<RankedStudent>> Controller::topStudentsByAverageByGroup(const StudentTable &table, size_t k)
+    {
+
+        unsigned numWorkers = effectiveWorkerCount(table.bucketCount(), 0);
+        std::vector<std::unordered_map<std::string, TopKHeap>> heaps(numWorkers);
+
+        parallelForSlots(table, numWorkers, [&](unsigned worker, size_t first, size_t last)
+                         {
+            auto &local = heaps[worker];
+            table.forEachInRange(first, last, [&local, k](int id, const std::shared_ptr<const Student> &student)
+                                         {
+                auto grades = summarizeGrades(*student);
+                if (grades.count != 0)
+                {
+                    local.try_emplace(student->getGroupIndex(), k).first->second.push({id, grades.average()});
+                } }); });
+
+        std::map<std::string, TopKHeap> merged;
+        for (const auto &local : heaps)
+        {
+            for (const auto &[group, heap] : local)
+            {
+                merged.try_emplace(group, k).first->second.merge(heap);
+            }
+        }
+
+        std::map<std::string, std::vector<RankedStudent>> result;
+        for (const auto &[group, heap] : merged)
+        {
+            result.emplace(group, heap.sorted());
+        }
+        return result;
+    }
+
+    std::map<std::string, double> Controller::calculateAverageGradesByGroup()
+    {
+        OperationScope operation(Operation::AVERAGES);
+        controllerMetrics().aggregations.add();
+        auto snapshot = takeSnapshot();
+        if (snapshot.mapped())
+        {
+            return averageGradesByGroup(*snapshot.mapped(), 1);
+        }
+        return averageGradesByGroup(snapshot.table());
+    }
+
+    GroupingCube Controller::calculateAverageGradesCube(const std::vector<GroupingDimension> &groupingSets)
+    {
+        OperationScope operation(Operation::AVERAGES_CUBE);
+        controllerMetrics().aggregations.add();
+        auto snapshot = takeSnapshot();
+        return averageGradesCube(inMemoryTable(snapshot), groupingSets);
+    }
+
+    std::vector<RankedStudent> Controller::calculateTopStudentsByAverage(size_t k)
+    {
+        OperationScope operation(Operation::TOP_STUDENTS);
+        controllerMetrics().aggregations.add();
+        auto snapshot = takeSnapshot();
+        return topStudentsByAverage(inMemoryTable(snapshot), k);
+    }
+
+    std::map<std::string, std::vector<RankedStudent>> Controller::calculateTopStudentsByAverageByGroup(size_t k)
+    {
+        OperationScope operation(Operation::TOP_STUDENTS_BY_GROUP);
+        controllerMetrics().aggregations.add();
+        auto snapshot = takeSnapshot();
+        return topStudentsByAverageByGroup(inMemoryTable(snapshot), k);
+    }
+
+    template <typename Result, typename Compute>
+    std::shared_ptr<const Result> Controller::cachedQuery(const std::string &key, Compute compute)
+    {
+        if (auto cached = queryCache_.find<Result>(key, getTableVersion()))
+        {
+            return cached;
+        }
+        auto snapshot = takeSnapshot();
+        return queryCache_.getOrCompute<Result>(key, snapshot.version(), [&snapshot, &compute]()
+                                                {
+            controllerMetrics().aggregations.add();
+            return compute(snapshot); });
+    }
+
+    std::shared_ptr<const std::map<std::string, double>> Controller::getAverageGradesByGroupCached()
+    {
+        OperationScope operation(Operation::AVERAGES_CACHED);
+        return cachedQuery<std::map<std::string, double>>("avg_by_group", [](const StudentSnapshot &snapshot)
+                                                          { return snapshot.mapped() ? averageGradesByGroup(*snapshot.mapped(), 0) : averageGradesByGroup(snapshot.table()); });
+    }
+
+    std::shared_ptr<const GroupingCube> Controller::getAverageGradesCubeCached(const std::vector<GroupingDimension> &groupingSets)
+    {
+        OperationScope operation(Operation::AVERAGES_CUBE_CACHED);
+        std::string key = "cube";
+        for (auto dimensions : groupingSets)
+        {
+            key += ':';
+            key += std::to_string(static_cast<unsigned>(dimensions));
+        }
+        return cachedQuery<GroupingCube>(key, [&groupingSets](const StudentSnapshot &snapshot)
+                                         { return averageGradesCube(inMemoryTable(snapshot), groupingSets); });
+    }
+
+    std::shared_ptr<const std::vector<RankedStudent>> Controller::getTopStudentsByAverageCached(size_t k)
+    {
+        OperationScope operation(Operation::TOP_STUDENTS_CACHED);
+        return cachedQuery<std::vector<RankedStudent>>("top_k:" + std::to_string(k), [k](const StudentSnapshot &snapshot)
+                                                       { return topStudentsByAverage(inMemoryTable(snapshot), k); });
+    }
+
+    std::shared_ptr<const std::map<std::string, std::vector<RankedStudent>>> Controller::getTopStudentsByAverageByGroupCached(size_t k)
+    {
+        OperationScope operation(Operation::TOP_STUDENTS_BY_GROUP_CACHED);
+        return cachedQuery<std::map<std::string, std::vector<RankedStudent>>>(
+            "top_k_by_group:" + std::to_string(k), [k](const StudentSnapshot &snapshot)
+            { return topStudentsByAverageByGroup(inMemoryTable(snapshot), k); });
+    }
+
+    QueryCacheStats Controller::getQueryCacheStats() const
+    {
+        return queryCache_.stats();
     }
 
     void Controller::modifyResearchWork()
     {
         int id = view_.getStudentId();
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        auto student = studentTable_.find(id);
-        if (!student)
+        std::optional<StudentCategory> category;
+        visitStudent(id, [&category](const Student &student)
+                     { category = student.getCategory(); });
+        if (!category)
         {
             view_.showMessage("Студент с ID " + std::to_string(id) + " не найден.");
             return;
         }
 
-        if (student->get()->getCategory() != StudentCategory::SENIOR)
+        if (*category != StudentCategory::SENIOR)
         {
             view_.showMessage("Только старшекурсники могут иметь исследовательскую работу.");
             return;
         }
 
-        auto &senior = dynamic_cast<SeniorStudent &>(*student->get());
+        // Ввод выполняется до захвата блокировки на запись
         ResearchWork newWork = view_.getNewResearchWork();
-        senior.setResearchWork(newWork);
-        view_.showMessage("Исследовательская работа успешно изменена.");
+        if (setStudentResearchWork(id, newWork))
+        {
+            view_.showMessage("Исследовательская работа успешно изменена.");
+        }
+        else
+        {
+            view_.showMessage("Студент с ID " + std::to_string(id) + " не найден или не является старшекурсником.");
+        }
+    }
+
+    int Controller::insertStudent(std::unique_ptr<Student> student)
+    {
+        OperationScope operation(Operation::INSERT);
+        if (!student)
+        {
+            throw std::invalid_argument("Студент не может быть пустым.");
+        }
+        std::shared_ptr<const Student> record = std::move(student);
+        PendingCommit pending;
+        int id = 0;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+            id = nextId_;
+            auto &table = beginWrite();
+            table.reserve(table.size() + 1);
+            pending = logMutation(storage::WalEntry::put(id, record));
+            table.insert(id, std::move(record));
+            ++nextId_;
+            controllerMetrics().tableSize.set(static_cast<int64_t>(table.size()));
+        }
+        controllerMetrics().added.add();
+        commitMutation(pending);
+        return id;
+    }
+
+    int Controller::insertStudents(std::vector<std::unique_ptr<Student>> students)
+    {
+        OperationScope operation(Operation::INSERT_BATCH);
+        std::vector<std::shared_ptr<const Student>> records;
+        records.reserve(students.size());
+        for (auto &student : students)
+        {
+            if (!student)
+            {
+                throw std::invalid_argument("Студент не может быть пустым.");
+            }
+            records.push_back(std::move(student));
+        }
+
+        PendingCommit pending;
+        int firstId = 0;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+            firstId = nextId_;
+            if (records.empty())
+            {
+                return firstId;
+            }
+            auto &table = beginWrite();
+            table.reserve(table.size() + records.size());
+            std::vector<storage::WalEntry> entries;
+            entries.reserve(records.size());
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                entries.push_back(storage::WalEntry::put(firstId + static_cast<int>(i), records[i]));
+            }
+            pending = logMutation(storage::WalEntry::batch(std::move(entries)));
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                table.insert(firstId + static_cast<int>(i), std::move(records[i]));
+            }
+            nextId_ += static_cast<int>(records.size());
+            controllerMetrics().tableSize.set(static_cast<int64_t>(table.size()));
+        }
+        controllerMetrics().added.add(records.size());
+        commitMutation(pending);
+        return firstId;
+    }
+
+    storage::CsvImportReport Controller::importCsv(const std::filesystem::path &path, const storage::CsvImportOptions &options)
+    {
+        OperationScope operation(Operation::IMPORT_CSV);
+        return storage::importStudentsCsv(path, options, [this](std::vector<std::unique_ptr<Student>> students)
+                                          { insertStudents(std::move(students)); });
+    }
+
+    storage::ExportReport Controller::exportStudents(const std::filesystem::path &path, const storage::ExportOptions &options) const
+    {
+        OperationScope operation(Operation::EXPORT_STUDENTS);
+        auto snapshot = takeSnapshot();
+        return storage::exportStudents(inMemoryTable(snapshot), path, options);
+    }
+
+    storage::ExportReport Controller::exportAverageGradesByGroup(const std::filesystem::path &path, const storage::ExportOptions &options)
+    {
+        OperationScope operation(Operation::EXPORT_AVERAGES);
+        return storage::exportGroupAverages(*getAverageGradesByGroupCached(), path, options);
+    }
+
+    bool Controller::eraseStudent(int id)
+    {
+        OperationScope operation(Operation::ERASE);
+        PendingCommit pending;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+            if (!studentTable_->find(id))
+            {
+                return false;
+            }
+            auto &table = beginWrite();
+            pending = logMutation(storage::WalEntry::remove(id));
+            table.remove(id);
+            controllerMetrics().tableSize.set(static_cast<int64_t>(table.size()));
+        }
+        controllerMetrics().removed.add();
+        commitMutation(pending);
+        return true;
     }
 
-    HashTable<int, std::unique_ptr<Student>>& Controller::getStudentTable()
+    bool Controller::setStudentGroup(int id, const std::string &groupIndex)
     {
-        return studentTable_;
+        OperationScope operation(Operation::SET_GROUP);
+        PendingCommit pending;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+            auto current = studentTable_->find(id);
+            if (!current)
+            {
+                return false;
+            }
+
+            // Опубликованная запись может читаться снимками, поэтому изменяем копию
+            auto updated = current->get()->clone();
+            updated->setGroupIndex(groupIndex);
+            auto &table = beginWrite();
+            pending = logMutation(storage::WalEntry::setGroup(id, groupIndex));
+            table.find(id)->get() = std::move(updated);
+        }
+        controllerMetrics().groupChanges.add();
+        commitMutation(pending);
+        return true;
+    }
+
+    bool Controller::setStudentResearchWork(int id, const ResearchWork &work)
+    {
+        OperationScope operation(Operation::SET_RESEARCH_WORK);
+        PendingCommit pending;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+            auto current = studentTable_->find(id);
+            if (!current || current->get()->getCategory() != StudentCategory::SENIOR)
+            {
+                return false;
+            }
+
+            auto updated = current->get()->clone();
+            dynamic_cast<SeniorStudent &>(*updated).setResearchWork(work);
+            auto &table = beginWrite();
+            pending = logMutation(storage::WalEntry::setResearchWork(id, work));
+            table.find(id)->get() = std::move(updated);
+        }
+        controllerMetrics().researchWorkChanges.add();
+        commitMutation(pending);
+        return true;
+    }
+
+    bool Controller::replaceStudent(int id, std::unique_ptr<Student> student)
+    {
+        OperationScope operation(Operation::REPLACE);
+        if (!student)
+        {
+            throw std::invalid_argument("Студент не может быть пустым.");
+        }
+        std::shared_ptr<const Student> record = std::move(student);
+        PendingCommit pending;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+            if (!studentTable_->find(id))
+            {
+                return false;
+            }
+            auto &table = beginWrite();
+            pending = logMutation(storage::WalEntry::put(id, record));
+            table.find(id)->get() = std::move(record);
+        }
+        controllerMetrics().transfers.add();
+        commitMutation(pending);
+        return true;
+    }
+
+    MutationBatchResult Controller::applyBatch(const std::vector<MutationCommand> &commands)
+    {
+        OperationScope operation(Operation::APPLY_BATCH);
+        MutationBatchResult batch;
+        batch.results.resize(commands.size());
+        // Записи, которые команды помещают в таблицу; для REMOVE остаются пустыми
+        std::vector<std::shared_ptr<const Student>> records(commands.size());
+        size_t added = 0, removed = 0, groupChanges = 0, researchWorkChanges = 0, transfers = 0;
+
+        PendingCommit pending;
+        {
+            auto lock = lockExclusive();
+            requireWritable();
+
+            // Состояние затронутых пакетом ID после уже проверенных команд; пустой указатель — студент удалён
+            std::unordered_map<int, std::shared_ptr<const Student>> staged;
+            auto current = [this, &staged](int id) -> const Student *
+            {
+                if (auto it = staged.find(id); it != staged.end())
+                {
+                    return it->second.get();
+                }
+                auto found = studentTable_->find(id);
+                return found ? found->get().get() : nullptr;
+            };
+
+            bool valid = true;
+            for (size_t i = 0; i < commands.size(); ++i)
+            {
+                const auto &command = commands[i];
+                auto &result = batch.results[i];
+                result.id = command.id;
+                if (command.type == MutationType::ADD || command.type == MutationType::REPLACE)
+                {
+                    if (!command.student)
+                    {
+                        result.status = MutationStatus::INVALID;
+                        valid = false;
+                        continue;
+                    }
+                }
+                if (command.type == MutationType::ADD)
+                {
+                    result.id = nextId_ + static_cast<int>(added++);
+                    records[i] = command.student;
+                    staged[result.id] = records[i];
+                    continue;
+                }
+
+                const Student *student = current(command.id);
+                if (student == nullptr)
+                {
+                    result.status = MutationStatus::NOT_FOUND;
+                    valid = false;
+                    continue;
+                }
+                switch (command.type)
+                {
+                case MutationType::REMOVE:
+                    ++removed;
+                    break;
+                case MutationType::SET_GROUP:
+                {
+                    auto updated = student->clone();
+                    updated->setGroupIndex(command.groupIndex);
+                    records[i] = std::move(updated);
+                    ++groupChanges;
+                    break;
+                }
+                case MutationType::SET_RESEARCH_WORK:
+                {
+                    if (student->getCategory() != StudentCategory::SENIOR)
+                    {
+                        result.status = MutationStatus::NOT_SENIOR;
+                        valid = false;
+                        continue;
+                    }
+                    auto updated = student->clone();
+                    dynamic_cast<SeniorStudent &>(*updated).setResearchWork(command.researchWork);
+                    records[i] = std::move(updated);
+                    ++researchWorkChanges;
+                    break;
+                }
+                case MutationType::REPLACE:
+                    records[i] = command.student;
+                    ++transfers;
+                    break;
+                case MutationType::ADD:
+                    break;
+                }
+                staged[command.id] = records[i];
+            }
+
+            if (!valid)
+            {
+                for (size_t i = 0; i < commands.size(); ++i)
+                {
+                    if (commands[i].type == MutationType::ADD)
+                    {
+                        batch.results[i].id = 0;
+                    }
+                }
+                return batch;
+            }
+
+            auto &table = beginWrite();
+            table.reserve(table.size() + added);
+            std::vector<storage::WalEntry> entries;
+            entries.reserve(commands.size());
+            for (size_t i = 0; i < commands.size(); ++i)
+            {
+                const auto &command = commands[i];
+                int id = batch.results[i].id;
+                switch (command.type)
+                {
+                case MutationType::ADD:
+                case MutationType::REPLACE:
+                    entries.push_back(storage::WalEntry::put(id, records[i]));
+                    break;
+                case MutationType::REMOVE:
+                    entries.push_back(storage::WalEntry::remove(id));
+                    break;
+                case MutationType::SET_GROUP:
+                    entries.push_back(storage::WalEntry::setGroup(id, command.groupIndex));
+                    break;
+                case MutationType::SET_RESEARCH_WORK:
+                    entries.push_back(storage::WalEntry::setResearchWork(id, command.researchWork));
+                    break;
+                }
+            }
+            // Одна запись журнала: после сбоя пакет восстанавливается целиком или не восстанавливается
+            pending = logMutation(storage::WalEntry::batch(std::move(entries)));
+
+            for (size_t i = 0; i < commands.size(); ++i)
+            {
+                int id = batch.results[i].id;
+                switch (commands[i].type)
+                {
+                case MutationType::ADD:
+                    table.insert(id, std::move(records[i]));
+                    break;
+                case MutationType::REMOVE:
+                    table.remove(id);
+                    break;
+                default:
+                    table.find(id)->get() = std::move(records[i]);
+                    break;
+                }
+                batch.results[i].status = MutationStatus::APPLIED;
+            }
+            nextId_ += static_cast<int>(added);
+            batch.applied = true;
+            controllerMetrics().tableSize.set(static_cast<int64_t>(table.size()));
+        }
+        auto &counters = controllerMetrics();
+        counters.added.add(added);
+        counters.removed.add(removed);
+        counters.groupChanges.add(groupChanges);
+        counters.researchWorkChanges.add(researchWorkChanges);
+        counters.transfers.add(transfers);
+        commitMutation(pending);
+        return batch;
+    }
+
+    Controller::PendingCommit Controller::logMutation(const storage::WalEntry &entry)
+    {
+        if (!wal_)
+        {
+            return {};
+        }
+        return {wal_, wal_->append(entry)};
+    }
+
+    void Controller::commitMutation(const PendingCommit &pending)
+    {
+        if (pending.wal)
+        {
+            UNIVERSITY_TRACE_SCOPE("wal", "commit");
+            pending.wal->commit(pending.lsn);
+        }
+    }
+
+    StudentTable& Controller::getStudentTable()
+    {
+        auto lock = lockExclusive();
+        return beginWrite();
+    }
+
+    StudentSnapshot Controller::takeSnapshot() const
+    {
+        auto lock = lockShared();
+        return StudentSnapshot(studentTable_, version_, mappedRegistry_);
+    }
+
+    StudentCursor Controller::openStudentCursor() const
+    {
+        return StudentCursor(takeSnapshot());
+    }
+
+    void Controller::setPageSize(size_t pageSize)
+    {
+        pageSize_ = pageSize != 0 ? pageSize : std::numeric_limits<size_t>::max();
+    }
+
+    uint64_t Controller::getTableVersion() const
+    {
+        auto lock = lockShared();
+        return version_;
+    }
+
+    std::shared_ptr<const Student> Controller::getStudent(int id) const
+    {
+        OperationScope operation(Operation::FIND);
+        // Поиск под разделяемой блокировкой без снимка: ссылка на таблицу на время
+        // поиска заставила бы писателя, захватившего блокировку следом, копировать таблицу
+        auto lock = lockShared();
+        std::shared_ptr<const Student> student;
+        if (mappedRegistry_)
+        {
+            if (const auto *record = mappedRegistry_->find(id))
+            {
+                student = mappedRegistry_->materialize(*record);
+            }
+        }
+        else if (auto stored = studentTable_->find(id))
+        {
+            student = stored->get();
+        }
+        recordFind(student != nullptr);
+        return student;
+    }
+
+    StudentTable &Controller::beginWrite()
+    {
+        requireWritable();
+
+        // Таблицу удерживает снимок: копируем указатели на записи и изменяем копию
+        if (studentTable_.use_count() > 1)
+        {
+            studentTable_ = std::make_shared<StudentTable>(*studentTable_);
+            controllerMetrics().tableCopies.add();
+        }
+        ++version_;
+        return *studentTable_;
     }
 
     void Controller::clearStudentTable()
     {
-        std::lock_guard<std::mutex> lock(tableMutex_);
-        studentTable_ = HashTable<int, std::unique_ptr<Student>>(16);
+        auto lock = lockExclusive();
+        studentTable_ = std::make_shared<StudentTable>(16);
+        mappedRegistry_.reset();
+        detachStorage();
+        ++version_;
         nextId_ = 1;
+        controllerMetrics().tableSize.set(0);
+    }
+
+    std::unique_lock<std::shared_mutex> Controller::lockExclusive() const
+    {
+        auto &counters = controllerMetrics();
+        counters.exclusiveLocks.add();
+        std::unique_lock<std::shared_mutex> lock(tableMutex_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            UNIVERSITY_TRACE_SCOPE("lock", "wait_exclusive");
+            metrics::ScopedTimer wait(counters.exclusiveLockWait);
+            lock.lock();
+        }
+        return lock;
+    }
+
+    std::shared_lock<std::shared_mutex> Controller::lockShared() const
+    {
+        auto &counters = controllerMetrics();
+        counters.sharedLocks.add();
+        std::shared_lock<std::shared_mutex> lock(tableMutex_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            UNIVERSITY_TRACE_SCOPE("lock", "wait_shared");
+            metrics::ScopedTimer wait(counters.sharedLockWait);
+            lock.lock();
+        }
+        return lock;
+    }
+
+    void Controller::recordFind(bool found)
+    {
+        auto &counters = controllerMetrics();
+        (found ? counters.findHits : counters.findMisses).add();
+    }
+
+    metrics::Histogram &Controller::findLatency()
+    {
+        return *controllerMetrics().latency[static_cast<size_t>(Operation::FIND)];
+    }
+
+    const StudentTable &Controller::inMemoryTable(const StudentSnapshot &snapshot)
+    {
+        if (snapshot.mapped())
+        {
+            throw std::logic_error("Реестр открыт только для чтения.");
+        }
+        return snapshot.table();
+    }
+
+    void Controller::requireWritable() const
+    {
+        if (mappedRegistry_)
+        {
+            throw std::logic_error("Реестр открыт только для чтения.");
+        }
+    }
+
+    void Controller::save(const std::filesystem::path &path) const
+    {
+        OperationScope operation(Operation::SAVE);
+        std::shared_ptr<const StudentTable> table;
+        int nextId = 0;
+        {
+            auto lock = lockShared();
+            requireWritable();
+            table = studentTable_;
+            nextId = nextId_;
+        }
+        storage::writeSnapshot(path, *table, nextId);
+    }
+
+    void Controller::saveMapped(const std::filesystem::path &path) const
+    {
+        OperationScope operation(Operation::SAVE_MAPPED);
+        std::shared_ptr<const StudentTable> table;
+        int nextId = 0;
+        {
+            auto lock = lockShared();
+            requireWritable();
+            table = studentTable_;
+            nextId = nextId_;
+        }
+        storage::writeMappedRegistry(path, *table, nextId);
+    }
+
+    void Controller::openReadOnly(const std::filesystem::path &path)
+    {
+        OperationScope operation(Operation::OPEN_READ_ONLY);
+        auto mapped = std::make_shared<const storage::MappedRegistry>(path);
+
+        auto lock = lockExclusive();
+        studentTable_ = std::make_shared<StudentTable>(16);
+        mappedRegistry_ = std::move(mapped);
+        detachStorage();
+        ++version_;
+        nextId_ = mappedRegistry_->nextId();
+        controllerMetrics().tableSize.set(static_cast<int64_t>(mappedRegistry_->size()));
+    }
+
+    bool Controller::isReadOnly() const
+    {
+        auto lock = lockShared();
+        return mappedRegistry_ != nullptr;
+    }
+
+    void Controller::load(const std::filesystem::path &path)
+    {
+        OperationScope operation(Operation::LOAD);
+        auto contents = storage::readSnapshot(path);
+        auto table = std::make_shared<StudentTable>(std::move(contents.table));
+
+        auto lock = lockExclusive();
+        studentTable_ = std::move(table);
+        mappedRegistry_.reset();
+        detachStorage();
+        ++version_;
+        nextId_ = contents.nextId;
+        controllerMetrics().tableSize.set(static_cast<int64_t>(studentTable_->size()));
+    }
+
+    void Controller::openStorage(const std::filesystem::path &directory, storage::WalOptions options)
+    {
+        OperationScope operation(Operation::OPEN_STORAGE);
+        std::filesystem::create_directories(directory);
+        auto snapshotPath = directory / SNAPSHOT_FILE;
+        auto walPath = directory / WAL_FILE;
+
+        // Восстановление: контрольная точка, затем журнал поверх неё
+        storage::SnapshotContents contents{StudentTable(16), 1};
+        if (std::filesystem::exists(snapshotPath))
+        {
+            contents = storage::readSnapshot(snapshotPath);
+        }
+        storage::WriteAheadLog::replay(walPath, [&contents](const storage::WalEntry &entry)
+                                       { applyLogEntry(contents.table, contents.nextId, entry); });
+        auto table = std::make_shared<StudentTable>(std::move(contents.table));
+        auto wal = std::make_shared<storage::WriteAheadLog>(walPath, options);
+
+        auto lock = lockExclusive();
+        studentTable_ = std::move(table);
+        mappedRegistry_.reset();
+        ++version_;
+        nextId_ = contents.nextId;
+        wal_ = std::move(wal);
+        controllerMetrics().tableSize.set(static_cast<int64_t>(studentTable_->size()));
+        storageDirectory_ = directory;
+    }
+
+    void Controller::checkpoint()
+    {
+        OperationScope operation(Operation::CHECKPOINT);
+        std::shared_ptr<const StudentTable> table;
+        std::shared_ptr<storage::WriteAheadLog> wal;
+        std::filesystem::path directory;
+        int nextId = 0;
+        uint64_t lsn = 0;
+        {
+            // Таблица и позиция журнала берутся согласованно: изменения добавляют записи под блокировкой на запись
+            auto lock = lockShared();
+            if (!wal_)
+            {
+                throw std::logic_error("Хранилище реестра не открыто.");
+            }
+            table = studentTable_;
+            wal = wal_;
+            directory = storageDirectory_;
+            nextId = nextId_;
+            lsn = wal_->endLsn();
+        }
+
+        auto snapshotPath = directory / SNAPSHOT_FILE;
+        auto temporary = snapshotPath;
+        temporary += ".tmp";
+        storage::writeSnapshot(temporary, *table, nextId);
+        storage::syncPath(temporary);
+        std::filesystem::rename(temporary, snapshotPath);
+        storage::syncPath(directory);
+        wal->discardBefore(lsn);
+    }
+
+    storage::WalStats Controller::getWalStats() const
+    {
+        auto lock = lockShared();
+        return wal_ ? wal_->stats() : storage::WalStats{};
+    }
+
+    void Controller::detachStorage()
+    {
+        wal_.reset();
+        storageDirectory_.clear();
     }
 
-} // namespace university
\ No newline at end of file
+} // namespace university
@@ -0,0 +1,113 @@
+#include "GroupingAggregation.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace university
+{
+
+    std::vector<GroupingDimension> allGroupingSets()
+    {
+        std::vector<GroupingDimension> sets;
+        for (unsigned mask = 0; mask < 8; ++mask)
+        {
+            sets.push_back(static_cast<GroupingDimension>(mask));
+        }
+        return sets;
+    }
+
+    const GroupAggregate *GroupingSetResult::find(size_t code) const
+    {
+        if (isDense(dimensions))
+        {
+            return code < cells.size() && cells[code].students != 0 ? &cells[code] : nullptr;
+        }
+        auto it = std::lower_bound(sparseCells.begin(), sparseCells.end(), code, [](const auto &cell, size_t value)
+                                   { return cell.first < value; });
+        return it != sparseCells.end() && it->first == code ? &it->second : nullptr;
+    }
+
+    GroupingCube::GroupingCube(std::vector<int> departments, std::vector<std::string> groups)
+        : departments_(std::move(departments)), groups_(std::move(groups)) {}
+
+    size_t GroupingCube::encode(GroupingDimension dimensions, uint32_t department, uint32_t category, uint32_t group) const
+    {
+        size_t code = 0;
+        if (hasDimension(dimensions, GroupingDimension::DEPARTMENT))
+        {
+            code = department;
+        }
+        if (hasDimension(dimensions, GroupingDimension::CATEGORY))
+        {
+            code = code * CATEGORY_COUNT + category;
+        }
+        if (hasDimension(dimensions, GroupingDimension::GROUP))
+        {
+            code = code * groups_.size() + group;
+        }
+        return code;
+    }
+
+    size_t GroupingCube::cellCount(GroupingDimension dimensions) const
+    {
+        size_t count = 1;
+        if (hasDimension(dimensions, GroupingDimension::DEPARTMENT))
+        {
+            count *= departments_.size();
+        }
+        if (hasDimension(dimensions, GroupingDimension::CATEGORY))
+        {
+            count *= CATEGORY_COUNT;
+        }
+        if (hasDimension(dimensions, GroupingDimension::GROUP))
+        {
+            count *= groups_.size();
+        }
+        return count;
+    }
+
+    GroupingKey GroupingCube::decode(GroupingDimension dimensions, size_t code) const
+    {
+        GroupingKey key;
+        if (hasDimension(dimensions, GroupingDimension::GROUP))
+        {
+            key.groupIndex = groups_[code % groups_.size()];
+            code /= groups_.size();
+        }
+        if (hasDimension(dimensions, GroupingDimension::CATEGORY))
+        {
+            key.category = static_cast<StudentCategory>(code % CATEGORY_COUNT);
+            code /= CATEGORY_COUNT;
+        }
+        if (hasDimension(dimensions, GroupingDimension::DEPARTMENT))
+        {
+            key.departmentNumber = departments_[code];
+        }
+        return key;
+    }
+
+    GroupingSetResult &GroupingCube::addSet(GroupingDimension dimensions)
+    {
+        GroupingSetResult set;
+        set.dimensions = dimensions;
+        if (GroupingSetResult::isDense(dimensions))
+        {
+            set.cells.resize(cellCount(dimensions));
+        }
+        sets_.push_back(std::move(set));
+        return sets_.back();
+    }
+
+    const GroupingSetResult &GroupingCube::rollup(GroupingDimension dimensions) const
+    {
+        for (const auto &set : sets_)
+        {
+            if (set.dimensions == dimensions)
+            {
+                return set;
+            }
+        }
+        throw std::out_of_range("Набор группировки не был запрошен.");
+    }
+
+} // namespace university
@@ -0,0 +1,47 @@
+#include "QueryCache.h"
+
+namespace university
+{
+
+    void QueryCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    QueryCacheStats QueryCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QueryCacheStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.entries = entries_.size();
+        return stats;
+    }
+
+    void QueryCache::store(const std::string &key, uint64_t version, std::shared_ptr<const void> result)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Результаты более старых версий больше никогда не будут выданы
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            if (it->second.version < version)
+            {
+                it = entries_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        auto &entry = entries_[key];
+        if (entry.result == nullptr || entry.version <= version)
+        {
+            entry.version = version;
+            entry.result = std::move(result);
+        }
+    }
+
+} // namespace university
@@ -0,0 +1,71 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+namespace university
+{
+
+    WorkerPool::WorkerPool(unsigned threads)
+    {
+        unsigned count = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        threads_.reserve(count);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            threads_.emplace_back(&WorkerPool::work, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void WorkerPool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        ready_.notify_one();
+    }
+
+    void WorkerPool::waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this]()
+                   { return tasks_.empty() && running_ == 0; });
+    }
+
+    void WorkerPool::work()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            ready_.wait(lock, [this]()
+                        { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty())
+            {
+                return; // Останавливаемся только после выполнения всей очереди
+            }
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++running_;
+            lock.unlock();
+            task();
+            lock.lock();
+            --running_;
+            if (tasks_.empty() && running_ == 0)
+            {
+                idle_.notify_all();
+            }
+        }
+    }
+
+} // namespace university
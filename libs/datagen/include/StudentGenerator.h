@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Student.h"
+#include "StudentTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace university
+{
+    namespace datagen
+    {
+
+        /**
+         * @brief Количество студентов в одном подпотоке случайных чисел.
+         *
+         * Студенты с порядковыми номерами [k * GENERATOR_BLOCK_SIZE, (k + 1) * GENERATOR_BLOCK_SIZE)
+         * генерируются из подпотока с зерном, выведенным из (seed, k). Блок — единица
+         * работы потока, поэтому результат не зависит от числа потоков.
+         */
+        inline constexpr size_t GENERATOR_BLOCK_SIZE = 4096;
+
+        /**
+         * @struct GeneratorOptions
+         * @brief Настройки генерации.
+         */
+        struct GeneratorOptions
+        {
+            uint64_t seed = 42;   ///< Зерно; одинаковое зерно даёт одинаковых студентов
+            unsigned threads = 0; ///< Потоков генерации (0 — по числу ядер)
+        };
+
+        /**
+         * @class StudentGenerator
+         * @brief Последовательный генератор случайных студентов из одного подпотока.
+         *
+         * Использует xoshiro256** и собственное приведение к диапазону вместо
+         * std::uniform_int_distribution, чьи результаты зависят от реализации
+         * стандартной библиотеки: последовательность студентов определяется
+         * только зерном. Имена и индексы групп выбираются из заранее построенных
+         * таблиц, поэтому на студента не выполняется конкатенация строк.
+         */
+        class StudentGenerator
+        {
+        public:
+            /**
+             * @brief Конструирует генератор.
+             * @param seed Зерно подпотока.
+             */
+            explicit StudentGenerator(uint64_t seed);
+
+            /**
+             * @brief Создаёт следующего студента.
+             * @param id ID студента (определяет номер кафедры).
+             * @return Новый студент.
+             */
+            std::unique_ptr<Student> next(int id);
+
+            /**
+             * @brief Создаёт следующего студента как неизменяемую запись реестра.
+             *
+             * Объект и счётчик ссылок размещаются одним выделением памяти.
+             *
+             * @param id ID студента (определяет номер кафедры).
+             * @return Новая запись.
+             */
+            std::shared_ptr<const Student> nextRecord(int id);
+
+        private:
+            /**
+             * @brief Возвращает следующее 64-битное число подпотока.
+             */
+            uint64_t nextBits();
+
+            /**
+             * @brief Возвращает равномерно распределённое число из [0, bound).
+             */
+            uint32_t below(uint32_t bound);
+
+            /**
+             * @brief Создаёт студента через фабрику make(category, name, group, department, ...).
+             */
+            template <typename Make>
+            auto generate(int id, Make &&make);
+
+            uint64_t state_[4];
+        };
+
+        /**
+         * @brief Выводит зерно подпотока для блока студентов.
+         * @param seed Общее зерно генерации.
+         * @param block Номер блока.
+         * @return Зерно для StudentGenerator.
+         */
+        uint64_t blockSeed(uint64_t seed, size_t block);
+
+        /**
+         * @brief Параллельно генерирует студентов с ID firstId, firstId + 1, ...
+         *
+         * Вектор результата выделяется заранее, и каждый поток заполняет свои
+         * блоки на месте. Результат определяется зерном и не зависит от числа потоков.
+         *
+         * @param count Количество студентов.
+         * @param firstId ID первого студента.
+         * @param options Настройки генерации.
+         * @return Студенты в порядке ID.
+         */
+        std::vector<std::unique_ptr<Student>> generateStudents(size_t count, int firstId = 1, const GeneratorOptions &options = {});
+
+        /**
+         * @brief Заполняет таблицу студентами с ID 1..count.
+         *
+         * Записи генерируются параллельно в заранее выделенный вектор, после
+         * чего таблица резервирует ёмкость и загружается одним проходом без
+         * перехеширований. Таблица должна быть пустой.
+         *
+         * @param table Таблица для заполнения.
+         * @param count Количество студентов.
+         * @param options Настройки генерации.
+         */
+        void populateTable(StudentTable &table, size_t count, const GeneratorOptions &options = {});
+
+    } // namespace datagen
+} // namespace university
@@ -0,0 +1,290 @@
+#include "StudentGenerator.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+#include <algorithm>
+#include <array>
+#include <future>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace university
+{
+    namespace datagen
+    {
+        namespace
+        {
+            constexpr std::array<std::string_view, 30> SURNAMES = {
+                "Иванов", "Петров", "Сидоров", "Козлов", "Новиков", "Морозов", "Петренко", "Иваненко",
+                "Шевченко", "Бондаренко", "Мельник", "Романенко", "Павленко", "Марченко", "Ткаченко",
+                "Романюк", "Василенко", "Полтавец", "Кравченко", "Олейник", "Бондарь", "Мазепа", "Тарасенко",
+                "Лисенко", "Мельниченко", "Дмитренко", "Коваленко", "Шевчук", "Бондарчук", "Пономаренко"};
+            constexpr std::array<std::string_view, 32> FIRST_NAMES = {
+                "Александр", "Дмитрий", "Максим", "Сергей", "Андрей", "Алексей", "Артём", "Илья",
+                "Кирилл", "Михаил", "Никита", "Матвей", "Роман", "Егор", "Арсений", "Владислав",
+                "Денис", "Степан", "Владимир", "Данил", "Евгений", "Тимофей", "Владислав", "Игорь",
+                "Артём", "Руслан", "Виталий", "Николай", "Павел", "Ростислав", "Глеб", "Константин"};
+            constexpr std::array<std::string_view, 5> FACULTIES = {"IU", "IT", "IB", "IM", "IE"};
+            constexpr std::array<std::string_view, 5> GROUP_LETTERS = {"A", "B", "C", "D", "E"};
+            constexpr int COURSES = 5;
+            constexpr int GROUP_NUMBERS = 99;
+
+            constexpr std::array<std::string_view, 10> RESEARCH_TOPICS = {
+                "Разработка системы управления базами данных",
+                "Анализ алгоритмов машинного обучения",
+                "Создание веб-приложения для электронной коммерции",
+                "Исследование методов криптографической защиты",
+                "Разработка мобильного приложения для здравоохранения",
+                "Анализ больших данных в социальных сетях",
+                "Создание системы искусственного интеллекта",
+                "Разработка облачной платформы",
+                "Исследование методов компьютерного зрения",
+                "Создание системы интернета вещей"};
+            constexpr std::array<std::string_view, 23> RESEARCH_PLACES = {
+                "Google", "Microsoft", "Apple", "Amazon", "Meta", "Netflix", "Uber", "Airbnb",
+                "Spotify", "Twitter", "LinkedIn", "Salesforce", "Adobe", "Oracle", "IBM",
+                "Intel", "NVIDIA", "AMD", "Cisco", "VMware", "Dell", "HP", "Lenovo"};
+            constexpr std::array<std::string_view, 10> DIPLOMA_TOPICS = {
+                "Исследование квантовых алгоритмов для оптимизации",
+                "Разработка новых методов глубокого обучения",
+                "Анализ сложности алгоритмов в теории графов",
+                "Создание систем распределённого искусственного интеллекта",
+                "Исследование методов защиты от кибератак",
+                "Разработка алгоритмов для обработки естественного языка",
+                "Анализ эффективности параллельных вычислений",
+                "Создание систем компьютерного зрения для робототехники",
+                "Исследование методов сжатия данных",
+                "Разработка алгоритмов для биоинформатики"};
+            constexpr std::array<std::string_view, 23> DIPLOMA_PLACES = {
+                "MIT", "Stanford", "Harvard", "Berkeley", "CMU", "Princeton", "Yale", "Columbia",
+                "UCLA", "UCSD", "Georgia Tech", "UIUC", "UMich", "UW", "UT Austin", "Cornell",
+                "Brown", "Dartmouth", "UPenn", "Northwestern", "Duke", "Vanderbilt", "Rice"};
+
+            /**
+             * @brief Полные имена «фамилия имя» для всех сочетаний, строятся один раз.
+             */
+            const std::vector<std::string> &fullNames()
+            {
+                static const std::vector<std::string> names = []()
+                {
+                    std::vector<std::string> result;
+                    result.reserve(SURNAMES.size() * FIRST_NAMES.size());
+                    for (auto surname : SURNAMES)
+                    {
+                        for (auto firstName : FIRST_NAMES)
+                        {
+                            std::string name;
+                            name.reserve(surname.size() + 1 + firstName.size());
+                            name.append(surname).append(" ").append(firstName);
+                            result.push_back(std::move(name));
+                        }
+                    }
+                    return result;
+                }();
+                return names;
+            }
+
+            /**
+             * @brief Индексы групп вида IU3-42B для всех сочетаний, строятся один раз.
+             */
+            const std::vector<std::string> &groupIndexes()
+            {
+                static const std::vector<std::string> groups = []()
+                {
+                    std::vector<std::string> result;
+                    result.reserve(FACULTIES.size() * COURSES * GROUP_NUMBERS * GROUP_LETTERS.size());
+                    for (auto faculty : FACULTIES)
+                    {
+                        for (int course = 1; course <= COURSES; ++course)
+                        {
+                            for (int number = 1; number <= GROUP_NUMBERS; ++number)
+                            {
+                                for (auto letter : GROUP_LETTERS)
+                                {
+                                    std::string group(faculty);
+                                    group.append(std::to_string(course)).append("-").append(std::to_string(number)).append(letter);
+                                    result.push_back(std::move(group));
+                                }
+                            }
+                        }
+                    }
+                    return result;
+                }();
+                return groups;
+            }
+
+            uint64_t splitMix64(uint64_t &state)
+            {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+            }
+
+            constexpr uint64_t rotateLeft(uint64_t value, int shift)
+            {
+                return (value << shift) | (value >> (64 - shift));
+            }
+
+            /**
+             * @brief Выполняет fn(block) для всех блоков, распределяя их между потоками.
+             */
+            template <typename Fn>
+            void forEachBlock(size_t count, unsigned requestedThreads, Fn &&fn)
+            {
+                size_t blocks = (count + GENERATOR_BLOCK_SIZE - 1) / GENERATOR_BLOCK_SIZE;
+                unsigned threads = requestedThreads != 0 ? requestedThreads : std::max(1u, std::thread::hardware_concurrency());
+                threads = static_cast<unsigned>(std::min<size_t>(threads, blocks));
+                auto work = [&](unsigned worker)
+                {
+                    // Блоки чередуются между потоками: соседние блоки стоят одинаково
+                    for (size_t block = worker; block < blocks; block += threads)
+                    {
+                        fn(block);
+                    }
+                };
+                std::vector<std::future<void>> futures;
+                for (unsigned worker = 1; worker < threads; ++worker)
+                {
+                    futures.push_back(std::async(std::launch::async, work, worker));
+                }
+                if (threads != 0)
+                {
+                    work(0);
+                }
+                for (auto &future : futures)
+                {
+                    future.get();
+                }
+            }
+
+        } // namespace
+
+        StudentGenerator::StudentGenerator(uint64_t seed)
+        {
+            for (auto &word : state_)
+            {
+                word = splitMix64(seed);
+            }
+        }
+
+        uint64_t StudentGenerator::nextBits()
+        {
+            // xoshiro256**
+            uint64_t result = rotateLeft(state_[1] * 5, 7) * 9;
+            uint64_t t = state_[1] << 17;
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+            state_[2] ^= t;
+            state_[3] = rotateLeft(state_[3], 45);
+            return result;
+        }
+
+        uint32_t StudentGenerator::below(uint32_t bound)
+        {
+            // Умножение на границу вместо деления; смещение не превышает bound / 2^32
+            return static_cast<uint32_t>(((nextBits() >> 32) * bound) >> 32);
+        }
+
+        template <typename Make>
+        auto StudentGenerator::generate(int id, Make &&make)
+        {
+            const auto &names = fullNames();
+            const auto &groups = groupIndexes();
+            auto category = static_cast<StudentCategory>(below(3));
+            const std::string &name = names[below(static_cast<uint32_t>(names.size()))];
+            const std::string &group = groups[below(static_cast<uint32_t>(groups.size()))];
+            int department = 100 + (id % 20);
+
+            auto grades = [this](size_t count)
+            {
+                std::vector<int> result(count);
+                for (int &grade : result)
+                {
+                    grade = 2 + static_cast<int>(below(4));
+                }
+                return result;
+            };
+            auto pick = [this](const auto &values)
+            {
+                return std::string(values[below(static_cast<uint32_t>(values.size()))]);
+            };
+
+            switch (category)
+            {
+            case StudentCategory::JUNIOR:
+                return make.template operator()<JuniorStudent>(name, group, department, grades(5));
+            case StudentCategory::SENIOR:
+            {
+                auto sessionGrades = grades(4);
+                ResearchWork work{3 + static_cast<int>(below(3)), 3 + static_cast<int>(below(3)), "", ""};
+                work.topic = pick(RESEARCH_TOPICS);
+                work.place = pick(RESEARCH_PLACES);
+                return make.template operator()<SeniorStudent>(name, group, department, std::move(sessionGrades), std::move(work));
+            }
+            default:
+            {
+                DiplomaProject project{3 + static_cast<int>(below(3)), 3 + static_cast<int>(below(3)), 3 + static_cast<int>(below(3)), "", ""};
+                project.topic = pick(DIPLOMA_TOPICS);
+                project.place = pick(DIPLOMA_PLACES);
+                return make.template operator()<GraduateStudent>(name, group, department, std::move(project));
+            }
+            }
+        }
+
+        std::unique_ptr<Student> StudentGenerator::next(int id)
+        {
+            return generate(id, []<typename T>(auto &&...args) -> std::unique_ptr<Student>
+                            { return std::make_unique<T>(std::forward<decltype(args)>(args)...); });
+        }
+
+        std::shared_ptr<const Student> StudentGenerator::nextRecord(int id)
+        {
+            return generate(id, []<typename T>(auto &&...args) -> std::shared_ptr<const Student>
+                            { return std::make_shared<T>(std::forward<decltype(args)>(args)...); });
+        }
+
+        uint64_t blockSeed(uint64_t seed, size_t block)
+        {
+            uint64_t state = seed ^ splitMix64(block);
+            return splitMix64(state);
+        }
+
+        std::vector<std::unique_ptr<Student>> generateStudents(size_t count, int firstId, const GeneratorOptions &options)
+        {
+            std::vector<std::unique_ptr<Student>> students(count);
+            forEachBlock(count, options.threads, [&](size_t block)
+                         {
+                StudentGenerator generator(blockSeed(options.seed, block));
+                size_t last = std::min(count, (block + 1) * GENERATOR_BLOCK_SIZE);
+                for (size_t i = block * GENERATOR_BLOCK_SIZE; i < last; ++i)
+                {
+                    students[i] = generator.next(firstId + static_cast<int>(i));
+                } });
+            return students;
+        }
+
+        void populateTable(StudentTable &table, size_t count, const GeneratorOptions &options)
+        {
+            std::vector<std::shared_ptr<const Student>> records(count);
+            forEachBlock(count, options.threads, [&](size_t block)
+                         {
+                StudentGenerator generator(blockSeed(options.seed, block));
+                size_t last = std::min(count, (block + 1) * GENERATOR_BLOCK_SIZE);
+                for (size_t i = block * GENERATOR_BLOCK_SIZE; i < last; ++i)
+                {
+                    records[i] = generator.nextRecord(static_cast<int>(i) + 1);
+                } });
+
+            table.reserve(table.size() + count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                table.insert(static_cast<int>(i) + 1, std::move(records[i]));
+            }
+        }
+
+    } // namespace datagen
+} // namespace university
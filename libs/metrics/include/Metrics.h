@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace university
+{
+    namespace metrics
+    {
+
+        /**
+         * @brief Количество сегментов счётчика: потоки пишут в разные строки кэша.
+         */
+        inline constexpr size_t SHARDS = 16;
+
+        /**
+         * @brief Получает сегмент текущего потока.
+         *
+         * Номер выдаётся потоку при первом обращении по кругу, поэтому
+         * одновременно работающие потоки (до SHARDS) не делят сегмент.
+         *
+         * @return Номер сегмента от 0 до SHARDS - 1.
+         */
+        size_t threadShard() noexcept;
+
+        /**
+         * @class Counter
+         * @brief Монотонный счётчик без блокировок, разделённый на сегменты по потокам.
+         */
+        class Counter
+        {
+        public:
+            /**
+             * @brief Увеличивает счётчик.
+             * @param amount Приращение.
+             */
+            void add(uint64_t amount = 1) noexcept
+            {
+                shards_[threadShard()].value.fetch_add(amount, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Получает сумму по всем сегментам.
+             */
+            [[nodiscard]] uint64_t value() const noexcept;
+
+        private:
+            struct alignas(64) Shard
+            {
+                std::atomic<uint64_t> value{0};
+            };
+            std::array<Shard, SHARDS> shards_;
+        };
+
+        /**
+         * @class Gauge
+         * @brief Текущее значение величины (например, размер таблицы).
+         */
+        class Gauge
+        {
+        public:
+            void set(int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+            [[nodiscard]] int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<int64_t> value_{0};
+        };
+
+        /**
+         * @class Histogram
+         * @brief Гистограмма длительностей с корзинами по степеням двойки, разделённая на сегменты по потокам.
+         *
+         * Значения записываются в наносекундах; корзина k содержит значения
+         * не больше 2^(k + MIN_BUCKET_EXPONENT) нс (от 256 нс до ~550 с),
+         * большие значения попадают только в +Inf. Выгружается в секундах.
+         */
+        class Histogram
+        {
+        public:
+            static constexpr unsigned MIN_BUCKET_EXPONENT = 8;
+            static constexpr size_t BUCKETS = 32;
+
+            /**
+             * @struct Snapshot
+             * @brief Сумма сегментов гистограммы на момент чтения.
+             */
+            struct Snapshot
+            {
+                std::array<uint64_t, BUCKETS + 1> buckets{}; ///< Некумулятивные; последняя — больше верхней границы
+                uint64_t count = 0;
+                uint64_t sumNs = 0;
+            };
+
+            /**
+             * @brief Добавляет значение.
+             * @param ns Длительность в наносекундах.
+             */
+            void observe(uint64_t ns) noexcept;
+
+            /**
+             * @brief Получает номер корзины значения.
+             * @param ns Длительность в наносекундах.
+             * @return Номер от 0 до BUCKETS (BUCKETS — больше верхней границы последней корзины).
+             */
+            static size_t bucketIndex(uint64_t ns) noexcept;
+
+            /**
+             * @brief Получает верхнюю границу корзины.
+             * @param bucket Номер корзины меньше BUCKETS.
+             * @return Граница в наносекундах.
+             */
+            static uint64_t bucketUpperBoundNs(size_t bucket) noexcept { return uint64_t{1} << (bucket + MIN_BUCKET_EXPONENT); }
+
+            [[nodiscard]] Snapshot snapshot() const noexcept;
+
+        private:
+            struct alignas(64) Shard
+            {
+                std::array<std::atomic<uint64_t>, BUCKETS + 1> buckets{};
+                std::atomic<uint64_t> sumNs{0};
+            };
+            std::array<Shard, SHARDS> shards_;
+        };
+
+        /**
+         * @class ScopedTimer
+         * @brief Записывает в гистограмму время от создания до уничтожения объекта.
+         */
+        class ScopedTimer
+        {
+        public:
+            explicit ScopedTimer(Histogram &histogram) noexcept
+                : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+            ~ScopedTimer()
+            {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                histogram_.observe(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+
+            ScopedTimer(const ScopedTimer &) = delete;
+            ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        private:
+            Histogram &histogram_;
+            std::chrono::steady_clock::time_point start_;
+        };
+
+        /**
+         * @class Registry
+         * @brief Реестр метрик процесса и их выгрузка в текстовом формате Prometheus.
+         *
+         * Регистрация выполняется под мьютексом и возвращает ссылку, действительную
+         * до конца работы процесса; повторная регистрация того же имени и меток
+         * возвращает ту же метрику. Обновление метрик блокировок не требует,
+         * поэтому ссылки следует получать один раз и хранить.
+         */
+        class Registry
+        {
+        public:
+            /**
+             * @brief Регистрирует счётчик.
+             * @param name Имя метрики, например "university_students_added_total".
+             * @param help Описание для строки # HELP.
+             * @param labels Метки без фигурных скобок, например "result=\"hit\"", или пустая строка.
+             * @return Счётчик.
+             */
+            Counter &counter(const std::string &name, const std::string &help, const std::string &labels = "");
+
+            /**
+             * @brief Регистрирует величину.
+             * @param name Имя метрики.
+             * @param help Описание.
+             * @param labels Метки или пустая строка.
+             * @return Величина.
+             */
+            Gauge &gauge(const std::string &name, const std::string &help, const std::string &labels = "");
+
+            /**
+             * @brief Регистрирует гистограмму длительностей (выгружается в секундах).
+             * @param name Имя метрики, например "university_operation_duration_seconds".
+             * @param help Описание.
+             * @param labels Метки или пустая строка.
+             * @return Гистограмма.
+             */
+            Histogram &histogram(const std::string &name, const std::string &help, const std::string &labels = "");
+
+            /**
+             * @brief Записывает все метрики в текстовом формате Prometheus 0.0.4.
+             * @param out Поток вывода.
+             */
+            void writePrometheus(std::ostream &out) const;
+
+            /**
+             * @brief Записывает метрики в файл атомарно: во временный файл рядом, затем переименование.
+             *
+             * Сборщик textfile у node exporter никогда не увидит файл наполовину записанным.
+             *
+             * @param path Путь к файлу (обычно с расширением .prom).
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void writePrometheus(const std::filesystem::path &path) const;
+
+        private:
+            enum class Type
+            {
+                COUNTER,
+                GAUGE,
+                HISTOGRAM
+            };
+
+            struct Entry
+            {
+                std::string name;
+                std::string help;
+                std::string labels;
+                Type type;
+                // Заполнен только указатель, соответствующий type
+                std::unique_ptr<Counter> counter;
+                std::unique_ptr<Gauge> gauge;
+                std::unique_ptr<Histogram> histogram;
+            };
+
+            Entry &find(const std::string &name, const std::string &help, const std::string &labels, Type type);
+
+            mutable std::mutex mutex_;
+            std::vector<Entry> entries_; // В порядке регистрации; метрики одного имени выводятся вместе
+        };
+
+        /**
+         * @brief Получает реестр метрик процесса.
+         */
+        Registry &registry();
+
+    } // namespace metrics
+} // namespace university
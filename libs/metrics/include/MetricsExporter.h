@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Metrics.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace university
+{
+    namespace metrics
+    {
+
+        /**
+         * @class MetricsExporter
+         * @brief Фоновая запись реестра метрик в файл для сборщика textfile у node exporter.
+         *
+         * Файл перезаписывается атомарно с заданным периодом, по сигналу,
+         * установленному installSignalHandler, и при уничтожении экспортёра.
+         * Сетевой службы в приложении нет: файл читает node exporter.
+         */
+        class MetricsExporter
+        {
+        public:
+            /**
+             * @brief Запускает фоновый поток записи.
+             * @param path Файл метрик (обычно в каталоге --collector.textfile.directory, расширение .prom).
+             * @param interval Период записи; 0 — только по сигналу и при уничтожении.
+             * @param source Реестр метрик.
+             */
+            MetricsExporter(std::filesystem::path path, std::chrono::milliseconds interval, Registry &source = registry());
+
+            /**
+             * @brief Останавливает поток и записывает итоговые значения.
+             */
+            ~MetricsExporter();
+
+            MetricsExporter(const MetricsExporter &) = delete;
+            MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+            /**
+             * @brief Немедленно записывает файл в вызывающем потоке.
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void dump();
+
+            /**
+             * @brief Получает количество записей файла.
+             */
+            [[nodiscard]] uint64_t dumps() const { return dumps_.load(); }
+
+            /**
+             * @brief Получает текст последней ошибки фоновой записи.
+             * @return Описание ошибки или пустая строка.
+             */
+            [[nodiscard]] std::string lastError() const;
+
+            /**
+             * @brief Запрашивает запись файла всеми экспортёрами; безопасна в обработчике сигнала.
+             */
+            static void requestDump() noexcept;
+
+            /**
+             * @brief Устанавливает обработчик сигнала, запрашивающий запись файла (например, SIGUSR1).
+             * @param signal Номер сигнала.
+             */
+            static void installSignalHandler(int signal);
+
+        private:
+            void run();
+
+            std::filesystem::path path_;
+            std::chrono::milliseconds interval_;
+            Registry &registry_;
+            std::atomic<uint64_t> dumps_{0};
+            uint64_t seenRequests_ = 0; // Последний обработанный номер запроса requestDump
+            mutable std::mutex mutex_;
+            std::condition_variable wake_;
+            bool stopping_ = false;
+            std::string lastError_;
+            std::thread thread_;
+        };
+
+    } // namespace metrics
+} // namespace university
@@ -0,0 +1,215 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace university
+{
+    namespace metrics
+    {
+        namespace
+        {
+            std::atomic<size_t> nextShard{0};
+
+            // Серия с метками: name{labels,extra} value
+            void writeSample(std::ostream &out, const std::string &name, const std::string &labels,
+                             const std::string &extra, const std::string &value)
+            {
+                out << name;
+                if (!labels.empty() || !extra.empty())
+                {
+                    out << '{' << labels << (!labels.empty() && !extra.empty() ? "," : "") << extra << '}';
+                }
+                out << ' ' << value << '\n';
+            }
+
+            std::string seconds(uint64_t ns)
+            {
+                std::ostringstream text;
+                text << std::setprecision(9) << static_cast<double>(ns) / 1e9;
+                return text.str();
+            }
+
+        } // namespace
+
+        size_t threadShard() noexcept
+        {
+            thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+            return shard;
+        }
+
+        uint64_t Counter::value() const noexcept
+        {
+            uint64_t sum = 0;
+            for (const auto &shard : shards_)
+            {
+                sum += shard.value.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        size_t Histogram::bucketIndex(uint64_t ns) noexcept
+        {
+            // Наименьшее k, при котором ns <= 2^(k + MIN_BUCKET_EXPONENT)
+            auto exponent = static_cast<size_t>(ns <= 1 ? 0 : std::bit_width(ns - 1));
+            return exponent <= MIN_BUCKET_EXPONENT ? 0 : std::min(exponent - MIN_BUCKET_EXPONENT, BUCKETS);
+        }
+
+        void Histogram::observe(uint64_t ns) noexcept
+        {
+            auto &shard = shards_[threadShard()];
+            shard.buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+            shard.sumNs.fetch_add(ns, std::memory_order_relaxed);
+        }
+
+        Histogram::Snapshot Histogram::snapshot() const noexcept
+        {
+            Snapshot result;
+            for (const auto &shard : shards_)
+            {
+                for (size_t bucket = 0; bucket <= BUCKETS; ++bucket)
+                {
+                    uint64_t count = shard.buckets[bucket].load(std::memory_order_relaxed);
+                    result.buckets[bucket] += count;
+                    result.count += count;
+                }
+                result.sumNs += shard.sumNs.load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        Registry::Entry &Registry::find(const std::string &name, const std::string &help, const std::string &labels, Type type)
+        {
+            for (auto &entry : entries_)
+            {
+                if (entry.name == name && entry.labels == labels)
+                {
+                    if (entry.type != type)
+                    {
+                        throw std::invalid_argument("Метрика " + name + " уже зарегистрирована с другим типом");
+                    }
+                    return entry;
+                }
+            }
+            Entry entry{name, help, labels, type, nullptr, nullptr, nullptr};
+            switch (type)
+            {
+            case Type::COUNTER:
+                entry.counter = std::make_unique<Counter>();
+                break;
+            case Type::GAUGE:
+                entry.gauge = std::make_unique<Gauge>();
+                break;
+            case Type::HISTOGRAM:
+                entry.histogram = std::make_unique<Histogram>();
+                break;
+            }
+            entries_.push_back(std::move(entry));
+            return entries_.back();
+        }
+
+        Counter &Registry::counter(const std::string &name, const std::string &help, const std::string &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return *find(name, help, labels, Type::COUNTER).counter;
+        }
+
+        Gauge &Registry::gauge(const std::string &name, const std::string &help, const std::string &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return *find(name, help, labels, Type::GAUGE).gauge;
+        }
+
+        Histogram &Registry::histogram(const std::string &name, const std::string &help, const std::string &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return *find(name, help, labels, Type::HISTOGRAM).histogram;
+        }
+
+        void Registry::writePrometheus(std::ostream &out) const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::set<std::string> written;
+            for (const auto &family : entries_)
+            {
+                // Серии одного имени выводятся одним блоком после общих # HELP и # TYPE
+                if (!written.insert(family.name).second)
+                {
+                    continue;
+                }
+                static constexpr const char *TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+                out << "# HELP " << family.name << ' ' << family.help << '\n';
+                out << "# TYPE " << family.name << ' ' << TYPE_NAMES[static_cast<size_t>(family.type)] << '\n';
+                for (const auto &entry : entries_)
+                {
+                    if (entry.name != family.name)
+                    {
+                        continue;
+                    }
+                    switch (entry.type)
+                    {
+                    case Type::COUNTER:
+                        writeSample(out, entry.name, entry.labels, "", std::to_string(entry.counter->value()));
+                        break;
+                    case Type::GAUGE:
+                        writeSample(out, entry.name, entry.labels, "", std::to_string(entry.gauge->value()));
+                        break;
+                    case Type::HISTOGRAM:
+                    {
+                        auto snapshot = entry.histogram->snapshot();
+                        uint64_t cumulative = 0;
+                        for (size_t bucket = 0; bucket < Histogram::BUCKETS; ++bucket)
+                        {
+                            cumulative += snapshot.buckets[bucket];
+                            writeSample(out, entry.name + "_bucket", entry.labels,
+                                        "le=\"" + seconds(Histogram::bucketUpperBoundNs(bucket)) + "\"", std::to_string(cumulative));
+                        }
+                        writeSample(out, entry.name + "_bucket", entry.labels, "le=\"+Inf\"", std::to_string(snapshot.count));
+                        writeSample(out, entry.name + "_sum", entry.labels, "", seconds(snapshot.sumNs));
+                        writeSample(out, entry.name + "_count", entry.labels, "", std::to_string(snapshot.count));
+                        break;
+                    }
+                    }
+                }
+            }
+        }
+
+        void Registry::writePrometheus(const std::filesystem::path &path) const
+        {
+            auto temporary = path;
+            temporary += ".tmp";
+            {
+                std::ofstream file(temporary);
+                if (!file)
+                {
+                    throw std::runtime_error("Не удалось открыть файл метрик: " + temporary.string());
+                }
+                writePrometheus(file);
+                file.flush();
+                if (!file)
+                {
+                    throw std::runtime_error("Ошибка записи файла метрик: " + temporary.string());
+                }
+            }
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+            if (error)
+            {
+                throw std::runtime_error("Не удалось заменить файл метрик " + path.string() + ": " + error.message());
+            }
+        }
+
+        Registry &registry()
+        {
+            // Не уничтожается при выходе: метрики обновляются и из потоков, переживших main
+            static Registry *instance = new Registry;
+            return *instance;
+        }
+
+    } // namespace metrics
+} // namespace university
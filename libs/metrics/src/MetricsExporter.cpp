@@ -0,0 +1,124 @@
+#include "MetricsExporter.h"
+#include <csignal>
+#include <stdexcept>
+
+namespace university
+{
+    namespace metrics
+    {
+        namespace
+        {
+            // Номер последнего запроса: обработчик сигнала только увеличивает его,
+            // а каждый экспортёр сравнивает со своим последним обработанным
+            std::atomic<uint64_t> dumpRequests{0};
+            static_assert(std::atomic<uint64_t>::is_always_lock_free, "requestDump должен быть безопасен в обработчике сигнала");
+
+            // Сигнал нельзя доставить через condition_variable, поэтому поток проверяет запросы с этим шагом
+            constexpr std::chrono::milliseconds SIGNAL_POLL_INTERVAL{100};
+
+            extern "C" void handleDumpSignal(int)
+            {
+                dumpRequests.fetch_add(1, std::memory_order_relaxed);
+            }
+
+        } // namespace
+
+        MetricsExporter::MetricsExporter(std::filesystem::path path, std::chrono::milliseconds interval, Registry &source)
+            : path_(std::move(path)), interval_(interval), registry_(source),
+              seenRequests_(dumpRequests.load(std::memory_order_relaxed))
+        {
+            thread_ = std::thread(&MetricsExporter::run, this);
+        }
+
+        MetricsExporter::~MetricsExporter()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            thread_.join();
+            try
+            {
+                dump();
+            }
+            catch (const std::runtime_error &)
+            {
+                // Деструктор не бросает исключений: последние значения теряются
+            }
+        }
+
+        void MetricsExporter::dump()
+        {
+            registry_.writePrometheus(path_);
+            dumps_.fetch_add(1);
+        }
+
+        std::string MetricsExporter::lastError() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return lastError_;
+        }
+
+        void MetricsExporter::requestDump() noexcept
+        {
+            dumpRequests.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void MetricsExporter::installSignalHandler(int signal)
+        {
+            if (std::signal(signal, handleDumpSignal) == SIG_ERR)
+            {
+                throw std::runtime_error("Не удалось установить обработчик сигнала " + std::to_string(signal));
+            }
+        }
+
+        void MetricsExporter::run()
+        {
+            auto nextDump = std::chrono::steady_clock::now() + interval_;
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_)
+            {
+                auto wait = SIGNAL_POLL_INTERVAL;
+                if (interval_.count() > 0)
+                {
+                    auto untilDump = std::chrono::duration_cast<std::chrono::milliseconds>(nextDump - std::chrono::steady_clock::now());
+                    wait = std::max(std::chrono::milliseconds{0}, std::min(wait, untilDump));
+                }
+                wake_.wait_for(lock, wait, [this]()
+                               { return stopping_; });
+                if (stopping_)
+                {
+                    break;
+                }
+
+                uint64_t requests = dumpRequests.load(std::memory_order_relaxed);
+                bool due = interval_.count() > 0 && std::chrono::steady_clock::now() >= nextDump;
+                if (requests == seenRequests_ && !due)
+                {
+                    continue;
+                }
+                seenRequests_ = requests;
+                if (due)
+                {
+                    nextDump = std::chrono::steady_clock::now() + interval_;
+                }
+
+                // Запись выполняется без мьютекса, чтобы остановка не ждала диска
+                lock.unlock();
+                std::string error;
+                try
+                {
+                    dump();
+                }
+                catch (const std::runtime_error &exception)
+                {
+                    error = exception.what();
+                }
+                lock.lock();
+                lastError_ = error;
+            }
+        }
+
+    } // namespace metrics
+} // namespace university
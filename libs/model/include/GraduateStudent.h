@@ -33,8 +33,8 @@ namespace university
          * @param departmentNumber Номер кафедры студента.
          * @param diplomaProject Детали дипломного проекта студента.
          */
-        GraduateStudent(const std::string &name, const std::string &groupIndex, int departmentNumber,
-                        const DiplomaProject &diplomaProject);
+        GraduateStudent(std::string name, std::string groupIndex, int departmentNumber,
+                        DiplomaProject diplomaProject);
 
         /**
          * @brief Получает категорию студента.
@@ -42,6 +42,12 @@ namespace university
          */
         [[nodiscard]] StudentCategory getCategory() const override;
 
+        /**
+         * @brief Создаёт полную копию студента.
+         * @return unique_ptr к копии типа GraduateStudent.
+         */
+        [[nodiscard]] std::unique_ptr<Student> clone() const override;
+
         /**
          * @brief Выводит информацию о студенте в заданный поток вывода.
          * @param os Поток вывода для записи.
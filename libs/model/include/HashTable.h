@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Metrics.h"
+#include "Trace.h"
 #include <vector>
 #include <optional>
 #include <memory>
@@ -8,6 +10,7 @@
 #include <iterator>
 #include <cstddef>
 #include <utility>
+#include <algorithm>
 
 namespace university
 {
@@ -166,7 +169,19 @@ namespace university
          */
         void rehash()
         {
-            size_t newSize = table_.empty() ? 16 : table_.size() * 2;
+            rehash(table_.empty() ? 16 : table_.size() * 2);
+        }
+
+        /**
+         * @brief Перестраивает хеш-таблицу с заданным количеством слотов.
+         * @param newSize Новое количество слотов (не меньше количества элементов).
+         */
+        void rehash(size_t newSize)
+        {
+            UNIVERSITY_TRACE_SCOPE_ARG("hashtable", "rehash", "slots", newSize);
+            static metrics::Counter &rehashes = metrics::registry().counter("university_hashtable_rehashes_total",
+                                                                            "Перестроений HashTable (все таблицы процесса)");
+            rehashes.add();
             std::vector<Entry> newTable(newSize);
             size_ = 0;
             for (auto &entry : table_)
@@ -197,6 +212,47 @@ namespace university
             table_.resize(initialCapacity);
         }
 
+        /**
+         * @brief Конструирует копию хеш-таблицы с тем же расположением элементов.
+         *
+         * Доступен только для копируемых значений (например, std::shared_ptr).
+         * @param other Копируемая таблица.
+         */
+        HashTable(const HashTable &other)
+            : table_(other.table_.size()), size_(other.size_), maxLoadFactor_(other.maxLoadFactor_)
+        {
+            for (size_t index = 0; index < other.table_.size(); ++index)
+            {
+                const Entry &source = other.table_[index];
+                Entry &target = table_[index];
+                target.occupied = source.occupied;
+                target.deleted = source.deleted;
+                if (source.occupied && !source.deleted)
+                {
+                    target.key = source.key;
+                    target.value = source.value;
+                }
+            }
+        }
+
+        HashTable(HashTable &&other) noexcept = default;
+        HashTable &operator=(HashTable &&other) noexcept = default;
+
+        /**
+         * @brief Заменяет содержимое копией другой таблицы.
+         * @param other Копируемая таблица.
+         * @return Ссылка на эту таблицу.
+         */
+        HashTable &operator=(const HashTable &other)
+        {
+            if (this != &other)
+            {
+                HashTable copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
         /**
          * @brief Вставляет пару ключ-значение в хеш-таблицу.
          * @param key Ключ для вставки.
@@ -332,6 +388,7 @@ namespace university
                 if (table_[index].key == key && !table_[index].deleted)
                 {
                     table_[index].deleted = true;
+                    table_[index].value = Value{}; // Освобождаем значение сразу, а не при перехешировании
                     size_--;
                     return true;
                 }
@@ -357,6 +414,69 @@ namespace university
         {
             return size_ == 0;
         }
+
+        /**
+         * @brief Резервирует место под заданное количество элементов.
+         *
+         * После вызова вставка до count элементов не вызывает перехеширования.
+         * Таблица растёт не меньше чем вдвое, поэтому частые резервирования
+         * на несколько элементов (небольшие пакеты) не перестраивают её каждый раз.
+         * @param count Ожидаемое количество элементов.
+         */
+        void reserve(size_t count)
+        {
+            auto required = static_cast<size_t>(static_cast<double>(count) / maxLoadFactor_) + 1;
+            if (required > table_.size())
+            {
+                rehash(std::max(required, table_.size() * 2));
+            }
+        }
+
+        /**
+         * @brief Получает количество слотов во внутреннем массиве таблицы.
+         * @return Количество слотов (занятых и свободных).
+         */
+        [[nodiscard]] size_t bucketCount() const
+        {
+            return table_.size();
+        }
+
+        /**
+         * @brief Получает объём памяти массива слотов.
+         *
+         * Учитываются все слоты, включая свободные и удалённые; память, на которую
+         * ссылаются значения (например, объекты за указателями), не входит.
+         *
+         * @return Размер массива слотов в байтах.
+         */
+        [[nodiscard]] size_t slotBytes() const
+        {
+            return table_.capacity() * sizeof(Entry);
+        }
+
+        /**
+         * @brief Обходит занятые слоты в диапазоне [first, last).
+         *
+         * Диапазоны слотов не пересекаются, поэтому несколько потоков могут
+         * одновременно обходить разные части таблицы без синхронизации.
+         *
+         * @param first Индекс первого слота.
+         * @param last Индекс слота, следующего за последним.
+         * @param fn Функция, вызываемая как fn(key, value) для каждого элемента.
+         */
+        template <typename Fn>
+        void forEachInRange(size_t first, size_t last, Fn &&fn) const
+        {
+            last = std::min(last, table_.size());
+            for (size_t index = first; index < last; ++index)
+            {
+                const Entry &entry = table_[index];
+                if (entry.occupied && !entry.deleted)
+                {
+                    fn(entry.key, entry.value);
+                }
+            }
+        }
     };
 
 } // namespace university
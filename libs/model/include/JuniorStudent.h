@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Student.h"
+#include <cstddef>
 #include <vector>
 
 namespace university
@@ -13,6 +14,8 @@ namespace university
     class JuniorStudent : public Student
     {
     public:
+        static constexpr size_t MAX_SESSION_GRADES = 5; ///< Наибольшее количество оценок за сессию
+
         /**
          * @brief Конструирует новый объект JuniorStudent.
          * @param name Полное имя студента.
@@ -21,7 +24,7 @@ namespace university
          * @param sessionGrades Вектор оценок за последнюю сессию (максимум 5).
          * @throw std::invalid_argument если sessionGrades содержит более 5 оценок.
          */
-        JuniorStudent(const std::string &name, const std::string &groupIndex, int departmentNumber, const std::vector<int> &sessionGrades);
+        JuniorStudent(std::string name, std::string groupIndex, int departmentNumber, std::vector<int> sessionGrades);
 
         /**
          * @brief Получает категорию студента.
@@ -29,6 +32,12 @@ namespace university
          */
         [[nodiscard]] StudentCategory getCategory() const override;
 
+        /**
+         * @brief Создаёт полную копию студента.
+         * @return unique_ptr к копии типа JuniorStudent.
+         */
+        [[nodiscard]] std::unique_ptr<Student> clone() const override;
+
         /**
          * @brief Выводит информацию о студенте в заданный поток вывода.
          * @param os Поток вывода для записи.
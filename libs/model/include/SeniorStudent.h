@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Student.h"
+#include <cstddef>
 #include <vector>
 #include <string>
 
@@ -26,6 +27,8 @@ namespace university
     class SeniorStudent : public Student
     {
     public:
+        static constexpr size_t MAX_SESSION_GRADES = 4; ///< Наибольшее количество оценок за сессию
+
         /**
          * @brief Конструирует новый объект SeniorStudent.
          * @param name Полное имя студента.
@@ -35,8 +38,8 @@ namespace university
          * @param researchWork Детали исследовательской работы студента.
          * @throw std::invalid_argument если sessionGrades содержит более 4 оценок.
          */
-        SeniorStudent(const std::string &name, const std::string &groupIndex, int departmentNumber,
-                      const std::vector<int> &sessionGrades, const ResearchWork &researchWork);
+        SeniorStudent(std::string name, std::string groupIndex, int departmentNumber,
+                      std::vector<int> sessionGrades, ResearchWork researchWork);
 
         /**
          * @brief Получает категорию студента.
@@ -44,6 +47,12 @@ namespace university
          */
         [[nodiscard]] StudentCategory getCategory() const override;
 
+        /**
+         * @brief Создаёт полную копию студента.
+         * @return unique_ptr к копии типа SeniorStudent.
+         */
+        [[nodiscard]] std::unique_ptr<Student> clone() const override;
+
         /**
          * @brief Выводит информацию о студенте в заданный поток вывода.
          * @param os Поток вывода для записи.
@@ -37,7 +37,7 @@ namespace university
          * @param departmentNumber Номер кафедры студента.
          * @throw std::invalid_argument если имя пустое или номер кафедры отрицательный.
          */
-        Student(const std::string &name, const std::string &groupIndex, int departmentNumber);
+        Student(std::string name, std::string groupIndex, int departmentNumber);
 
         /**
          * @brief Виртуальный деструктор.
@@ -50,6 +50,16 @@ namespace university
          */
         [[nodiscard]] virtual StudentCategory getCategory() const = 0;
 
+        /**
+         * @brief Создаёт полную копию студента с сохранением его категории.
+         *
+         * Используется для копирования при записи: опубликованная запись не
+         * изменяется, вместо этого изменяется и публикуется её копия.
+         *
+         * @return unique_ptr к копии студента.
+         */
+        [[nodiscard]] virtual std::unique_ptr<Student> clone() const = 0;
+
         /**
          * @brief Выводит информацию о студенте в заданный поток вывода.
          * @param os Поток вывода для записи.
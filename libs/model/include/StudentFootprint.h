@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Student.h"
+#include <cstddef>
+
+namespace university
+{
+
+    /**
+     * @struct StudentFootprint
+     * @brief Память, занимаемая записью студента, по составляющим.
+     *
+     * Учитываются полезные размеры: объект и буферы строк и оценок в куче.
+     * Служебные данные распределителя памяти и счётчик ссылок shared_ptr
+     * сюда не входят — их показывает счётчик выделений бенчмарка.
+     */
+    struct StudentFootprint
+    {
+        size_t object = 0;          ///< sizeof объекта его фактического типа
+        size_t strings = 0;         ///< Буферы строк в куче (строки в буфере SSO не занимают кучу)
+        size_t grades = 0;          ///< Буфер оценок за сессию (по ёмкости вектора)
+        size_t heapAllocations = 0; ///< Количество отдельных блоков в куче, включая сам объект
+
+        /**
+         * @brief Добавляет к сводке другую сводку.
+         * @param other Сводка для объединения.
+         */
+        void merge(const StudentFootprint &other)
+        {
+            object += other.object;
+            strings += other.strings;
+            grades += other.grades;
+            heapAllocations += other.heapAllocations;
+        }
+
+        /**
+         * @brief Вычисляет общий объём.
+         * @return Сумма составляющих в байтах.
+         */
+        [[nodiscard]] size_t total() const
+        {
+            return object + strings + grades;
+        }
+    };
+
+    /**
+     * @brief Вычисляет память, занимаемую записью студента, с учётом его категории.
+     *
+     * Для младшекурсников и старшекурсников учитываются оценки за сессию, для
+     * старшекурсников и выпускников — строки темы и места УИР/ДП.
+     *
+     * @param student Студент.
+     * @return Объём по составляющим.
+     */
+    StudentFootprint footprintOf(const Student &student);
+
+} // namespace university
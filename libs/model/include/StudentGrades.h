@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Student.h"
+#include <cstddef>
+
+namespace university
+{
+
+    /**
+     * @struct GradeSummary
+     * @brief Сумма и количество оценок студента или группы студентов.
+     *
+     * Хранение суммы и количества вместо списка оценок позволяет объединять
+     * частичные результаты разных потоков без копирования данных.
+     */
+    struct GradeSummary
+    {
+        double sum = 0.0;
+        size_t count = 0;
+
+        /**
+         * @brief Добавляет к сводке оценки из другой сводки.
+         * @param other Сводка для объединения.
+         */
+        void merge(const GradeSummary &other)
+        {
+            sum += other.sum;
+            count += other.count;
+        }
+
+        /**
+         * @brief Вычисляет среднюю оценку.
+         * @return Средняя оценка или 0, если оценок нет.
+         */
+        [[nodiscard]] double average() const
+        {
+            return count == 0 ? 0.0 : sum / static_cast<double>(count);
+        }
+    };
+
+    /**
+     * @brief Собирает все оценки студента с учётом его категории.
+     *
+     * Для младшекурсников учитываются оценки за сессию, для старшекурсников —
+     * оценки за сессию и обе оценки за УИР, для выпускников — три оценки за ДП.
+     *
+     * @param student Студент, чьи оценки нужно собрать.
+     * @return Сумма и количество оценок студента.
+     */
+    GradeSummary summarizeGrades(const Student &student);
+
+} // namespace university
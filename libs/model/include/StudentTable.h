@@ -0,0 +1,25 @@
+#pragma once
+
+#include "HashTable.h"
+#include "Student.h"
+#include <memory>
+#include <utility>
+
+namespace university
+{
+
+    /**
+     * @brief Таблица студентов реестра: ID студента → неизменяемая запись.
+     *
+     * Записи разделяются между текущей таблицей и снимками, поэтому
+     * опубликованная запись никогда не изменяется на месте: изменение
+     * выполняется над копией (Student::clone), которая заменяет запись в таблице.
+     */
+    using StudentTable = HashTable<int, std::shared_ptr<const Student>>;
+
+    /**
+     * @brief Строка реестра: ID студента и его запись.
+     */
+    using StudentRow = std::pair<int, std::shared_ptr<const Student>>;
+
+} // namespace university
@@ -1,27 +1,33 @@
 #include "GraduateStudent.h"
+#include <utility>
 
 namespace university
 {
 
-    GraduateStudent::GraduateStudent(const std::string &name, const std::string &groupIndex, int departmentNumber,
-                                     const DiplomaProject &diplomaProject)
-        : Student(name, groupIndex, departmentNumber), diplomaProject_(diplomaProject) {}
+    GraduateStudent::GraduateStudent(std::string name, std::string groupIndex, int departmentNumber,
+                                     DiplomaProject diplomaProject)
+        : Student(std::move(name), std::move(groupIndex), departmentNumber), diplomaProject_(std::move(diplomaProject)) {}
 
     StudentCategory GraduateStudent::getCategory() const
     {
         return StudentCategory::GRADUATE;
     }
 
+    std::unique_ptr<Student> GraduateStudent::clone() const
+    {
+        return std::make_unique<GraduateStudent>(*this);
+    }
+
     void GraduateStudent::printInfo(std::ostream &os) const
     {
         Student::printInfo(os);
-        os << "Category: Graduate Student" << std::endl;
-        os << "Diploma Project Topic: " << diplomaProject_.topic << std::endl;
-        os << "Diploma Project Place: " << diplomaProject_.place << std::endl;
+        os << "Category: Graduate Student" << '\n';
+        os << "Diploma Project Topic: " << diplomaProject_.topic << '\n';
+        os << "Diploma Project Place: " << diplomaProject_.place << '\n';
         os << "Diploma Project Grades (Supervisor, Reviewer, State Commission): "
            << diplomaProject_.supervisorGrade << ", "
            << diplomaProject_.reviewerGrade << ", "
-           << diplomaProject_.stateCommissionGrade << std::endl;
+           << diplomaProject_.stateCommissionGrade << '\n';
     }
 
     const DiplomaProject &GraduateStudent::getDiplomaProject() const
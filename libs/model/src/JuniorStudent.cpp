@@ -2,19 +2,27 @@
 #include <stdexcept>
 #include <algorithm>
 #include <iterator>
+#include <utility>
 
 namespace university
 {
 
     namespace
     {
-        constexpr size_t MAX_JUNIOR_GRADES = 5;
+        void checkGradeCount(const std::vector<int> &grades)
+        {
+            if (grades.size() > JuniorStudent::MAX_SESSION_GRADES)
+            {
+                throw std::invalid_argument("A junior student can have at most " + std::to_string(JuniorStudent::MAX_SESSION_GRADES) + " grades.");
+            }
+        }
     }
 
-    JuniorStudent::JuniorStudent(const std::string &name, const std::string &groupIndex, int departmentNumber, const std::vector<int> &sessionGrades)
-        : Student(name, groupIndex, departmentNumber)
+    JuniorStudent::JuniorStudent(std::string name, std::string groupIndex, int departmentNumber, std::vector<int> sessionGrades)
+        : Student(std::move(name), std::move(groupIndex), departmentNumber)
     {
-        setSessionGrades(sessionGrades);
+        checkGradeCount(sessionGrades);
+        sessionGrades_ = std::move(sessionGrades);
     }
 
     StudentCategory JuniorStudent::getCategory() const
@@ -22,13 +30,18 @@ namespace university
         return StudentCategory::JUNIOR;
     }
 
+    std::unique_ptr<Student> JuniorStudent::clone() const
+    {
+        return std::make_unique<JuniorStudent>(*this);
+    }
+
     void JuniorStudent::printInfo(std::ostream &os) const
     {
         Student::printInfo(os);
-        os << "Category: Junior Student" << std::endl;
+        os << "Category: Junior Student" << '\n';
         os << "Session Grades: ";
         std::copy(sessionGrades_.begin(), sessionGrades_.end(), std::ostream_iterator<int>(os, " "));
-        os << std::endl;
+        os << '\n';
     }
 
     const std::vector<int> &JuniorStudent::getSessionGrades() const
@@ -38,10 +51,7 @@ namespace university
 
     void JuniorStudent::setSessionGrades(const std::vector<int> &grades)
     {
-        if (grades.size() > MAX_JUNIOR_GRADES)
-        {
-            throw std::invalid_argument("A junior student can have at most " + std::to_string(MAX_JUNIOR_GRADES) + " grades.");
-        }
+        checkGradeCount(grades);
         sessionGrades_ = grades;
     }
 
@@ -2,20 +2,28 @@
 #include <stdexcept>
 #include <algorithm>
 #include <iterator>
+#include <utility>
 
 namespace university
 {
 
     namespace
     {
-        constexpr size_t MAX_SENIOR_GRADES = 4;
+        void checkGradeCount(const std::vector<int> &grades)
+        {
+            if (grades.size() > SeniorStudent::MAX_SESSION_GRADES)
+            {
+                throw std::invalid_argument("A senior student can have at most " + std::to_string(SeniorStudent::MAX_SESSION_GRADES) + " grades.");
+            }
+        }
     }
 
-    SeniorStudent::SeniorStudent(const std::string &name, const std::string &groupIndex, int departmentNumber,
-                                 const std::vector<int> &sessionGrades, const ResearchWork &researchWork)
-        : Student(name, groupIndex, departmentNumber), researchWork_(researchWork)
+    SeniorStudent::SeniorStudent(std::string name, std::string groupIndex, int departmentNumber,
+                                 std::vector<int> sessionGrades, ResearchWork researchWork)
+        : Student(std::move(name), std::move(groupIndex), departmentNumber), researchWork_(std::move(researchWork))
     {
-        setSessionGrades(sessionGrades);
+        checkGradeCount(sessionGrades);
+        sessionGrades_ = std::move(sessionGrades);
     }
 
     StudentCategory SeniorStudent::getCategory() const
@@ -23,17 +31,22 @@ namespace university
         return StudentCategory::SENIOR;
     }
 
+    std::unique_ptr<Student> SeniorStudent::clone() const
+    {
+        return std::make_unique<SeniorStudent>(*this);
+    }
+
     void SeniorStudent::printInfo(std::ostream &os) const
     {
         Student::printInfo(os);
-        os << "Category: Senior Student" << std::endl;
+        os << "Category: Senior Student" << '\n';
         os << "Session Grades: ";
         std::copy(sessionGrades_.begin(), sessionGrades_.end(), std::ostream_iterator<int>(os, " "));
-        os << std::endl;
-        os << "Research Work Topic: " << researchWork_.topic << std::endl;
-        os << "Research Work Place: " << researchWork_.place << std::endl;
+        os << '\n';
+        os << "Research Work Topic: " << researchWork_.topic << '\n';
+        os << "Research Work Place: " << researchWork_.place << '\n';
         os << "Research Work Grades (Supervisor, Commission): " << researchWork_.supervisorGrade
-           << ", " << researchWork_.commissionGrade << std::endl;
+           << ", " << researchWork_.commissionGrade << '\n';
     }
 
     const std::vector<int> &SeniorStudent::getSessionGrades() const
@@ -43,10 +56,7 @@ namespace university
 
     void SeniorStudent::setSessionGrades(const std::vector<int> &grades)
     {
-        if (grades.size() > MAX_SENIOR_GRADES)
-        {
-            throw std::invalid_argument("A senior student can have at most " + std::to_string(MAX_SENIOR_GRADES) + " grades.");
-        }
+        checkGradeCount(grades);
         sessionGrades_ = grades;
     }
 
@@ -1,13 +1,14 @@
 #include "Student.h"
 #include <stdexcept>
+#include <utility>
 
 namespace university
 {
 
-    Student::Student(const std::string &name, const std::string &groupIndex, int departmentNumber)
-        : name_(name), groupIndex_(groupIndex), departmentNumber_(departmentNumber)
+    Student::Student(std::string name, std::string groupIndex, int departmentNumber)
+        : departmentNumber_(departmentNumber), name_(std::move(name)), groupIndex_(std::move(groupIndex))
     {
-        if (name.empty())
+        if (name_.empty())
         {
             throw std::invalid_argument("Student name cannot be empty.");
         }
@@ -19,9 +20,9 @@ namespace university
 
     void Student::printInfo(std::ostream &os) const
     {
-        os << "Name: " << name_ << std::endl;
-        os << "Group Index: " << groupIndex_ << std::endl;
-        os << "Department Number: " << departmentNumber_ << std::endl;
+        os << "Name: " << name_ << '\n';
+        os << "Group Index: " << groupIndex_ << '\n';
+        os << "Department Number: " << departmentNumber_ << '\n';
     }
 
     void Student::setGroupIndex(const std::string &newGroupIndex)
@@ -0,0 +1,69 @@
+#include "StudentFootprint.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+
+namespace university
+{
+    namespace
+    {
+        void addString(StudentFootprint &footprint, const std::string &text)
+        {
+            // Короткие строки хранятся внутри объекта строки
+            const auto *object = reinterpret_cast<const char *>(&text);
+            if (text.data() >= object && text.data() < object + sizeof(text))
+            {
+                return;
+            }
+            footprint.strings += text.capacity() + 1;
+            footprint.heapAllocations += 1;
+        }
+
+        void addGrades(StudentFootprint &footprint, const std::vector<int> &grades)
+        {
+            if (grades.capacity() != 0)
+            {
+                footprint.grades += grades.capacity() * sizeof(int);
+                footprint.heapAllocations += 1;
+            }
+        }
+
+    } // namespace
+
+    StudentFootprint footprintOf(const Student &student)
+    {
+        StudentFootprint footprint;
+        footprint.heapAllocations = 1;
+        addString(footprint, student.getName());
+        addString(footprint, student.getGroupIndex());
+        switch (student.getCategory())
+        {
+        case StudentCategory::JUNIOR:
+        {
+            const auto &junior = dynamic_cast<const JuniorStudent &>(student);
+            footprint.object = sizeof(JuniorStudent);
+            addGrades(footprint, junior.getSessionGrades());
+            break;
+        }
+        case StudentCategory::SENIOR:
+        {
+            const auto &senior = dynamic_cast<const SeniorStudent &>(student);
+            footprint.object = sizeof(SeniorStudent);
+            addGrades(footprint, senior.getSessionGrades());
+            addString(footprint, senior.getResearchWork().topic);
+            addString(footprint, senior.getResearchWork().place);
+            break;
+        }
+        case StudentCategory::GRADUATE:
+        {
+            const auto &graduate = dynamic_cast<const GraduateStudent &>(student);
+            footprint.object = sizeof(GraduateStudent);
+            addString(footprint, graduate.getDiplomaProject().topic);
+            addString(footprint, graduate.getDiplomaProject().place);
+            break;
+        }
+        }
+        return footprint;
+    }
+
+} // namespace university
@@ -0,0 +1,52 @@
+#include "StudentGrades.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+
+namespace university
+{
+
+    GradeSummary summarizeGrades(const Student &student)
+    {
+        GradeSummary summary;
+        switch (student.getCategory())
+        {
+        case StudentCategory::JUNIOR:
+        {
+            const auto &junior = dynamic_cast<const JuniorStudent &>(student);
+            for (int grade : junior.getSessionGrades())
+            {
+                summary.sum += static_cast<double>(grade);
+            }
+            summary.count += junior.getSessionGrades().size();
+            break;
+        }
+        case StudentCategory::SENIOR:
+        {
+            const auto &senior = dynamic_cast<const SeniorStudent &>(student);
+            for (int grade : senior.getSessionGrades())
+            {
+                summary.sum += static_cast<double>(grade);
+            }
+            summary.count += senior.getSessionGrades().size();
+            const auto &work = senior.getResearchWork();
+            summary.sum += static_cast<double>(work.supervisorGrade);
+            summary.sum += static_cast<double>(work.commissionGrade);
+            summary.count += 2;
+            break;
+        }
+        case StudentCategory::GRADUATE:
+        {
+            const auto &graduate = dynamic_cast<const GraduateStudent &>(student);
+            const auto &project = graduate.getDiplomaProject();
+            summary.sum += static_cast<double>(project.supervisorGrade);
+            summary.sum += static_cast<double>(project.reviewerGrade);
+            summary.sum += static_cast<double>(project.stateCommissionGrade);
+            summary.count += 3;
+            break;
+        }
+        }
+        return summary;
+    }
+
+} // namespace university
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "RegistryServer.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace university
+{
+    namespace server
+    {
+
+        /**
+         * @class RegistryClient
+         * @brief Блокирующий клиент сервера реестра с конвейерной отправкой запросов.
+         *
+         * send() только добавляет запрос в буфер; буфер отправляется flush() или
+         * receive(), когда ответов в буфере приёма нет. Сервер не читает новые
+         * запросы соединения, пока не отправит накопленные ответы, поэтому
+         * клиент должен принимать ответы, не накапливая неотвеченными больше
+         * нескольких мегабайт запросов.
+         */
+        class RegistryClient
+        {
+        public:
+            /**
+             * @brief Подключается к серверу.
+             * @param address Адрес сервера.
+             * @throw std::runtime_error если подключиться не удалось.
+             */
+            explicit RegistryClient(const ServerAddress &address);
+
+            ~RegistryClient();
+
+            RegistryClient(const RegistryClient &) = delete;
+            RegistryClient &operator=(const RegistryClient &) = delete;
+
+            /**
+             * @brief Добавляет запрос в буфер отправки.
+             * @param request Команда без перевода строки.
+             */
+            void send(std::string_view request);
+
+            /**
+             * @brief Отправляет буфер запросов.
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void flush();
+
+            /**
+             * @brief Получает следующий ответ, при необходимости отправив буфер и дождавшись данных.
+             * @return Ответ без перевода строки.
+             * @throw std::runtime_error если соединение закрыто или прервано.
+             */
+            std::string receive();
+
+            /**
+             * @brief Отправляет запрос и ждёт ответа на него.
+             * @param request Команда без перевода строки.
+             * @return Ответ (если ранее отправленные запросы не приняты, — ответ на первый из них).
+             */
+            std::string request(std::string_view request)
+            {
+                send(request);
+                return receive();
+            }
+
+        private:
+            int fd_ = -1;
+            std::string output_;
+            std::string input_;
+            size_t inputOffset_ = 0; // Начало непрочитанных ответов в input_
+        };
+
+    } // namespace server
+} // namespace university
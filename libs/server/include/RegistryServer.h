@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Controller.h"
+#include "CommandScript.h"
+#include "WorkerPool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+    namespace server
+    {
+
+        /**
+         * @struct ServerAddress
+         * @brief Адрес сервера реестра: Unix-сокет или TCP-порт на 127.0.0.1.
+         */
+        struct ServerAddress
+        {
+            std::string unixPath; ///< Путь Unix-сокета; пустой — TCP
+            uint16_t tcpPort = 0; ///< Порт TCP (0 при прослушивании — выбирается системой)
+
+            /**
+             * @brief Разбирает адрес вида "unix:<путь>", "tcp:<порт>" или "<путь>".
+             * @param text Текст адреса.
+             * @return Адрес.
+             * @throw std::invalid_argument если адрес пуст или порт некорректен.
+             */
+            static ServerAddress parse(const std::string &text);
+
+            /**
+             * @brief Получает адрес в виде, принимаемом parse.
+             */
+            [[nodiscard]] std::string toString() const;
+        };
+
+        /**
+         * @struct ServerOptions
+         * @brief Настройки сервера реестра.
+         */
+        struct ServerOptions
+        {
+            ServerAddress address;
+            unsigned workers = 0;                       ///< Потоков обработки запросов (0 — по числу ядер)
+            size_t maxBufferedBytes = size_t{4} << 20; ///< Предел непрочитанных запросов и неотправленных ответов соединения
+            ScriptOptions script;                       ///< Размер пакета изменений
+        };
+
+        /**
+         * @class RegistryServer
+         * @brief Сервер общего реестра в памяти для нескольких локальных процессов.
+         *
+         * Протокол — команды сценария (CommandSession): запрос — строка, ответ —
+         * строка, ответы идут в порядке запросов соединения, поэтому клиент может
+         * отправлять запросы, не дожидаясь ответов. Пустые строки и строки с '#'
+         * ответа не получают. Цикл событий на epoll принимает соединения и читает
+         * запросы; все полные строки, прочитанные из соединения, передаются одной
+         * задачей в пул потоков, который вызывает Controller. У соединения не более
+         * одной задачи одновременно; пока ответы не отправлены и их больше
+         * maxBufferedBytes, новые запросы соединения не выполняются. На строку
+         * запроса длиной maxBufferedBytes и больше сервер отвечает
+         * "ERROR <строка>: request too long" и закрывает соединение.
+         */
+        class RegistryServer
+        {
+        public:
+            /**
+             * @brief Открывает сокет и начинает прослушивание; существующий файл Unix-сокета заменяется.
+             * @param controller Реестр, общий для всех клиентов.
+             * @param options Настройки.
+             * @throw std::runtime_error если сокет не удалось открыть.
+             */
+            RegistryServer(Controller &controller, ServerOptions options);
+
+            /**
+             * @brief Закрывает сокеты и удаляет файл Unix-сокета.
+             */
+            ~RegistryServer();
+
+            RegistryServer(const RegistryServer &) = delete;
+            RegistryServer &operator=(const RegistryServer &) = delete;
+
+            /**
+             * @brief Обслуживает клиентов до вызова stop() или сигнала, установленного installStopSignalHandler.
+             *
+             * Цикл ждёт в epoll_wait без таймаута: stop() и обработчик сигнала
+             * будят его записью в eventfd сервера. Перед возвратом закрывает
+             * соединения и дожидается начатых задач.
+             * @throw std::runtime_error при ошибке epoll или если одновременно запущено больше 64 серверов.
+             */
+            void run();
+
+            /**
+             * @brief Останавливает цикл событий; можно вызывать из любого потока.
+             */
+            void stop() noexcept;
+
+            /**
+             * @brief Получает адрес прослушивания (для TCP — с фактическим портом).
+             */
+            [[nodiscard]] const ServerAddress &address() const { return address_; }
+
+            /**
+             * @brief Устанавливает обработчик сигнала (например, SIGINT, SIGTERM), останавливающий запущенные серверы.
+             * @param signal Номер сигнала.
+             */
+            static void installStopSignalHandler(int signal);
+
+        private:
+            struct Connection
+            {
+                int fd = -1;
+                std::string input;     // Прочитанные, но ещё не переданные в пул байты
+                std::string output;    // Неотправленные ответы
+                size_t nextLine = 1;   // Номер следующей строки запроса
+                uint32_t events = 0;   // Текущая подписка epoll
+                bool busy = false;     // Задача соединения выполняется в пуле
+                bool peerClosed = false;
+                bool closing = false;  // Закрыть после отправки ответов (слишком длинный запрос)
+            };
+
+            struct Completion
+            {
+                uint64_t id;
+                std::string output;
+            };
+
+            void accept();
+            void read(uint64_t id, Connection &connection);
+            void write(uint64_t id, Connection &connection);
+            void dispatch(uint64_t id, Connection &connection);
+            void drainCompletions();
+            void update(uint64_t id, Connection &connection);
+            void close(uint64_t id);
+            void wake() noexcept;
+
+            Controller &controller_;
+            ServerOptions options_;
+            ServerAddress address_;
+            int listenFd_ = -1;
+            int epollFd_ = -1;
+            int wakeFd_ = -1; // eventfd: завершённые задачи и остановка
+            std::atomic<bool> stopping_{false};
+            std::unordered_map<uint64_t, Connection> connections_;
+            uint64_t nextId_ = 0;
+            std::mutex completionsMutex_;
+            std::vector<Completion> completions_;
+            std::unique_ptr<WorkerPool> pool_; // Последним: уничтожается первым, пока задачи могут обращаться к серверу
+        };
+
+    } // namespace server
+} // namespace university
@@ -0,0 +1,149 @@
+#include "RegistryClient.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace university
+{
+    namespace server
+    {
+        namespace
+        {
+            constexpr size_t RECEIVE_SIZE = size_t{64} << 10;
+
+            [[noreturn]] void throwConnectionError(const std::string &action)
+            {
+                throw std::runtime_error(action + ": " + std::strerror(errno));
+            }
+
+        } // namespace
+
+#if !defined(_WIN32)
+
+        RegistryClient::RegistryClient(const ServerAddress &address)
+        {
+            int result = -1;
+            if (!address.unixPath.empty())
+            {
+                sockaddr_un remote{};
+                remote.sun_family = AF_UNIX;
+                if (address.unixPath.size() >= sizeof(remote.sun_path))
+                {
+                    throw std::runtime_error("Слишком длинный путь сокета: " + address.unixPath);
+                }
+                std::copy(address.unixPath.begin(), address.unixPath.end(), remote.sun_path);
+                fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                result = fd_ < 0 ? -1 : ::connect(fd_, reinterpret_cast<sockaddr *>(&remote), sizeof(remote));
+            }
+            else
+            {
+                sockaddr_in remote{};
+                remote.sin_family = AF_INET;
+                remote.sin_port = htons(address.tcpPort);
+                remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                result = fd_ < 0 ? -1 : ::connect(fd_, reinterpret_cast<sockaddr *>(&remote), sizeof(remote));
+                int noDelay = 1;
+                if (result == 0)
+                {
+                    ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                }
+            }
+            if (result != 0)
+            {
+                int error = errno;
+                if (fd_ >= 0)
+                {
+                    ::close(fd_);
+                }
+                errno = error;
+                throwConnectionError("Не удалось подключиться к " + address.toString());
+            }
+        }
+
+        RegistryClient::~RegistryClient()
+        {
+            ::close(fd_);
+        }
+
+        void RegistryClient::send(std::string_view request)
+        {
+            output_.append(request);
+            output_ += '\n';
+        }
+
+        void RegistryClient::flush()
+        {
+            size_t sent = 0;
+            while (sent < output_.size())
+            {
+                ssize_t bytes = ::send(fd_, output_.data() + sent, output_.size() - sent, MSG_NOSIGNAL);
+                if (bytes < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throwConnectionError("Ошибка отправки запросов");
+                }
+                sent += static_cast<size_t>(bytes);
+            }
+            output_.clear();
+        }
+
+        std::string RegistryClient::receive()
+        {
+            while (true)
+            {
+                size_t end = input_.find('\n', inputOffset_);
+                if (end != std::string::npos)
+                {
+                    std::string response = input_.substr(inputOffset_, end - inputOffset_);
+                    inputOffset_ = end + 1;
+                    return response;
+                }
+                // Перед ожиданием сервера отправляем накопленные запросы, иначе ответа может не быть
+                flush();
+                input_.erase(0, inputOffset_);
+                inputOffset_ = 0;
+                size_t offset = input_.size();
+                input_.resize(offset + RECEIVE_SIZE);
+                ssize_t bytes = ::recv(fd_, input_.data() + offset, RECEIVE_SIZE, 0);
+                input_.resize(offset + static_cast<size_t>(std::max<ssize_t>(bytes, 0)));
+                if (bytes == 0)
+                {
+                    throw std::runtime_error("Сервер закрыл соединение");
+                }
+                if (bytes < 0 && errno != EINTR)
+                {
+                    throwConnectionError("Ошибка получения ответа");
+                }
+            }
+        }
+
+#else
+
+        RegistryClient::RegistryClient(const ServerAddress &)
+        {
+            throw std::runtime_error("Клиент сервера реестра не поддерживается на этой платформе.");
+        }
+
+        RegistryClient::~RegistryClient() = default;
+        void RegistryClient::send(std::string_view) {}
+        void RegistryClient::flush() {}
+        std::string RegistryClient::receive() { return {}; }
+
+#endif
+
+    } // namespace server
+} // namespace university
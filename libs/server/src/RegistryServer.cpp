@@ -0,0 +1,560 @@
+#include "RegistryServer.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace university
+{
+    namespace server
+    {
+        namespace
+        {
+            constexpr uint64_t LISTEN_ID = 0;
+            constexpr uint64_t WAKE_ID = 1;
+            constexpr uint64_t FIRST_CONNECTION_ID = 2;
+            constexpr size_t READ_SIZE = size_t{64} << 10;
+            constexpr int MAX_EVENTS = 64;
+
+            constexpr size_t MAX_SIGNAL_TARGETS = 64;
+
+            // Номер последнего запроса остановки по сигналу; сервер сравнивает его с номером при запуске run
+            std::atomic<uint64_t> stopRequests{0};
+            // eventfd запущенных серверов плюс один (0 — свободный слот): обработчик сигнала будит их циклы
+            std::atomic<int> signalTargets[MAX_SIGNAL_TARGETS];
+            static_assert(std::atomic<uint64_t>::is_always_lock_free, "обработчик сигнала должен быть без блокировок");
+            static_assert(std::atomic<int>::is_always_lock_free, "обработчик сигнала должен быть без блокировок");
+
+            extern "C" void handleStopSignal(int)
+            {
+                int savedErrno = errno;
+                stopRequests.fetch_add(1, std::memory_order_relaxed);
+                for (auto &target : signalTargets)
+                {
+                    int fd = target.load(std::memory_order_acquire) - 1;
+                    if (fd >= 0)
+                    {
+                        uint64_t one = 1;
+                        [[maybe_unused]] auto bytes = ::write(fd, &one, sizeof(one)); // write безопасен в обработчике
+                    }
+                }
+                errno = savedErrno;
+            }
+
+            /**
+             * @brief Регистрирует eventfd цикла событий для пробуждения по сигналу на время жизни объекта.
+             */
+            class SignalTarget
+            {
+            public:
+                explicit SignalTarget(int fd)
+                {
+                    for (auto &target : signalTargets)
+                    {
+                        int expected = 0;
+                        if (target.compare_exchange_strong(expected, fd + 1, std::memory_order_acq_rel))
+                        {
+                            target_ = &target;
+                            return;
+                        }
+                    }
+                    throw std::runtime_error("Слишком много одновременно запущенных серверов");
+                }
+
+                ~SignalTarget() { target_->store(0, std::memory_order_release); }
+
+                SignalTarget(const SignalTarget &) = delete;
+                SignalTarget &operator=(const SignalTarget &) = delete;
+
+            private:
+                std::atomic<int> *target_ = nullptr;
+            };
+
+            struct ServerMetrics
+            {
+                metrics::Counter &connections;
+                metrics::Counter &requests;
+                metrics::Counter &errors;
+                metrics::Gauge &openConnections;
+            };
+
+            ServerMetrics &serverMetrics()
+            {
+                static ServerMetrics *instance = []()
+                {
+                    auto &registry = metrics::registry();
+                    return new ServerMetrics{
+                        registry.counter("university_server_connections_total", "Принятых соединений сервера реестра"),
+                        registry.counter("university_server_requests_total", "Выполненных запросов сервера реестра"),
+                        registry.counter("university_server_request_errors_total", "Ответов ERROR сервера реестра"),
+                        registry.gauge("university_server_open_connections", "Открытых соединений сервера реестра")};
+                }();
+                return *instance;
+            }
+
+#if defined(__linux__)
+            [[noreturn]] void throwSocketError(const std::string &action)
+            {
+                throw std::runtime_error(action + ": " + std::strerror(errno));
+            }
+#endif
+
+        } // namespace
+
+        ServerAddress ServerAddress::parse(const std::string &text)
+        {
+            ServerAddress address;
+            std::string_view rest = text;
+            if (rest.starts_with("tcp:"))
+            {
+                rest.remove_prefix(4);
+                auto [end, error] = std::from_chars(rest.data(), rest.data() + rest.size(), address.tcpPort);
+                if (rest.empty() || error != std::errc{} || end != rest.data() + rest.size())
+                {
+                    throw std::invalid_argument("Некорректный порт сервера: " + text);
+                }
+                return address;
+            }
+            if (rest.starts_with("unix:"))
+            {
+                rest.remove_prefix(5);
+            }
+            if (rest.empty())
+            {
+                throw std::invalid_argument("Не указан адрес сервера");
+            }
+            address.unixPath = rest;
+            return address;
+        }
+
+        std::string ServerAddress::toString() const
+        {
+            return unixPath.empty() ? "tcp:" + std::to_string(tcpPort) : "unix:" + unixPath;
+        }
+
+        void RegistryServer::installStopSignalHandler(int signal)
+        {
+            if (std::signal(signal, handleStopSignal) == SIG_ERR)
+            {
+                throw std::runtime_error("Не удалось установить обработчик сигнала " + std::to_string(signal));
+            }
+        }
+
+#if defined(__linux__)
+
+        RegistryServer::RegistryServer(Controller &controller, ServerOptions options)
+            : controller_(controller), options_(std::move(options)), address_(options_.address)
+        {
+            try
+            {
+                if (!address_.unixPath.empty())
+                {
+                    sockaddr_un local{};
+                    local.sun_family = AF_UNIX;
+                    if (address_.unixPath.size() >= sizeof(local.sun_path))
+                    {
+                        throw std::runtime_error("Слишком длинный путь сокета: " + address_.unixPath);
+                    }
+                    std::copy(address_.unixPath.begin(), address_.unixPath.end(), local.sun_path);
+                    // Файл, оставшийся от завершившегося сервера, заменяется; другие файлы не трогаем
+                    std::error_code error;
+                    if (std::filesystem::is_socket(address_.unixPath, error))
+                    {
+                        std::filesystem::remove(address_.unixPath, error);
+                    }
+                    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                    if (listenFd_ < 0 || ::bind(listenFd_, reinterpret_cast<sockaddr *>(&local), sizeof(local)) != 0)
+                    {
+                        throwSocketError("Не удалось открыть сокет " + address_.unixPath);
+                    }
+                }
+                else
+                {
+                    sockaddr_in local{};
+                    local.sin_family = AF_INET;
+                    local.sin_port = htons(address_.tcpPort);
+                    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                    listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                    int reuse = 1;
+                    if (listenFd_ < 0 || ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+                        ::bind(listenFd_, reinterpret_cast<sockaddr *>(&local), sizeof(local)) != 0)
+                    {
+                        throwSocketError("Не удалось открыть порт " + std::to_string(address_.tcpPort));
+                    }
+                    socklen_t length = sizeof(local);
+                    if (::getsockname(listenFd_, reinterpret_cast<sockaddr *>(&local), &length) != 0)
+                    {
+                        throwSocketError("Не удалось определить порт сервера");
+                    }
+                    address_.tcpPort = ntohs(local.sin_port);
+                }
+                if (::listen(listenFd_, SOMAXCONN) != 0)
+                {
+                    throwSocketError("Не удалось начать прослушивание " + address_.toString());
+                }
+
+                epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+                wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                if (epollFd_ < 0 || wakeFd_ < 0)
+                {
+                    throwSocketError("Не удалось создать epoll");
+                }
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.u64 = LISTEN_ID;
+                if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event) != 0)
+                {
+                    throwSocketError("Не удалось добавить сокет сервера в epoll");
+                }
+                event.data.u64 = WAKE_ID;
+                if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event) != 0)
+                {
+                    throwSocketError("Не удалось добавить eventfd в epoll");
+                }
+            }
+            catch (...)
+            {
+                for (int fd : {listenFd_, epollFd_, wakeFd_})
+                {
+                    if (fd >= 0)
+                    {
+                        ::close(fd);
+                    }
+                }
+                throw;
+            }
+            nextId_ = FIRST_CONNECTION_ID;
+            pool_ = std::make_unique<WorkerPool>(options_.workers);
+        }
+
+        RegistryServer::~RegistryServer()
+        {
+            pool_.reset();
+            for (auto &[id, connection] : connections_)
+            {
+                ::close(connection.fd);
+            }
+            ::close(listenFd_);
+            ::close(epollFd_);
+            ::close(wakeFd_);
+            if (!address_.unixPath.empty())
+            {
+                std::error_code error;
+                std::filesystem::remove(address_.unixPath, error);
+            }
+        }
+
+        void RegistryServer::run()
+        {
+            // Регистрация до чтения счётчика: сигнал после чтения обязательно разбудит epoll_wait
+            SignalTarget signalTarget(wakeFd_);
+            uint64_t seenStopRequests = stopRequests.load(std::memory_order_relaxed);
+            epoll_event events[MAX_EVENTS];
+            while (!stopping_.load(std::memory_order_relaxed) && stopRequests.load(std::memory_order_relaxed) == seenStopRequests)
+            {
+                int count = ::epoll_wait(epollFd_, events, MAX_EVENTS, -1);
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throwSocketError("Ошибка epoll_wait");
+                }
+                for (int i = 0; i < count; ++i)
+                {
+                    uint64_t id = events[i].data.u64;
+                    if (id == LISTEN_ID)
+                    {
+                        accept();
+                        continue;
+                    }
+                    if (id == WAKE_ID)
+                    {
+                        uint64_t value = 0;
+                        [[maybe_unused]] auto bytes = ::read(wakeFd_, &value, sizeof(value));
+                        drainCompletions();
+                        continue;
+                    }
+                    auto it = connections_.find(id);
+                    if (it == connections_.end())
+                    {
+                        continue; // Закрыто при обработке предыдущего события
+                    }
+                    if (events[i].events & (EPOLLHUP | EPOLLERR))
+                    {
+                        // Клиент закрыл сокет полностью: ответы доставить некуда
+                        close(id);
+                        continue;
+                    }
+                    if (events[i].events & EPOLLIN)
+                    {
+                        read(id, it->second);
+                    }
+                    it = connections_.find(id);
+                    if (it != connections_.end() && (events[i].events & EPOLLOUT))
+                    {
+                        write(id, it->second);
+                    }
+                }
+            }
+
+            // Начатые задачи обращаются к реестру: дожидаемся их до возврата управления
+            pool_->waitIdle();
+            while (!connections_.empty())
+            {
+                close(connections_.begin()->first);
+            }
+            std::lock_guard<std::mutex> lock(completionsMutex_);
+            completions_.clear();
+        }
+
+        void RegistryServer::stop() noexcept
+        {
+            stopping_.store(true, std::memory_order_relaxed);
+            wake();
+        }
+
+        void RegistryServer::wake() noexcept
+        {
+            uint64_t one = 1;
+            [[maybe_unused]] auto bytes = ::write(wakeFd_, &one, sizeof(one));
+        }
+
+        void RegistryServer::accept()
+        {
+            while (true)
+            {
+                int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    return; // EAGAIN — очередь пуста; прочие ошибки относятся к отдельному соединению
+                }
+                if (address_.unixPath.empty())
+                {
+                    int noDelay = 1;
+                    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                }
+                uint64_t id = nextId_++;
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.u64 = id;
+                if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0)
+                {
+                    ::close(fd);
+                    continue;
+                }
+                auto &connection = connections_[id];
+                connection.fd = fd;
+                connection.events = EPOLLIN;
+                serverMetrics().connections.add();
+                serverMetrics().openConnections.set(static_cast<int64_t>(connections_.size()));
+            }
+        }
+
+        void RegistryServer::read(uint64_t id, Connection &connection)
+        {
+            while (connection.input.size() < options_.maxBufferedBytes)
+            {
+                size_t offset = connection.input.size();
+                connection.input.resize(offset + READ_SIZE);
+                ssize_t bytes = ::recv(connection.fd, connection.input.data() + offset, READ_SIZE, 0);
+                connection.input.resize(offset + static_cast<size_t>(std::max<ssize_t>(bytes, 0)));
+                if (bytes > 0)
+                {
+                    continue;
+                }
+                if (bytes == 0)
+                {
+                    connection.peerClosed = true;
+                    break;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                if (errno != EINTR)
+                {
+                    close(id);
+                    return;
+                }
+            }
+            dispatch(id, connection);
+        }
+
+        void RegistryServer::write(uint64_t id, Connection &connection)
+        {
+            size_t sent = 0;
+            while (sent < connection.output.size())
+            {
+                ssize_t bytes = ::send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+                if (bytes > 0)
+                {
+                    sent += static_cast<size_t>(bytes);
+                    continue;
+                }
+                if (bytes < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    break;
+                }
+                close(id);
+                return;
+            }
+            connection.output.erase(0, sent);
+            dispatch(id, connection);
+        }
+
+        void RegistryServer::dispatch(uint64_t id, Connection &connection)
+        {
+            if (!connection.busy && connection.output.size() < options_.maxBufferedBytes)
+            {
+                // Передаём только полные строки; после закрытия записи клиентом — и неполную последнюю
+                size_t end = connection.input.rfind('\n');
+                end = end == std::string::npos ? 0 : end + 1;
+                if (connection.peerClosed)
+                {
+                    end = connection.input.size();
+                }
+                if (end != 0)
+                {
+                    std::string requests = connection.input.substr(0, end);
+                    connection.input.erase(0, end);
+                    size_t firstLine = connection.nextLine;
+                    connection.nextLine += static_cast<size_t>(std::count(requests.begin(), requests.end(), '\n'));
+                    connection.busy = true;
+                    pool_->submit([this, id, firstLine, requests = std::move(requests)]()
+                                  {
+                        UNIVERSITY_TRACE_SCOPE("server", "requests");
+                        CommandSession session(controller_, options_.script);
+                        try
+                        {
+                            session.executeLines(requests, firstLine);
+                            session.flush();
+                        }
+                        catch (const std::exception &error)
+                        {
+                            // Ошибка журнала: ответы на оставшиеся запросы потеряны, клиент узнаёт причину
+                            session.output() += "ERROR " + std::to_string(firstLine) + ": " + error.what() + "\n";
+                        }
+                        serverMetrics().requests.add(session.commands());
+                        serverMetrics().errors.add(session.errors());
+                        {
+                            std::lock_guard<std::mutex> lock(completionsMutex_);
+                            completions_.push_back({id, std::move(session.output())});
+                        }
+                        wake(); });
+                }
+                else if (connection.input.size() >= options_.maxBufferedBytes)
+                {
+                    // Строка не уместилась в буфер: дочитать её нельзя, поэтому отвечаем ошибкой и закрываем соединение
+                    connection.output += "ERROR " + std::to_string(connection.nextLine) + ": request too long\n";
+                    connection.input.clear();
+                    connection.closing = true;
+                    serverMetrics().errors.add();
+                }
+            }
+            if ((connection.peerClosed || connection.closing) && !connection.busy && connection.input.empty() && connection.output.empty())
+            {
+                close(id);
+                return;
+            }
+            update(id, connection);
+        }
+
+        void RegistryServer::drainCompletions()
+        {
+            std::vector<Completion> completed;
+            {
+                std::lock_guard<std::mutex> lock(completionsMutex_);
+                completed.swap(completions_);
+            }
+            for (auto &completion : completed)
+            {
+                auto it = connections_.find(completion.id);
+                if (it == connections_.end())
+                {
+                    continue; // Клиент отключился, пока выполнялись его запросы
+                }
+                auto &connection = it->second;
+                connection.busy = false;
+                connection.output += completion.output;
+                write(completion.id, connection);
+            }
+        }
+
+        void RegistryServer::update(uint64_t id, Connection &connection)
+        {
+            uint32_t events = 0;
+            if (!connection.peerClosed && !connection.closing && connection.input.size() < options_.maxBufferedBytes)
+            {
+                events |= EPOLLIN;
+            }
+            if (!connection.output.empty())
+            {
+                events |= EPOLLOUT;
+            }
+            if (events != connection.events)
+            {
+                epoll_event event{};
+                event.events = events;
+                event.data.u64 = id;
+                if (::epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event) != 0)
+                {
+                    // Подписка не изменилась: соединение больше не получит нужных событий
+                    close(id);
+                    return;
+                }
+                connection.events = events;
+            }
+        }
+
+        void RegistryServer::close(uint64_t id)
+        {
+            auto it = connections_.find(id);
+            if (it == connections_.end())
+            {
+                return;
+            }
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+            ::close(it->second.fd);
+            connections_.erase(it);
+            serverMetrics().openConnections.set(static_cast<int64_t>(connections_.size()));
+        }
+
+#else
+
+        RegistryServer::RegistryServer(Controller &controller, ServerOptions options)
+            : controller_(controller), options_(std::move(options))
+        {
+            throw std::runtime_error("Сервер реестра поддерживается только в Linux.");
+        }
+
+        RegistryServer::~RegistryServer() = default;
+        void RegistryServer::run() {}
+        void RegistryServer::stop() noexcept {}
+        void RegistryServer::wake() noexcept {}
+
+#endif
+
+    } // namespace server
+} // namespace university
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "StudentTable.h"
+#include <cstdint>
+#include <filesystem>
+
+namespace university
+{
+    namespace storage
+    {
+
+        /**
+         * @brief Текущая версия двоичного формата снимка реестра.
+         */
+        inline constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+        /**
+         * @struct SnapshotContents
+         * @brief Содержимое снимка: таблица студентов и следующий свободный ID.
+         */
+        struct SnapshotContents
+        {
+            StudentTable table;
+            int nextId = 1;
+        };
+
+        /**
+         * @brief Записывает таблицу студентов в двоичный файл снимка.
+         *
+         * Формат (все целые — little-endian):
+         * - заголовок: сигнатура "STUDREG\0", версия формата, число студентов,
+         *   следующий ID, размер словаря строк;
+         * - словарь строк: индексы групп, темы и места УИР/ДП (повторяющиеся
+         *   значения), каждая строка хранится один раз с длиной-префиксом;
+         * - записи студентов: ID, категория, кафедра, ссылка на группу в словаре,
+         *   имя с длиной-префиксом и данные категории; целые числа кодируются
+         *   varint, оценки из диапазона 0..15 упаковываются по две в байт.
+         *
+         * Запись выполняется через буфер большого размера, поэтому файл пишется
+         * крупными блоками.
+         *
+         * @param path Путь к файлу (перезаписывается).
+         * @param table Таблица студентов.
+         * @param nextId Следующий свободный ID.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         */
+        void writeSnapshot(const std::filesystem::path &path, const StudentTable &table, int nextId);
+
+        /**
+         * @brief Читает двоичный файл снимка.
+         *
+         * Файл читается целиком одним вызовом, таблица заранее резервируется
+         * под число студентов из заголовка, поэтому загрузка не выполняет
+         * промежуточных перехеширований.
+         *
+         * @param path Путь к файлу.
+         * @return Таблица студентов и следующий свободный ID.
+         * @throw std::runtime_error если файл не открывается, имеет другую версию формата или повреждён.
+         */
+        SnapshotContents readSnapshot(const std::filesystem::path &path);
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "Student.h"
+#include "StudentGrades.h"
+#include "StudentTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace university
+{
+    namespace storage
+    {
+
+        /**
+         * @brief Текущая версия формата отображаемого в память файла реестра.
+         */
+        inline constexpr uint32_t MAPPED_FORMAT_VERSION = 1;
+
+        /**
+         * @struct StringRef
+         * @brief Ссылка на строку в куче строк файла: смещение и длина в байтах.
+         */
+        struct StringRef
+        {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        /**
+         * @struct MappedStudentRecord
+         * @brief Запись студента фиксированной ширины в отображаемом файле.
+         *
+         * Поля, не относящиеся к категории студента, равны нулю. Для старшекурсника
+         * secondGrade — оценка комиссии за УИР, для выпускника — оценка рецензента.
+         */
+        struct MappedStudentRecord
+        {
+            int32_t id;
+            int32_t departmentNumber;
+            uint8_t category;
+            uint8_t gradeCount;
+            uint16_t reserved;
+            uint32_t groupCode;
+            StringRef name;
+            StringRef topic;
+            StringRef place;
+            int32_t sessionGrades[5];
+            int32_t supervisorGrade;
+            int32_t secondGrade;
+            int32_t stateCommissionGrade;
+        };
+
+        static_assert(sizeof(MappedStudentRecord) == 72, "Размер записи входит в формат файла");
+        static_assert(std::is_trivially_copyable_v<MappedStudentRecord>);
+
+        /**
+         * @struct MappedIndexSlot
+         * @brief Слот индекса ID: ID студента и номер его записи (UINT32_MAX — пустой слот).
+         */
+        struct MappedIndexSlot
+        {
+            int32_t id;
+            uint32_t record;
+        };
+
+        /**
+         * @brief Вычисляет сводку оценок записи так же, как summarizeGrades для студента.
+         * @param record Запись студента.
+         * @return Сумма и количество оценок.
+         */
+        GradeSummary summarizeGrades(const MappedStudentRecord &record);
+
+        /**
+         * @brief Записывает таблицу студентов в файл, пригодный для отображения в память.
+         *
+         * Файл состоит из заголовка, таблицы записей фиксированной ширины
+         * (упорядоченных по ID), таблицы групп (плотные коды групп), индекса ID
+         * (открытая адресация, степень двойки слотов) и кучи строк. Все секции
+         * выровнены по 8 байт, целые хранятся в порядке little-endian.
+         *
+         * @param path Путь к файлу (перезаписывается).
+         * @param table Таблица студентов.
+         * @param nextId Следующий свободный ID.
+         * @throw std::runtime_error при ошибке ввода-вывода или если данные не помещаются в формат.
+         */
+        void writeMappedRegistry(const std::filesystem::path &path, const StudentTable &table, int nextId);
+
+        /**
+         * @class MappedRegistry
+         * @brief Реестр студентов, читаемый напрямую из отображённого в память файла.
+         *
+         * Открытие проверяет только заголовок и границы секций, поэтому его время
+         * не зависит от размера реестра. Объекты Student не создаются: поиск идёт
+         * по индексу в файле, агрегации читают записи фиксированной ширины.
+         * Отображение разделяемое и только для чтения, поэтому несколько процессов
+         * используют одни и те же страницы кэша файловой системы.
+         */
+        class MappedRegistry
+        {
+        public:
+            /**
+             * @brief Отображает файл реестра в память.
+             * @param path Путь к файлу, созданному writeMappedRegistry.
+             * @throw std::runtime_error если файл недоступен, имеет другую версию формата или повреждён.
+             */
+            explicit MappedRegistry(const std::filesystem::path &path);
+
+            ~MappedRegistry();
+
+            MappedRegistry(const MappedRegistry &) = delete;
+            MappedRegistry &operator=(const MappedRegistry &) = delete;
+
+            /**
+             * @brief Получает количество студентов.
+             * @return Количество записей.
+             */
+            [[nodiscard]] size_t size() const { return records_.size(); }
+
+            /**
+             * @brief Получает количество слотов для параллельного обхода (см. parallelForSlots).
+             * @return Количество записей: каждая запись — занятый слот.
+             */
+            [[nodiscard]] size_t bucketCount() const { return records_.size(); }
+
+            /**
+             * @brief Получает следующий свободный ID, сохранённый в файле.
+             * @return Следующий ID.
+             */
+            [[nodiscard]] int nextId() const { return nextId_; }
+
+            /**
+             * @brief Получает все записи в порядке возрастания ID.
+             * @return Записи в отображённой памяти.
+             */
+            [[nodiscard]] std::span<const MappedStudentRecord> records() const { return records_; }
+
+            /**
+             * @brief Находит запись по ID через индекс файла.
+             * @param id ID студента.
+             * @return Указатель на запись или nullptr, если студент не найден.
+             */
+            [[nodiscard]] const MappedStudentRecord *find(int id) const;
+
+            /**
+             * @brief Получает строку из кучи строк.
+             * @param ref Ссылка на строку.
+             * @return Представление строки в отображённой памяти.
+             * @throw std::runtime_error если ссылка выходит за пределы кучи.
+             */
+            [[nodiscard]] std::string_view string(StringRef ref) const;
+
+            /**
+             * @brief Получает количество различных групп.
+             * @return Размер таблицы групп.
+             */
+            [[nodiscard]] size_t groupCount() const { return groups_.size(); }
+
+            /**
+             * @brief Получает индекс группы по её плотному коду.
+             * @param code Код группы из MappedStudentRecord::groupCode.
+             * @return Индекс группы.
+             * @throw std::runtime_error если код вне таблицы групп.
+             */
+            [[nodiscard]] std::string_view groupName(uint32_t code) const;
+
+            /**
+             * @brief Создаёт объект студента по записи (для вывода одного студента).
+             * @param record Запись студента.
+             * @return Новый объект студента соответствующей категории.
+             * @throw std::runtime_error если запись повреждена.
+             */
+            [[nodiscard]] std::unique_ptr<Student> materialize(const MappedStudentRecord &record) const;
+
+        private:
+            void *mapping_ = nullptr;
+            size_t mappingSize_ = 0;
+            int nextId_ = 1;
+            std::span<const MappedStudentRecord> records_;
+            std::span<const StringRef> groups_;
+            std::span<const MappedIndexSlot> index_;
+            std::string_view strings_;
+        };
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "StudentTable.h"
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace university
+{
+    namespace storage
+    {
+
+        /**
+         * @enum ExportFormat
+         * @brief Формат выгрузки.
+         */
+        enum class ExportFormat
+        {
+            CSV, ///< Столбцы CSV_COLUMNS, совместимо с importStudentsCsv
+            JSON ///< Массив объектов с ID и всеми полями студента
+        };
+
+        /**
+         * @struct ExportOptions
+         * @brief Настройки выгрузки.
+         */
+        struct ExportOptions
+        {
+            ExportFormat format = ExportFormat::CSV;
+            char delimiter = ',';                ///< Разделитель полей CSV ('\t' для TSV)
+            unsigned threads = 1;                ///< Потоков форматирования (0 — по числу ядер)
+            size_t bufferSize = size_t{4} << 20; ///< Размер буфера, после которого данные передаются в файл
+        };
+
+        /**
+         * @struct ExportReport
+         * @brief Итоги выгрузки.
+         */
+        struct ExportReport
+        {
+            size_t rows = 0;      ///< Выгружено записей
+            size_t bytes = 0;     ///< Записано байт
+            double seconds = 0.0; ///< Время выгрузки
+
+            /**
+             * @brief Вычисляет скорость выгрузки.
+             * @return Байт в секунду.
+             */
+            [[nodiscard]] double bytesPerSecond() const
+            {
+                return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+            }
+        };
+
+        /**
+         * @brief Выгружает студентов таблицы в файл.
+         *
+         * Записи форматируются в буфер многократного использования (числа —
+         * std::to_chars) и передаются в файл крупными блоками. При threads > 1
+         * слоты таблицы делятся на фрагменты, которые форматируются параллельно
+         * и записываются в исходном порядке; результат не зависит от числа потоков.
+         * Таблица не должна изменяться во время выгрузки (передаётся снимок).
+         *
+         * @param table Таблица студентов.
+         * @param path Путь к файлу (перезаписывается).
+         * @param options Настройки выгрузки.
+         * @return Отчёт о выгрузке.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         */
+        ExportReport exportStudents(const StudentTable &table, const std::filesystem::path &path, const ExportOptions &options = {});
+
+        /**
+         * @brief Выгружает средние оценки по группам.
+         *
+         * CSV — столбцы group и average; JSON — объект «группа: средняя оценка».
+         *
+         * @param averages Карта индекса группы к средней оценке.
+         * @param path Путь к файлу (перезаписывается).
+         * @param options Настройки выгрузки (threads не используется).
+         * @return Отчёт о выгрузке.
+         * @throw std::runtime_error при ошибке ввода-вывода.
+         */
+        ExportReport exportGroupAverages(const std::map<std::string, double> &averages, const std::filesystem::path &path,
+                                         const ExportOptions &options = {});
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Student.h"
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace university
+{
+    namespace storage
+    {
+
+        /**
+         * @brief Столбцы файла студентов в порядке следования.
+         *
+         * category — junior, senior или graduate; grades — сессионные оценки через
+         * пробел; topic, place, supervisor_grade — тема, место и оценка руководителя
+         * УИР или дипломного проекта; second_grade — оценка комиссии за УИР или
+         * рецензента ДП; state_commission_grade — оценка ГЭК. Поля, не относящиеся
+         * к категории, пусты и в конце строки могут быть опущены. Поле может быть
+         * заключено в двойные кавычки (кавычка внутри удваивается); перевод строки
+         * внутри поля не допускается.
+         */
+        inline constexpr std::array<std::string_view, 10> CSV_COLUMNS = {
+            "category", "name", "group", "department", "grades",
+            "topic", "place", "supervisor_grade", "second_grade", "state_commission_grade"};
+
+        /**
+         * @brief Значения столбца category, по индексу StudentCategory.
+         */
+        inline constexpr std::array<std::string_view, 3> CSV_CATEGORY_NAMES = {"junior", "senior", "graduate"};
+
+        /**
+         * @struct CsvImportOptions
+         * @brief Настройки импорта.
+         */
+        struct CsvImportOptions
+        {
+            char delimiter = ',';                    ///< ',' для CSV, '\t' для TSV
+            bool hasHeader = true;                   ///< Первая строка — заголовок и пропускается
+            unsigned threads = 0;                    ///< Потоков разбора (0 — по числу ядер)
+            size_t chunkSize = size_t{4} << 20;      ///< Размер читаемого блока, байт
+            size_t maxReportedErrors = 100;          ///< Сколько ошибок сохранять с описанием
+        };
+
+        /**
+         * @struct CsvRowError
+         * @brief Описание некорректной строки.
+         */
+        struct CsvRowError
+        {
+            size_t line;         ///< Номер строки в файле, начиная с 1
+            std::string message; ///< Причина
+        };
+
+        /**
+         * @struct CsvImportReport
+         * @brief Итоги импорта.
+         */
+        struct CsvImportReport
+        {
+            size_t rowsRead = 0;             ///< Непустых строк данных
+            size_t rowsImported = 0;         ///< Строк, переданных в реестр
+            size_t malformedRows = 0;        ///< Некорректных строк (всего)
+            std::vector<CsvRowError> errors; ///< Первые maxReportedErrors ошибок по возрастанию номера строки
+            double seconds = 0.0;            ///< Время импорта
+
+            /**
+             * @brief Вычисляет скорость импорта.
+             * @return Прочитанных строк в секунду.
+             */
+            [[nodiscard]] double rowsPerSecond() const
+            {
+                return seconds > 0.0 ? static_cast<double>(rowsRead) / seconds : 0.0;
+            }
+        };
+
+        /**
+         * @brief Функция, принимающая студентов очередного блока в порядке строк файла.
+         */
+        using StudentBatchSink = std::function<void(std::vector<std::unique_ptr<Student>> students)>;
+
+        /**
+         * @brief Разбирает одну строку файла студентов.
+         * @param line Строка без символа перевода строки.
+         * @param delimiter Разделитель полей.
+         * @return Новый студент.
+         * @throw std::invalid_argument если строка некорректна.
+         */
+        std::unique_ptr<Student> parseStudentRow(std::string_view line, char delimiter);
+
+        /**
+         * @brief Потоково импортирует студентов из CSV/TSV файла.
+         *
+         * Файл читается блоками по chunkSize, обрезанными по последнему переводу
+         * строки. Блок делится на части по числу потоков, и части разбираются
+         * параллельно: поля остаются представлениями внутри блока, числа читаются
+         * std::from_chars, строки создаются только для полей, хранимых в студенте.
+         * Студенты блока передаются в sink одним пакетом; некорректные строки
+         * пропускаются и попадают в отчёт.
+         *
+         * @param path Путь к файлу.
+         * @param options Настройки импорта.
+         * @param sink Получатель пакетов студентов.
+         * @return Отчёт об импорте.
+         * @throw std::runtime_error если файл недоступен.
+         */
+        CsvImportReport importStudentsCsv(const std::filesystem::path &path, const CsvImportOptions &options,
+                                          const StudentBatchSink &sink);
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "Student.h"
+#include "SeniorStudent.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+    namespace storage
+    {
+
+        /**
+         * @brief Текущая версия формата журнала упреждающей записи.
+         */
+        inline constexpr uint32_t WAL_FORMAT_VERSION = 1;
+
+        /**
+         * @enum Durability
+         * @brief Когда изменения, записанные в журнал, сбрасываются на диск.
+         */
+        enum class Durability
+        {
+            EVERY_OPERATION, ///< Операция завершается только после fdatasync (групповая фиксация)
+            INTERVAL,        ///< Фоновый поток сбрасывает журнал на диск каждые flushInterval
+            NONE             ///< Фоновый поток передаёт журнал ОС без fdatasync
+        };
+
+        /**
+         * @struct WalOptions
+         * @brief Настройки журнала.
+         */
+        struct WalOptions
+        {
+            Durability durability = Durability::INTERVAL;
+            std::chrono::milliseconds flushInterval{10};
+        };
+
+        /**
+         * @enum WalOperation
+         * @brief Вид записи журнала.
+         *
+         * Каждая запись задаёт итоговое состояние (а не приращение), поэтому
+         * повторное применение журнала к снимку, уже содержащему эти изменения,
+         * даёт то же состояние.
+         */
+        enum class WalOperation : uint8_t
+        {
+            PUT = 1,               ///< Студент с ID добавлен или заменён (добавление, перевод)
+            REMOVE = 2,            ///< Студент с ID удалён
+            SET_GROUP = 3,         ///< Изменена группа студента
+            SET_RESEARCH_WORK = 4, ///< Изменена УИР старшекурсника
+            BATCH = 5              ///< Пакет записей, который применяется целиком
+        };
+
+        /**
+         * @struct WalEntry
+         * @brief Запись журнала. Заполнены только поля, относящиеся к операции;
+         * записи создаются фабричными функциями put, remove, setGroup, setResearchWork, batch.
+         *
+         * Пакет хранится в журнале одной записью с одной контрольной суммой,
+         * поэтому при восстановлении он либо применяется полностью, либо
+         * (оборванный при сбое) отбрасывается целиком.
+         */
+        struct WalEntry
+        {
+            WalOperation operation = WalOperation::PUT;
+            int id = 0;
+            std::shared_ptr<const Student> student;
+            std::string groupIndex;
+            ResearchWork researchWork{};
+            std::vector<WalEntry> entries; ///< Записи пакета (только для BATCH)
+
+            static WalEntry put(int id, std::shared_ptr<const Student> student)
+            {
+                WalEntry entry;
+                entry.operation = WalOperation::PUT;
+                entry.id = id;
+                entry.student = std::move(student);
+                return entry;
+            }
+
+            static WalEntry remove(int id)
+            {
+                WalEntry entry;
+                entry.operation = WalOperation::REMOVE;
+                entry.id = id;
+                return entry;
+            }
+
+            static WalEntry setGroup(int id, std::string groupIndex)
+            {
+                WalEntry entry;
+                entry.operation = WalOperation::SET_GROUP;
+                entry.id = id;
+                entry.groupIndex = std::move(groupIndex);
+                return entry;
+            }
+
+            static WalEntry setResearchWork(int id, ResearchWork work)
+            {
+                WalEntry entry;
+                entry.operation = WalOperation::SET_RESEARCH_WORK;
+                entry.id = id;
+                entry.researchWork = std::move(work);
+                return entry;
+            }
+
+            /**
+             * @param entries Записи пакета в порядке применения; вложенные пакеты не допускаются.
+             */
+            static WalEntry batch(std::vector<WalEntry> entries)
+            {
+                WalEntry entry;
+                entry.operation = WalOperation::BATCH;
+                entry.entries = std::move(entries);
+                return entry;
+            }
+        };
+
+        /**
+         * @struct WalStats
+         * @brief Счётчики журнала.
+         */
+        struct WalStats
+        {
+            uint64_t records = 0; ///< Добавлено записей
+            uint64_t bytes = 0;   ///< Добавлено байт (с заголовками записей)
+            uint64_t writes = 0;  ///< Пакетов, переданных ОС
+            uint64_t syncs = 0;   ///< Вызовов fdatasync
+        };
+
+        /**
+         * @brief Сбрасывает содержимое файла или каталога на диск (fsync).
+         * @param path Путь к файлу или каталогу.
+         * @throw std::runtime_error при ошибке.
+         */
+        void syncPath(const std::filesystem::path &path);
+
+        /**
+         * @class WriteAheadLog
+         * @brief Журнал упреждающей записи изменений реестра с групповой фиксацией.
+         *
+         * Записи сначала накапливаются в буфере памяти. В режиме EVERY_OPERATION
+         * первый ожидающий поток становится ведущим: он забирает весь буфер,
+         * записывает его одним вызовом и выполняет один fdatasync, а потоки,
+         * добавившие записи за это время, ждут его результата. Так несколько
+         * одновременных изменений разделяют стоимость одной синхронизации.
+         *
+         * Позиция в журнале (LSN) — количество байт записей от создания журнала;
+         * она не меняется при отбрасывании префикса после контрольной точки.
+         *
+         * Файл: заголовок (сигнатура, версия, LSN первой записи) и записи вида
+         * [длина][контрольная сумма FNV-1a][данные]. Недописанный хвост после
+         * сбоя распознаётся по длине или контрольной сумме последней записи и
+         * отбрасывается; повреждённая запись в середине файла — ошибка.
+         */
+        class WriteAheadLog
+        {
+        public:
+            /**
+             * @brief Открывает журнал для дозаписи (создаёт файл, если его нет).
+             *
+             * Недописанный хвост существующего журнала (неполная последняя запись
+             * или последняя запись с неверной контрольной суммой) обрезается.
+             *
+             * @param path Путь к файлу журнала.
+             * @param options Режим сохранности.
+             * @throw std::runtime_error если файл недоступен, не является журналом или
+             *        повреждён в середине (файл при этом не изменяется).
+             */
+            explicit WriteAheadLog(const std::filesystem::path &path, WalOptions options = {});
+
+            /**
+             * @brief Останавливает фоновый поток и сбрасывает оставшиеся записи.
+             */
+            ~WriteAheadLog();
+
+            WriteAheadLog(const WriteAheadLog &) = delete;
+            WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+            /**
+             * @brief Добавляет запись в буфер журнала.
+             *
+             * Порядок записей в журнале совпадает с порядком вызовов, поэтому
+             * вызывающий должен добавлять записи в том же порядке, в каком
+             * применяет изменения (например, под блокировкой на запись).
+             *
+             * @param entry Запись.
+             * @return LSN конца записи для передачи в commit().
+             * @throw std::runtime_error если ранее произошла ошибка записи.
+             */
+            uint64_t append(const WalEntry &entry);
+
+            /**
+             * @brief Завершает операцию в соответствии с режимом сохранности.
+             *
+             * В режиме EVERY_OPERATION ждёт, пока запись с данным LSN не окажется
+             * на диске; в остальных режимах возвращается сразу.
+             *
+             * @param lsn Значение, полученное от append().
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void commit(uint64_t lsn);
+
+            /**
+             * @brief Записывает все накопленные записи и выполняет fdatasync.
+             * @throw std::runtime_error при ошибке записи.
+             */
+            void sync();
+
+            /**
+             * @brief Получает LSN конца последней добавленной записи.
+             * @return LSN.
+             */
+            [[nodiscard]] uint64_t endLsn() const;
+
+            /**
+             * @brief Отбрасывает записи до заданного LSN (после контрольной точки).
+             *
+             * Оставшийся хвост переписывается в новый файл, который атомарно
+             * заменяет старый. Основная часть хвоста копируется и сбрасывается на
+             * диск без мьютекса журнала; append и commit ждут только дозаписи
+             * записей, появившихся за время копирования, fdatasync нового файла,
+             * его переименования и синхронизации каталога.
+             *
+             * @param lsn Граница записи, полученная от endLsn().
+             * @throw std::runtime_error при ошибке ввода-вывода.
+             */
+            void discardBefore(uint64_t lsn);
+
+            /**
+             * @brief Получает счётчики журнала.
+             * @return Счётчики.
+             */
+            [[nodiscard]] WalStats stats() const;
+
+            /**
+             * @brief Читает журнал и передаёт записи в функцию по порядку.
+             *
+             * Чтение останавливается на недописанном хвосте (см. конструктор).
+             *
+             * @param path Путь к файлу журнала; отсутствующий файл — пустой журнал.
+             * @param apply Функция, вызываемая для каждой записи.
+             * @return Количество прочитанных записей.
+             * @throw std::runtime_error если файл не является журналом или повреждён в середине.
+             */
+            static size_t replay(const std::filesystem::path &path, const std::function<void(const WalEntry &)> &apply);
+
+        private:
+            /**
+             * @brief Передаёт буфер ОС (и при необходимости на диск), пока не будет покрыт LSN.
+             * @param lock Захваченный мьютекс журнала.
+             * @param lsn Требуемая позиция.
+             * @param durable Выполнять ли fdatasync.
+             */
+            void flushUpTo(std::unique_lock<std::mutex> &lock, uint64_t lsn, bool durable);
+
+            void runFlusher();
+            void rethrowError() const;
+
+            std::filesystem::path path_;
+            WalOptions options_;
+            int fd_ = -1;
+            uint64_t baseLsn_ = 0;    // LSN первой записи в файле
+            uint64_t endLsn_ = 0;     // LSN конца добавленных записей
+            uint64_t writtenLsn_ = 0; // Передано ОС
+            uint64_t durableLsn_ = 0; // Сброшено на диск
+            std::vector<char> pending_;
+            bool flushing_ = false;
+            bool stopping_ = false;
+            std::exception_ptr error_;
+            WalStats stats_;
+            mutable std::mutex mutex_;
+            std::mutex compactionMutex_; // Удерживается всё время discardBefore
+            std::condition_variable flushed_;
+            std::condition_variable wake_;
+            std::thread flusher_;
+        };
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,308 @@
+#include "BinarySnapshot.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+#include "Encoding.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+    namespace storage
+    {
+        namespace
+        {
+            constexpr char MAGIC[8] = {'S', 'T', 'U', 'D', 'R', 'E', 'G', '\0'};
+            constexpr size_t WRITE_BUFFER_SIZE = size_t{1} << 20; // 1 МиБ
+            constexpr const char *SOURCE = "файл снимка";
+
+            /**
+             * @class SnapshotFile
+             * @brief Файл снимка, в который закодированные данные пишутся блоками по 1 МиБ.
+             */
+            class SnapshotFile
+            {
+            public:
+                explicit SnapshotFile(const std::filesystem::path &path) : out_(path, std::ios::binary | std::ios::trunc)
+                {
+                    if (!out_)
+                    {
+                        throw std::runtime_error("Не удалось открыть файл для записи: " + path.string());
+                    }
+                    buffer_.reserve(WRITE_BUFFER_SIZE + WRITE_BUFFER_SIZE / 4);
+                }
+
+                detail::ByteWriter &buffer() { return buffer_; }
+
+                void flushIfFull()
+                {
+                    if (buffer_.size() >= WRITE_BUFFER_SIZE)
+                    {
+                        flush();
+                    }
+                }
+
+                void finish()
+                {
+                    flush();
+                    out_.close();
+                    if (!out_)
+                    {
+                        throw std::runtime_error("Ошибка при закрытии файла снимка.");
+                    }
+                }
+
+            private:
+                void flush()
+                {
+                    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                    if (!out_)
+                    {
+                        throw std::runtime_error("Ошибка записи файла снимка.");
+                    }
+                    buffer_.clear();
+                }
+
+                std::ofstream out_;
+                detail::ByteWriter buffer_;
+            };
+
+            /**
+             * @class StringDictionary
+             * @brief Словарь повторяющихся строк: каждая строка получает номер при первом появлении.
+             */
+            class StringDictionary
+            {
+            public:
+                uint32_t intern(const std::string &value)
+                {
+                    auto [it, inserted] = codes_.try_emplace(value, static_cast<uint32_t>(strings_.size()));
+                    if (inserted)
+                    {
+                        strings_.push_back(value);
+                    }
+                    return it->second;
+                }
+
+                [[nodiscard]] const std::vector<std::string_view> &strings() const { return strings_; }
+
+            private:
+                std::unordered_map<std::string_view, uint32_t> codes_;
+                std::vector<std::string_view> strings_;
+            };
+
+            std::string getDictionaryString(detail::ByteReader &in, const std::vector<std::string_view> &dictionary)
+            {
+                uint64_t code = in.getVarint();
+                if (code >= dictionary.size())
+                {
+                    in.fail("ссылка за пределы словаря строк");
+                }
+                return std::string(dictionary[code]);
+            }
+
+            std::shared_ptr<const Student> readStudent(detail::ByteReader &in, const std::vector<std::string_view> &dictionary, StudentCategory category,
+                                                       std::string name, std::string group, int department)
+            {
+                switch (category)
+                {
+                case StudentCategory::JUNIOR:
+                    return std::make_shared<JuniorStudent>(std::move(name), std::move(group), department, detail::getGrades(in));
+                case StudentCategory::SENIOR:
+                {
+                    auto grades = detail::getGrades(in);
+                    ResearchWork work{};
+                    work.supervisorGrade = in.getInt();
+                    work.commissionGrade = in.getInt();
+                    work.topic = getDictionaryString(in, dictionary);
+                    work.place = getDictionaryString(in, dictionary);
+                    return std::make_shared<SeniorStudent>(std::move(name), std::move(group), department, std::move(grades), std::move(work));
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    DiplomaProject project{};
+                    project.supervisorGrade = in.getInt();
+                    project.reviewerGrade = in.getInt();
+                    project.stateCommissionGrade = in.getInt();
+                    project.topic = getDictionaryString(in, dictionary);
+                    project.place = getDictionaryString(in, dictionary);
+                    return std::make_shared<GraduateStudent>(std::move(name), std::move(group), department, std::move(project));
+                }
+                default:
+                    in.fail("неизвестная категория студента");
+                }
+            }
+
+        } // namespace
+
+        void writeSnapshot(const std::filesystem::path &path, const StudentTable &table, int nextId)
+        {
+            // Первый проход: словарь повторяющихся строк и число записей. Коды строк
+            // сохраняются в порядке обхода, чтобы второй проход не хешировал строки повторно
+            StringDictionary dictionary;
+            std::vector<uint32_t> codes;
+            codes.reserve(table.size() * 3);
+            uint64_t studentCount = 0;
+            table.forEachInRange(0, table.bucketCount(), [&](int, const std::shared_ptr<const Student> &student)
+                                 {
+                if (!student)
+                {
+                    return;
+                }
+                ++studentCount;
+                codes.push_back(dictionary.intern(student->getGroupIndex()));
+                if (student->getCategory() == StudentCategory::SENIOR)
+                {
+                    const auto &work = dynamic_cast<const SeniorStudent &>(*student).getResearchWork();
+                    codes.push_back(dictionary.intern(work.topic));
+                    codes.push_back(dictionary.intern(work.place));
+                }
+                else if (student->getCategory() == StudentCategory::GRADUATE)
+                {
+                    const auto &project = dynamic_cast<const GraduateStudent &>(*student).getDiplomaProject();
+                    codes.push_back(dictionary.intern(project.topic));
+                    codes.push_back(dictionary.intern(project.place));
+                } });
+
+            SnapshotFile file(path);
+            auto &out = file.buffer();
+            out.putBytes(MAGIC, sizeof(MAGIC));
+            out.putFixed32(SNAPSHOT_FORMAT_VERSION);
+            out.putFixed64(studentCount);
+            out.putFixed32(static_cast<uint32_t>(nextId));
+            out.putFixed32(static_cast<uint32_t>(dictionary.strings().size()));
+            for (auto value : dictionary.strings())
+            {
+                out.putString(value);
+            }
+
+            // Второй проход: записи студентов
+            size_t nextCode = 0;
+            table.forEachInRange(0, table.bucketCount(), [&](int id, const std::shared_ptr<const Student> &student)
+                                 {
+                if (!student)
+                {
+                    return;
+                }
+                file.flushIfFull();
+                out.putSigned(id);
+                out.putByte(static_cast<uint8_t>(student->getCategory()));
+                out.putSigned(student->getDepartmentNumber());
+                out.putVarint(codes[nextCode++]);
+                out.putString(student->getName());
+
+                switch (student->getCategory())
+                {
+                case StudentCategory::JUNIOR:
+                    detail::putGrades(out, dynamic_cast<const JuniorStudent &>(*student).getSessionGrades());
+                    break;
+                case StudentCategory::SENIOR:
+                {
+                    const auto &senior = dynamic_cast<const SeniorStudent &>(*student);
+                    const auto &work = senior.getResearchWork();
+                    detail::putGrades(out, senior.getSessionGrades());
+                    out.putSigned(work.supervisorGrade);
+                    out.putSigned(work.commissionGrade);
+                    out.putVarint(codes[nextCode++]);
+                    out.putVarint(codes[nextCode++]);
+                    break;
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    const auto &project = dynamic_cast<const GraduateStudent &>(*student).getDiplomaProject();
+                    out.putSigned(project.supervisorGrade);
+                    out.putSigned(project.reviewerGrade);
+                    out.putSigned(project.stateCommissionGrade);
+                    out.putVarint(codes[nextCode++]);
+                    out.putVarint(codes[nextCode++]);
+                    break;
+                }
+                } });
+            file.finish();
+        }
+
+        SnapshotContents readSnapshot(const std::filesystem::path &path)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+            {
+                throw std::runtime_error("Не удалось открыть файл снимка: " + path.string());
+            }
+            std::vector<char> data(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(data.data(), static_cast<std::streamsize>(data.size())))
+            {
+                throw std::runtime_error("Ошибка чтения файла снимка: " + path.string());
+            }
+
+            detail::ByteReader in(std::string_view(data.data(), data.size()), SOURCE);
+            if (std::memcmp(in.getBytes(sizeof(MAGIC)).data(), MAGIC, sizeof(MAGIC)) != 0)
+            {
+                throw std::runtime_error("Файл не является снимком реестра: " + path.string());
+            }
+            uint32_t formatVersion = in.getFixed32();
+            if (formatVersion != SNAPSHOT_FORMAT_VERSION)
+            {
+                throw std::runtime_error("Неподдерживаемая версия формата снимка: " + std::to_string(formatVersion));
+            }
+            uint64_t studentCount = in.getFixed64();
+            auto nextId = static_cast<int>(in.getFixed32());
+            uint32_t dictionarySize = in.getFixed32();
+            // Любая запись занимает не меньше нескольких байт
+            if (studentCount > in.remaining() || dictionarySize > in.remaining())
+            {
+                in.fail("некорректный заголовок");
+            }
+
+            std::vector<std::string_view> dictionary;
+            dictionary.reserve(dictionarySize);
+            for (uint32_t i = 0; i < dictionarySize; ++i)
+            {
+                dictionary.push_back(in.getString());
+            }
+
+            SnapshotContents contents{StudentTable(16), nextId};
+            contents.table.reserve(studentCount);
+            for (uint64_t i = 0; i < studentCount; ++i)
+            {
+                int id = in.getInt();
+                uint8_t category = in.getByte();
+                int department = in.getInt();
+                std::string group = getDictionaryString(in, dictionary);
+                std::string name(in.getString());
+
+                std::shared_ptr<const Student> student;
+                try
+                {
+                    student = readStudent(in, dictionary, static_cast<StudentCategory>(category), std::move(name), std::move(group), department);
+                }
+                catch (const std::invalid_argument &error)
+                {
+                    // Конструкторы студентов проверяют данные: нарушение означает повреждённый файл
+                    in.fail(error.what());
+                }
+
+                if (!contents.table.insert(id, std::move(student)))
+                {
+                    in.fail("повторяющийся ID " + std::to_string(id));
+                }
+                nextId = std::max(nextId, id + 1);
+            }
+            if (in.remaining() != 0)
+            {
+                in.fail("лишние данные после записей");
+            }
+            contents.nextId = nextId;
+            return contents;
+        }
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace university
+{
+    namespace storage
+    {
+        namespace detail
+        {
+
+            /**
+             * @class ByteWriter
+             * @brief Накопитель закодированных данных: целые little-endian, varint и строки с длиной-префиксом.
+             */
+            class ByteWriter
+            {
+            public:
+                void putByte(uint8_t value) { bytes_.push_back(static_cast<char>(value)); }
+
+                void putFixed32(uint32_t value)
+                {
+                    for (int shift = 0; shift < 32; shift += 8)
+                    {
+                        bytes_.push_back(static_cast<char>((value >> shift) & 0xFF));
+                    }
+                }
+
+                void putFixed64(uint64_t value)
+                {
+                    for (int shift = 0; shift < 64; shift += 8)
+                    {
+                        bytes_.push_back(static_cast<char>((value >> shift) & 0xFF));
+                    }
+                }
+
+                void putVarint(uint64_t value)
+                {
+                    while (value >= 0x80)
+                    {
+                        bytes_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                        value >>= 7;
+                    }
+                    bytes_.push_back(static_cast<char>(value));
+                }
+
+                void putSigned(int64_t value)
+                {
+                    // Zigzag: небольшие отрицательные числа тоже занимают один байт
+                    putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+                }
+
+                void putBytes(const char *data, size_t size) { bytes_.insert(bytes_.end(), data, data + size); }
+
+                void putString(std::string_view value)
+                {
+                    putVarint(value.size());
+                    putBytes(value.data(), value.size());
+                }
+
+                [[nodiscard]] const char *data() const { return bytes_.data(); }
+                [[nodiscard]] size_t size() const { return bytes_.size(); }
+                void reserve(size_t capacity) { bytes_.reserve(capacity); }
+                void clear() { bytes_.clear(); }
+
+            private:
+                std::vector<char> bytes_;
+            };
+
+            /**
+             * @class ByteReader
+             * @brief Последовательно декодирует данные ByteWriter с проверкой границ.
+             *
+             * Любое нарушение формата приводит к std::runtime_error с описанием источника.
+             */
+            class ByteReader
+            {
+            public:
+                /**
+                 * @param data Декодируемые байты.
+                 * @param source Название источника для сообщений об ошибках, например "файл снимка".
+                 */
+                ByteReader(std::string_view data, const char *source) : data_(data), source_(source) {}
+
+                [[nodiscard]] size_t remaining() const { return data_.size() - position_; }
+                [[nodiscard]] size_t position() const { return position_; }
+
+                [[noreturn]] void fail(const std::string &reason) const
+                {
+                    throw std::runtime_error(std::string("Повреждённый ") + source_ + ": " + reason);
+                }
+
+                uint8_t getByte()
+                {
+                    require(1);
+                    return static_cast<uint8_t>(data_[position_++]);
+                }
+
+                uint32_t getFixed32()
+                {
+                    require(4);
+                    uint32_t value = 0;
+                    for (int shift = 0; shift < 32; shift += 8)
+                    {
+                        value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[position_++])) << shift;
+                    }
+                    return value;
+                }
+
+                uint64_t getFixed64()
+                {
+                    require(8);
+                    uint64_t value = 0;
+                    for (int shift = 0; shift < 64; shift += 8)
+                    {
+                        value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[position_++])) << shift;
+                    }
+                    return value;
+                }
+
+                uint64_t getVarint()
+                {
+                    uint64_t value = 0;
+                    for (int shift = 0; shift < 64; shift += 7)
+                    {
+                        uint8_t byte = getByte();
+                        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                        if ((byte & 0x80) == 0)
+                        {
+                            return value;
+                        }
+                    }
+                    fail("слишком длинное число");
+                }
+
+                int getInt()
+                {
+                    uint64_t encoded = getVarint();
+                    auto value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+                    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+                    {
+                        fail("число вне диапазона int");
+                    }
+                    return static_cast<int>(value);
+                }
+
+                std::string_view getBytes(size_t size)
+                {
+                    require(size);
+                    std::string_view bytes = data_.substr(position_, size);
+                    position_ += size;
+                    return bytes;
+                }
+
+                std::string_view getString() { return getBytes(getVarint()); }
+
+            private:
+                void require(uint64_t size) const
+                {
+                    if (size > remaining())
+                    {
+                        fail("неожиданный конец данных");
+                    }
+                }
+
+                std::string_view data_;
+                const char *source_;
+                size_t position_ = 0;
+            };
+
+            /**
+             * @brief Кодирует оценки: количество и флаг упаковки, затем оценки 0..15 по две в байт или varint.
+             */
+            inline void putGrades(ByteWriter &out, const std::vector<int> &grades)
+            {
+                bool packed = std::all_of(grades.begin(), grades.end(), [](int grade)
+                                          { return grade >= 0 && grade <= 15; });
+                out.putVarint((static_cast<uint64_t>(grades.size()) << 1) | (packed ? 1 : 0));
+                if (packed)
+                {
+                    for (size_t i = 0; i < grades.size(); i += 2)
+                    {
+                        auto byte = static_cast<uint8_t>(grades[i]);
+                        if (i + 1 < grades.size())
+                        {
+                            byte = static_cast<uint8_t>(byte | (grades[i + 1] << 4));
+                        }
+                        out.putByte(byte);
+                    }
+                }
+                else
+                {
+                    for (int grade : grades)
+                    {
+                        out.putSigned(grade);
+                    }
+                }
+            }
+
+            /**
+             * @brief Декодирует оценки, записанные putGrades.
+             */
+            inline std::vector<int> getGrades(ByteReader &in)
+            {
+                uint64_t header = in.getVarint();
+                uint64_t count = header >> 1;
+                bool packed = (header & 1) != 0;
+                // Каждая оценка занимает не меньше половины байта: защищает от огромных выделений
+                if (count > in.remaining() * 2)
+                {
+                    in.fail("некорректное количество оценок");
+                }
+
+                std::vector<int> grades;
+                grades.reserve(count);
+                if (packed)
+                {
+                    for (uint64_t i = 0; i < count; i += 2)
+                    {
+                        uint8_t byte = in.getByte();
+                        grades.push_back(byte & 0x0F);
+                        if (i + 1 < count)
+                        {
+                            grades.push_back(byte >> 4);
+                        }
+                    }
+                }
+                else
+                {
+                    for (uint64_t i = 0; i < count; ++i)
+                    {
+                        grades.push_back(in.getInt());
+                    }
+                }
+                return grades;
+            }
+
+        } // namespace detail
+    } // namespace storage
+} // namespace university
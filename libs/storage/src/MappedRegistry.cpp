@@ -0,0 +1,424 @@
+#include "MappedRegistry.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace university
+{
+    namespace storage
+    {
+        namespace
+        {
+            constexpr char MAGIC[8] = {'S', 'T', 'U', 'D', 'M', 'A', 'P', '\0'};
+            constexpr uint32_t EMPTY_SLOT = std::numeric_limits<uint32_t>::max();
+            constexpr size_t SECTION_ALIGNMENT = 8;
+
+            /**
+             * @struct FileHeader
+             * @brief Заголовок файла: версия формата и расположение секций.
+             */
+            struct FileHeader
+            {
+                char magic[8];
+                uint32_t formatVersion;
+                int32_t nextId;
+                uint64_t recordCount;
+                uint64_t groupCount;
+                uint64_t indexBucketCount;
+                uint64_t recordsOffset;
+                uint64_t groupsOffset;
+                uint64_t indexOffset;
+                uint64_t stringsOffset;
+                uint64_t stringsSize;
+            };
+
+            static_assert(sizeof(FileHeader) == 80, "Размер заголовка входит в формат файла");
+
+            [[noreturn]] void throwCorrupted(const std::string &reason)
+            {
+                throw std::runtime_error("Повреждённый файл реестра: " + reason);
+            }
+
+            void requireLittleEndian()
+            {
+                if constexpr (std::endian::native != std::endian::little)
+                {
+                    throw std::runtime_error("Отображаемый файл реестра поддерживается только на little-endian платформах.");
+                }
+            }
+
+            size_t alignSection(size_t offset)
+            {
+                return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+            }
+
+            size_t homeSlot(int id, size_t mask)
+            {
+                // Мультипликативное хеширование: соседние ID не образуют длинных цепочек
+                return (static_cast<uint32_t>(id) * 2654435761u) & mask;
+            }
+
+            /**
+             * @brief Проверяет, что секция из count элементов по elementSize байт лежит внутри файла.
+             */
+            void checkSection(uint64_t offset, uint64_t count, size_t elementSize, size_t fileSize, const char *name)
+            {
+                if (offset % SECTION_ALIGNMENT != 0 || offset > fileSize || count > (fileSize - offset) / elementSize)
+                {
+                    throwCorrupted(std::string("секция ") + name + " выходит за пределы файла");
+                }
+            }
+
+            template <typename T>
+            void writeSection(std::ofstream &out, size_t &position, size_t offset, const T *data, size_t count)
+            {
+                static const char padding[SECTION_ALIGNMENT] = {};
+                out.write(padding, static_cast<std::streamsize>(offset - position));
+                out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(count * sizeof(T)));
+                position = offset + count * sizeof(T);
+            }
+
+        } // namespace
+
+        GradeSummary summarizeGrades(const MappedStudentRecord &record)
+        {
+            GradeSummary summary;
+            switch (static_cast<StudentCategory>(record.category))
+            {
+            case StudentCategory::JUNIOR:
+            case StudentCategory::SENIOR:
+            {
+                size_t count = std::min<size_t>(record.gradeCount, std::size(record.sessionGrades));
+                for (size_t i = 0; i < count; ++i)
+                {
+                    summary.sum += static_cast<double>(record.sessionGrades[i]);
+                }
+                summary.count += count;
+                if (record.category == static_cast<uint8_t>(StudentCategory::SENIOR))
+                {
+                    summary.sum += static_cast<double>(record.supervisorGrade);
+                    summary.sum += static_cast<double>(record.secondGrade);
+                    summary.count += 2;
+                }
+                break;
+            }
+            case StudentCategory::GRADUATE:
+                summary.sum += static_cast<double>(record.supervisorGrade);
+                summary.sum += static_cast<double>(record.secondGrade);
+                summary.sum += static_cast<double>(record.stateCommissionGrade);
+                summary.count += 3;
+                break;
+            }
+            return summary;
+        }
+
+        void writeMappedRegistry(const std::filesystem::path &path, const StudentTable &table, int nextId)
+        {
+            requireLittleEndian();
+
+            std::vector<std::pair<int, const Student *>> students;
+            students.reserve(table.size());
+            table.forEachInRange(0, table.bucketCount(), [&students](int id, const std::shared_ptr<const Student> &student)
+                                 {
+                if (student)
+                {
+                    students.emplace_back(id, student.get());
+                } });
+            std::sort(students.begin(), students.end(), [](const auto &lhs, const auto &rhs)
+                      { return lhs.first < rhs.first; });
+            if (students.size() >= EMPTY_SLOT)
+            {
+                throw std::runtime_error("Слишком много студентов для отображаемого файла реестра.");
+            }
+
+            // Куча строк: повторяющиеся значения (группы, темы, места) хранятся один раз
+            std::string heap;
+            std::unordered_map<std::string_view, StringRef> interned;
+            auto append = [&heap](const std::string &value)
+            {
+                if (heap.size() + value.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    throw std::runtime_error("Куча строк не помещается в отображаемый файл реестра.");
+                }
+                StringRef ref{static_cast<uint32_t>(heap.size()), static_cast<uint32_t>(value.size())};
+                heap += value;
+                return ref;
+            };
+            auto intern = [&](const std::string &value)
+            {
+                auto it = interned.find(value);
+                if (it == interned.end())
+                {
+                    it = interned.emplace(value, append(value)).first;
+                }
+                return it->second;
+            };
+
+            std::unordered_map<std::string_view, uint32_t> groupCodes;
+            std::vector<StringRef> groups;
+            std::vector<MappedStudentRecord> records(students.size());
+            for (size_t i = 0; i < students.size(); ++i)
+            {
+                const auto &[id, student] = students[i];
+                MappedStudentRecord &record = records[i];
+                record.id = id;
+                record.departmentNumber = student->getDepartmentNumber();
+                record.category = static_cast<uint8_t>(student->getCategory());
+                record.name = append(student->getName());
+
+                auto [group, inserted] = groupCodes.try_emplace(student->getGroupIndex(), static_cast<uint32_t>(groups.size()));
+                if (inserted)
+                {
+                    groups.push_back(intern(student->getGroupIndex()));
+                }
+                record.groupCode = group->second;
+
+                switch (student->getCategory())
+                {
+                case StudentCategory::JUNIOR:
+                {
+                    const auto &grades = dynamic_cast<const JuniorStudent &>(*student).getSessionGrades();
+                    record.gradeCount = static_cast<uint8_t>(grades.size());
+                    std::copy(grades.begin(), grades.end(), record.sessionGrades);
+                    break;
+                }
+                case StudentCategory::SENIOR:
+                {
+                    const auto &senior = dynamic_cast<const SeniorStudent &>(*student);
+                    const auto &work = senior.getResearchWork();
+                    record.gradeCount = static_cast<uint8_t>(senior.getSessionGrades().size());
+                    std::copy(senior.getSessionGrades().begin(), senior.getSessionGrades().end(), record.sessionGrades);
+                    record.supervisorGrade = work.supervisorGrade;
+                    record.secondGrade = work.commissionGrade;
+                    record.topic = intern(work.topic);
+                    record.place = intern(work.place);
+                    break;
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    const auto &project = dynamic_cast<const GraduateStudent &>(*student).getDiplomaProject();
+                    record.supervisorGrade = project.supervisorGrade;
+                    record.secondGrade = project.reviewerGrade;
+                    record.stateCommissionGrade = project.stateCommissionGrade;
+                    record.topic = intern(project.topic);
+                    record.place = intern(project.place);
+                    break;
+                }
+                }
+            }
+
+            // Индекс ID: открытая адресация, загрузка не выше 1/2
+            size_t bucketCount = std::bit_ceil(std::max<size_t>(1, records.size() * 2));
+            std::vector<MappedIndexSlot> index(bucketCount, MappedIndexSlot{0, EMPTY_SLOT});
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                size_t slot = homeSlot(records[i].id, bucketCount - 1);
+                while (index[slot].record != EMPTY_SLOT)
+                {
+                    slot = (slot + 1) & (bucketCount - 1);
+                }
+                index[slot] = MappedIndexSlot{records[i].id, static_cast<uint32_t>(i)};
+            }
+
+            FileHeader header{};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.formatVersion = MAPPED_FORMAT_VERSION;
+            header.nextId = nextId;
+            header.recordCount = records.size();
+            header.groupCount = groups.size();
+            header.indexBucketCount = bucketCount;
+            header.recordsOffset = alignSection(sizeof(FileHeader));
+            header.groupsOffset = alignSection(header.recordsOffset + records.size() * sizeof(MappedStudentRecord));
+            header.indexOffset = alignSection(header.groupsOffset + groups.size() * sizeof(StringRef));
+            header.stringsOffset = alignSection(header.indexOffset + index.size() * sizeof(MappedIndexSlot));
+            header.stringsSize = heap.size();
+
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                throw std::runtime_error("Не удалось открыть файл для записи: " + path.string());
+            }
+            size_t position = 0;
+            writeSection(out, position, 0, &header, 1);
+            writeSection(out, position, header.recordsOffset, records.data(), records.size());
+            writeSection(out, position, header.groupsOffset, groups.data(), groups.size());
+            writeSection(out, position, header.indexOffset, index.data(), index.size());
+            writeSection(out, position, header.stringsOffset, heap.data(), heap.size());
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error("Ошибка записи файла реестра: " + path.string());
+            }
+        }
+
+        MappedRegistry::MappedRegistry(const std::filesystem::path &path)
+        {
+            requireLittleEndian();
+#if defined(_WIN32)
+            throw std::runtime_error("Отображение файла реестра в память не поддерживается на этой платформе.");
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Не удалось открыть файл реестра: " + path.string());
+            }
+            struct stat status{};
+            if (::fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(FileHeader))
+            {
+                ::close(fd);
+                throw std::runtime_error("Файл не является отображаемым реестром: " + path.string());
+            }
+            mappingSize_ = static_cast<size_t>(status.st_size);
+            void *mapping = ::mmap(nullptr, mappingSize_, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                throw std::runtime_error("Не удалось отобразить файл реестра в память: " + path.string());
+            }
+            mapping_ = mapping;
+
+            try
+            {
+                const auto *base = static_cast<const char *>(mapping_);
+                const auto *header = reinterpret_cast<const FileHeader *>(base);
+                if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+                {
+                    throw std::runtime_error("Файл не является отображаемым реестром: " + path.string());
+                }
+                if (header->formatVersion != MAPPED_FORMAT_VERSION)
+                {
+                    throw std::runtime_error("Неподдерживаемая версия формата реестра: " + std::to_string(header->formatVersion));
+                }
+                checkSection(header->recordsOffset, header->recordCount, sizeof(MappedStudentRecord), mappingSize_, "записей");
+                checkSection(header->groupsOffset, header->groupCount, sizeof(StringRef), mappingSize_, "групп");
+                checkSection(header->indexOffset, header->indexBucketCount, sizeof(MappedIndexSlot), mappingSize_, "индекса");
+                checkSection(header->stringsOffset, header->stringsSize, 1, mappingSize_, "строк");
+                if (!std::has_single_bit(header->indexBucketCount) || header->indexBucketCount <= header->recordCount)
+                {
+                    throwCorrupted("некорректный размер индекса");
+                }
+
+                nextId_ = header->nextId;
+                records_ = {reinterpret_cast<const MappedStudentRecord *>(base + header->recordsOffset), header->recordCount};
+                groups_ = {reinterpret_cast<const StringRef *>(base + header->groupsOffset), header->groupCount};
+                index_ = {reinterpret_cast<const MappedIndexSlot *>(base + header->indexOffset), header->indexBucketCount};
+                strings_ = {base + header->stringsOffset, header->stringsSize};
+            }
+            catch (...)
+            {
+                ::munmap(mapping_, mappingSize_);
+                throw;
+            }
+#endif
+        }
+
+        MappedRegistry::~MappedRegistry()
+        {
+#if !defined(_WIN32)
+            if (mapping_ != nullptr)
+            {
+                ::munmap(mapping_, mappingSize_);
+            }
+#endif
+        }
+
+        const MappedStudentRecord *MappedRegistry::find(int id) const
+        {
+            size_t mask = index_.size() - 1;
+            size_t slot = homeSlot(id, mask);
+            for (size_t probe = 0; probe < index_.size(); ++probe)
+            {
+                const MappedIndexSlot &entry = index_[slot];
+                if (entry.record == EMPTY_SLOT)
+                {
+                    return nullptr;
+                }
+                if (entry.id == id)
+                {
+                    if (entry.record >= records_.size())
+                    {
+                        throwCorrupted("ссылка индекса за пределы записей");
+                    }
+                    return &records_[entry.record];
+                }
+                slot = (slot + 1) & mask;
+            }
+            return nullptr;
+        }
+
+        std::string_view MappedRegistry::string(StringRef ref) const
+        {
+            if (ref.offset > strings_.size() || ref.length > strings_.size() - ref.offset)
+            {
+                throwCorrupted("ссылка за пределы кучи строк");
+            }
+            return strings_.substr(ref.offset, ref.length);
+        }
+
+        std::string_view MappedRegistry::groupName(uint32_t code) const
+        {
+            if (code >= groups_.size())
+            {
+                throwCorrupted("код группы вне таблицы групп");
+            }
+            return string(groups_[code]);
+        }
+
+        std::unique_ptr<Student> MappedRegistry::materialize(const MappedStudentRecord &record) const
+        {
+            if (record.gradeCount > std::size(record.sessionGrades))
+            {
+                throwCorrupted("некорректное количество оценок");
+            }
+            std::string name(string(record.name));
+            std::string group(groupName(record.groupCode));
+            std::vector<int> grades(record.sessionGrades, record.sessionGrades + record.gradeCount);
+
+            try
+            {
+                switch (static_cast<StudentCategory>(record.category))
+                {
+                case StudentCategory::JUNIOR:
+                    return std::make_unique<JuniorStudent>(std::move(name), std::move(group), record.departmentNumber, std::move(grades));
+                case StudentCategory::SENIOR:
+                {
+                    ResearchWork work{record.supervisorGrade, record.secondGrade,
+                                      std::string(string(record.topic)), std::string(string(record.place))};
+                    return std::make_unique<SeniorStudent>(std::move(name), std::move(group), record.departmentNumber,
+                                                           std::move(grades), std::move(work));
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    DiplomaProject project{record.supervisorGrade, record.secondGrade, record.stateCommissionGrade,
+                                           std::string(string(record.topic)), std::string(string(record.place))};
+                    return std::make_unique<GraduateStudent>(std::move(name), std::move(group), record.departmentNumber,
+                                                             std::move(project));
+                }
+                }
+            }
+            catch (const std::invalid_argument &error)
+            {
+                throwCorrupted(error.what());
+            }
+            throwCorrupted("неизвестная категория студента");
+        }
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,463 @@
+#include "RegistryExport.h"
+#include "StudentCsv.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace university
+{
+    namespace storage
+    {
+        namespace
+        {
+            /**
+             * @class TextBuffer
+             * @brief Буфер форматирования многократного использования: строки и числа без временных объектов.
+             */
+            class TextBuffer
+            {
+            public:
+                explicit TextBuffer(std::string storage = {}) : text_(std::move(storage)) { text_.clear(); }
+
+                void append(std::string_view text) { text_.append(text); }
+                void append(char symbol) { text_.push_back(symbol); }
+
+                template <typename Number>
+                void appendNumber(Number value)
+                {
+                    char digits[32];
+                    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+                    text_.append(digits, result.ptr);
+                }
+
+                void appendCsvField(std::string_view field, char delimiter)
+                {
+                    bool plain = std::none_of(field.begin(), field.end(), [delimiter](char symbol)
+                                              { return symbol == delimiter || symbol == '"' || symbol == '\n' || symbol == '\r'; });
+                    if (plain)
+                    {
+                        text_.append(field);
+                        return;
+                    }
+                    text_.push_back('"');
+                    for (char symbol : field)
+                    {
+                        if (symbol == '"')
+                        {
+                            text_.push_back('"');
+                        }
+                        text_.push_back(symbol);
+                    }
+                    text_.push_back('"');
+                }
+
+                void appendJsonString(std::string_view value)
+                {
+                    text_.push_back('"');
+                    bool plain = std::none_of(value.begin(), value.end(), [](char symbol)
+                                              { return symbol == '"' || symbol == '\\' || static_cast<unsigned char>(symbol) < 0x20; });
+                    if (plain)
+                    {
+                        text_.append(value);
+                        text_.push_back('"');
+                        return;
+                    }
+                    for (char symbol : value)
+                    {
+                        auto code = static_cast<unsigned char>(symbol);
+                        if (symbol == '"' || symbol == '\\')
+                        {
+                            text_.push_back('\\');
+                            text_.push_back(symbol);
+                        }
+                        else if (code < 0x20)
+                        {
+                            constexpr char HEX[] = "0123456789abcdef";
+                            text_.append("\\u00");
+                            text_.push_back(HEX[code >> 4]);
+                            text_.push_back(HEX[code & 0x0F]);
+                        }
+                        else
+                        {
+                            text_.push_back(symbol);
+                        }
+                    }
+                    text_.push_back('"');
+                }
+
+                [[nodiscard]] std::string_view view() const { return text_; }
+                [[nodiscard]] size_t size() const { return text_.size(); }
+                void clear() { text_.clear(); }
+                std::string release() { return std::move(text_); }
+
+            private:
+                std::string text_;
+            };
+
+            /**
+             * @class OutputFile
+             * @brief Файл выгрузки, принимающий крупные блоки текста.
+             */
+            class OutputFile
+            {
+            public:
+                explicit OutputFile(const std::filesystem::path &path) : out_(path, std::ios::binary | std::ios::trunc)
+                {
+                    if (!out_)
+                    {
+                        throw std::runtime_error("Не удалось открыть файл для записи: " + path.string());
+                    }
+                }
+
+                void write(std::string_view text)
+                {
+                    out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    if (!out_)
+                    {
+                        throw std::runtime_error("Ошибка записи файла выгрузки.");
+                    }
+                    bytes_ += text.size();
+                }
+
+                size_t finish()
+                {
+                    out_.close();
+                    if (!out_)
+                    {
+                        throw std::runtime_error("Ошибка при закрытии файла выгрузки.");
+                    }
+                    return bytes_;
+                }
+
+            private:
+                std::ofstream out_;
+                size_t bytes_ = 0;
+            };
+
+            void appendGrades(TextBuffer &out, const std::vector<int> &grades, char separator)
+            {
+                for (size_t i = 0; i < grades.size(); ++i)
+                {
+                    if (i != 0)
+                    {
+                        out.append(separator);
+                    }
+                    out.appendNumber(grades[i]);
+                }
+            }
+
+            void formatCsv(TextBuffer &out, const Student &student, char delimiter)
+            {
+                out.append(CSV_CATEGORY_NAMES[static_cast<size_t>(student.getCategory())]);
+                out.append(delimiter);
+                out.appendCsvField(student.getName(), delimiter);
+                out.append(delimiter);
+                out.appendCsvField(student.getGroupIndex(), delimiter);
+                out.append(delimiter);
+                out.appendNumber(student.getDepartmentNumber());
+                out.append(delimiter);
+                switch (student.getCategory())
+                {
+                case StudentCategory::JUNIOR:
+                    appendGrades(out, dynamic_cast<const JuniorStudent &>(student).getSessionGrades(), ' ');
+                    break;
+                case StudentCategory::SENIOR:
+                {
+                    const auto &senior = dynamic_cast<const SeniorStudent &>(student);
+                    const auto &work = senior.getResearchWork();
+                    appendGrades(out, senior.getSessionGrades(), ' ');
+                    out.append(delimiter);
+                    out.appendCsvField(work.topic, delimiter);
+                    out.append(delimiter);
+                    out.appendCsvField(work.place, delimiter);
+                    out.append(delimiter);
+                    out.appendNumber(work.supervisorGrade);
+                    out.append(delimiter);
+                    out.appendNumber(work.commissionGrade);
+                    break;
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    const auto &project = dynamic_cast<const GraduateStudent &>(student).getDiplomaProject();
+                    out.append(delimiter);
+                    out.appendCsvField(project.topic, delimiter);
+                    out.append(delimiter);
+                    out.appendCsvField(project.place, delimiter);
+                    out.append(delimiter);
+                    out.appendNumber(project.supervisorGrade);
+                    out.append(delimiter);
+                    out.appendNumber(project.reviewerGrade);
+                    out.append(delimiter);
+                    out.appendNumber(project.stateCommissionGrade);
+                    break;
+                }
+                }
+                out.append('\n');
+            }
+
+            // Каждый объект начинается с ",\n"; у первого записанного объекта запятая отбрасывается
+            void formatJson(TextBuffer &out, int id, const Student &student)
+            {
+                out.append(",\n{\"id\":");
+                out.appendNumber(id);
+                out.append(",\"category\":\"");
+                out.append(CSV_CATEGORY_NAMES[static_cast<size_t>(student.getCategory())]);
+                out.append("\",\"name\":");
+                out.appendJsonString(student.getName());
+                out.append(",\"group\":");
+                out.appendJsonString(student.getGroupIndex());
+                out.append(",\"department\":");
+                out.appendNumber(student.getDepartmentNumber());
+                switch (student.getCategory())
+                {
+                case StudentCategory::JUNIOR:
+                    out.append(",\"grades\":[");
+                    appendGrades(out, dynamic_cast<const JuniorStudent &>(student).getSessionGrades(), ',');
+                    out.append(']');
+                    break;
+                case StudentCategory::SENIOR:
+                {
+                    const auto &senior = dynamic_cast<const SeniorStudent &>(student);
+                    const auto &work = senior.getResearchWork();
+                    out.append(",\"grades\":[");
+                    appendGrades(out, senior.getSessionGrades(), ',');
+                    out.append("],\"researchWork\":{\"topic\":");
+                    out.appendJsonString(work.topic);
+                    out.append(",\"place\":");
+                    out.appendJsonString(work.place);
+                    out.append(",\"supervisorGrade\":");
+                    out.appendNumber(work.supervisorGrade);
+                    out.append(",\"commissionGrade\":");
+                    out.appendNumber(work.commissionGrade);
+                    out.append('}');
+                    break;
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    const auto &project = dynamic_cast<const GraduateStudent &>(student).getDiplomaProject();
+                    out.append(",\"diplomaProject\":{\"topic\":");
+                    out.appendJsonString(project.topic);
+                    out.append(",\"place\":");
+                    out.appendJsonString(project.place);
+                    out.append(",\"supervisorGrade\":");
+                    out.appendNumber(project.supervisorGrade);
+                    out.append(",\"reviewerGrade\":");
+                    out.appendNumber(project.reviewerGrade);
+                    out.append(",\"stateCommissionGrade\":");
+                    out.appendNumber(project.stateCommissionGrade);
+                    out.append('}');
+                    break;
+                }
+                }
+                out.append('}');
+            }
+
+            /**
+             * @brief Форматирует занятые слоты [first, last) в буфер.
+             * @return Количество записей.
+             */
+            size_t formatRange(TextBuffer &out, const StudentTable &table, size_t first, size_t last, const ExportOptions &options)
+            {
+                size_t rows = 0;
+                table.forEachInRange(first, last, [&](int id, const std::shared_ptr<const Student> &student)
+                                     {
+                    if (!student)
+                    {
+                        return;
+                    }
+                    if (options.format == ExportFormat::CSV)
+                    {
+                        formatCsv(out, *student, options.delimiter);
+                    }
+                    else
+                    {
+                        formatJson(out, id, *student);
+                    }
+                    ++rows; });
+                return rows;
+            }
+
+            /**
+             * @class ExportWriter
+             * @brief Записывает отформатированные блоки, убирая разделитель перед первым объектом JSON.
+             */
+            class ExportWriter
+            {
+            public:
+                ExportWriter(const std::filesystem::path &path, ExportFormat format) : file_(path), format_(format) {}
+
+                void write(std::string_view text)
+                {
+                    if (format_ == ExportFormat::JSON && first_ && !text.empty())
+                    {
+                        text.remove_prefix(1);
+                        first_ = false;
+                    }
+                    file_.write(text);
+                }
+
+                void writeRaw(std::string_view text) { file_.write(text); }
+
+                size_t finish() { return file_.finish(); }
+
+            private:
+                OutputFile file_;
+                ExportFormat format_;
+                bool first_ = true;
+            };
+
+        } // namespace
+
+        ExportReport exportStudents(const StudentTable &table, const std::filesystem::path &path, const ExportOptions &options)
+        {
+            auto start = std::chrono::steady_clock::now();
+            ExportWriter writer(path, options.format);
+            size_t bufferSize = std::max<size_t>(options.bufferSize, 4096);
+
+            TextBuffer header;
+            if (options.format == ExportFormat::CSV)
+            {
+                for (size_t i = 0; i < CSV_COLUMNS.size(); ++i)
+                {
+                    if (i != 0)
+                    {
+                        header.append(options.delimiter);
+                    }
+                    header.append(CSV_COLUMNS[i]);
+                }
+                header.append('\n');
+            }
+            else
+            {
+                header.append('[');
+            }
+            writer.writeRaw(header.view());
+
+            ExportReport report;
+            unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+            if (threads <= 1)
+            {
+                TextBuffer buffer;
+                // Слоты обходятся порциями, чтобы буфер сбрасывался по достижении bufferSize
+                constexpr size_t SLOTS_PER_STEP = 1024;
+                for (size_t first = 0; first < table.bucketCount(); first += SLOTS_PER_STEP)
+                {
+                    report.rows += formatRange(buffer, table, first, std::min(first + SLOTS_PER_STEP, table.bucketCount()), options);
+                    if (buffer.size() >= bufferSize)
+                    {
+                        writer.write(buffer.view());
+                        buffer.clear();
+                    }
+                }
+                writer.write(buffer.view());
+            }
+            else
+            {
+                // Не больше threads фрагментов в работе; буферы записанных фрагментов переиспользуются
+                struct Chunk
+                {
+                    std::string text;
+                    size_t rows;
+                };
+                size_t slotsPerChunk = std::max<size_t>(1024, bufferSize / 64);
+                std::deque<std::future<Chunk>> inFlight;
+                std::vector<std::string> freeBuffers;
+
+                auto writeOldest = [&]()
+                {
+                    Chunk chunk = inFlight.front().get();
+                    inFlight.pop_front();
+                    writer.write(chunk.text);
+                    report.rows += chunk.rows;
+                    freeBuffers.push_back(std::move(chunk.text));
+                };
+
+                for (size_t first = 0; first < table.bucketCount(); first += slotsPerChunk)
+                {
+                    if (inFlight.size() >= threads)
+                    {
+                        writeOldest();
+                    }
+                    std::string storage;
+                    if (!freeBuffers.empty())
+                    {
+                        storage = std::move(freeBuffers.back());
+                        freeBuffers.pop_back();
+                    }
+                    size_t last = std::min(first + slotsPerChunk, table.bucketCount());
+                    inFlight.push_back(std::async(std::launch::async, [&table, &options, first, last, storage = std::move(storage)]() mutable
+                                                  {
+                        TextBuffer buffer(std::move(storage));
+                        size_t rows = formatRange(buffer, table, first, last, options);
+                        return Chunk{buffer.release(), rows}; }));
+                }
+                while (!inFlight.empty())
+                {
+                    writeOldest();
+                }
+            }
+
+            if (options.format == ExportFormat::JSON)
+            {
+                writer.writeRaw("\n]\n");
+            }
+            report.bytes = writer.finish();
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return report;
+        }
+
+        ExportReport exportGroupAverages(const std::map<std::string, double> &averages, const std::filesystem::path &path,
+                                         const ExportOptions &options)
+        {
+            auto start = std::chrono::steady_clock::now();
+            ExportWriter writer(path, options.format);
+            TextBuffer buffer;
+            if (options.format == ExportFormat::CSV)
+            {
+                buffer.append("group");
+                buffer.append(options.delimiter);
+                buffer.append("average\n");
+                for (const auto &[group, average] : averages)
+                {
+                    buffer.appendCsvField(group, options.delimiter);
+                    buffer.append(options.delimiter);
+                    buffer.appendNumber(average);
+                    buffer.append('\n');
+                }
+            }
+            else
+            {
+                buffer.append('{');
+                bool first = true;
+                for (const auto &[group, average] : averages)
+                {
+                    buffer.append(first ? "\n" : ",\n");
+                    first = false;
+                    buffer.appendJsonString(group);
+                    buffer.append(':');
+                    buffer.appendNumber(average);
+                }
+                buffer.append("\n}\n");
+            }
+            writer.writeRaw(buffer.view());
+
+            ExportReport report;
+            report.rows = averages.size();
+            report.bytes = writer.finish();
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return report;
+        }
+
+    } // namespace storage
+} // namespace university
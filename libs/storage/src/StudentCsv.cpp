@@ -0,0 +1,353 @@
+#include "StudentCsv.h"
+#include "JuniorStudent.h"
+#include "SeniorStudent.h"
+#include "GraduateStudent.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace university
+{
+    namespace storage
+    {
+        namespace
+        {
+            constexpr size_t COLUMN_COUNT = CSV_COLUMNS.size();
+            constexpr size_t MIN_COLUMN_COUNT = 5; // category .. grades
+
+            enum Column : size_t
+            {
+                CATEGORY,
+                NAME,
+                GROUP,
+                DEPARTMENT,
+                GRADES,
+                TOPIC,
+                PLACE,
+                SUPERVISOR_GRADE,
+                SECOND_GRADE,
+                STATE_COMMISSION_GRADE
+            };
+
+            using Fields = std::array<std::string_view, COLUMN_COUNT>;
+
+            /**
+             * @brief Делит строку на поля; поля в кавычках возвращаются вместе с кавычками.
+             * @return Количество полей.
+             */
+            size_t splitFields(std::string_view line, char delimiter, Fields &fields)
+            {
+                size_t count = 0;
+                size_t position = 0;
+                while (true)
+                {
+                    if (count == COLUMN_COUNT)
+                    {
+                        throw std::invalid_argument("слишком много полей");
+                    }
+                    size_t end;
+                    if (position < line.size() && line[position] == '"')
+                    {
+                        end = position + 1;
+                        while (true)
+                        {
+                            end = line.find('"', end);
+                            if (end == std::string_view::npos)
+                            {
+                                throw std::invalid_argument("незакрытая кавычка");
+                            }
+                            if (end + 1 < line.size() && line[end + 1] == '"')
+                            {
+                                end += 2;
+                                continue;
+                            }
+                            break;
+                        }
+                        ++end;
+                        if (end < line.size() && line[end] != delimiter)
+                        {
+                            throw std::invalid_argument("символ после закрывающей кавычки");
+                        }
+                    }
+                    else
+                    {
+                        end = std::min(line.find(delimiter, position), line.size());
+                    }
+                    fields[count++] = line.substr(position, end - position);
+                    if (end >= line.size())
+                    {
+                        return count;
+                    }
+                    position = end + 1;
+                }
+            }
+
+            std::string toText(std::string_view field)
+            {
+                if (field.empty() || field.front() != '"')
+                {
+                    return std::string(field);
+                }
+                std::string text;
+                text.reserve(field.size() - 2);
+                for (size_t i = 1; i + 1 < field.size(); ++i)
+                {
+                    text.push_back(field[i]);
+                    if (field[i] == '"')
+                    {
+                        ++i; // Удвоенная кавычка
+                    }
+                }
+                return text;
+            }
+
+            int toInt(std::string_view field, Column column)
+            {
+                int value = 0;
+                auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+                if (field.empty() || error != std::errc() || end != field.data() + field.size())
+                {
+                    throw std::invalid_argument("некорректное число в поле " + std::string(CSV_COLUMNS[column]));
+                }
+                return value;
+            }
+
+            std::vector<int> toGrades(std::string_view field)
+            {
+                std::vector<int> grades;
+                const char *current = field.data();
+                const char *end = field.data() + field.size();
+                while (true)
+                {
+                    while (current != end && *current == ' ')
+                    {
+                        ++current;
+                    }
+                    if (current == end)
+                    {
+                        return grades;
+                    }
+                    int grade = 0;
+                    auto result = std::from_chars(current, end, grade);
+                    if (result.ec != std::errc() || (result.ptr != end && *result.ptr != ' '))
+                    {
+                        throw std::invalid_argument("некорректная оценка в поле grades");
+                    }
+                    grades.push_back(grade);
+                    current = result.ptr;
+                }
+            }
+
+            /**
+             * @brief Результат разбора части блока одним потоком.
+             */
+            struct ParsedPart
+            {
+                std::vector<std::unique_ptr<Student>> students;
+                std::vector<CsvRowError> errors; // Номера строк относительно начала части
+                size_t lines = 0;
+                size_t rows = 0;
+                size_t malformed = 0;
+            };
+
+            void parsePart(std::string_view part, char delimiter, size_t maxErrors, ParsedPart &result)
+            {
+                result.students.reserve(part.size() / 64);
+                size_t position = 0;
+                while (position < part.size())
+                {
+                    size_t end = std::min(part.find('\n', position), part.size());
+                    std::string_view line = part.substr(position, end - position);
+                    position = end + 1;
+                    ++result.lines;
+                    if (!line.empty() && line.back() == '\r')
+                    {
+                        line.remove_suffix(1);
+                    }
+                    if (line.empty())
+                    {
+                        continue;
+                    }
+
+                    ++result.rows;
+                    try
+                    {
+                        result.students.push_back(parseStudentRow(line, delimiter));
+                    }
+                    catch (const std::invalid_argument &error)
+                    {
+                        ++result.malformed;
+                        if (result.errors.size() < maxErrors)
+                        {
+                            result.errors.push_back({result.lines, error.what()});
+                        }
+                    }
+                }
+            }
+
+            /**
+             * @brief Делит блок на части по границам строк.
+             */
+            std::vector<std::string_view> splitBlock(std::string_view block, unsigned parts)
+            {
+                std::vector<std::string_view> result;
+                size_t first = 0;
+                for (unsigned part = 1; part <= parts && first < block.size(); ++part)
+                {
+                    size_t last = block.size();
+                    if (part < parts)
+                    {
+                        last = block.find('\n', std::max(first, block.size() * part / parts));
+                        last = last == std::string_view::npos ? block.size() : last + 1;
+                    }
+                    result.push_back(block.substr(first, last - first));
+                    first = last;
+                }
+                return result;
+            }
+
+        } // namespace
+
+        std::unique_ptr<Student> parseStudentRow(std::string_view line, char delimiter)
+        {
+            Fields fields{};
+            size_t count = splitFields(line, delimiter, fields);
+            if (count < MIN_COLUMN_COUNT)
+            {
+                throw std::invalid_argument("недостаточно полей");
+            }
+
+            std::string_view category = fields[CATEGORY];
+            int department = toInt(fields[DEPARTMENT], DEPARTMENT);
+            if (category == CSV_CATEGORY_NAMES[static_cast<size_t>(StudentCategory::JUNIOR)])
+            {
+                return std::make_unique<JuniorStudent>(toText(fields[NAME]), toText(fields[GROUP]), department,
+                                                       toGrades(fields[GRADES]));
+            }
+            if (category == CSV_CATEGORY_NAMES[static_cast<size_t>(StudentCategory::SENIOR)])
+            {
+                ResearchWork work{toInt(fields[SUPERVISOR_GRADE], SUPERVISOR_GRADE), toInt(fields[SECOND_GRADE], SECOND_GRADE),
+                                  toText(fields[TOPIC]), toText(fields[PLACE])};
+                return std::make_unique<SeniorStudent>(toText(fields[NAME]), toText(fields[GROUP]), department,
+                                                       toGrades(fields[GRADES]), std::move(work));
+            }
+            if (category == CSV_CATEGORY_NAMES[static_cast<size_t>(StudentCategory::GRADUATE)])
+            {
+                DiplomaProject project{toInt(fields[SUPERVISOR_GRADE], SUPERVISOR_GRADE), toInt(fields[SECOND_GRADE], SECOND_GRADE),
+                                       toInt(fields[STATE_COMMISSION_GRADE], STATE_COMMISSION_GRADE),
+                                       toText(fields[TOPIC]), toText(fields[PLACE])};
+                return std::make_unique<GraduateStudent>(toText(fields[NAME]), toText(fields[GROUP]), department,
+                                                         std::move(project));
+            }
+            throw std::invalid_argument("неизвестная категория студента");
+        }
+
+        CsvImportReport importStudentsCsv(const std::filesystem::path &path, const CsvImportOptions &options,
+                                          const StudentBatchSink &sink)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+            {
+                throw std::runtime_error("Не удалось открыть файл импорта: " + path.string());
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            unsigned numThreads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+            size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+
+            CsvImportReport report;
+            std::string buffer;
+            size_t carry = 0;        // Байт неполной строки, перенесённых из предыдущего блока
+            size_t nextLine = 1;     // Номер первой строки очередного блока
+            bool skipHeader = options.hasHeader;
+            bool endOfFile = false;
+            while (!endOfFile)
+            {
+                buffer.resize(carry + chunkSize);
+                file.read(buffer.data() + carry, static_cast<std::streamsize>(chunkSize));
+                size_t total = carry + static_cast<size_t>(file.gcount());
+                endOfFile = !file;
+
+                std::string_view data(buffer.data(), total);
+                size_t blockEnd = total;
+                if (!endOfFile)
+                {
+                    size_t lastNewline = data.rfind('\n');
+                    if (lastNewline == std::string_view::npos)
+                    {
+                        // Строка длиннее блока: дочитываем
+                        carry = total;
+                        continue;
+                    }
+                    blockEnd = lastNewline + 1;
+                }
+
+                std::string_view block = data.substr(0, blockEnd);
+                if (skipHeader && !block.empty())
+                {
+                    size_t headerEnd = std::min(block.find('\n'), block.size() - 1);
+                    block.remove_prefix(headerEnd + 1);
+                    ++nextLine;
+                    skipHeader = false;
+                }
+
+                auto parts = splitBlock(block, numThreads);
+                std::vector<ParsedPart> parsed(parts.size());
+                std::vector<std::future<void>> futures;
+                for (size_t i = 1; i < parts.size(); ++i)
+                {
+                    futures.push_back(std::async(std::launch::async, [&, i]()
+                                                 { parsePart(parts[i], options.delimiter, options.maxReportedErrors, parsed[i]); }));
+                }
+                if (!parts.empty())
+                {
+                    parsePart(parts[0], options.delimiter, options.maxReportedErrors, parsed[0]);
+                }
+                for (auto &future : futures)
+                {
+                    future.get();
+                }
+
+                // Сборка в порядке строк файла
+                std::vector<std::unique_ptr<Student>> students;
+                size_t studentCount = 0;
+                for (const auto &part : parsed)
+                {
+                    studentCount += part.students.size();
+                }
+                students.reserve(studentCount);
+                for (auto &part : parsed)
+                {
+                    std::move(part.students.begin(), part.students.end(), std::back_inserter(students));
+                    for (auto &error : part.errors)
+                    {
+                        if (report.errors.size() < options.maxReportedErrors)
+                        {
+                            report.errors.push_back({nextLine + error.line - 1, std::move(error.message)});
+                        }
+                    }
+                    nextLine += part.lines;
+                    report.rowsRead += part.rows;
+                    report.malformedRows += part.malformed;
+                }
+                report.rowsImported += students.size();
+                if (!students.empty())
+                {
+                    sink(std::move(students));
+                }
+
+                carry = total - blockEnd;
+                std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(blockEnd), buffer.begin() + static_cast<std::ptrdiff_t>(total), buffer.begin());
+            }
+
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return report;
+        }
+
+    } // namespace storage
+} // namespace university
@@ -0,0 +1,686 @@
+#include "WriteAheadLog.h"
+#include "JuniorStudent.h"
+#include "GraduateStudent.h"
+#include "Encoding.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace university
+{
+    namespace storage
+    {
+        namespace
+        {
+            constexpr char MAGIC[8] = {'S', 'T', 'U', 'D', 'W', 'A', 'L', '\0'};
+            constexpr size_t FILE_HEADER_SIZE = sizeof(MAGIC) + 4 + 4 + 8;
+            constexpr size_t RECORD_HEADER_SIZE = 8;
+            constexpr const char *SOURCE = "журнал реестра";
+
+            uint32_t checksum(std::string_view payload)
+            {
+                // FNV-1a: достаточно для обнаружения недописанной записи
+                uint32_t hash = 2166136261u;
+                for (char byte : payload)
+                {
+                    hash ^= static_cast<uint8_t>(byte);
+                    hash *= 16777619u;
+                }
+                return hash;
+            }
+
+            [[noreturn]] void throwIoError(const std::string &action, const std::filesystem::path &path)
+            {
+                throw std::runtime_error(action + " " + path.string() + ": " + std::strerror(errno));
+            }
+
+            std::string readFile(const std::filesystem::path &path)
+            {
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file)
+                {
+                    throw std::runtime_error("Не удалось открыть журнал реестра: " + path.string());
+                }
+                std::string data(static_cast<size_t>(file.tellg()), '\0');
+                file.seekg(0);
+                if (!file.read(data.data(), static_cast<std::streamsize>(data.size())))
+                {
+                    throw std::runtime_error("Ошибка чтения журнала реестра: " + path.string());
+                }
+                return data;
+            }
+
+            /**
+             * @brief Проверяет заголовок файла журнала.
+             * @return LSN первой записи в файле.
+             */
+            uint64_t readFileHeader(std::string_view data, const std::filesystem::path &path)
+            {
+                detail::ByteReader in(data, SOURCE);
+                if (std::memcmp(in.getBytes(sizeof(MAGIC)).data(), MAGIC, sizeof(MAGIC)) != 0)
+                {
+                    throw std::runtime_error("Файл не является журналом реестра: " + path.string());
+                }
+                uint32_t formatVersion = in.getFixed32();
+                if (formatVersion != WAL_FORMAT_VERSION)
+                {
+                    throw std::runtime_error("Неподдерживаемая версия формата журнала: " + std::to_string(formatVersion));
+                }
+                in.getFixed32(); // Зарезервировано
+                return in.getFixed64();
+            }
+
+            /**
+             * @brief Обходит целые записи журнала после заголовка.
+             *
+             * Неполная запись (длина больше оставшихся данных) и запись с неверной
+             * контрольной суммой, которая заканчивается в конце файла, считаются
+             * хвостом, оборванным сбоем: обход на них останавливается. Так же
+             * трактуется повреждённая запись, за которой идут только нулевые байты
+             * (файл удлинён, а данные не записаны). Повреждение, за которым есть
+             * другие данные, не может быть следствием оборванной дозаписи.
+             *
+             * @param data Содержимое файла.
+             * @param onRecord Функция, получающая данные каждой записи.
+             * @return Смещение конца последней целой записи.
+             * @throw std::runtime_error если повреждена запись в середине журнала.
+             */
+            template <typename Function>
+            size_t scanRecords(std::string_view data, Function &&onRecord)
+            {
+                size_t position = FILE_HEADER_SIZE;
+                while (data.size() - position >= RECORD_HEADER_SIZE)
+                {
+                    detail::ByteReader header(data.substr(position, RECORD_HEADER_SIZE), SOURCE);
+                    uint32_t length = header.getFixed32();
+                    uint32_t expected = header.getFixed32();
+                    if (length > data.size() - position - RECORD_HEADER_SIZE)
+                    {
+                        break;
+                    }
+                    std::string_view payload = data.substr(position + RECORD_HEADER_SIZE, length);
+                    if (checksum(payload) != expected)
+                    {
+                        size_t recordEnd = position + RECORD_HEADER_SIZE + length;
+                        if (data.find_first_not_of('\0', recordEnd) != std::string_view::npos)
+                        {
+                            header.fail("неверная контрольная сумма записи на смещении " + std::to_string(position) +
+                                        ", за которой в файле есть другие записи");
+                        }
+                        break;
+                    }
+                    onRecord(payload);
+                    position += RECORD_HEADER_SIZE + length;
+                }
+                return position;
+            }
+
+            void putResearchWork(detail::ByteWriter &out, const ResearchWork &work)
+            {
+                out.putSigned(work.supervisorGrade);
+                out.putSigned(work.commissionGrade);
+                out.putString(work.topic);
+                out.putString(work.place);
+            }
+
+            ResearchWork getResearchWork(detail::ByteReader &in)
+            {
+                ResearchWork work{};
+                work.supervisorGrade = in.getInt();
+                work.commissionGrade = in.getInt();
+                work.topic = in.getString();
+                work.place = in.getString();
+                return work;
+            }
+
+            void putStudent(detail::ByteWriter &out, const Student &student)
+            {
+                out.putByte(static_cast<uint8_t>(student.getCategory()));
+                out.putSigned(student.getDepartmentNumber());
+                out.putString(student.getGroupIndex());
+                out.putString(student.getName());
+                switch (student.getCategory())
+                {
+                case StudentCategory::JUNIOR:
+                    detail::putGrades(out, dynamic_cast<const JuniorStudent &>(student).getSessionGrades());
+                    break;
+                case StudentCategory::SENIOR:
+                {
+                    const auto &senior = dynamic_cast<const SeniorStudent &>(student);
+                    detail::putGrades(out, senior.getSessionGrades());
+                    putResearchWork(out, senior.getResearchWork());
+                    break;
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    const auto &project = dynamic_cast<const GraduateStudent &>(student).getDiplomaProject();
+                    out.putSigned(project.supervisorGrade);
+                    out.putSigned(project.reviewerGrade);
+                    out.putSigned(project.stateCommissionGrade);
+                    out.putString(project.topic);
+                    out.putString(project.place);
+                    break;
+                }
+                }
+            }
+
+            std::shared_ptr<const Student> getStudent(detail::ByteReader &in)
+            {
+                auto category = static_cast<StudentCategory>(in.getByte());
+                int department = in.getInt();
+                std::string group(in.getString());
+                std::string name(in.getString());
+                switch (category)
+                {
+                case StudentCategory::JUNIOR:
+                    return std::make_shared<JuniorStudent>(std::move(name), std::move(group), department, detail::getGrades(in));
+                case StudentCategory::SENIOR:
+                {
+                    auto grades = detail::getGrades(in);
+                    return std::make_shared<SeniorStudent>(std::move(name), std::move(group), department, std::move(grades), getResearchWork(in));
+                }
+                case StudentCategory::GRADUATE:
+                {
+                    DiplomaProject project{};
+                    project.supervisorGrade = in.getInt();
+                    project.reviewerGrade = in.getInt();
+                    project.stateCommissionGrade = in.getInt();
+                    project.topic = in.getString();
+                    project.place = in.getString();
+                    return std::make_shared<GraduateStudent>(std::move(name), std::move(group), department, std::move(project));
+                }
+                default:
+                    in.fail("неизвестная категория студента");
+                }
+            }
+
+            void encodeEntry(detail::ByteWriter &out, const WalEntry &entry, bool nested = false)
+            {
+                out.putByte(static_cast<uint8_t>(entry.operation));
+                out.putSigned(entry.id);
+                switch (entry.operation)
+                {
+                case WalOperation::PUT:
+                    if (!entry.student)
+                    {
+                        throw std::invalid_argument("Запись PUT журнала требует студента.");
+                    }
+                    putStudent(out, *entry.student);
+                    break;
+                case WalOperation::REMOVE:
+                    break;
+                case WalOperation::SET_GROUP:
+                    out.putString(entry.groupIndex);
+                    break;
+                case WalOperation::SET_RESEARCH_WORK:
+                    putResearchWork(out, entry.researchWork);
+                    break;
+                case WalOperation::BATCH:
+                    if (nested)
+                    {
+                        throw std::invalid_argument("Пакет журнала не может содержать пакет.");
+                    }
+                    out.putVarint(entry.entries.size());
+                    for (const auto &item : entry.entries)
+                    {
+                        encodeEntry(out, item, true);
+                    }
+                    break;
+                }
+            }
+
+            WalEntry decodeEntry(detail::ByteReader &in, bool nested = false)
+            {
+                WalEntry entry;
+                entry.operation = static_cast<WalOperation>(in.getByte());
+                entry.id = in.getInt();
+                try
+                {
+                    switch (entry.operation)
+                    {
+                    case WalOperation::PUT:
+                        entry.student = getStudent(in);
+                        break;
+                    case WalOperation::REMOVE:
+                        break;
+                    case WalOperation::SET_GROUP:
+                        entry.groupIndex = in.getString();
+                        break;
+                    case WalOperation::SET_RESEARCH_WORK:
+                        entry.researchWork = getResearchWork(in);
+                        break;
+                    case WalOperation::BATCH:
+                    {
+                        if (nested)
+                        {
+                            in.fail("вложенный пакет");
+                        }
+                        uint64_t count = in.getVarint();
+                        // Каждая запись занимает не меньше двух байт: не резервируем больше, чем вмещают данные
+                        if (count > in.remaining() / 2)
+                        {
+                            in.fail("некорректный размер пакета");
+                        }
+                        entry.entries.reserve(count);
+                        for (uint64_t i = 0; i < count; ++i)
+                        {
+                            entry.entries.push_back(decodeEntry(in, true));
+                        }
+                        break;
+                    }
+                    default:
+                        in.fail("неизвестная операция");
+                    }
+                }
+                catch (const std::invalid_argument &error)
+                {
+                    // Конструкторы студентов проверяют данные: нарушение означает повреждённую запись
+                    in.fail(error.what());
+                }
+                return entry;
+            }
+
+            WalEntry decodeEntry(std::string_view payload)
+            {
+                detail::ByteReader in(payload, SOURCE);
+                WalEntry entry = decodeEntry(in);
+                if (in.remaining() != 0)
+                {
+                    in.fail("лишние данные в записи");
+                }
+                return entry;
+            }
+
+#if !defined(_WIN32)
+            void writeAll(int fd, const char *data, size_t size, const std::filesystem::path &path)
+            {
+                while (size > 0)
+                {
+                    ssize_t written = ::write(fd, data, size);
+                    if (written < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        throwIoError("Ошибка записи журнала", path);
+                    }
+                    data += written;
+                    size -= static_cast<size_t>(written);
+                }
+            }
+
+            /**
+             * @brief Создаёт файл журнала, содержащий только заголовок, и сбрасывает его на диск.
+             * @return Дескриптор, открытый на запись.
+             */
+            int createLogFile(const std::filesystem::path &path, uint64_t baseLsn, std::string_view records = {})
+            {
+                int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+                if (fd < 0)
+                {
+                    throwIoError("Не удалось создать журнал", path);
+                }
+                detail::ByteWriter header;
+                header.putBytes(MAGIC, sizeof(MAGIC));
+                header.putFixed32(WAL_FORMAT_VERSION);
+                header.putFixed32(0);
+                header.putFixed64(baseLsn);
+                try
+                {
+                    writeAll(fd, header.data(), header.size(), path);
+                    writeAll(fd, records.data(), records.size(), path);
+                    if (::fdatasync(fd) != 0)
+                    {
+                        throwIoError("Ошибка синхронизации журнала", path);
+                    }
+                }
+                catch (...)
+                {
+                    ::close(fd);
+                    throw;
+                }
+                return fd;
+            }
+
+            std::string readRange(const std::filesystem::path &path, uint64_t offset, uint64_t size)
+            {
+                std::string bytes(size, '\0');
+                std::ifstream file(path, std::ios::binary);
+                file.seekg(static_cast<std::streamoff>(offset));
+                if (!file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+                {
+                    throw std::runtime_error("Ошибка чтения журнала реестра: " + path.string());
+                }
+                return bytes;
+            }
+
+            int openForAppend(const std::filesystem::path &path)
+            {
+                int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+                if (fd < 0)
+                {
+                    throwIoError("Не удалось открыть журнал", path);
+                }
+                return fd;
+            }
+#endif
+
+        } // namespace
+
+        void syncPath(const std::filesystem::path &path)
+        {
+#if defined(_WIN32)
+            (void)path;
+#else
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                throwIoError("Не удалось открыть", path);
+            }
+            int result = ::fsync(fd);
+            ::close(fd);
+            if (result != 0)
+            {
+                throwIoError("Ошибка синхронизации", path);
+            }
+#endif
+        }
+
+        WriteAheadLog::WriteAheadLog(const std::filesystem::path &path, WalOptions options)
+            : path_(path), options_(options)
+        {
+#if defined(_WIN32)
+            throw std::runtime_error("Журнал упреждающей записи не поддерживается на этой платформе.");
+#else
+            std::error_code error;
+            auto fileSize = std::filesystem::file_size(path_, error);
+            // Файл короче заголовка мог остаться только от сбоя при создании журнала
+            if (error || fileSize < FILE_HEADER_SIZE)
+            {
+                fd_ = createLogFile(path_, 0);
+                syncPath(path_.has_parent_path() ? path_.parent_path() : std::filesystem::path("."));
+            }
+            else
+            {
+                std::string data = readFile(path_);
+                baseLsn_ = readFileHeader(data, path_);
+                size_t validEnd = scanRecords(data, [](std::string_view) {});
+                if (validEnd < data.size())
+                {
+                    std::filesystem::resize_file(path_, validEnd);
+                }
+                fd_ = openForAppend(path_);
+                endLsn_ = baseLsn_ + (validEnd - FILE_HEADER_SIZE);
+            }
+            writtenLsn_ = endLsn_;
+            durableLsn_ = endLsn_;
+
+            if (options_.durability != Durability::EVERY_OPERATION)
+            {
+                flusher_ = std::thread(&WriteAheadLog::runFlusher, this);
+            }
+#endif
+        }
+
+        WriteAheadLog::~WriteAheadLog()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            if (flusher_.joinable())
+            {
+                flusher_.join();
+            }
+#if !defined(_WIN32)
+            if (fd_ >= 0)
+            {
+                try
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    flushUpTo(lock, endLsn_, options_.durability != Durability::NONE);
+                }
+                catch (const std::exception &)
+                {
+                    // Деструктор не бросает: ошибка уже сохранена в error_
+                }
+                ::close(fd_);
+            }
+#endif
+        }
+
+        uint64_t WriteAheadLog::append(const WalEntry &entry)
+        {
+            // Кодирование вне мьютекса в буфер потока, который переиспользуется между вызовами
+            thread_local detail::ByteWriter payload;
+            payload.clear();
+            encodeEntry(payload, entry);
+            std::string_view bytes(payload.data(), payload.size());
+
+            detail::ByteWriter header;
+            header.putFixed32(static_cast<uint32_t>(bytes.size()));
+            header.putFixed32(checksum(bytes));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            rethrowError();
+            pending_.insert(pending_.end(), header.data(), header.data() + header.size());
+            pending_.insert(pending_.end(), bytes.begin(), bytes.end());
+            endLsn_ += RECORD_HEADER_SIZE + bytes.size();
+            ++stats_.records;
+            stats_.bytes += RECORD_HEADER_SIZE + bytes.size();
+            return endLsn_;
+        }
+
+        void WriteAheadLog::commit(uint64_t lsn)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (options_.durability == Durability::EVERY_OPERATION)
+            {
+                flushUpTo(lock, lsn, true);
+            }
+            else
+            {
+                rethrowError();
+            }
+        }
+
+        void WriteAheadLog::sync()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            flushUpTo(lock, endLsn_, true);
+        }
+
+        uint64_t WriteAheadLog::endLsn() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return endLsn_;
+        }
+
+        WalStats WriteAheadLog::stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+        void WriteAheadLog::flushUpTo(std::unique_lock<std::mutex> &lock, uint64_t lsn, bool durable)
+        {
+#if defined(_WIN32)
+            (void)lock;
+            (void)lsn;
+            (void)durable;
+#else
+            while ((durable ? durableLsn_ : writtenLsn_) < lsn)
+            {
+                rethrowError();
+                if (flushing_)
+                {
+                    // Запись уже выполняет ведущий поток: его пакет может покрыть и наш LSN
+                    flushed_.wait(lock);
+                    continue;
+                }
+
+                flushing_ = true;
+                std::vector<char> batch;
+                batch.swap(pending_);
+                uint64_t target = endLsn_;
+                lock.unlock();
+                try
+                {
+                    writeAll(fd_, batch.data(), batch.size(), path_);
+                    if (durable && ::fdatasync(fd_) != 0)
+                    {
+                        throwIoError("Ошибка синхронизации журнала", path_);
+                    }
+                }
+                catch (...)
+                {
+                    lock.lock();
+                    flushing_ = false;
+                    error_ = std::current_exception();
+                    flushed_.notify_all();
+                    throw;
+                }
+                lock.lock();
+
+                flushing_ = false;
+                writtenLsn_ = target;
+                ++stats_.writes;
+                if (durable)
+                {
+                    durableLsn_ = target;
+                    ++stats_.syncs;
+                }
+                // Возвращаем ёмкость буфера, если за время записи новых записей не появилось
+                if (pending_.empty())
+                {
+                    batch.clear();
+                    pending_.swap(batch);
+                }
+                flushed_.notify_all();
+            }
+#endif
+        }
+
+        void WriteAheadLog::runFlusher()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_)
+            {
+                wake_.wait_for(lock, options_.flushInterval, [this]
+                               { return stopping_; });
+                if (stopping_ || error_)
+                {
+                    continue;
+                }
+                try
+                {
+                    flushUpTo(lock, endLsn_, options_.durability == Durability::INTERVAL);
+                }
+                catch (const std::exception &)
+                {
+                    // Ошибка сохранена в error_ и будет брошена следующим вызовом append или commit
+                }
+            }
+        }
+
+        void WriteAheadLog::rethrowError() const
+        {
+            if (error_)
+            {
+                std::rethrow_exception(error_);
+            }
+        }
+
+        void WriteAheadLog::discardBefore(uint64_t lsn)
+        {
+#if defined(_WIN32)
+            (void)lsn;
+#else
+            // Одновременные отбрасывания переписывали бы один временный файл
+            std::lock_guard<std::mutex> compaction(compactionMutex_);
+            std::unique_lock<std::mutex> lock(mutex_);
+            flushUpTo(lock, endLsn_, false);
+            if (lsn < baseLsn_ || lsn > writtenLsn_)
+            {
+                throw std::invalid_argument("LSN вне журнала: " + std::to_string(lsn));
+            }
+            uint64_t base = baseLsn_;
+            uint64_t copied = writtenLsn_;
+            lock.unlock();
+
+            // Основной хвост копируется без мьютекса: дозапись продолжается в конец старого файла,
+            // а скопированная часть файла уже не меняется
+            auto temporary = path_;
+            temporary += ".tmp";
+            int fd = createLogFile(temporary, lsn, readRange(path_, FILE_HEADER_SIZE + (lsn - base), copied - lsn));
+
+            lock.lock();
+            try
+            {
+                while (flushing_)
+                {
+                    flushed_.wait(lock);
+                }
+                // Под мьютексом — только записи, переданные ОС за время копирования, и замена файла
+                if (writtenLsn_ > copied)
+                {
+                    std::string delta = readRange(path_, FILE_HEADER_SIZE + (copied - base), writtenLsn_ - copied);
+                    writeAll(fd, delta.data(), delta.size(), temporary);
+                    if (::fdatasync(fd) != 0)
+                    {
+                        throwIoError("Ошибка синхронизации журнала", temporary);
+                    }
+                }
+                ::close(fd);
+                fd = -1;
+                std::filesystem::rename(temporary, path_);
+                syncPath(path_.has_parent_path() ? path_.parent_path() : std::filesystem::path("."));
+            }
+            catch (...)
+            {
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+                throw;
+            }
+
+            ::close(fd_);
+            fd_ = openForAppend(path_);
+            baseLsn_ = lsn;
+#endif
+        }
+
+        size_t WriteAheadLog::replay(const std::filesystem::path &path, const std::function<void(const WalEntry &)> &apply)
+        {
+            std::error_code error;
+            auto fileSize = std::filesystem::file_size(path, error);
+            if (error || fileSize < FILE_HEADER_SIZE)
+            {
+                return 0;
+            }
+
+            std::string data = readFile(path);
+            readFileHeader(data, path);
+            size_t count = 0;
+            scanRecords(data, [&](std::string_view payload)
+                        {
+                apply(decodeEntry(payload));
+                ++count; });
+            return count;
+        }
+
+    } // namespace storage
+} // namespace university
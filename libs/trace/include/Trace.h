@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+namespace university
+{
+    namespace trace
+    {
+
+        /**
+         * @brief Количество событий в кольцевом буфере одного потока по умолчанию.
+         */
+        inline constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+        /**
+         * @struct TraceEvent
+         * @brief Завершённый участок трассировки (событие "X" формата Chrome trace_event).
+         *
+         * Категория, имя и имя аргумента — строковые литералы: хранятся только указатели.
+         */
+        struct TraceEvent
+        {
+            const char *category = "";
+            const char *name = "";
+            const char *argName = nullptr; ///< Имя числового аргумента или nullptr
+            int64_t argValue = 0;
+            uint64_t startNs = 0;    ///< Начало от момента start(), нс
+            uint64_t durationNs = 0; ///< Длительность, нс
+            uint32_t thread = 0;     ///< Номер кольцевого буфера (дорожка в Perfetto)
+        };
+
+        namespace detail
+        {
+            extern std::atomic<bool> enabled;
+
+            uint64_t nowNs() noexcept;
+            void record(const char *category, const char *name, const char *argName, int64_t argValue,
+                        uint64_t startNs, uint64_t endNs) noexcept;
+        } // namespace detail
+
+        /**
+         * @brief Проверяет, записываются ли участки.
+         *
+         * Одна атомарная загрузка без упорядочивания: это вся цена участка при выключенной трассировке.
+         */
+        inline bool enabled() noexcept
+        {
+            return detail::enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Очищает буферы и включает запись участков.
+         * @param eventsPerThread Ёмкость кольцевого буфера потока: при переполнении старые события вытесняются.
+         */
+        void start(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+
+        /**
+         * @brief Выключает запись участков; записанные события сохраняются до следующего start().
+         */
+        void stop();
+
+        /**
+         * @brief Собирает события всех потоков.
+         * @return События, упорядоченные по времени начала.
+         */
+        std::vector<TraceEvent> collect();
+
+        /**
+         * @brief Получает количество событий, вытесненных из переполненных буферов с момента start().
+         */
+        uint64_t droppedEvents();
+
+        /**
+         * @brief Записывает события в формате Chrome trace_event JSON (открывается в Perfetto и chrome://tracing).
+         * @param out Поток вывода.
+         */
+        void writeChromeTrace(std::ostream &out);
+
+        /**
+         * @brief Записывает события в файл в формате Chrome trace_event JSON.
+         * @param path Путь к файлу (перезаписывается).
+         * @throw std::runtime_error при ошибке записи.
+         */
+        void writeChromeTrace(const std::filesystem::path &path);
+
+        /**
+         * @class Span
+         * @brief Участок трассировки от создания до уничтожения объекта.
+         *
+         * Событие записывается в кольцевой буфер текущего потока; буфер защищён
+         * собственным мьютексом, который конкурирует только со сбором событий.
+         * Участок, начатый при выключенной трассировке, не записывается.
+         */
+        class Span
+        {
+        public:
+            Span(const char *category, const char *name) noexcept : Span(category, name, nullptr, 0) {}
+
+            Span(const char *category, const char *name, const char *argName, int64_t argValue) noexcept
+                : category_(category), name_(name), argName_(argName), argValue_(argValue), active_(enabled()),
+                  startNs_(active_ ? detail::nowNs() : 0)
+            {
+            }
+
+            ~Span()
+            {
+                if (active_)
+                {
+                    detail::record(category_, name_, argName_, argValue_, startNs_, detail::nowNs());
+                }
+            }
+
+            Span(const Span &) = delete;
+            Span &operator=(const Span &) = delete;
+
+        private:
+            const char *category_;
+            const char *name_;
+            const char *argName_;
+            int64_t argValue_;
+            bool active_;
+            uint64_t startNs_;
+        };
+
+    } // namespace trace
+} // namespace university
+
+#define UNIVERSITY_TRACE_CONCAT_IMPL(a, b) a##b
+#define UNIVERSITY_TRACE_CONCAT(a, b) UNIVERSITY_TRACE_CONCAT_IMPL(a, b)
+
+#if UNIVERSITY_TRACING
+/// Участок трассировки до конца текущей области видимости
+#define UNIVERSITY_TRACE_SCOPE(category, name) \
+    ::university::trace::Span UNIVERSITY_TRACE_CONCAT(traceSpan, __LINE__)(category, name)
+/// Участок трассировки с числовым аргументом
+#define UNIVERSITY_TRACE_SCOPE_ARG(category, name, argName, argValue)                                  \
+    ::university::trace::Span UNIVERSITY_TRACE_CONCAT(traceSpan, __LINE__)(category, name, argName, \
+                                                                           static_cast<int64_t>(argValue))
+#else
+#define UNIVERSITY_TRACE_SCOPE(category, name) static_cast<void>(0)
+#define UNIVERSITY_TRACE_SCOPE_ARG(category, name, argName, argValue) static_cast<void>(0)
+#endif
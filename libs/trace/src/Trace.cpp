@@ -0,0 +1,265 @@
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace university
+{
+    namespace trace
+    {
+        namespace detail
+        {
+            std::atomic<bool> enabled{false};
+        } // namespace detail
+
+        namespace
+        {
+            /**
+             * @brief Кольцевой буфер событий одного потока.
+             *
+             * После завершения потока буфер возвращается в реестр и достаётся
+             * следующему новому потоку, поэтому короткоживущие потоки параллельных
+             * обходов не множат буферы, а в Perfetto занимают общие дорожки.
+             */
+            struct ThreadBuffer
+            {
+                std::mutex mutex;
+                std::vector<TraceEvent> events;
+                uint64_t written = 0; ///< Всего записано с момента start()
+                uint32_t thread = 0;
+            };
+
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+                std::vector<ThreadBuffer *> idle;
+                std::atomic<size_t> capacity{DEFAULT_EVENTS_PER_THREAD};
+                std::atomic<uint64_t> epochNs{0};
+            };
+
+            // Не уничтожается при выходе: потоки могут завершаться позже статических объектов
+            Registry &registry()
+            {
+                static Registry *instance = new Registry;
+                return *instance;
+            }
+
+            struct ThreadSlot
+            {
+                ThreadBuffer *buffer = nullptr;
+
+                ~ThreadSlot()
+                {
+                    if (buffer != nullptr)
+                    {
+                        auto &shared = registry();
+                        std::lock_guard<std::mutex> lock(shared.mutex);
+                        shared.idle.push_back(buffer);
+                    }
+                }
+            };
+
+            thread_local ThreadSlot slot;
+
+            ThreadBuffer &threadBuffer()
+            {
+                if (slot.buffer == nullptr)
+                {
+                    auto &shared = registry();
+                    std::lock_guard<std::mutex> lock(shared.mutex);
+                    if (!shared.idle.empty())
+                    {
+                        slot.buffer = shared.idle.back();
+                        shared.idle.pop_back();
+                    }
+                    else
+                    {
+                        shared.buffers.push_back(std::make_unique<ThreadBuffer>());
+                        slot.buffer = shared.buffers.back().get();
+                        slot.buffer->thread = static_cast<uint32_t>(shared.buffers.size());
+                    }
+                }
+                return *slot.buffer;
+            }
+
+            void writeJsonString(std::ostream &out, const char *text)
+            {
+                out << '"';
+                for (; *text != '\0'; ++text)
+                {
+                    if (*text == '"' || *text == '\\')
+                    {
+                        out << '\\';
+                    }
+                    out << *text;
+                }
+                out << '"';
+            }
+
+            void writeMicroseconds(std::ostream &out, uint64_t ns)
+            {
+                out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+            }
+
+        } // namespace
+
+        namespace detail
+        {
+            uint64_t nowNs() noexcept
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 std::chrono::steady_clock::now().time_since_epoch())
+                                                 .count());
+            }
+
+            void record(const char *category, const char *name, const char *argName, int64_t argValue,
+                        uint64_t startNs, uint64_t endNs) noexcept
+            {
+                auto &shared = registry();
+                uint64_t epoch = shared.epochNs.load(std::memory_order_relaxed);
+                // Участок, начатый до перезапуска трассировки, относится к прошлой записи
+                if (startNs < epoch)
+                {
+                    return;
+                }
+                TraceEvent event{category, name, argName, argValue, startNs - epoch, endNs - startNs, 0};
+                try
+                {
+                    auto &buffer = threadBuffer();
+                    event.thread = buffer.thread;
+                    std::lock_guard<std::mutex> lock(buffer.mutex);
+                    size_t capacity = std::max<size_t>(1, shared.capacity.load(std::memory_order_relaxed));
+                    if (buffer.events.size() < capacity)
+                    {
+                        buffer.events.push_back(event);
+                    }
+                    else
+                    {
+                        buffer.events[buffer.written % capacity] = event;
+                    }
+                    ++buffer.written;
+                }
+                catch (...)
+                {
+                    // Нехватка памяти под буфер: событие теряется, трассируемый код продолжает работу
+                }
+            }
+        } // namespace detail
+
+        void start(size_t eventsPerThread)
+        {
+            auto &shared = registry();
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.capacity.store(eventsPerThread, std::memory_order_relaxed);
+                for (auto &buffer : shared.buffers)
+                {
+                    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+                    buffer->events.clear();
+                    buffer->written = 0;
+                }
+                shared.epochNs.store(detail::nowNs(), std::memory_order_relaxed);
+            }
+            detail::enabled.store(true, std::memory_order_relaxed);
+        }
+
+        void stop()
+        {
+            detail::enabled.store(false, std::memory_order_relaxed);
+        }
+
+        std::vector<TraceEvent> collect()
+        {
+            auto &shared = registry();
+            std::vector<TraceEvent> events;
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            for (auto &buffer : shared.buffers)
+            {
+                std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+                // В заполненном буфере самое старое событие стоит на месте следующей записи
+                size_t oldest = buffer->written > buffer->events.size() ? buffer->written % buffer->events.size() : 0;
+                events.insert(events.end(), buffer->events.begin() + static_cast<std::ptrdiff_t>(oldest), buffer->events.end());
+                events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + static_cast<std::ptrdiff_t>(oldest));
+            }
+            std::stable_sort(events.begin(), events.end(), [](const TraceEvent &a, const TraceEvent &b)
+                             { return a.startNs < b.startNs; });
+            return events;
+        }
+
+        uint64_t droppedEvents()
+        {
+            auto &shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            uint64_t dropped = 0;
+            for (auto &buffer : shared.buffers)
+            {
+                std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+                dropped += buffer->written - buffer->events.size();
+            }
+            return dropped;
+        }
+
+        void writeChromeTrace(std::ostream &out)
+        {
+            auto events = collect();
+            std::vector<uint32_t> threads;
+            for (const auto &event : events)
+            {
+                threads.push_back(event.thread);
+            }
+            std::sort(threads.begin(), threads.end());
+            threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+            out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+            bool first = true;
+            for (uint32_t thread : threads)
+            {
+                out << (first ? "\n" : ",\n") << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+                    << ", \"args\": {\"name\": \"thread " << thread << "\"}}";
+                first = false;
+            }
+            for (const auto &event : events)
+            {
+                out << (first ? "\n" : ",\n") << "  {\"name\": ";
+                writeJsonString(out, event.name);
+                out << ", \"cat\": ";
+                writeJsonString(out, event.category);
+                out << ", \"ph\": \"X\", \"ts\": ";
+                writeMicroseconds(out, event.startNs);
+                out << ", \"dur\": ";
+                writeMicroseconds(out, event.durationNs);
+                out << ", \"pid\": 1, \"tid\": " << event.thread;
+                if (event.argName != nullptr)
+                {
+                    out << ", \"args\": {";
+                    writeJsonString(out, event.argName);
+                    out << ": " << event.argValue << '}';
+                }
+                out << '}';
+                first = false;
+            }
+            out << "\n]}\n";
+        }
+
+        void writeChromeTrace(const std::filesystem::path &path)
+        {
+            std::ofstream file(path);
+            if (!file)
+            {
+                throw std::runtime_error("Не удалось открыть файл трассировки: " + path.string());
+            }
+            writeChromeTrace(file);
+            file.flush();
+            if (!file)
+            {
+                throw std::runtime_error("Ошибка записи файла трассировки: " + path.string());
+            }
+        }
+
+    } // namespace trace
+} // namespace university
@@ -6,6 +6,7 @@
 #include <map>
 #include "Student.h"
 #include "HashTable.h"
+#include "StudentTable.h"
 #include "SeniorStudent.h"
 #include "GraduateStudent.h"
 
@@ -43,7 +44,24 @@ namespace university
          * @brief Отображает содержимое таблицы студентов.
          * @param table Хеш-таблица студентов.
          */
-        void showStudentTable(const HashTable<int, std::unique_ptr<Student>> &table);
+        void showStudentTable(const StudentTable &table);
+
+        /**
+         * @brief Отображает страницу таблицы студентов.
+         *
+         * Страница форматируется в буфер и выводится одной операцией записи.
+         *
+         * @param rows Студенты страницы.
+         * @param first Количество студентов на предыдущих страницах.
+         * @param total Общее количество студентов.
+         */
+        void showStudentPage(const std::vector<StudentRow> &rows, size_t first, size_t total);
+
+        /**
+         * @brief Спрашивает, показать ли следующую страницу.
+         * @return true для следующей страницы, false для завершения просмотра.
+         */
+        bool askNextPage();
 
         /**
          * @brief Отображает сообщение пользователю.
@@ -106,6 +124,14 @@ namespace university
          */
         void clearInputBuffer();
 
+        /**
+         * @brief Добавляет в буфер описание студента с его ID.
+         * @param out Буфер вывода.
+         * @param id ID студента.
+         * @param student Студент.
+         */
+        static void appendStudentRow(std::ostream &out, int id, const Student &student);
+
         /**
          * @brief Запрашивает и считывает общую информацию о студенте.
          * @param name Ссылка для хранения имени студента.
@@ -169,21 +169,60 @@ namespace university
         student.printInfo(std::cout);
     }
 
-    void View::showStudentTable(const HashTable<int, std::unique_ptr<Student>> &table)
+    void View::appendStudentRow(std::ostream &out, int id, const Student &student)
     {
-        std::cout << "\n--- Все студенты ---\n";
+        out << "ID: " << id << '\n';
+        student.printInfo(out);
+        out << "---------------------\n";
+    }
+
+    void View::showStudentTable(const StudentTable &table)
+    {
+        std::ostringstream out;
+        out << "\n--- Все студенты ---\n";
         if (table.size() == 0)
         {
-            std::cout << "В реестре нет студентов." << std::endl;
-            return;
+            out << "В реестре нет студентов.\n";
         }
         for (auto it = table.begin(); it != table.end(); ++it)
         {
             auto pair = *it;
-            std::cout << "ID: " << pair.first << std::endl;
-            pair.second->printInfo(std::cout);
-            std::cout << "---------------------\n";
+            appendStudentRow(out, pair.first, *pair.second);
+        }
+        auto text = out.view();
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        std::cout.flush();
+    }
+
+    void View::showStudentPage(const std::vector<StudentRow> &rows, size_t first, size_t total)
+    {
+        std::ostringstream out;
+        if (rows.empty())
+        {
+            out << "\n--- Все студенты ---\nВ реестре нет студентов.\n";
+        }
+        else
+        {
+            out << "\n--- Студенты " << first + 1 << "–" << first + rows.size() << " из " << total << " ---\n";
+        }
+        for (const auto &[id, student] : rows)
+        {
+            appendStudentRow(out, id, *student);
+        }
+        auto text = out.view();
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        std::cout.flush();
+    }
+
+    bool View::askNextPage()
+    {
+        std::cout << "Enter — следующая страница, q — завершить просмотр: ";
+        std::string answer;
+        if (!std::getline(std::cin, answer))
+        {
+            return false;
         }
+        return answer.empty() || (answer[0] != 'q' && answer[0] != 'Q');
     }
 
     void View::showMessage(const std::string &message)
@@ -218,7 +257,7 @@ namespace university
     void View::showStudentGrades(const Student &student)
     {
         std::cout << "\n--- Оценки студента ---\n";
-        std::cout << "Имя: " << student.getName() << std::endl;
+        std::cout << "Имя: " << student.getName() << '\n';
         std::cout << "Категория: ";
         switch (student.getCategory())
         {
@@ -229,7 +268,7 @@ namespace university
         default:
             break;
         }
-        std::cout << std::endl;
+        std::cout << '\n';
 
         // Отображаем оценки в зависимости от категории
         switch (student.getCategory())
@@ -242,7 +281,7 @@ namespace university
             {
                 std::cout << grade << " ";
             }
-            std::cout << std::endl;
+            std::cout << '\n';
             break;
         }
         case StudentCategory::SENIOR:
@@ -253,10 +292,10 @@ namespace university
             {
                 std::cout << grade << " ";
             }
-            std::cout << std::endl;
+            std::cout << '\n';
             const auto &work = senior.getResearchWork();
             std::cout << "Оценки за УИР (Руководитель, Комиссия): "
-                      << work.supervisorGrade << ", " << work.commissionGrade << std::endl;
+                      << work.supervisorGrade << ", " << work.commissionGrade << '\n';
             break;
         }
         case StudentCategory::GRADUATE:
@@ -265,7 +304,7 @@ namespace university
             const auto &project = graduate.getDiplomaProject();
             std::cout << "Оценки за ДП (Руководитель, Рецензент, ГЭК): "
                       << project.supervisorGrade << ", " << project.reviewerGrade
-                      << ", " << project.stateCommissionGrade << std::endl;
+                      << ", " << project.stateCommissionGrade << '\n';
             break;
         }
         }
@@ -276,12 +315,12 @@ namespace university
         std::cout << "\n--- Средние оценки по группам ---\n";
         if (averages.empty())
         {
-            std::cout << "Студенты не найдены." << std::endl;
+            std::cout << "Студенты не найдены.\n";
             return;
         }
         for (const auto &[group, average] : averages)
         {
-            std::cout << "Группа " << group << ": " << std::fixed << std::setprecision(2) << average << std::endl;
+            std::cout << "Группа " << group << ": " << std::fixed << std::setprecision(2) << average << '\n';
         }
     }
 
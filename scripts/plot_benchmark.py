@@ -11,6 +11,45 @@ import seaborn as sns
 from pathlib import Path
 import os
 
+def load_results(csv_file):
+    """
+    Читает результаты бенчмарка (строка на сочетание объёма, режима, числа
+    потоков и зерна) и сводит их в строку на объём данных.
+
+    Для каждого режима берётся медиана медиан по зёрнам, нижняя граница
+    погрешности — минимальное время, верхняя — 95-й процентиль. Погрешность
+    ускорения оценивается по относительным стандартным отклонениям режимов.
+
+    Args:
+        csv_file (str): Путь к CSV файлу с результатами
+
+    Returns:
+        pandas.DataFrame: Столбцы Students, SingleThread(ms), MultiThread(ms), Speedup
+        и границы погрешностей Single*/Multi*/SpeedupErr
+    """
+    raw = pd.read_csv(csv_file)
+    if 'Threads' in raw.columns:
+        # Многопоточный режим сравнивается при наибольшем замеренном числе потоков
+        max_threads = raw[raw['Mode'] == 'multi'].groupby('Students')['Threads'].transform('max')
+        raw = raw[(raw['Mode'] != 'multi') | (raw['Threads'] == max_threads)]
+    grouped = raw.groupby(['Students', 'Mode']).agg(
+        median=('WallMedian(ms)', 'median'),
+        low=('WallMin(ms)', 'min'),
+        high=('WallP95(ms)', 'max'),
+        stddev=('WallStddev(ms)', 'median')).reset_index()
+
+    df = pd.DataFrame({'Students': sorted(grouped['Students'].unique())})
+    for mode, column in (('single', 'Single'), ('multi', 'Multi')):
+        part = grouped[grouped['Mode'] == mode].set_index('Students')
+        df[f'{column}Thread(ms)'] = df['Students'].map(part['median'])
+        df[f'{column}Low'] = df[f'{column}Thread(ms)'] - df['Students'].map(part['low'])
+        df[f'{column}High'] = df['Students'].map(part['high']) - df[f'{column}Thread(ms)']
+        df[f'{column}Stddev'] = df['Students'].map(part['stddev'])
+    df['Speedup'] = df['SingleThread(ms)'] / df['MultiThread(ms)']
+    df['SpeedupErr'] = df['Speedup'] * np.sqrt((df['SingleStddev'] / df['SingleThread(ms)']) ** 2 +
+                                               (df['MultiStddev'] / df['MultiThread(ms)']) ** 2)
+    return df
+
 def plot_benchmark_results(csv_file='docs/benchmark_results.csv'):
     """
     Строит графики результатов бенчмарка.
@@ -26,8 +65,8 @@ def plot_benchmark_results(csv_file='docs/benchmark_results.csv'):
     
     # Читаем данные
     try:
-        df = pd.read_csv(csv_file)
-        print(f"Загружено {len(df)} записей из {csv_file}")
+        df = load_results(csv_file)
+        print(f"Загружено {len(df)} объёмов данных из {csv_file}")
     except Exception as e:
         print(f"Ошибка при чтении файла: {e}")
         return
@@ -42,11 +81,11 @@ def plot_benchmark_results(csv_file='docs/benchmark_results.csv'):
                 'Сравнение однопоточного и многопоточного режимов', 
                 fontsize=16, fontweight='bold')
     
-    # График 1: Время выполнения vs Размер данных (линейная шкала)
-    ax1.plot(df['Students'], df['SingleThread(ms)'], 'o-', 
-             label='Однопоточный режим', linewidth=3, markersize=8, color='red')
-    ax1.plot(df['Students'], df['MultiThread(ms)'], 's-', 
-             label='Многопоточный режим', linewidth=3, markersize=8, color='blue')
+    # График 1: Время выполнения vs Размер данных (линейная шкала); погрешность — от min до p95
+    ax1.errorbar(df['Students'], df['SingleThread(ms)'], yerr=[df['SingleLow'], df['SingleHigh']], fmt='o-',
+                 label='Однопоточный режим (медиана)', linewidth=3, markersize=8, color='red', capsize=5)
+    ax1.errorbar(df['Students'], df['MultiThread(ms)'], yerr=[df['MultiLow'], df['MultiHigh']], fmt='s-',
+                 label='Многопоточный режим (медиана)', linewidth=3, markersize=8, color='blue', capsize=5)
     ax1.set_xlabel('Количество студентов')
     ax1.set_ylabel('Время выполнения (мс)')
     ax1.set_title('Время выполнения vs Размер данных (линейная шкала)')
@@ -64,8 +103,8 @@ def plot_benchmark_results(csv_file='docs/benchmark_results.csv'):
                         textcoords="offset points", xytext=(0,-15), ha='center', fontsize=10)
     
     # График 2: Ускорение vs Размер данных
-    ax2.plot(df['Students'], df['Speedup'], 'o-', 
-             color='green', linewidth=3, markersize=8)
+    ax2.errorbar(df['Students'], df['Speedup'], yerr=df['SpeedupErr'], fmt='o-',
+                 color='green', linewidth=3, markersize=8, capsize=5)
     ax2.axhline(y=1, color='red', linestyle='--', alpha=0.7, label='Без ускорения')
     ax2.axhline(y=2, color='orange', linestyle='--', alpha=0.7, label='2x ускорение')
     ax2.axhline(y=4, color='purple', linestyle='--', alpha=0.7, label='4x ускорение (идеал)')
@@ -170,10 +209,12 @@ def create_focused_plot(df):
                 fontsize=16, fontweight='bold')
     
     # График 1: Время выполнения для больших объёмов
-    ax1.plot(large_data['Students'], large_data['SingleThread(ms)'], 'o-', 
-             label='Однопоточный режим', linewidth=3, markersize=10, color='red')
-    ax1.plot(large_data['Students'], large_data['MultiThread(ms)'], 's-', 
-             label='Многопоточный режим', linewidth=3, markersize=10, color='blue')
+    ax1.errorbar(large_data['Students'], large_data['SingleThread(ms)'],
+                 yerr=[large_data['SingleLow'], large_data['SingleHigh']], fmt='o-',
+                 label='Однопоточный режим (медиана)', linewidth=3, markersize=10, color='red', capsize=5)
+    ax1.errorbar(large_data['Students'], large_data['MultiThread(ms)'],
+                 yerr=[large_data['MultiLow'], large_data['MultiHigh']], fmt='s-',
+                 label='Многопоточный режим (медиана)', linewidth=3, markersize=10, color='blue', capsize=5)
     ax1.set_xlabel('Количество студентов')
     ax1.set_ylabel('Время выполнения (мс)')
     ax1.set_title('Время выполнения на больших объёмах данных')
@@ -192,7 +233,7 @@ def create_focused_plot(df):
                     bbox=dict(boxstyle="round,pad=0.3", facecolor="lightblue", alpha=0.8))
     
     # График 2: Ускорение для больших объёмов
-    bars = ax2.bar(large_data['Students'], large_data['Speedup'], 
+    bars = ax2.bar(large_data['Students'], large_data['Speedup'], yerr=large_data['SpeedupErr'], capsize=5,
                    color=['green' if x > 2 else 'orange' if x > 1.5 else 'red' for x in large_data['Speedup']],
                    alpha=0.7, width=large_data['Students']*0.3)
     ax2.axhline(y=1, color='red', linestyle='--', alpha=0.7, label='Без ускорения')
@@ -231,7 +272,7 @@ def create_detailed_report(csv_file='docs/benchmark_results.csv'):
     if not Path(csv_file).exists():
         return
     
-    df = pd.read_csv(csv_file)
+    df = load_results(csv_file)
     
     # Создаём отчёт
     report = []
@@ -287,11 +328,52 @@ def create_detailed_report(csv_file='docs/benchmark_results.csv'):
     
     print("Детальный отчёт сохранён в файл: docs/benchmark_report.md")
 
+def plot_scaling(csv_file='docs/scaling_benchmark_results.csv'):
+    """
+    Строит графики масштабирования по числу потоков: ускорение, эффективность
+    и дисбаланс нагрузки потоков для каждого объёма данных.
+
+    Args:
+        csv_file (str): Путь к CSV файлу с результатами прогона по числу потоков
+    """
+    if not Path(csv_file).exists():
+        return
+
+    df = pd.read_csv(csv_file).groupby(['Students', 'Threads']).median(numeric_only=True).reset_index()
+    fig, (ax1, ax2, ax3) = plt.subplots(1, 3, figsize=(18, 5))
+    fig.suptitle('Масштабирование средних по группам по числу потоков', fontsize=16, fontweight='bold')
+
+    threads = sorted(df['Threads'].unique())
+    ax1.plot(threads, threads, 'k--', alpha=0.5, label='Идеальное')
+    for students, part in df.groupby('Students'):
+        ax1.plot(part['Threads'], part['Speedup'], 'o-', label=f'{students:,} студентов')
+        ax2.plot(part['Threads'], part['Efficiency'] * 100, 'o-', label=f'{students:,} студентов')
+        ax3.plot(part['Threads'], part['Imbalance'], 'o-', label=f'{students:,} студентов')
+
+    ax1.set_ylabel('Ускорение (x)')
+    ax1.set_title('Ускорение относительно одного потока')
+    ax2.set_ylabel('Эффективность (%)')
+    ax2.set_title('Эффективность: ускорение / число потоков')
+    ax3.axhline(y=1, color='green', linestyle='--', alpha=0.7)
+    ax3.set_ylabel('Самый медленный поток / среднее')
+    ax3.set_title('Дисбаланс нагрузки потоков')
+    for ax in (ax1, ax2, ax3):
+        ax.set_xlabel('Потоков')
+        ax.set_xticks(threads)
+        ax.grid(True, alpha=0.3)
+        ax.legend()
+
+    plt.tight_layout()
+    output_file = 'docs/scaling_benchmark_results.png'
+    plt.savefig(output_file, dpi=300, bbox_inches='tight')
+    print(f"График масштабирования сохранён в файл: {output_file}")
+
 if __name__ == "__main__":
     print("=== Анализ результатов бенчмарка ===")
     
     # Построение графиков
     plot_benchmark_results()
+    plot_scaling()
     
     # Создание отчёта
     create_detailed_report()
@@ -3,6 +3,13 @@
 #include "JuniorStudent.h"
 #include "SeniorStudent.h"
 #include "GraduateStudent.h"
+#include "StudentGenerator.h"
+#include "BenchHarness.h"
+#include "BenchOptions.h"
+#include "BenchReport.h"
+#include "PerfCounters.h"
+#include "MemoryAccounting.h"
+#include "StudentFootprint.h"
 #include <chrono>
 #include <iostream>
 #include <fstream>
@@ -12,255 +19,715 @@
 #include <algorithm>
 #include <iomanip>
 #include <filesystem>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <cmath>
 
 namespace {
-    // Генератор случайных имён
-    std::string generateRandomName(std::mt19937& gen) {
-        static const std::vector<std::string> surnames = {
-            "Иванов", "Петров", "Сидоров", "Козлов", "Новиков", "Морозов", "Петренко", "Иваненко",
-            "Шевченко", "Бондаренко", "Мельник", "Романенко", "Павленко", "Марченко", "Ткаченко",
-            "Романюк", "Василенко", "Полтавец", "Кравченко", "Олейник", "Бондарь", "Мазепа", "Тарасенко",
-            "Лисенко", "Мельниченко", "Дмитренко", "Коваленко", "Шевчук", "Бондарчук", "Пономаренко"
-        };
-        static const std::vector<std::string> names = {
-            "Александр", "Дмитрий", "Максим", "Сергей", "Андрей", "Алексей", "Артём", "Илья",
-            "Кирилл", "Михаил", "Никита", "Матвей", "Роман", "Егор", "Арсений", "Владислав",
-            "Денис", "Степан", "Владимир", "Данил", "Евгений", "Тимофей", "Владислав", "Игорь",
-            "Артём", "Руслан", "Виталий", "Николай", "Павел", "Ростислав", "Глеб", "Константин"
-        };
-        
-        std::uniform_int_distribution<> surnameDist(0, static_cast<int>(surnames.size()) - 1);
-        std::uniform_int_distribution<> nameDist(0, static_cast<int>(names.size()) - 1);
-        
-        return surnames[surnameDist(gen)] + " " + names[nameDist(gen)];
+    // Сравнивает результаты вычисления средних с допуском на порядок суммирования
+    bool sameAverages(const std::map<std::string, double>& expected, const std::map<std::string, double>& actual) {
+        if (expected.size() != actual.size()) {
+            return false;
+        }
+        for (const auto& [group, average] : expected) {
+            auto it = actual.find(group);
+            if (it == actual.end() || std::abs(it->second - average) > 0.001) {
+                return false;
+            }
+        }
+        return true;
     }
     
-    // Генератор случайных групп
-    std::string generateRandomGroup(std::mt19937& gen) {
-        static const std::vector<std::string> faculties = {"IU", "IT", "IB", "IM", "IE"};
-        static const std::vector<std::string> years = {"1", "2", "3", "4", "5"};
-        static const std::vector<std::string> groups = {"A", "B", "C", "D", "E"};
-        
-        std::uniform_int_distribution<> facultyDist(0, static_cast<int>(faculties.size()) - 1);
-        std::uniform_int_distribution<> yearDist(0, static_cast<int>(years.size()) - 1);
-        std::uniform_int_distribution<> groupDist(0, static_cast<int>(groups.size()) - 1);
-        std::uniform_int_distribution<> numberDist(1, 99);
-        
-        return faculties[facultyDist(gen)] + years[yearDist(gen)] + "-" + 
-               std::to_string(numberDist(gen)) + groups[groupDist(gen)];
+    // Вычисляет средние по группам в заданном режиме
+    std::map<std::string, double> calculateAverages(university::Controller& controller, const std::string& mode, unsigned threads) {
+        return mode == "single" ? controller.calculateAverageGradesByGroup()
+                                : controller.calculateAverageGradesByGroupMultithreaded(threads);
+    }
+    
+    void printStats(const char* label, const university::bench::SampleStats& stats) {
+        std::cout << label << "медиана " << stats.median << " мс (min " << stats.min << ", p95 " << stats.p95
+                  << ", σ " << stats.stddev << ")";
+    }
+    
+    // Печатает загрузку потоков одного профилированного прогона
+    void printProfile(const university::ParallelProfile& profile) {
+        std::cout << std::setprecision(3) << "    потоков " << profile.workers.size() << ", занятость "
+                  << profile.utilization() * 100.0 << "%, дисбаланс " << profile.imbalance() << ":";
+        for (size_t worker = 0; worker < profile.workers.size(); ++worker) {
+            std::cout << " [" << worker << "] " << profile.workers[worker].busyMs << " мс/"
+                      << profile.workers[worker].items;
+        }
+        std::cout << std::endl;
     }
     
-    // Генератор случайных оценок
-    std::vector<int> generateRandomGrades(std::mt19937& gen, int count) {
-        std::vector<int> grades;
-        grades.reserve(static_cast<size_t>(count));
+    // Замеряет средние по группам для всех сочетаний зерна, объёма данных, режима и числа потоков
+    void runAveragesBenchmark(const university::bench::BenchOptions& options, const std::vector<unsigned>& threadCounts) {
+        university::bench::BenchReport report("averages", options.run);
+        std::ofstream scalingFile(options.outputDirectory / "scaling_benchmark_results.csv");
+        scalingFile << "Students,Seed,Threads,Workers,Median(ms),Speedup,Efficiency,Utilization,Imbalance,"
+                    << "MinBusy(ms),MaxBusy(ms),MinItems,MaxItems" << std::endl;
+        for (uint64_t seed : options.seeds) {
+            for (size_t size : options.sizes) {
+                std::cout << "\n=== Тестирование на " << size << " студентах (зерно " << seed << ") ===" << std::endl;
+                
+                university::Controller controller;
+                university::datagen::GeneratorOptions generatorOptions;
+                generatorOptions.seed = seed;
+                university::datagen::populateTable(controller.getStudentTable(), size, generatorOptions);
+                
+                // Проверка корректности
+                if (sameAverages(controller.calculateAverageGradesByGroup(), controller.calculateAverageGradesByGroupMultithreaded())) {
+                    std::cout << "[OK] Результаты совпадают!" << std::endl;
+                } else {
+                    std::cout << "[ОШИБКА] Результаты не совпадают!" << std::endl;
+                }
+                
+                // Однопоточный режим — один прогон, многопоточный — по прогону на каждое число потоков
+                std::optional<double> singleMedian;
+                std::optional<double> baselineMedian;
+                std::optional<double> multiMedian;
+                for (const auto& mode : options.modes) {
+                    auto counts = mode == "single" ? std::vector<unsigned>{1} : threadCounts;
+                    for (unsigned threads : counts) {
+                        size_t groups = 0;
+                        auto measurement = university::bench::measure(options.run, [&]() {
+                            groups += calculateAverages(controller, mode, threads).size();
+                        });
+                        double median = measurement.wallMs.median;
+                        
+                        std::cout << std::fixed << std::setprecision(3);
+                        std::cout << "  " << std::left << std::setw(7) << mode << std::right << " x" << std::setw(2) << threads;
+                        printStats(" реальное: ", measurement.wallMs);
+                        printStats("; процессорное: ", measurement.cpuMs);
+                        std::cout << std::endl;
+                        if (measurement.counters.any()) {
+                            std::cout << "    " << university::bench::formatPerfCounts(measurement.counters, size) << std::endl;
+                        }
+                        report.add({{"Students", std::to_string(size)}, {"Mode", mode}, {"Threads", std::to_string(threads)},
+                                    {"Seed", std::to_string(seed)}},
+                                   std::move(measurement));
+                        if (mode == "single") {
+                            singleMedian = median;
+                            continue;
+                        }
+                        
+                        // Эффективность считается относительно прогона того же алгоритма в одном потоке,
+                        // а если его нет в списке — относительно однопоточного режима
+                        if (threads == 1) {
+                            baselineMedian = median;
+                        }
+                        multiMedian = median;
+                        university::ParallelProfile profile;
+                        controller.calculateAverageGradesByGroupMultithreaded(threads, &profile);
+                        printProfile(profile);
+                        
+                        double speedup = baselineMedian.value_or(singleMedian.value_or(median)) / median;
+                        auto [minBusy, maxBusy] = std::minmax_element(profile.workers.begin(), profile.workers.end(),
+                            [](const auto& a, const auto& b) { return a.busyMs < b.busyMs; });
+                        auto [minItems, maxItems] = std::minmax_element(profile.workers.begin(), profile.workers.end(),
+                            [](const auto& a, const auto& b) { return a.items < b.items; });
+                        scalingFile << size << "," << seed << "," << threads << "," << profile.workers.size() << ","
+                                    << median << "," << speedup << "," << speedup / threads << ","
+                                    << profile.utilization() << "," << profile.imbalance() << ","
+                                    << minBusy->busyMs << "," << maxBusy->busyMs << ","
+                                    << minItems->items << "," << maxItems->items << std::endl;
+                    }
+                }
+                if (singleMedian && multiMedian) {
+                    std::cout << std::setprecision(2) << "  Ускорение по медианам (" << threadCounts.back() << " потоков): "
+                              << *singleMedian / *multiMedian << "x" << std::endl;
+                }
+            }
+        }
+        report.writeCsv(options.outputDirectory / "benchmark_results.csv");
+        report.writeJson(options.outputDirectory / "benchmark_results.json");
+    }
+    
+    // Результат замера задержки точечных поисков
+    struct LookupLatency {
+        size_t lookups = 0;
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double maxUs = 0.0;
+    };
+    
+    // Замеряет задержку поисков по ID, пока фоновый поток выполняет длинные сканирования
+    LookupLatency measureLookupLatency(int totalStudents, const std::function<void(int)>& lookup,
+                                       const std::function<void(const std::atomic<bool>&)>& background) {
+        std::atomic<bool> stop{false};
+        std::thread scanner;
+        if (background) {
+            scanner = std::thread([&]() { background(stop); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Даём сканированию начаться
+        }
         
-        std::uniform_int_distribution<> gradeDist(2, 5);
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<> idDist(1, totalStudents);
+        std::vector<double> latencies;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1500);
+        while (std::chrono::steady_clock::now() < deadline) {
+            int id = idDist(gen);
+            auto start = std::chrono::steady_clock::now();
+            lookup(id);
+            auto end = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
         
-        for (int i = 0; i < count; ++i) {
-            grades.push_back(gradeDist(gen));
+        stop = true;
+        if (scanner.joinable()) {
+            scanner.join();
         }
         
-        return grades;
+        LookupLatency result;
+        result.lookups = latencies.size();
+        if (!latencies.empty()) {
+            std::sort(latencies.begin(), latencies.end());
+            result.p50Us = latencies[latencies.size() / 2];
+            result.p99Us = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+            result.maxUs = latencies.back();
+        }
+        return result;
     }
     
-    // Генератор исследовательской работы для старшекурсников
-    university::ResearchWork generateRandomResearchWork(std::mt19937& gen) {
-        static const std::vector<std::string> topics = {
-            "Разработка системы управления базами данных",
-            "Анализ алгоритмов машинного обучения",
-            "Создание веб-приложения для электронной коммерции",
-            "Исследование методов криптографической защиты",
-            "Разработка мобильного приложения для здравоохранения",
-            "Анализ больших данных в социальных сетях",
-            "Создание системы искусственного интеллекта",
-            "Разработка облачной платформы",
-            "Исследование методов компьютерного зрения",
-            "Создание системы интернета вещей"
-        };
-        static const std::vector<std::string> places = {
-            "Google", "Microsoft", "Apple", "Amazon", "Meta", "Netflix", "Uber", "Airbnb",
-            "Spotify", "Twitter", "LinkedIn", "Salesforce", "Adobe", "Oracle", "IBM",
-            "Intel", "NVIDIA", "AMD", "Cisco", "VMware", "Dell", "HP", "Lenovo"
+    // Сравнивает задержку поисков во время длинных сканирований при эксклюзивной и разделяемой блокировке
+    void runLockContentionBenchmark(int totalStudents, const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Конкуренция поисков и сканирований (" << totalStudents << " студентов) ===" << std::endl;
+        
+        university::Controller controller;
+        university::datagen::populateTable(controller.getStudentTable(), static_cast<size_t>(totalStudents));
+        
+        long long checksum = 0;
+        auto sharedLookup = [&](int id) {
+            controller.visitStudent(id, [&checksum](const university::Student& student) {
+                checksum += student.getDepartmentNumber();
+            });
         };
         
-        std::uniform_int_distribution<> topicDist(0, static_cast<int>(topics.size()) - 1);
-        std::uniform_int_distribution<> placeDist(0, static_cast<int>(places.size()) - 1);
-        std::uniform_int_distribution<> gradeDist(3, 5);
+        // Эмуляция прежнего поведения: сканирование и поиск сериализуются одним мьютексом
+        std::mutex exclusiveMutex;
+        auto exclusiveLookup = [&](int id) {
+            std::lock_guard<std::mutex> lock(exclusiveMutex);
+            sharedLookup(id);
+        };
+        auto exclusiveScans = [&](const std::atomic<bool>& stop) {
+            while (!stop) {
+                std::lock_guard<std::mutex> lock(exclusiveMutex);
+                controller.calculateAverageGradesByGroupMultithreaded();
+            }
+        };
+        auto sharedScans = [&](const std::atomic<bool>& stop) {
+            while (!stop) {
+                controller.calculateAverageGradesByGroupMultithreaded();
+            }
+        };
         
-        return university::ResearchWork{
-            gradeDist(gen),
-            gradeDist(gen),
-            topics[topicDist(gen)],
-            places[placeDist(gen)]
+        struct Scenario {
+            std::string name;
+            LookupLatency latency;
         };
+        std::vector<Scenario> scenarios;
+        scenarios.push_back({"idle", measureLookupLatency(totalStudents, sharedLookup, {})});
+        scenarios.push_back({"exclusive_scans", measureLookupLatency(totalStudents, exclusiveLookup, exclusiveScans)});
+        scenarios.push_back({"shared_scans", measureLookupLatency(totalStudents, sharedLookup, sharedScans)});
+        std::cout << "  Контрольная сумма поисков: " << checksum << std::endl;
+        
+        std::ofstream csvFile(csvPath);
+        csvFile << "Scenario,Lookups,P50(us),P99(us),Max(us)" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        for (const auto& scenario : scenarios) {
+            std::cout << "  " << std::left << std::setw(16) << scenario.name << std::right
+                      << " поисков: " << std::setw(6) << scenario.latency.lookups
+                      << "  p50: " << std::setw(9) << scenario.latency.p50Us << " мкс"
+                      << "  p99: " << std::setw(9) << scenario.latency.p99Us << " мкс"
+                      << "  max: " << std::setw(9) << scenario.latency.maxUs << " мкс" << std::endl;
+            csvFile << scenario.name << "," << scenario.latency.lookups << "," << scenario.latency.p50Us << ","
+                    << scenario.latency.p99Us << "," << scenario.latency.maxUs << std::endl;
+        }
     }
     
-    // Генератор дипломного проекта для выпускников
-    university::DiplomaProject generateRandomDiplomaProject(std::mt19937& gen) {
-        static const std::vector<std::string> topics = {
-            "Исследование квантовых алгоритмов для оптимизации",
-            "Разработка новых методов глубокого обучения",
-            "Анализ сложности алгоритмов в теории графов",
-            "Создание систем распределённого искусственного интеллекта",
-            "Исследование методов защиты от кибератак",
-            "Разработка алгоритмов для обработки естественного языка",
-            "Анализ эффективности параллельных вычислений",
-            "Создание систем компьютерного зрения для робототехники",
-            "Исследование методов сжатия данных",
-            "Разработка алгоритмов для биоинформатики"
-        };
-        static const std::vector<std::string> places = {
-            "MIT", "Stanford", "Harvard", "Berkeley", "CMU", "Princeton", "Yale", "Columbia",
-            "UCLA", "UCSD", "Georgia Tech", "UIUC", "UMich", "UW", "UT Austin", "Cornell",
-            "Brown", "Dartmouth", "UPenn", "Northwestern", "Duke", "Vanderbilt", "Rice"
-        };
+    // Сравнивает генерацию реестра с сохранением и загрузкой двоичного снимка
+    void runSnapshotBenchmark(int totalStudents, const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Двоичный снимок реестра (" << totalStudents << " студентов) ===" << std::endl;
         
-        std::uniform_int_distribution<> topicDist(0, static_cast<int>(topics.size()) - 1);
-        std::uniform_int_distribution<> placeDist(0, static_cast<int>(places.size()) - 1);
-        std::uniform_int_distribution<> gradeDist(3, 5);
+        university::Controller controller;
+        auto generateStart = std::chrono::high_resolution_clock::now();
+        university::datagen::populateTable(controller.getStudentTable(), static_cast<size_t>(totalStudents));
+        auto generateEnd = std::chrono::high_resolution_clock::now();
+        
+        auto snapshotPath = std::filesystem::temp_directory_path() / "registry_benchmark.bin";
+        auto saveStart = std::chrono::high_resolution_clock::now();
+        controller.save(snapshotPath);
+        auto saveEnd = std::chrono::high_resolution_clock::now();
+        
+        university::Controller loaded;
+        auto loadStart = std::chrono::high_resolution_clock::now();
+        loaded.load(snapshotPath);
+        auto loadEnd = std::chrono::high_resolution_clock::now();
+        
+        auto fileSize = std::filesystem::file_size(snapshotPath);
+        std::filesystem::remove(snapshotPath);
+        
+        // Отображаемый файл: открытие не зависит от размера, агрегация читает записи напрямую
+        auto mappedPath = std::filesystem::temp_directory_path() / "registry_benchmark.map";
+        auto saveMappedStart = std::chrono::high_resolution_clock::now();
+        controller.saveMapped(mappedPath);
+        auto saveMappedEnd = std::chrono::high_resolution_clock::now();
+        
+        university::Controller mapped;
+        auto openStart = std::chrono::high_resolution_clock::now();
+        mapped.openReadOnly(mappedPath);
+        auto openEnd = std::chrono::high_resolution_clock::now();
+        auto mappedAveragesStart = std::chrono::high_resolution_clock::now();
+        auto mappedAverages = mapped.calculateAverageGradesByGroupMultithreaded();
+        auto mappedAveragesEnd = std::chrono::high_resolution_clock::now();
+        auto tableAveragesStart = std::chrono::high_resolution_clock::now();
+        auto tableAverages = loaded.calculateAverageGradesByGroupMultithreaded();
+        auto tableAveragesEnd = std::chrono::high_resolution_clock::now();
+        if (mappedAverages.size() != tableAverages.size()) {
+            std::cout << "  Предупреждение: результаты агрегации по файлу и по таблице различаются" << std::endl;
+        }
+        mapped.clearStudentTable();
+        std::filesystem::remove(mappedPath);
         
-        return university::DiplomaProject{
-            gradeDist(gen),
-            gradeDist(gen),
-            gradeDist(gen),
-            topics[topicDist(gen)],
-            places[placeDist(gen)]
+        auto toMs = [](auto duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
         };
+        double generateMs = toMs(generateEnd - generateStart);
+        double saveMs = toMs(saveEnd - saveStart);
+        double loadMs = toMs(loadEnd - loadStart);
+        double saveMappedMs = toMs(saveMappedEnd - saveMappedStart);
+        double openMappedMs = toMs(openEnd - openStart);
+        double mappedAveragesMs = toMs(mappedAveragesEnd - mappedAveragesStart);
+        double tableAveragesMs = toMs(tableAveragesEnd - tableAveragesStart);
+        
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  Генерация: " << generateMs << " мс" << std::endl;
+        std::cout << "  Сохранение: " << saveMs << " мс" << std::endl;
+        std::cout << "  Загрузка: " << loadMs << " мс (" << loaded.takeSnapshot().size() << " студентов)" << std::endl;
+        std::cout << "  Размер файла: " << fileSize / 1024 << " КиБ ("
+                  << static_cast<double>(fileSize) / totalStudents << " байт на студента)" << std::endl;
+        std::cout << "  Сохранение отображаемого файла: " << saveMappedMs << " мс" << std::endl;
+        std::cout << "  Открытие отображаемого файла: " << openMappedMs << " мс" << std::endl;
+        std::cout << "  Средние по группам: " << mappedAveragesMs << " мс из файла, "
+                  << tableAveragesMs << " мс из таблицы" << std::endl;
+        
+        std::ofstream csvFile(csvPath);
+        csvFile << "Students,Generate(ms),Save(ms),Load(ms),FileBytes,SaveMapped(ms),OpenMapped(ms),"
+                << "MappedAverages(ms),TableAverages(ms)" << std::endl;
+        csvFile << totalStudents << "," << generateMs << "," << saveMs << "," << loadMs << "," << fileSize << ","
+                << saveMappedMs << "," << openMappedMs << "," << mappedAveragesMs << "," << tableAveragesMs << std::endl;
     }
     
-    // Создание случайного студента
-    std::unique_ptr<university::Student> createRandomStudent(std::mt19937& gen, int id) {
-        std::uniform_int_distribution<> categoryDist(0, 2);
-        university::StudentCategory category = static_cast<university::StudentCategory>(categoryDist(gen));
+    // Замеряет параллельную генерацию реестра и проверяет, что результат не зависит от числа потоков
+    void runGenerationBenchmark(int totalStudents, const std::vector<unsigned>& threadCounts, uint64_t seed,
+                                const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Генерация реестра (" << totalStudents << " студентов) ===" << std::endl;
         
-        std::string name = generateRandomName(gen);
-        std::string group = generateRandomGroup(gen);
-        int department = 100 + (id % 20);
+        std::ofstream csvFile(csvPath);
+        csvFile << "Threads,Students,Generate(ms),StudentsPerSec,SameAsFirstRun" << std::endl;
+        std::optional<std::map<std::string, double>> reference;
+        for (unsigned threads : threadCounts) {
+            university::Controller controller;
+            university::datagen::GeneratorOptions options;
+            options.seed = seed;
+            options.threads = threads;
+            auto start = std::chrono::high_resolution_clock::now();
+            university::datagen::populateTable(controller.getStudentTable(), static_cast<size_t>(totalStudents), options);
+            auto end = std::chrono::high_resolution_clock::now();
+            
+            auto averages = controller.calculateAverageGradesByGroup();
+            if (!reference) {
+                reference = averages;
+            }
+            bool same = averages == *reference;
+            double timeMs = std::chrono::duration<double, std::milli>(end - start).count();
+            double perSec = totalStudents / (timeMs / 1000.0);
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "  Потоков " << threads << ": " << timeMs << " мс, " << perSec << " студентов/с"
+                      << (same ? "" : " [ОШИБКА] результат отличается от первого прогона") << std::endl;
+            csvFile << threads << "," << totalStudents << "," << timeMs << "," << perSec << "," << (same ? 1 : 0) << std::endl;
+        }
+    }
+    
+    void runWalBenchmark(int totalOperations, const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Журнал упреждающей записи (" << totalOperations << " добавлений) ===" << std::endl;
+        
+        std::ofstream csvFile(csvPath);
+        csvFile << "Durability,Writers,Operations,Time(ms),OpsPerSec,Syncs,OpsPerSync" << std::endl;
         
-        switch (category) {
-            case university::StudentCategory::JUNIOR: {
-                auto grades = generateRandomGrades(gen, 5);
-                return std::make_unique<university::JuniorStudent>(name, group, department, grades);
+        const std::pair<university::storage::Durability, const char*> modes[] = {
+            {university::storage::Durability::EVERY_OPERATION, "every_operation"},
+            {university::storage::Durability::INTERVAL, "interval_10ms"},
+            {university::storage::Durability::NONE, "none"},
+        };
+        for (const auto& [durability, name] : modes) {
+            for (int writers : {1, 4, 16}) {
+                auto directory = std::filesystem::temp_directory_path() / "registry_wal_benchmark";
+                std::filesystem::remove_all(directory);
+                university::Controller controller;
+                controller.openStorage(directory, {durability});
+                
+                // Потоки-писатели добавляют студентов одновременно: в режиме EVERY_OPERATION
+                // их записи объединяются в общие вызовы fdatasync
+                int perWriter = totalOperations / writers;
+                auto start = std::chrono::high_resolution_clock::now();
+                std::vector<std::thread> threads;
+                for (int w = 0; w < writers; ++w) {
+                    threads.emplace_back([&controller, perWriter, w]() {
+                        university::datagen::StudentGenerator generator(university::datagen::blockSeed(42, static_cast<size_t>(w)));
+                        for (int i = 0; i < perWriter; ++i) {
+                            controller.insertStudent(generator.next(i));
+                        }
+                    });
+                }
+                for (auto& thread : threads) thread.join();
+                auto end = std::chrono::high_resolution_clock::now();
+                
+                auto stats = controller.getWalStats();
+                int operations = perWriter * writers;
+                double timeMs = std::chrono::duration<double, std::milli>(end - start).count();
+                double opsPerSec = operations / (timeMs / 1000.0);
+                double opsPerSync = stats.syncs != 0 ? static_cast<double>(operations) / stats.syncs : 0.0;
+                
+                std::cout << std::fixed << std::setprecision(1);
+                std::cout << "  " << name << ", писателей " << writers << ": " << opsPerSec << " оп/с, "
+                          << stats.syncs << " fdatasync (" << opsPerSync << " оп на fdatasync)" << std::endl;
+                csvFile << name << "," << writers << "," << operations << "," << timeMs << ","
+                        << opsPerSec << "," << stats.syncs << "," << opsPerSync << std::endl;
+                
+                controller.clearStudentTable();
+                std::filesystem::remove_all(directory);
             }
-            case university::StudentCategory::SENIOR: {
-                auto grades = generateRandomGrades(gen, 4);
-                auto researchWork = generateRandomResearchWork(gen);
-                return std::make_unique<university::SeniorStudent>(name, group, department, grades, researchWork);
+        }
+    }
+    
+    // Смешанный пакет синхронизации: 40% добавлений, 30% переводов в другую группу, 20% удалений, 10% замен записи
+    std::vector<university::MutationCommand> makeSyncCommands(int totalStudents, int totalCommands) {
+        university::datagen::StudentGenerator generator(42);
+        std::vector<university::MutationCommand> commands;
+        commands.reserve(static_cast<size_t>(totalCommands));
+        int removeCursor = totalStudents;
+        for (int k = 0; k < totalCommands; ++k) {
+            int existing = 1 + k % (totalStudents / 2);
+            switch (k % 10) {
+            case 0: case 1: case 2: case 3:
+                commands.push_back(university::MutationCommand::add(generator.next(0)));
+                break;
+            case 4: case 5: case 6:
+                commands.push_back(university::MutationCommand::setGroup(existing, "SYNC-" + std::to_string(k % 50)));
+                break;
+            case 7: case 8:
+                commands.push_back(university::MutationCommand::remove(removeCursor--));
+                break;
+            default:
+                commands.push_back(university::MutationCommand::replace(existing, generator.next(existing)));
+                break;
             }
-            case university::StudentCategory::GRADUATE: {
-                auto diplomaProject = generateRandomDiplomaProject(gen);
-                return std::make_unique<university::GraduateStudent>(name, group, department, diplomaProject);
+        }
+        return commands;
+    }
+    
+    // Применяет команды пакета отдельными вызовами Controller
+    void applyOneByOne(university::Controller& controller, const std::vector<university::MutationCommand>& commands) {
+        for (const auto& command : commands) {
+            switch (command.type) {
+            case university::MutationType::ADD:
+                controller.insertStudent(command.student->clone());
+                break;
+            case university::MutationType::REMOVE:
+                controller.eraseStudent(command.id);
+                break;
+            case university::MutationType::SET_GROUP:
+                controller.setStudentGroup(command.id, command.groupIndex);
+                break;
+            case university::MutationType::SET_RESEARCH_WORK:
+                controller.setStudentResearchWork(command.id, command.researchWork);
+                break;
+            case university::MutationType::REPLACE:
+                controller.replaceStudent(command.id, command.student->clone());
+                break;
             }
-            default:
-                return nullptr;
         }
     }
     
-    // Функция для выполнения бенчмарка на определённом объёме данных
-    void runBenchmarkForSize(int totalStudents, std::ofstream& csvFile) {
-        std::cout << "\n=== Тестирование на " << totalStudents << " студентах ===" << std::endl;
+    void runBatchBenchmark(int totalStudents, int totalCommands, const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Пакетные изменения (" << totalCommands << " команд над " << totalStudents << " студентами) ===" << std::endl;
         
-        university::Controller controller;
-        std::mt19937 gen(42); // Фиксированное зерно для воспроизводимости
+        std::ofstream csvFile(csvPath);
+        csvFile << "Storage,Method,Commands,Time(ms),CommandsPerSec" << std::endl;
         
-        // Генерация студентов
-        std::cout << "Генерация " << totalStudents << " студентов..." << std::endl;
-        for (int i = 1; i <= totalStudents; ++i) {
-            auto student = createRandomStudent(gen, i);
-            if (student) {
-                controller.getStudentTable().insert(i, std::move(student));
+        auto commands = makeSyncCommands(totalStudents, totalCommands);
+        for (bool durable : {false, true}) {
+            const char* storage = durable ? "wal_every_operation" : "memory";
+            for (bool batched : {false, true}) {
+                auto directory = std::filesystem::temp_directory_path() / "registry_batch_benchmark";
+                std::filesystem::remove_all(directory);
+                university::Controller controller;
+                if (durable) {
+                    controller.openStorage(directory, {university::storage::Durability::EVERY_OPERATION});
+                }
+                controller.insertStudents(university::datagen::generateStudents(static_cast<size_t>(totalStudents)));
+                
+                auto start = std::chrono::high_resolution_clock::now();
+                bool applied = true;
+                if (batched) {
+                    applied = controller.applyBatch(commands).applied;
+                } else {
+                    applyOneByOne(controller, commands);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                
+                double timeMs = std::chrono::duration<double, std::milli>(end - start).count();
+                double perSec = totalCommands / (timeMs / 1000.0);
+                const char* method = batched ? "apply_batch" : "one_by_one";
+                std::cout << std::fixed << std::setprecision(1);
+                std::cout << "  " << storage << ", " << method << ": " << timeMs << " мс, " << perSec << " команд/с"
+                          << (applied ? "" : " [ОШИБКА] пакет отклонён") << std::endl;
+                csvFile << storage << "," << method << "," << totalCommands << "," << timeMs << "," << perSec << std::endl;
+                
+                controller.clearStudentTable();
+                std::filesystem::remove_all(directory);
             }
         }
+    }
+    
+    void runCsvImportBenchmark(int totalStudents, const std::vector<unsigned>& threadCounts, const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Импорт CSV (" << totalStudents << " строк) ===" << std::endl;
         
-        // Тест однопоточного режима
-        std::cout << "Запуск однопоточного режима..." << std::endl;
-        auto startSingle = std::chrono::high_resolution_clock::now();
-        
-        auto resultSingle = controller.calculateAverageGradesByGroup();
+        // Файл импорта создаётся выгрузкой сгенерированного реестра
+        auto importPath = std::filesystem::temp_directory_path() / "registry_import_benchmark.csv";
+        {
+            university::Controller source;
+            university::datagen::populateTable(source.getStudentTable(), static_cast<size_t>(totalStudents));
+            source.exportStudents(importPath);
+        }
+        auto fileSize = std::filesystem::file_size(importPath);
         
-        auto endSingle = std::chrono::high_resolution_clock::now();
-        auto durationSingle = std::chrono::duration_cast<std::chrono::microseconds>(endSingle - startSingle);
+        std::ofstream csvFile(csvPath);
+        csvFile << "Threads,Rows,FileBytes,Time(ms),RowsPerSec,MBPerSec" << std::endl;
+        for (unsigned threads : threadCounts) {
+            university::Controller controller;
+            university::storage::CsvImportOptions options;
+            options.threads = threads;
+            auto report = controller.importCsv(importPath, options);
+            
+            double timeMs = report.seconds * 1000.0;
+            double megabytesPerSec = static_cast<double>(fileSize) / (1024.0 * 1024.0) / report.seconds;
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "  Потоков " << threads << ": " << timeMs << " мс, " << report.rowsPerSecond() << " строк/с, "
+                      << megabytesPerSec << " МиБ/с, некорректных строк: " << report.malformedRows << std::endl;
+            csvFile << threads << "," << report.rowsRead << "," << fileSize << "," << timeMs << ","
+                    << report.rowsPerSecond() << "," << megabytesPerSec << std::endl;
+        }
+        std::filesystem::remove(importPath);
+    }
+    
+    void runExportBenchmark(int totalStudents, const std::vector<unsigned>& threadCounts, const std::filesystem::path& csvPath) {
+        std::cout << "\n=== Выгрузка реестра (" << totalStudents << " студентов) ===" << std::endl;
         
-        // Тест многопоточного режима
-        std::cout << "Запуск многопоточного режима..." << std::endl;
-        auto startMulti = std::chrono::high_resolution_clock::now();
+        university::Controller controller;
+        university::datagen::populateTable(controller.getStudentTable(), static_cast<size_t>(totalStudents));
         
-        auto resultMulti = controller.calculateAverageGradesByGroupMultithreaded();
+        std::ofstream csvFile(csvPath);
+        csvFile << "Format,Threads,Rows,Bytes,Time(ms),MBPerSec" << std::endl;
+        auto exportPath = std::filesystem::temp_directory_path() / "registry_export_benchmark.out";
+        const std::pair<university::storage::ExportFormat, const char*> formats[] = {
+            {university::storage::ExportFormat::CSV, "csv"},
+            {university::storage::ExportFormat::JSON, "json"},
+        };
+        for (const auto& [format, name] : formats) {
+            for (unsigned threads : threadCounts) {
+                university::storage::ExportOptions options;
+                options.format = format;
+                options.threads = threads;
+                auto report = controller.exportStudents(exportPath, options);
+                
+                double megabytesPerSec = report.bytesPerSecond() / (1024.0 * 1024.0);
+                std::cout << std::fixed << std::setprecision(1);
+                std::cout << "  " << name << ", потоков " << threads << ": " << report.seconds * 1000.0 << " мс, "
+                          << report.bytes / (1024 * 1024) << " МиБ, " << megabytesPerSec << " МиБ/с" << std::endl;
+                csvFile << name << "," << threads << "," << report.rows << "," << report.bytes << ","
+                        << report.seconds * 1000.0 << "," << megabytesPerSec << std::endl;
+            }
+        }
+        std::filesystem::remove(exportPath);
+    }
+    
+    // Замеряет выделения памяти одной операции, повторённой count раз
+    void measureOperationMemory(std::ofstream& csvFile, const char* name, size_t count, const std::function<void(size_t)>& operation) {
+        university::bench::AllocationScope scope;
+        for (size_t i = 0; i < count; ++i) {
+            operation(i);
+        }
+        auto delta = scope.delta();
+        double perOp = static_cast<double>(count);
+        std::cout << std::fixed << std::setprecision(2) << "  " << std::left << std::setw(16) << name << std::right
+                  << " выделений/оп: " << std::setw(8) << delta.allocations / perOp
+                  << "  байт/оп: " << std::setw(10) << delta.bytesAllocated / perOp
+                  << "  прирост/оп: " << std::setw(10) << delta.liveBytes() / perOp << std::endl;
+        csvFile << name << "," << count << "," << delta.allocations / perOp << "," << delta.bytesAllocated / perOp << ","
+                << delta.liveBytes() / perOp << std::endl;
+    }
+    
+    // Память реестра по объёмам: байт на студента по составляющим, выделения и резидентная память,
+    // а также выделения на одну операцию
+    void runMemoryBenchmark(const std::vector<size_t>& sizes, uint64_t seed, const std::filesystem::path& outputDirectory) {
+        std::cout << "\n=== Память реестра ===" << std::endl;
         
-        auto endMulti = std::chrono::high_resolution_clock::now();
-        auto durationMulti = std::chrono::duration_cast<std::chrono::microseconds>(endMulti - startMulti);
+        std::ofstream memoryFile(outputDirectory / "memory_benchmark_results.csv");
+        memoryFile << "Students,LiveBytes,BytesPerStudent,AllocationsPerStudent,ObjectPerStudent,StringsPerStudent,"
+                   << "GradesPerStudent,SlotsPerStudent,OtherPerStudent,RssDeltaPerStudent,PeakRss" << std::endl;
+        std::ofstream footprintFile(outputDirectory / "memory_footprint_results.csv");
+        footprintFile << "Students,Category,Count,Object,Strings,Grades,Total,HeapAllocations" << std::endl;
+        const char* categoryNames[] = {"junior", "senior", "graduate"};
         
-        // Проверка корректности
-        bool resultsMatch = (resultSingle.size() == resultMulti.size());
-        if (resultsMatch) {
-            for (const auto& pair : resultSingle) {
-                if (resultMulti.find(pair.first) == resultMulti.end() || 
-                    std::abs(resultMulti.at(pair.first) - pair.second) > 0.001) {
-                    resultsMatch = false;
-                    break;
+        for (size_t size : sizes) {
+            university::bench::resetPeakRss();
+            auto rssBefore = university::bench::processMemory();
+            university::bench::AllocationScope scope;
+            auto controller = std::make_unique<university::Controller>();
+            university::datagen::GeneratorOptions generatorOptions;
+            generatorOptions.seed = seed;
+            university::datagen::populateTable(controller->getStudentTable(), size, generatorOptions);
+            auto allocations = scope.delta();
+            auto rssAfter = university::bench::processMemory();
+            
+            // Составляющие записей по категориям
+            const auto& table = controller->getStudentTable();
+            university::StudentFootprint categories[3];
+            size_t counts[3] = {};
+            table.forEachInRange(0, table.bucketCount(), [&](int, const std::shared_ptr<const university::Student>& student) {
+                auto category = static_cast<size_t>(student->getCategory());
+                categories[category].merge(university::footprintOf(*student));
+                ++counts[category];
+            });
+            university::StudentFootprint all;
+            for (const auto& footprint : categories) {
+                all.merge(footprint);
+            }
+            
+            double students = static_cast<double>(std::max<size_t>(size, 1));
+            double bytesPerStudent = static_cast<double>(allocations.liveBytes()) / students;
+            double slotsPerStudent = static_cast<double>(table.slotBytes()) / students;
+            double otherPerStudent = bytesPerStudent - static_cast<double>(all.total()) / students - slotsPerStudent;
+            double rssPerStudent = (static_cast<double>(rssAfter.rssBytes) - static_cast<double>(rssBefore.rssBytes)) / students;
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "  " << std::setw(8) << size << " студентов: " << bytesPerStudent << " Б/студента (объект "
+                      << all.object / students << ", строки " << all.strings / students << ", оценки "
+                      << all.grades / students << ", слоты " << slotsPerStudent << ", прочее " << otherPerStudent
+                      << "), выделений/студента " << allocations.allocations / students << ", RSS +"
+                      << rssPerStudent << " Б/студента, пик " << rssAfter.peakRssBytes / (1024 * 1024) << " МиБ" << std::endl;
+            memoryFile << size << "," << allocations.liveBytes() << "," << bytesPerStudent << ","
+                       << allocations.allocations / students << "," << all.object / students << "," << all.strings / students << ","
+                       << all.grades / students << "," << slotsPerStudent << "," << otherPerStudent << ","
+                       << rssPerStudent << "," << rssAfter.peakRssBytes << std::endl;
+            for (size_t category = 0; category < 3; ++category) {
+                if (counts[category] == 0) {
+                    continue;
                 }
+                double count = static_cast<double>(counts[category]);
+                const auto& footprint = categories[category];
+                footprintFile << size << "," << categoryNames[category] << "," << counts[category] << ","
+                              << footprint.object / count << "," << footprint.strings / count << ","
+                              << footprint.grades / count << "," << footprint.total() / count << ","
+                              << footprint.heapAllocations / count << std::endl;
             }
         }
         
-        if (resultsMatch) {
-            std::cout << "[OK] Результаты совпадают!" << std::endl;
-        } else {
-            std::cout << "[ОШИБКА] Результаты не совпадают!" << std::endl;
-        }
-        
-        double timeSingle = durationSingle.count() / 1000.0; // мс
-        double timeMulti = durationMulti.count() / 1000.0;   // мс
-        double speedup = timeSingle / timeMulti;
-        
-        std::cout << std::fixed << std::setprecision(2);
-        std::cout << "  Однопоточный режим: " << timeSingle << " мс" << std::endl;
-        std::cout << "  Многопоточный режим: " << timeMulti << " мс" << std::endl;
-        std::cout << "  Ускорение: " << speedup << "x" << std::endl;
+        // Выделения на операцию; новые студенты создаются до замера
+        std::cout << "  --- Выделения памяти на операцию (10 000 студентов) ---" << std::endl;
+        const size_t operations = 10000;
+        university::Controller controller;
+        university::datagen::GeneratorOptions generatorOptions;
+        generatorOptions.seed = seed;
+        controller.insertStudents(university::datagen::generateStudents(operations, 1, generatorOptions));
+        auto newStudents = university::datagen::generateStudents(operations, operations + 1, generatorOptions);
+        size_t checksum = 0;
         
-        // Запись в CSV
-        csvFile << totalStudents << "," << timeSingle << "," << timeMulti << "," << speedup << std::endl;
+        std::ofstream operationsFile(outputDirectory / "memory_operations_results.csv");
+        operationsFile << "Operation,Operations,AllocationsPerOp,BytesPerOp,LiveBytesPerOp" << std::endl;
+        int idCount = static_cast<int>(operations);
+        measureOperationMemory(operationsFile, "lookup", operations, [&](size_t i) {
+            checksum += controller.getStudent(static_cast<int>(i) % idCount + 1) != nullptr;
+        });
+        measureOperationMemory(operationsFile, "visit", operations, [&](size_t i) {
+            controller.visitStudent(static_cast<int>(i) % idCount + 1, [&](const university::Student& student) {
+                checksum += static_cast<size_t>(student.getDepartmentNumber());
+            });
+        });
+        measureOperationMemory(operationsFile, "insert", operations, [&](size_t i) {
+            checksum += static_cast<size_t>(controller.insertStudent(std::move(newStudents[i])));
+        });
+        measureOperationMemory(operationsFile, "update_group", operations, [&](size_t i) {
+            checksum += controller.setStudentGroup(static_cast<int>(i) % idCount + 1, "IU7-11B");
+        });
+        measureOperationMemory(operationsFile, "aggregate", 20, [&](size_t) {
+            checksum += controller.calculateAverageGradesByGroup().size();
+        });
+        measureOperationMemory(operationsFile, "aggregate_multi", 20, [&](size_t) {
+            checksum += controller.calculateAverageGradesByGroupMultithreaded().size();
+        });
+        std::cout << "  Контрольная сумма: " << checksum << std::endl;
     }
 }
 
-int main() {
-    std::cout << "=== Бенчмарк производительности студенческого реестра ===" << std::endl;
-    std::cout << "Тестирование различных объёмов данных..." << std::endl;
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> suites = {"averages", "lock", "generation", "snapshot", "wal", "csv_import", "export", "memory", "batch"};
+    const std::vector<std::string> modes = {"single", "multi"};
+    university::bench::BenchOptions defaults;
+    defaults.sizes = {100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000};
+    defaults.modes = modes;
     
-    // Создание папки docs, если её нет
-    std::filesystem::path docsPath = "../docs";
-    if (!std::filesystem::exists(docsPath)) {
-        std::filesystem::create_directories(docsPath);
-        std::cout << "Создана папка docs" << std::endl;
+    university::bench::BenchOptions options;
+    try {
+        options = university::bench::parseBenchOptions(argc, argv, defaults, suites, modes);
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << "\n" << university::bench::benchUsage(argv[0], suites, modes);
+        return 1;
+    }
+    if (options.help) {
+        std::cout << university::bench::benchUsage(argv[0], suites, modes);
+        return 0;
     }
     
-    // Создание CSV файла в папке docs
-    std::filesystem::path csvPath = docsPath / "benchmark_results.csv";
-    std::ofstream csvFile(csvPath);
-    csvFile << "Students,SingleThread(ms),MultiThread(ms),Speedup" << std::endl;
-    
-    // Различные объёмы данных для тестирования
-    std::vector<int> testSizes = {
-        100,      // Маленький объём
-        500,      // Небольшой объём
-        1000,     // Средний объём
-        5000,     // Большой объём
-        10000,    // Очень большой объём
-        50000,    // Огромный объём
-        100000,   // Массивный объём
-        500000,   // Гигантский объём
-        1000000   // Мега объём
-    };
+    std::cout << "=== Бенчмарк производительности студенческого реестра ===" << std::endl;
+    std::cout << "Прогревочных прогонов: " << options.run.warmup << ", учитываемых: " << options.run.repetitions << std::endl;
+    std::optional<university::bench::PerfCounters> counters;
+    if (options.counters) {
+        counters.emplace();
+        if (counters->available()) {
+            options.run.counters = &*counters;
+        } else {
+            std::cout << "Аппаратные счётчики недоступны (" << counters->unavailableReason()
+                      << "), замеряется только время" << std::endl;
+        }
+    }
     
-    for (int size : testSizes) {
-        runBenchmarkForSize(size, csvFile);
+    // Создание каталога результатов, если его нет
+    const auto& docsPath = options.outputDirectory;
+    if (!std::filesystem::exists(docsPath)) {
+        std::filesystem::create_directories(docsPath);
+        std::cout << "Создан каталог " << docsPath << std::endl;
     }
     
-    csvFile.close();
+    auto threadCounts = options.threadCounts();
+    if (options.selected("averages")) runAveragesBenchmark(options, threadCounts);
+    if (options.selected("lock")) runLockContentionBenchmark(200000, docsPath / "lock_benchmark_results.csv");
+    if (options.selected("generation")) runGenerationBenchmark(1000000, threadCounts, options.seeds.front(), docsPath / "generation_benchmark_results.csv");
+    if (options.selected("snapshot")) runSnapshotBenchmark(1000000, docsPath / "snapshot_benchmark_results.csv");
+    if (options.selected("wal")) runWalBenchmark(4000, docsPath / "wal_benchmark_results.csv");
+    if (options.selected("csv_import")) runCsvImportBenchmark(1000000, threadCounts, docsPath / "csv_import_benchmark_results.csv");
+    if (options.selected("export")) runExportBenchmark(1000000, threadCounts, docsPath / "export_benchmark_results.csv");
+    if (options.selected("memory")) runMemoryBenchmark(options.sizes, options.seeds.front(), docsPath);
+    if (options.selected("batch")) runBatchBenchmark(200000, 20000, docsPath / "batch_benchmark_results.csv");
     
     std::cout << "\n=== Бенчмарк завершён ===" << std::endl;
-    std::cout << "Результаты сохранены в файл: " << csvPath << std::endl;
+    std::cout << "Результаты сохранены в каталог: " << docsPath << std::endl;
     std::cout << "Для построения графика запустите: python3 ../scripts/plot_benchmark.py" << std::endl;
     
     return 0;
-} 
\ No newline at end of file
+}
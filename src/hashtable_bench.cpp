@@ -0,0 +1,454 @@
+#include "HashTable.h"
+#include "StudentTable.h"
+#include "JuniorStudent.h"
+#include "BenchHarness.h"
+#include "BenchOptions.h"
+#include "BenchReport.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+    using Record = std::shared_ptr<const university::Student>;
+
+    // Открытая адресация без надгробий: ёмкость — степень двойки, хеш Фибоначчи,
+    // удаление со сдвигом назад. Ориентир для сравнения с HashTable
+    class LinearProbingBaseline {
+    public:
+        explicit LinearProbingBaseline(size_t capacity = 16) {
+            rehash(capacity);
+        }
+
+        bool insert(int key, Record value) {
+            if (static_cast<double>(size_ + 1) > static_cast<double>(slots_.size()) * MAX_LOAD_FACTOR) {
+                rehash(slots_.size() * 2);
+            }
+            size_t index = indexOf(key);
+            while (slots_[index].used) {
+                if (slots_[index].key == key) {
+                    return false;
+                }
+                index = (index + 1) & mask_;
+            }
+            slots_[index] = {key, true, std::move(value)};
+            ++size_;
+            return true;
+        }
+
+        const Record* find(int key) const {
+            for (size_t index = indexOf(key); slots_[index].used; index = (index + 1) & mask_) {
+                if (slots_[index].key == key) {
+                    return &slots_[index].value;
+                }
+            }
+            return nullptr;
+        }
+
+        bool remove(int key) {
+            size_t index = indexOf(key);
+            while (true) {
+                if (!slots_[index].used) {
+                    return false;
+                }
+                if (slots_[index].key == key) {
+                    break;
+                }
+                index = (index + 1) & mask_;
+            }
+            // Сдвигаем назад элементы цепочки, которые могут занять освободившийся слот
+            size_t hole = index;
+            for (size_t next = (hole + 1) & mask_; slots_[next].used; next = (next + 1) & mask_) {
+                size_t home = indexOf(slots_[next].key);
+                if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+                    slots_[hole] = std::move(slots_[next]);
+                    hole = next;
+                }
+            }
+            slots_[hole] = Slot{};
+            --size_;
+            return true;
+        }
+
+        void reserve(size_t count) {
+            auto required = static_cast<size_t>(static_cast<double>(count) / MAX_LOAD_FACTOR) + 1;
+            if (required > slots_.size()) {
+                rehash(required);
+            }
+        }
+
+        size_t size() const { return size_; }
+        size_t bucketCount() const { return slots_.size(); }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            for (const auto& slot : slots_) {
+                if (slot.used) {
+                    fn(slot.key, slot.value);
+                }
+            }
+        }
+
+    private:
+        static constexpr double MAX_LOAD_FACTOR = 0.7;
+
+        struct Slot {
+            int key = 0;
+            bool used = false;
+            Record value;
+        };
+
+        size_t indexOf(int key) const {
+            return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ULL) >> shift_);
+        }
+
+        void rehash(size_t capacity) {
+            size_t bits = 4;
+            while ((size_t{1} << bits) < capacity) {
+                ++bits;
+            }
+            std::vector<Slot> old(size_t{1} << bits);
+            old.swap(slots_);
+            mask_ = slots_.size() - 1;
+            shift_ = 64 - static_cast<int>(bits);
+            size_ = 0;
+            for (auto& slot : old) {
+                if (slot.used) {
+                    insert(slot.key, std::move(slot.value));
+                }
+            }
+        }
+
+        std::vector<Slot> slots_;
+        size_t mask_ = 0;
+        int shift_ = 60;
+        size_t size_ = 0;
+    };
+
+    // Единый интерфейс сравниваемых контейнеров
+    struct HashTableAdapter {
+        using Map = university::StudentTable;
+        static constexpr const char* NAME = "hashtable";
+        static constexpr double MAX_LOAD_FACTOR = 0.7;
+        static Map withSlots(size_t slots) { return Map(slots); }
+        static void reserve(Map& map, size_t count) { map.reserve(count); }
+        static bool insert(Map& map, int key, const Record& value) { return map.insert(key, value); }
+        static bool contains(const Map& map, int key) { return map.find(key).has_value(); }
+        static bool remove(Map& map, int key) { return map.remove(key); }
+        static size_t buckets(const Map& map) { return map.bucketCount(); }
+        template <typename Fn>
+        static void forEach(const Map& map, Fn&& fn) {
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                auto pair = *it;
+                fn(pair.first, pair.second);
+            }
+        }
+    };
+
+    struct UnorderedMapAdapter {
+        using Map = std::unordered_map<int, Record>;
+        static constexpr const char* NAME = "unordered_map";
+        static constexpr double MAX_LOAD_FACTOR = 1.0;
+        static Map withSlots(size_t slots) { return Map(slots); }
+        static void reserve(Map& map, size_t count) { map.reserve(count); }
+        static bool insert(Map& map, int key, const Record& value) { return map.emplace(key, value).second; }
+        static bool contains(const Map& map, int key) { return map.find(key) != map.end(); }
+        static bool remove(Map& map, int key) { return map.erase(key) != 0; }
+        static size_t buckets(const Map& map) { return map.bucket_count(); }
+        template <typename Fn>
+        static void forEach(const Map& map, Fn&& fn) {
+            for (const auto& [key, value] : map) {
+                fn(key, value);
+            }
+        }
+    };
+
+    struct OpenAddressingAdapter {
+        using Map = LinearProbingBaseline;
+        static constexpr const char* NAME = "open_addressing";
+        static constexpr double MAX_LOAD_FACTOR = 0.7;
+        static Map withSlots(size_t slots) { return Map(slots); }
+        static void reserve(Map& map, size_t count) { map.reserve(count); }
+        static bool insert(Map& map, int key, const Record& value) { return map.insert(key, value); }
+        static bool contains(const Map& map, int key) { return map.find(key) != nullptr; }
+        static bool remove(Map& map, int key) { return map.remove(key); }
+        static size_t buckets(const Map& map) { return map.bucketCount(); }
+        template <typename Fn>
+        static void forEach(const Map& map, Fn&& fn) {
+            map.forEach(fn);
+        }
+    };
+
+    // Ключи, присутствующие в контейнере, и ключи, которых в нём нет
+    struct KeySet {
+        std::vector<int> present;
+        std::vector<int> missing;
+    };
+
+    constexpr int CLUSTER_SIZE = 64;
+    constexpr int CLUSTER_STRIDE = 256;
+
+    // Промахи и замены в HashTable на высокой загрузке вырождаются в просмотр длинных
+    // цепочек занятых и удалённых слотов, поэтому число таких операций ограничено
+    constexpr size_t MAX_SLOW_OPERATIONS = 10000;
+
+    // sequential — ID 1..N, как выдаёт реестр; random — случайные различные ключи;
+    // clustered — серии по 64 соседних ключа с промежутками (например, выгрузки по группам)
+    KeySet generateKeys(const std::string& distribution, size_t count, uint64_t seed) {
+        KeySet keys;
+        keys.present.reserve(count);
+        keys.missing.reserve(count);
+        if (distribution == "sequential") {
+            for (size_t i = 0; i < count; ++i) {
+                keys.present.push_back(static_cast<int>(i) + 1);
+                keys.missing.push_back(static_cast<int>(count + i) + 1);
+            }
+        } else if (distribution == "random") {
+            std::mt19937_64 gen(seed);
+            std::uniform_int_distribution<int> keyDist(1, INT32_MAX);
+            std::unordered_set<int> used;
+            used.reserve(count * 2);
+            while (keys.missing.size() < count) {
+                int key = keyDist(gen);
+                if (used.insert(key).second) {
+                    (keys.present.size() < count ? keys.present : keys.missing).push_back(key);
+                }
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                int cluster = static_cast<int>(i) / CLUSTER_SIZE;
+                int offset = static_cast<int>(i) % CLUSTER_SIZE;
+                keys.present.push_back(cluster * CLUSTER_STRIDE + offset + 1);
+                keys.missing.push_back(cluster * CLUSTER_STRIDE + CLUSTER_SIZE + offset + 1);
+            }
+        }
+        return keys;
+    }
+
+    // Заполняет контейнер так, чтобы его загрузка была близка к loadFactor
+    template <typename Adapter>
+    typename Adapter::Map buildAtLoad(const std::vector<int>& keys, double loadFactor, const Record& value) {
+        auto slots = static_cast<size_t>(std::ceil(static_cast<double>(keys.size()) / loadFactor)) + 1;
+        auto map = Adapter::withSlots(slots);
+        for (int key : keys) {
+            Adapter::insert(map, key, value);
+        }
+        return map;
+    }
+
+    struct BenchContext {
+        const university::bench::BenchOptions& options;
+        university::bench::BenchReport& report;
+        const Record& value;
+    };
+
+    void record(BenchContext& context, const std::string& operation, const char* container, const std::string& distribution,
+                size_t size, size_t operations, const std::string& loadFactor, double actualLoadFactor, uint64_t seed,
+                university::bench::Measurement measurement, size_t checksum) {
+        double nsPerOp = measurement.wallMs.median * 1e6 / static_cast<double>(operations);
+        std::cout << std::fixed << std::setprecision(1) << "  " << std::left << std::setw(16) << operation
+                  << std::setw(16) << container << std::setw(11) << distribution << std::right
+                  << " n=" << std::setw(8) << size << " load " << std::setw(4) << loadFactor
+                  << " (" << std::setprecision(2) << actualLoadFactor << "): " << std::setprecision(1)
+                  << std::setw(8) << nsPerOp << " нс/оп, медиана " << std::setprecision(3) << measurement.wallMs.median
+                  << " мс, p95 " << measurement.wallMs.p95 << " мс [контроль " << checksum << "]" << std::endl;
+        if (measurement.counters.any()) {
+            std::cout << "    " << university::bench::formatPerfCounts(measurement.counters, operations) << std::endl;
+        }
+        std::ostringstream actual;
+        actual << std::setprecision(3) << actualLoadFactor;
+        context.report.add({{"Operation", operation},
+                            {"Container", container},
+                            {"Distribution", distribution},
+                            {"Size", std::to_string(size)},
+                            {"Operations", std::to_string(operations)},
+                            {"LoadFactor", loadFactor},
+                            {"ActualLoadFactor", actual.str()},
+                            {"Seed", std::to_string(seed)}},
+                           std::move(measurement));
+    }
+
+    template <typename Adapter>
+    void runContainer(BenchContext& context, const std::string& distribution, const KeySet& keys, uint64_t seed,
+                      const std::vector<double>& loadFactors) {
+        using Map = typename Adapter::Map;
+        const auto& options = context.options;
+        const auto& value = context.value;
+        size_t size = keys.present.size();
+        size_t slowOperations = std::min(size, MAX_SLOW_OPERATIONS);
+
+        // Порядок обращений перемешан, чтобы не проходить таблицу подряд
+        std::vector<int> lookupOrder = keys.present;
+        std::vector<int> missOrder = keys.missing;
+        std::mt19937_64 gen(seed ^ 0x5bd1e995);
+        std::shuffle(lookupOrder.begin(), lookupOrder.end(), gen);
+        std::shuffle(missOrder.begin(), missOrder.end(), gen);
+
+        Map map = Adapter::withSlots(16);
+        size_t checksum = 0;
+        auto finalLoad = [&]() { return static_cast<double>(size) / static_cast<double>(Adapter::buckets(map)); };
+        std::ostringstream maxLoad;
+        maxLoad << Adapter::MAX_LOAD_FACTOR;
+
+        if (options.selected("insert")) {
+            auto measurement = university::bench::measure(options.run, [&]() { map = Adapter::withSlots(16); }, [&]() {
+                for (int key : keys.present) {
+                    Adapter::insert(map, key, value);
+                }
+            });
+            record(context, "insert", Adapter::NAME, distribution, size, size, "grow", finalLoad(), seed, std::move(measurement), size);
+        }
+        if (options.selected("insert_reserved")) {
+            auto measurement = university::bench::measure(options.run, [&]() { map = Adapter::withSlots(16); }, [&]() {
+                Adapter::reserve(map, size);
+                for (int key : keys.present) {
+                    Adapter::insert(map, key, value);
+                }
+            });
+            record(context, "insert_reserved", Adapter::NAME, distribution, size, size, "grow", finalLoad(), seed,
+                   std::move(measurement), size);
+        }
+
+        for (double loadFactor : loadFactors) {
+            if (loadFactor > Adapter::MAX_LOAD_FACTOR) {
+                continue;
+            }
+            std::ostringstream loadText;
+            loadText << loadFactor;
+            const Map prepared = buildAtLoad<Adapter>(keys.present, loadFactor, value);
+            double actualLoad = static_cast<double>(size) / static_cast<double>(Adapter::buckets(prepared));
+
+            if (options.selected("lookup_hit")) {
+                checksum = 0;
+                auto measurement = university::bench::measure(options.run, [&]() {
+                    for (int key : lookupOrder) {
+                        checksum += Adapter::contains(prepared, key);
+                    }
+                });
+                record(context, "lookup_hit", Adapter::NAME, distribution, size, size, loadText.str(), actualLoad, seed,
+                       std::move(measurement), checksum);
+            }
+            if (options.selected("lookup_miss")) {
+                checksum = 0;
+                auto measurement = university::bench::measure(options.run, [&]() {
+                    for (size_t i = 0; i < slowOperations; ++i) {
+                        checksum += Adapter::contains(prepared, missOrder[i]);
+                    }
+                });
+                record(context, "lookup_miss", Adapter::NAME, distribution, size, slowOperations, loadText.str(), actualLoad, seed,
+                       std::move(measurement), checksum);
+            }
+            if (options.selected("iterate")) {
+                checksum = 0;
+                auto measurement = university::bench::measure(options.run, [&]() {
+                    Adapter::forEach(prepared, [&](int key, const Record& record) {
+                        checksum += static_cast<size_t>(key) + (record != nullptr);
+                    });
+                });
+                record(context, "iterate", Adapter::NAME, distribution, size, size, loadText.str(), actualLoad, seed,
+                       std::move(measurement), checksum);
+            }
+            if (options.selected("remove")) {
+                checksum = 0;
+                auto measurement = university::bench::measure(options.run, [&]() { map = prepared; }, [&]() {
+                    for (int key : lookupOrder) {
+                        checksum += Adapter::remove(map, key);
+                    }
+                });
+                record(context, "remove", Adapter::NAME, distribution, size, size, loadText.str(), actualLoad, seed,
+                       std::move(measurement), checksum);
+            }
+            if (options.selected("churn")) {
+                // Удаление старого ключа и вставка нового, как при отчислении и зачислении:
+                // размер не меняется, а в HashTable накапливаются удалённые слоты
+                checksum = 0;
+                auto measurement = university::bench::measure(options.run, [&]() { map = prepared; }, [&]() {
+                    for (size_t i = 0; i < slowOperations; ++i) {
+                        checksum += Adapter::remove(map, lookupOrder[i]);
+                        checksum += Adapter::insert(map, missOrder[i], value);
+                    }
+                });
+                record(context, "churn", Adapter::NAME, distribution, size, slowOperations, loadText.str(), actualLoad, seed,
+                       std::move(measurement), checksum);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> operations = {"insert", "insert_reserved", "lookup_hit", "lookup_miss", "remove", "churn", "iterate"};
+    const std::vector<std::string> containers = {"hashtable", "unordered_map", "open_addressing"};
+    const std::vector<std::string> distributions = {"sequential", "random", "clustered"};
+    const std::vector<double> loadFactors = {0.25, 0.5, 0.7};
+
+    university::bench::BenchOptions defaults;
+    defaults.sizes = {1000, 100000};
+    defaults.modes = containers;
+    defaults.run = {1, 5};
+
+    university::bench::BenchOptions options;
+    try {
+        // --modes выбирает контейнеры, --suites — операции
+        options = university::bench::parseBenchOptions(argc, argv, defaults, operations, containers);
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << "\n" << university::bench::benchUsage(argv[0], operations, containers);
+        return 1;
+    }
+    if (options.help) {
+        std::cout << university::bench::benchUsage(argv[0], operations, containers);
+        std::cout << "Распределения ключей: sequential, random, clustered; загрузка: 0.25, 0.5, 0.7\n";
+        return 0;
+    }
+
+    std::cout << "=== Микробенчмарк HashTable ===" << std::endl;
+    std::cout << "Прогревочных прогонов: " << options.run.warmup << ", учитываемых: " << options.run.repetitions << std::endl;
+    std::optional<university::bench::PerfCounters> counters;
+    if (options.counters) {
+        counters.emplace();
+        if (counters->available()) {
+            options.run.counters = &*counters;
+        } else {
+            std::cout << "Аппаратные счётчики недоступны (" << counters->unavailableReason()
+                      << "), замеряется только время" << std::endl;
+        }
+    }
+    if (!std::filesystem::exists(options.outputDirectory)) {
+        std::filesystem::create_directories(options.outputDirectory);
+    }
+
+    // Значение того же типа, что и в реестре; все ключи ссылаются на одну запись
+    Record value = std::make_shared<const university::JuniorStudent>("Иванов", "IU7-11B", 101, std::vector<int>{5, 4});
+    university::bench::BenchReport report("hashtable", options.run);
+    BenchContext context{options, report, value};
+
+    auto selectedContainer = [&](const std::string& name) {
+        return std::find(options.modes.begin(), options.modes.end(), name) != options.modes.end();
+    };
+    for (uint64_t seed : options.seeds) {
+        for (size_t size : options.sizes) {
+            for (const auto& distribution : distributions) {
+                std::cout << "\n--- " << distribution << ", " << size << " ключей, зерно " << seed << " ---" << std::endl;
+                auto keys = generateKeys(distribution, size, seed);
+                if (selectedContainer("hashtable")) runContainer<HashTableAdapter>(context, distribution, keys, seed, loadFactors);
+                if (selectedContainer("unordered_map")) runContainer<UnorderedMapAdapter>(context, distribution, keys, seed, loadFactors);
+                if (selectedContainer("open_addressing")) runContainer<OpenAddressingAdapter>(context, distribution, keys, seed, loadFactors);
+            }
+        }
+    }
+
+    report.writeCsv(options.outputDirectory / "hashtable_benchmark_results.csv");
+    report.writeJson(options.outputDirectory / "hashtable_benchmark_results.json");
+    std::cout << "\nРезультаты сохранены в каталог: " << options.outputDirectory << std::endl;
+    return 0;
+}
@@ -0,0 +1,311 @@
+#include "Controller.h"
+#include "StudentGenerator.h"
+#include "BenchOptions.h"
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using university::bench::LatencyHistogram;
+
+    // Операции клиентов: поиск по ID, зачисление, перевод в другую группу, средние по группам
+    enum Operation : size_t { LOOKUP, INSERT, UPDATE_GROUP, AGGREGATE, OPERATION_COUNT };
+    constexpr std::array<std::string_view, OPERATION_COUNT> OPERATION_NAMES = {"lookup", "insert", "update_group", "aggregate"};
+
+    // Группы для переводов; совпадают по формату с индексами групп генератора
+    constexpr std::array<const char*, 8> TRANSFER_GROUPS = {"IU7-11B", "IU7-12B", "IU7-21B", "IU7-22B",
+                                                            "IU5-31B", "IU5-32B", "IU5-41B", "IU5-42B"};
+
+    struct LoadOptions {
+        std::array<unsigned, OPERATION_COUNT> mix = {90, 5, 4, 1}; // --mix: относительные веса операций
+        double rate = 20000.0;                                     // --rate: операций в секунду на всех клиентов (open)
+        double durationSec = 3.0;                                  // --duration: длительность прогона
+        std::filesystem::path tracePath;                           // --trace: файл трассы Chrome trace_event
+        std::filesystem::path metricsPath;                         // --metrics: файл метрик Prometheus
+    };
+
+    // Нагрузка одного прогона
+    struct LoadRun {
+        unsigned clients;
+        bool openLoop;
+        uint64_t seed;
+    };
+
+    // Задержки и число операций open loop, не начатых до конца прогона, по видам операций
+    struct ClientResult {
+        std::array<LatencyHistogram, OPERATION_COUNT> histograms;
+        std::array<uint64_t, OPERATION_COUNT> dropped{};
+    };
+
+    std::array<unsigned, OPERATION_COUNT> parseMix(std::string_view text) {
+        std::array<unsigned, OPERATION_COUNT> mix{};
+        while (!text.empty()) {
+            size_t comma = std::min(text.find(','), text.size());
+            std::string_view item = text.substr(0, comma);
+            text.remove_prefix(std::min(comma + 1, text.size()));
+
+            size_t colon = item.find(':');
+            auto name = item.substr(0, colon);
+            auto it = std::find(OPERATION_NAMES.begin(), OPERATION_NAMES.end(), name);
+            if (colon == std::string_view::npos || it == OPERATION_NAMES.end()) {
+                throw std::invalid_argument("Некорректный элемент --mix: " + std::string(item));
+            }
+            mix[static_cast<size_t>(it - OPERATION_NAMES.begin())] = static_cast<unsigned>(std::stoul(std::string(item.substr(colon + 1))));
+        }
+        if (std::all_of(mix.begin(), mix.end(), [](unsigned weight) { return weight == 0; })) {
+            throw std::invalid_argument("В --mix должна быть хотя бы одна операция с ненулевым весом");
+        }
+        return mix;
+    }
+
+    // Извлекает ключи генератора нагрузки; остальные аргументы разбирает parseBenchOptions
+    std::vector<const char*> extractLoadOptions(int argc, char* argv[], LoadOptions& load) {
+        std::vector<const char*> rest = {argv[0]};
+        for (int i = 1; i < argc; ++i) {
+            std::string_view option = argv[i];
+            bool own = option == "--mix" || option == "--rate" || option == "--duration" || option == "--trace" ||
+                       option == "--metrics";
+            if (!own) {
+                rest.push_back(argv[i]);
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Не указано значение для " + std::string(option));
+            }
+            std::string value = argv[++i];
+            if (option == "--mix") {
+                load.mix = parseMix(value);
+            } else if (option == "--rate") {
+                load.rate = std::stod(value);
+            } else if (option == "--trace") {
+                load.tracePath = value;
+            } else if (option == "--metrics") {
+                load.metricsPath = value;
+            } else {
+                load.durationSec = std::stod(value);
+            }
+            if (load.rate <= 0.0 || load.durationSec <= 0.0) {
+                throw std::invalid_argument("Значение " + std::string(option) + " должно быть положительным");
+            }
+        }
+        return rest;
+    }
+
+    void raiseMaxId(std::atomic<int>& maxId, int id) {
+        int current = maxId.load(std::memory_order_relaxed);
+        while (current < id && !maxId.compare_exchange_weak(current, id, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Выполняет операции одного клиента до окончания прогона.
+    // Closed loop: следующая операция начинается сразу после предыдущей, задержка — время операции.
+    // Open loop: операции поступают пуассоновским потоком с частотой rate / clients; задержка
+    // отсчитывается от запланированного момента, поэтому очередь при перегрузке видна в хвостах
+    // (без «скоординированного пропуска» медленных интервалов). Запросы, до которых клиент не
+    // дошёл к концу прогона, не выполняются и считаются отброшенными.
+    void runClient(university::Controller& controller, const LoadOptions& load, const LoadRun& run, unsigned client,
+                   std::atomic<int>& maxId, Clock::time_point start, Clock::time_point deadline, ClientResult& result) {
+        std::mt19937_64 gen(university::datagen::blockSeed(run.seed, client));
+        std::discrete_distribution<size_t> pickOperation(load.mix.begin(), load.mix.end());
+        std::exponential_distribution<double> interval(load.rate / run.clients);
+        university::datagen::StudentGenerator students(university::datagen::blockSeed(run.seed ^ 0x9e3779b97f4a7c15ULL, client));
+        size_t checksum = 0;
+
+        auto scheduled = start;
+        while (true) {
+            if (run.openLoop) {
+                scheduled += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval(gen)));
+                if (scheduled >= deadline) {
+                    break;
+                }
+                if (Clock::now() >= deadline) {
+                    ++result.dropped[pickOperation(gen)];
+                    continue;
+                }
+                std::this_thread::sleep_until(scheduled);
+            } else {
+                scheduled = Clock::now();
+                if (scheduled >= deadline) {
+                    break;
+                }
+            }
+
+            auto operation = static_cast<Operation>(pickOperation(gen));
+            int id = std::uniform_int_distribution<int>(1, std::max(1, maxId.load(std::memory_order_relaxed)))(gen);
+            switch (operation) {
+            case LOOKUP:
+                checksum += controller.getStudent(id) != nullptr;
+                break;
+            case INSERT:
+                raiseMaxId(maxId, controller.insertStudent(students.next(id)));
+                break;
+            case UPDATE_GROUP:
+                checksum += controller.setStudentGroup(id, TRANSFER_GROUPS[gen() % TRANSFER_GROUPS.size()]);
+                break;
+            case AGGREGATE:
+                checksum += controller.calculateAverageGradesByGroup().size();
+                break;
+            case OPERATION_COUNT:
+                break;
+            }
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - scheduled);
+            result.histograms[operation].record(static_cast<uint64_t>(latency.count()));
+        }
+        if (checksum == SIZE_MAX) {
+            std::cout << checksum << std::endl; // Не даём компилятору отбросить операции
+        }
+    }
+
+    double toUs(uint64_t ns) {
+        return static_cast<double>(ns) / 1000.0;
+    }
+
+    void writeRow(std::ofstream& csvFile, size_t students, const LoadRun& run, std::string_view name,
+                  const LatencyHistogram& histogram, uint64_t dropped, double seconds) {
+        double throughput = static_cast<double>(histogram.count()) / seconds;
+        std::cout << "  " << std::left << std::setw(13) << name << std::right << std::setw(9) << histogram.count()
+                  << std::setw(11) << throughput << " оп/с  p50 " << std::setw(9) << toUs(histogram.percentile(50))
+                  << "  p99 " << std::setw(9) << toUs(histogram.percentile(99)) << "  p999 " << std::setw(9)
+                  << toUs(histogram.percentile(99.9)) << "  max " << std::setw(9) << toUs(histogram.max()) << " мкс";
+        if (dropped != 0) {
+            std::cout << "  отброшено " << dropped;
+        }
+        std::cout << std::endl;
+        csvFile << students << "," << (run.openLoop ? "open" : "closed") << "," << run.clients << "," << run.seed << ","
+                << name << "," << histogram.count() << "," << throughput << "," << histogram.mean() / 1000.0 << ","
+                << toUs(histogram.percentile(50)) << "," << toUs(histogram.percentile(99)) << ","
+                << toUs(histogram.percentile(99.9)) << "," << toUs(histogram.max()) << "," << dropped << std::endl;
+    }
+
+    void runLoad(size_t students, const LoadOptions& load, const LoadRun& run, std::ofstream& csvFile) {
+        std::cout << "\n--- " << (run.openLoop ? "open loop, " : "closed loop, ") << run.clients << " клиентов, "
+                  << students << " студентов";
+        if (run.openLoop) {
+            std::cout << ", " << load.rate << " оп/с";
+        }
+        std::cout << " ---" << std::endl;
+
+        university::Controller controller;
+        university::datagen::GeneratorOptions generatorOptions;
+        generatorOptions.seed = run.seed;
+        controller.insertStudents(university::datagen::generateStudents(students, 1, generatorOptions));
+        std::atomic<int> maxId{static_cast<int>(students)};
+
+        std::vector<ClientResult> results(run.clients);
+        std::vector<std::thread> clients;
+        auto start = Clock::now();
+        auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(load.durationSec));
+        for (unsigned client = 0; client < run.clients; ++client) {
+            clients.emplace_back(runClient, std::ref(controller), std::cref(load), std::cref(run), client, std::ref(maxId),
+                                 start, deadline, std::ref(results[client]));
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        ClientResult merged;
+        LatencyHistogram total;
+        uint64_t totalDropped = 0;
+        for (const auto& local : results) {
+            for (size_t operation = 0; operation < OPERATION_COUNT; ++operation) {
+                merged.histograms[operation].merge(local.histograms[operation]);
+                merged.dropped[operation] += local.dropped[operation];
+                total.merge(local.histograms[operation]);
+                totalDropped += local.dropped[operation];
+            }
+        }
+        std::cout << std::fixed << std::setprecision(1);
+        for (size_t operation = 0; operation < OPERATION_COUNT; ++operation) {
+            if (merged.histograms[operation].count() != 0) {
+                writeRow(csvFile, students, run, OPERATION_NAMES[operation], merged.histograms[operation],
+                         merged.dropped[operation], seconds);
+            }
+        }
+        writeRow(csvFile, students, run, "all", total, totalDropped, seconds);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> loops = {"closed", "open"};
+
+    university::bench::BenchOptions defaults;
+    defaults.sizes = {100000};
+    defaults.modes = {"closed"};
+    defaults.threads = {1, 4, 16};
+
+    LoadOptions load;
+    university::bench::BenchOptions options;
+    try {
+        // --threads задаёт числа клиентов, --modes — режим поступления запросов
+        auto rest = extractLoadOptions(argc, argv, load);
+        options = university::bench::parseBenchOptions(static_cast<int>(rest.size()), rest.data(), defaults, {}, loops);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n" << university::bench::benchUsage(argv[0], {}, loops);
+        return 1;
+    }
+    if (options.help) {
+        std::cout << university::bench::benchUsage(argv[0], {}, loops);
+        std::cout << "  --mix OP:W,...       веса операций (lookup, insert, update_group, aggregate), по умолчанию lookup:90,insert:5,update_group:4,aggregate:1\n"
+                  << "  --rate N             операций в секунду на всех клиентов в режиме open\n"
+                  << "  --duration S         длительность прогона, с\n"
+                  << "  --trace FILE         записать трассу операций (последние события каждого потока) для Perfetto\n"
+                  << "  --metrics FILE       записать метрики операций всех прогонов в текстовом формате Prometheus\n"
+                  << "--threads задаёт числа клиентов, --modes — closed (без пауз) или open (пуассоновский поток)\n";
+        return 0;
+    }
+
+    std::cout << "=== Генератор смешанной нагрузки ===" << std::endl;
+    std::cout << "Смесь операций:";
+    for (size_t operation = 0; operation < OPERATION_COUNT; ++operation) {
+        std::cout << " " << OPERATION_NAMES[operation] << "=" << load.mix[operation];
+    }
+    std::cout << ", длительность прогона " << load.durationSec << " с" << std::endl;
+    if (!std::filesystem::exists(options.outputDirectory)) {
+        std::filesystem::create_directories(options.outputDirectory);
+    }
+
+    std::ofstream csvFile(options.outputDirectory / "load_benchmark_results.csv");
+    csvFile << "Students,Loop,Clients,Seed,Operation,Count,Throughput(ops/s),Mean(us),P50(us),P99(us),P999(us),Max(us),Dropped"
+            << std::endl;
+    if (!load.tracePath.empty()) {
+        university::trace::start();
+    }
+    for (uint64_t seed : options.seeds) {
+        for (size_t size : options.sizes) {
+            for (const auto& loop : options.modes) {
+                for (unsigned clients : options.threadCounts()) {
+                    runLoad(size, load, LoadRun{clients, loop == "open", seed}, csvFile);
+                }
+            }
+        }
+    }
+    if (!load.tracePath.empty()) {
+        university::trace::stop();
+        university::trace::writeChromeTrace(load.tracePath);
+        std::cout << "\nТрасса записана в " << load.tracePath << " (вытеснено событий: "
+                  << university::trace::droppedEvents() << ")" << std::endl;
+    }
+    if (!load.metricsPath.empty()) {
+        university::metrics::registry().writePrometheus(load.metricsPath);
+        std::cout << "Метрики записаны в " << load.metricsPath << std::endl;
+    }
+    std::cout << "\nРезультаты сохранены в каталог: " << options.outputDirectory << std::endl;
+    return 0;
+}
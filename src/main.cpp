@@ -1,15 +1,292 @@
 #include "Controller.h"
+#include "CommandScript.h"
+#include "MetricsExporter.h"
+#include "RegistryServer.h"
+#include "Trace.h"
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    /**
+     * @struct CommandLine
+     * @brief Разобранные аргументы командной строки.
+     */
+    struct CommandLine
+    {
+        std::filesystem::path tracePath;
+        std::filesystem::path metricsPath;
+        std::optional<size_t> pageSize;
+        std::string scriptPath;
+        std::optional<university::server::ServerAddress> serveAddress;
+        std::filesystem::path mappedPath;   // --mapped
+        std::filesystem::path storagePath;  // --storage
+        std::filesystem::path snapshotPath; // Позиционный аргумент
+        bool help = false;
+    };
+
+    /**
+     * @brief Формирует справку по аргументам.
+     * @param program Имя программы (argv[0]).
+     */
+    std::string usage(const char *program)
+    {
+        return std::string("Использование: ") + program +
+               " [--trace <файл трассы>] [--metrics <файл метрик>] [--page-size <число>]\n"
+               "       [--script <файл сценария>|-] [--serve unix:<путь>|tcp:<порт>]\n"
+               "       [<путь к снимку> | --mapped <файл реестра> | --storage <каталог хранилища>]\n"
+               "Ключи можно указывать в любом порядке.\n";
+    }
+
+    /**
+     * @brief Разбирает значение ключа --page-size.
+     * @param text Текст значения.
+     * @return Размер страницы или std::nullopt, если значение не является положительным числом size_t.
+     */
+    std::optional<size_t> parsePageSize(std::string_view text)
+    {
+        size_t value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size() || value == 0)
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Разбирает аргументы в любом порядке.
+     * @param argc Количество аргументов.
+     * @param argv Аргументы.
+     * @return Разобранные аргументы.
+     * @throw std::invalid_argument при неизвестном ключе, ключе без значения, повторе ключа,
+     *        некорректном значении или нескольких источниках реестра.
+     */
+    CommandLine parseCommandLine(int argc, char *argv[])
+    {
+        CommandLine options;
+        bool seen[7] = {}; // Повтор ключа со значением — ошибка
+        auto value = [&](int &i, std::string_view option, size_t slot) -> std::string_view
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("Не указано значение для " + std::string(option));
+            }
+            if (seen[slot])
+            {
+                throw std::invalid_argument("Ключ " + std::string(option) + " указан дважды");
+            }
+            seen[slot] = true;
+            return argv[++i];
+        };
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view argument = argv[i];
+            if (argument == "--help" || argument == "-h")
+            {
+                options.help = true;
+            }
+            else if (argument == "--trace")
+            {
+                options.tracePath = value(i, argument, 0);
+            }
+            else if (argument == "--metrics")
+            {
+                options.metricsPath = value(i, argument, 1);
+            }
+            else if (argument == "--page-size")
+            {
+                auto text = value(i, argument, 2);
+                options.pageSize = parsePageSize(text);
+                if (!options.pageSize)
+                {
+                    throw std::invalid_argument("Некорректный размер страницы: " + std::string(text) + " (ожидается положительное число)");
+                }
+            }
+            else if (argument == "--script")
+            {
+                options.scriptPath = value(i, argument, 3);
+            }
+            else if (argument == "--serve")
+            {
+                options.serveAddress = university::server::ServerAddress::parse(std::string(value(i, argument, 4)));
+            }
+            else if (argument == "--mapped")
+            {
+                options.mappedPath = value(i, argument, 5);
+            }
+            else if (argument == "--storage")
+            {
+                options.storagePath = value(i, argument, 6);
+            }
+            else if (argument.size() > 1 && argument[0] == '-' && argument != "-")
+            {
+                throw std::invalid_argument("Неизвестный ключ: " + std::string(argument));
+            }
+            else if (!options.snapshotPath.empty())
+            {
+                throw std::invalid_argument("Лишний аргумент: " + std::string(argument));
+            }
+            else
+            {
+                options.snapshotPath = argument;
+            }
+        }
+        if (!options.snapshotPath.empty() + seen[5] + seen[6] > 1)
+        {
+            throw std::invalid_argument("Укажите только один из вариантов: путь к снимку, --mapped или --storage");
+        }
+        return options;
+    }
+} // namespace
 
 /**
  * @brief Главная функция приложения.
  *
- * Создаёт и запускает контроллер приложения реестра студентов.
+ * Создаёт и запускает контроллер приложения реестра студентов. Если передан
+ * путь к файлу снимка, реестр загружается из него при запуске (если файл
+ * существует) и сохраняется в него при выходе. С ключом --mapped реестр
+ * открывается только для чтения из файла, созданного Controller::saveMapped.
+ * С ключом --storage каждое изменение записывается в журнал в каталоге
+ * хранилища, а при выходе создаётся контрольная точка. Ключ --page-size
+ * задаёт количество студентов на странице при просмотре реестра. С ключом
+ * --trace операции реестра трассируются, а при выходе трасса записывается
+ * в файл в формате Chrome trace_event (открывается в Perfetto). С ключом
+ * --metrics метрики операций записываются в файл в текстовом формате
+ * Prometheus каждые 10 секунд, по сигналу SIGUSR1 и при выходе. С ключом
+ * --script вместо меню выполняется сценарий команд из файла ("-" — из
+ * стандартного ввода), ответы выводятся в стандартный вывод, а итоги — в
+ * стандартный поток ошибок. С ключом --serve вместо меню реестр обслуживает
+ * клиентов по тому же протоколу через Unix-сокет или TCP-порт на 127.0.0.1
+ * до SIGINT или SIGTERM.
  *
- * @return 0 при успешном завершении
+ * @param argc Количество аргументов.
+ * @param argv Аргументы в любом порядке: [--trace <файл трассы>] [--metrics <файл метрик>] [--page-size <число>]
+ *             [--script <файл сценария>] [--serve unix:<путь>|tcp:<порт>] и не более одного из
+ *             [путь к снимку], --mapped <путь к файлу реестра>, --storage <каталог хранилища>.
+ * @return 0 при успешном завершении, 1 при ошибке аргументов, загрузки, сохранения или ответе ERROR в сценарии
  */
-int main()
+int main(int argc, char *argv[])
 {
+    CommandLine options;
+    try
+    {
+        options = parseCommandLine(argc, argv);
+    }
+    catch (const std::invalid_argument &error)
+    {
+        std::cerr << error.what() << "\n" << usage(argv[0]);
+        return 1;
+    }
+    if (options.help)
+    {
+        std::cout << usage(argv[0]);
+        return 0;
+    }
+
     university::Controller app;
-    app.run();
-    return 0;
-}
\ No newline at end of file
+    bool scriptFailed = false;
+    std::unique_ptr<university::metrics::MetricsExporter> metricsExporter;
+    auto writeTrace = [&options]()
+    {
+        if (!options.tracePath.empty())
+        {
+            university::trace::stop();
+            university::trace::writeChromeTrace(options.tracePath);
+        }
+    };
+
+    try
+    {
+        if (!options.tracePath.empty())
+        {
+            university::trace::start();
+        }
+        if (!options.metricsPath.empty())
+        {
+            metricsExporter = std::make_unique<university::metrics::MetricsExporter>(options.metricsPath, std::chrono::seconds(10));
+            university::metrics::MetricsExporter::installSignalHandler(SIGUSR1);
+        }
+        if (options.pageSize)
+        {
+            app.setPageSize(*options.pageSize);
+        }
+        auto runApp = [&app, &options, &scriptFailed]()
+        {
+            if (options.serveAddress)
+            {
+                university::server::ServerOptions serverOptions;
+                serverOptions.address = *options.serveAddress;
+                university::server::RegistryServer server(app, serverOptions);
+                university::server::RegistryServer::installStopSignalHandler(SIGINT);
+                university::server::RegistryServer::installStopSignalHandler(SIGTERM);
+                std::cerr << "Сервер реестра: " << server.address().toString() << std::endl;
+                server.run();
+                return;
+            }
+            if (options.scriptPath.empty())
+            {
+                app.run();
+                return;
+            }
+            std::ios::sync_with_stdio(false);
+            std::ifstream file;
+            if (options.scriptPath != "-")
+            {
+                file.open(options.scriptPath, std::ios::binary);
+                if (!file)
+                {
+                    throw std::runtime_error("Не удалось открыть файл сценария: " + options.scriptPath);
+                }
+            }
+            auto report = university::runCommandScript(app, options.scriptPath == "-" ? std::cin : file, std::cout);
+            std::cerr << "Выполнено команд: " << report.commands << " за " << report.seconds << " с ("
+                      << static_cast<long long>(report.commandsPerSecond()) << " команд/с), ошибок: " << report.errors << std::endl;
+            scriptFailed = report.errors != 0;
+        };
+
+        if (!options.mappedPath.empty())
+        {
+            app.openReadOnly(options.mappedPath);
+            runApp();
+            writeTrace();
+            return scriptFailed ? 1 : 0;
+        }
+
+        if (!options.storagePath.empty())
+        {
+            app.openStorage(options.storagePath, {university::storage::Durability::EVERY_OPERATION});
+            runApp();
+            app.checkpoint();
+            writeTrace();
+            return scriptFailed ? 1 : 0;
+        }
+
+        if (!options.snapshotPath.empty() && std::filesystem::exists(options.snapshotPath))
+        {
+            app.load(options.snapshotPath);
+        }
+        runApp();
+        if (!options.snapshotPath.empty())
+        {
+            app.save(options.snapshotPath);
+        }
+        writeTrace();
+    }
+    catch (const std::runtime_error &error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return scriptFailed ? 1 : 0;
+}
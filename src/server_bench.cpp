@@ -0,0 +1,240 @@
+#include "Controller.h"
+#include "RegistryServer.h"
+#include "RegistryClient.h"
+#include "StudentGenerator.h"
+#include "BenchOptions.h"
+#include "LatencyHistogram.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using university::bench::LatencyHistogram;
+
+    struct ServerBenchOptions {
+        std::optional<university::server::ServerAddress> address; // --address: внешний сервер вместо встроенного
+        std::vector<size_t> depths = {1, 16, 128};                // --depth: запросов в полёте на клиента
+        size_t requests = 100000;                                 // --requests: запросов на клиента
+        unsigned workers = 0;                                     // --workers: потоков встроенного сервера
+        unsigned groupPercent = 5;                                // --group-percent: доля GROUP, остальное FIND
+    };
+
+    std::vector<size_t> parseList(const std::string& text) {
+        std::vector<size_t> values;
+        size_t first = 0;
+        while (first <= text.size()) {
+            size_t comma = std::min(text.find(',', first), text.size());
+            values.push_back(std::stoul(text.substr(first, comma - first)));
+            first = comma + 1;
+        }
+        return values;
+    }
+
+    // Извлекает ключи бенчмарка сервера; остальные аргументы разбирает parseBenchOptions
+    std::vector<const char*> extractServerOptions(int argc, char* argv[], ServerBenchOptions& bench) {
+        std::vector<const char*> rest = {argv[0]};
+        for (int i = 1; i < argc; ++i) {
+            std::string_view option = argv[i];
+            bool own = option == "--address" || option == "--depth" || option == "--requests" || option == "--workers" ||
+                       option == "--group-percent";
+            if (!own) {
+                rest.push_back(argv[i]);
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Не указано значение для " + std::string(option));
+            }
+            std::string value = argv[++i];
+            if (option == "--address") {
+                bench.address = university::server::ServerAddress::parse(value);
+            } else if (option == "--depth") {
+                bench.depths = parseList(value);
+            } else if (option == "--requests") {
+                bench.requests = std::stoul(value);
+            } else if (option == "--workers") {
+                bench.workers = static_cast<unsigned>(std::stoul(value));
+            } else {
+                bench.groupPercent = static_cast<unsigned>(std::stoul(value));
+            }
+        }
+        for (size_t depth : bench.depths) {
+            if (depth == 0) {
+                throw std::invalid_argument("Значение --depth должно быть положительным");
+            }
+        }
+        if (bench.groupPercent > 100) {
+            throw std::invalid_argument("Значение --group-percent должно быть от 0 до 100");
+        }
+        return rest;
+    }
+
+    // Клиент держит depth запросов в полёте: на каждый ответ отправляет следующий запрос.
+    // Задержка — от постановки запроса в буфер отправки до получения ответа, включая ожидание
+    // в конвейере за предыдущими запросами соединения.
+    void runClient(const university::server::ServerAddress& address, const ServerBenchOptions& bench, size_t depth,
+                   size_t students, uint64_t seed, std::latch& ready, LatencyHistogram& histogram) {
+        university::server::RegistryClient client(address);
+        std::mt19937_64 gen(seed);
+        std::uniform_int_distribution<int> pickId(1, static_cast<int>(std::max<size_t>(students, 1)));
+        std::uniform_int_distribution<unsigned> pickPercent(0, 99);
+        std::vector<Clock::time_point> sentAt(depth); // Кольцо моментов отправки запросов в полёте
+        std::string request;
+
+        auto sendNext = [&](size_t index) {
+            int id = pickId(gen);
+            if (pickPercent(gen) < bench.groupPercent) {
+                request = "GROUP " + std::to_string(id) + " BENCH-" + std::to_string(id % 8);
+            } else {
+                request = "FIND " + std::to_string(id);
+            }
+            sentAt[index % depth] = Clock::now();
+            client.send(request);
+        };
+
+        ready.arrive_and_wait();
+        size_t sent = 0;
+        for (; sent < std::min(depth, bench.requests); ++sent) {
+            sendNext(sent);
+        }
+        for (size_t received = 0; received < bench.requests; ++received) {
+            client.receive();
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sentAt[received % depth]);
+            histogram.record(static_cast<uint64_t>(latency.count()));
+            if (sent < bench.requests) {
+                sendNext(sent++);
+            }
+        }
+    }
+
+    double toUs(uint64_t ns) {
+        return static_cast<double>(ns) / 1000.0;
+    }
+
+    void runBench(const university::server::ServerAddress& address, std::string_view transport, size_t students,
+                  unsigned clients, size_t depth, const ServerBenchOptions& bench, uint64_t seed, std::ofstream& csvFile) {
+        std::vector<LatencyHistogram> histograms(clients);
+        std::vector<std::thread> threads;
+        std::latch ready(static_cast<std::ptrdiff_t>(clients) + 1);
+        for (unsigned client = 0; client < clients; ++client) {
+            threads.emplace_back(runClient, std::cref(address), std::cref(bench), depth, students,
+                                 university::datagen::blockSeed(seed, client), std::ref(ready), std::ref(histograms[client]));
+        }
+        ready.arrive_and_wait();
+        auto start = Clock::now();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        LatencyHistogram total;
+        for (const auto& histogram : histograms) {
+            total.merge(histogram);
+        }
+        double throughput = static_cast<double>(total.count()) / seconds;
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  " << transport << ", клиентов " << std::setw(3) << clients << ", глубина " << std::setw(4) << depth
+                  << ": " << std::setw(10) << throughput << " запр/с  p50 " << std::setw(8) << toUs(total.percentile(50))
+                  << "  p99 " << std::setw(8) << toUs(total.percentile(99)) << "  p999 " << std::setw(8)
+                  << toUs(total.percentile(99.9)) << "  max " << std::setw(8) << toUs(total.max()) << " мкс" << std::endl;
+        csvFile << students << "," << transport << "," << clients << "," << depth << "," << total.count() << ","
+                << throughput << "," << total.mean() / 1000.0 << "," << toUs(total.percentile(50)) << ","
+                << toUs(total.percentile(99)) << "," << toUs(total.percentile(99.9)) << "," << toUs(total.max()) << std::endl;
+    }
+
+    // Запускает встроенный сервер над реестром из students студентов и замеряет все сочетания клиентов и глубины
+    void runEmbedded(const std::string& transport, size_t students, const ServerBenchOptions& bench,
+                     const university::bench::BenchOptions& options, uint64_t seed, std::ofstream& csvFile) {
+        university::Controller controller;
+        university::datagen::GeneratorOptions generatorOptions;
+        generatorOptions.seed = seed;
+        controller.insertStudents(university::datagen::generateStudents(students, 1, generatorOptions));
+
+        university::server::ServerOptions serverOptions;
+        serverOptions.workers = bench.workers;
+        if (transport == "unix") {
+            serverOptions.address.unixPath = (std::filesystem::temp_directory_path() / "registry_server_bench.sock").string();
+        }
+        university::server::RegistryServer server(controller, serverOptions);
+        std::thread loop([&server]() { server.run(); });
+        std::cout << "\n--- " << students << " студентов, сервер " << server.address().toString() << " ---" << std::endl;
+        for (unsigned clients : options.threadCounts()) {
+            for (size_t depth : bench.depths) {
+                runBench(server.address(), transport, students, clients, depth, bench, seed, csvFile);
+            }
+        }
+        server.stop();
+        loop.join();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> transports = {"unix", "tcp"};
+
+    university::bench::BenchOptions defaults;
+    defaults.sizes = {100000};
+    defaults.modes = {"unix", "tcp"};
+    defaults.threads = {1, 4, 16};
+
+    ServerBenchOptions bench;
+    university::bench::BenchOptions options;
+    try {
+        // --threads задаёт числа клиентов, --modes — транспорт встроенного сервера
+        auto rest = extractServerOptions(argc, argv, bench);
+        options = university::bench::parseBenchOptions(static_cast<int>(rest.size()), rest.data(), defaults, {}, transports);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n" << university::bench::benchUsage(argv[0], {}, transports);
+        return 1;
+    }
+    if (options.help) {
+        std::cout << university::bench::benchUsage(argv[0], {}, transports);
+        std::cout << "  --address ADDR       замерять внешний сервер (unix:<путь> или tcp:<порт>) с реестром из --sizes студентов\n"
+                  << "  --depth N,...        запросов в полёте на клиента (конвейер), по умолчанию 1,16,128\n"
+                  << "  --requests N         запросов на клиента\n"
+                  << "  --workers N          потоков встроенного сервера (0 — по числу ядер)\n"
+                  << "  --group-percent P    доля запросов GROUP, остальные — FIND (по умолчанию 5)\n"
+                  << "--threads задаёт числа клиентов, --modes — транспорт встроенного сервера (unix, tcp)\n";
+        return 0;
+    }
+
+    std::cout << "=== Бенчмарк сервера реестра ===" << std::endl;
+    std::cout << "Запросов на клиента: " << bench.requests << ", GROUP " << bench.groupPercent << "%, остальные FIND" << std::endl;
+    if (!std::filesystem::exists(options.outputDirectory)) {
+        std::filesystem::create_directories(options.outputDirectory);
+    }
+    std::ofstream csvFile(options.outputDirectory / "server_benchmark_results.csv");
+    csvFile << "Students,Transport,Clients,Depth,Requests,Throughput(req/s),Mean(us),P50(us),P99(us),P999(us),Max(us)" << std::endl;
+
+    try {
+        for (size_t students : options.sizes) {
+            if (bench.address) {
+                std::cout << "\n--- внешний сервер " << bench.address->toString() << " ---" << std::endl;
+                for (unsigned clients : options.threadCounts()) {
+                    for (size_t depth : bench.depths) {
+                        runBench(*bench.address, "external", students, clients, depth, bench, options.seeds.front(), csvFile);
+                    }
+                }
+                continue;
+            }
+            for (const auto& transport : options.modes) {
+                runEmbedded(transport, students, bench, options, options.seeds.front(), csvFile);
+            }
+        }
+    } catch (const std::runtime_error& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    std::cout << "\nРезультаты сохранены в каталог: " << options.outputDirectory << std::endl;
+    return 0;
+}
@@ -4,9 +4,36 @@
 #include "SeniorStudent.h"
 #include "GraduateStudent.h"
 #include "HashTable.h"
+#include "Controller.h"
+#include "AsyncController.h"
+#include "CommandScript.h"
+#include "BinarySnapshot.h"
+#include "StudentCsv.h"
+#include "StudentGenerator.h"
+#include "BenchHarness.h"
+#include "BenchOptions.h"
+#include "LatencyHistogram.h"
+#include "MemoryAccounting.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+#include "Metrics.h"
+#include "MetricsExporter.h"
+#include "StudentFootprint.h"
+#include "RegistryServer.h"
+#include "RegistryClient.h"
+#include <atomic>
+#include <csignal>
+#include <filesystem>
+#include <future>
+#include <fstream>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
 #include <vector>
 #include <string>
+#include <thread>
 
 using namespace university;
 
@@ -160,4 +187,1653 @@ TEST(HashTableTest, StudentPolymorphism)
     auto foundSenior = studentTable.find(202);
     ASSERT_TRUE(foundSenior.has_value());
     EXPECT_EQ(foundSenior->get()->getCategory(), StudentCategory::SENIOR);
-}
\ No newline at end of file
+}
+
+// --- Тесты агрегаций контроллера ---
+
+namespace
+{
+    void fillSampleRegistry(Controller &controller)
+    {
+        auto &table = controller.getStudentTable();
+        table.insert(1, std::make_unique<JuniorStudent>("Ivanov", "IU7-11B", 101, std::vector<int>{5, 4, 3}));
+        table.insert(2, std::make_unique<JuniorStudent>("Petrov", "IU7-12B", 101, std::vector<int>{2, 2}));
+        table.insert(3, std::make_unique<SeniorStudent>("Sidorov", "IU7-11B", 102, std::vector<int>{5, 5},
+                                                        ResearchWork{4, 3, "Тема", "Место"}));
+        table.insert(4, std::make_unique<GraduateStudent>("Kuznetsov", "IU5-81M", 102,
+                                                          DiplomaProject{5, 4, 3, "Тема", "Место"}));
+    }
+}
+
+TEST(GroupingCubeTest, GroupRollupMatchesAverageByGroup)
+{
+    Controller controller;
+    fillSampleRegistry(controller);
+    // Достаточно студентов, чтобы обход выполнялся несколькими потоками
+    for (int id = 100; id < 20000; ++id)
+    {
+        controller.getStudentTable().insert(id, std::make_unique<JuniorStudent>(
+                                                    "Student", "G-" + std::to_string(id % 37), 100 + id % 5,
+                                                    std::vector<int>{2 + id % 4, 3 + id % 3}));
+    }
+
+    auto expected = controller.calculateAverageGradesByGroup();
+    auto cube = controller.calculateAverageGradesCube({GroupingDimension::GROUP});
+
+    std::map<std::string, double> actual;
+    cube.forEachCell(GroupingDimension::GROUP, [&](const GroupingKey &key, const GroupAggregate &cell)
+                     { actual[key.groupIndex] = cell.grades.average(); });
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(GroupingCubeTest, ComputesAllRequestedRollupsInOnePass)
+{
+    Controller controller;
+    fillSampleRegistry(controller);
+
+    auto cube = controller.calculateAverageGradesCube(allGroupingSets());
+    ASSERT_EQ(cube.sets().size(), 8u);
+
+    const auto &total = cube.rollup(GroupingDimension::NONE);
+    ASSERT_EQ(total.cells.size(), 1u);
+    EXPECT_EQ(total.cells[0].students, 4u);
+    EXPECT_EQ(total.cells[0].grades.count, 12u);
+    EXPECT_DOUBLE_EQ(total.cells[0].grades.sum, 45.0);
+
+    std::map<std::pair<int, StudentCategory>, size_t> students;
+    cube.forEachCell(GroupingDimension::DEPARTMENT | GroupingDimension::CATEGORY,
+                     [&](const GroupingKey &key, const GroupAggregate &cell)
+                     { students[{key.departmentNumber, key.category}] = cell.students; });
+    std::map<std::pair<int, StudentCategory>, size_t> expected = {
+        {{101, StudentCategory::JUNIOR}, 2},
+        {{102, StudentCategory::SENIOR}, 1},
+        {{102, StudentCategory::GRADUATE}, 1}};
+    EXPECT_EQ(students, expected);
+
+    // Срезы по нескольким измерениям хранят только непустые ячейки по возрастанию кода
+    const auto &byDepartmentAndCategory = cube.rollup(GroupingDimension::DEPARTMENT | GroupingDimension::CATEGORY);
+    EXPECT_TRUE(byDepartmentAndCategory.cells.empty());
+    ASSERT_EQ(byDepartmentAndCategory.sparseCells.size(), 3u);
+    EXPECT_TRUE(std::is_sorted(byDepartmentAndCategory.sparseCells.begin(), byDepartmentAndCategory.sparseCells.end(),
+                               [](const auto &lhs, const auto &rhs)
+                               { return lhs.first < rhs.first; }));
+    size_t juniorCode = cube.encode(byDepartmentAndCategory.dimensions, 0, static_cast<uint32_t>(StudentCategory::JUNIOR), 0);
+    ASSERT_NE(byDepartmentAndCategory.find(juniorCode), nullptr);
+    EXPECT_EQ(byDepartmentAndCategory.find(juniorCode)->students, 2u);
+    EXPECT_EQ(byDepartmentAndCategory.find(cube.encode(byDepartmentAndCategory.dimensions, 0, static_cast<uint32_t>(StudentCategory::SENIOR), 0)), nullptr);
+    EXPECT_EQ(cube.rollup(GroupingDimension::GROUP).cells.size(), cube.groups().size());
+
+    auto groupsOnly = controller.calculateAverageGradesCube({GroupingDimension::GROUP});
+    EXPECT_THROW((void)groupsOnly.rollup(GroupingDimension::CATEGORY), std::out_of_range);
+}
+
+// --- Тесты запросов с предикатами ---
+
+namespace
+{
+    // Дорогое условие, которое считает свои вызовы
+    struct CountingPredicate
+    {
+        static constexpr int COST = query::COST_PAYLOAD;
+        int *calls;
+
+        bool operator()(const Student &) const
+        {
+            ++*calls;
+            return true;
+        }
+    };
+}
+
+namespace
+{
+    struct SlotRange
+    {
+        size_t bucketCount() const { return slots; }
+        size_t slots;
+    };
+}
+
+TEST(ParallelScanTest, ChunksCoverEverySlotOnce)
+{
+    const SlotRange table{100003};
+    std::vector<std::vector<std::pair<size_t, size_t>>> ranges(3);
+    parallelForSlots(table, 3, [&](unsigned worker, size_t first, size_t last)
+                     { ranges[worker].emplace_back(first, last); });
+
+    std::vector<std::pair<size_t, size_t>> all;
+    for (const auto &local : ranges)
+    {
+        all.insert(all.end(), local.begin(), local.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(all.size(), 3 * CHUNKS_PER_WORKER);
+    size_t expectedFirst = 0;
+    for (const auto &[first, last] : all)
+    {
+        EXPECT_EQ(first, expectedFirst);
+        EXPECT_LT(first, last);
+        expectedFirst = last;
+    }
+    EXPECT_EQ(expectedFirst, table.slots);
+}
+
+TEST(ParallelScanTest, ProfileReportsWorkPerThread)
+{
+    Controller controller;
+    fillSampleRegistry(controller);
+    for (int id = 100; id < 20000; ++id)
+    {
+        controller.getStudentTable().insert(id, std::make_unique<JuniorStudent>(
+                                                    "Student", "G-" + std::to_string(id % 37), 100,
+                                                    std::vector<int>{2 + id % 4, 3 + id % 3}));
+    }
+
+    ParallelProfile profile;
+    auto averages = controller.calculateAverageGradesByGroupMultithreaded(4, &profile);
+    EXPECT_EQ(averages, controller.calculateAverageGradesByGroup());
+    ASSERT_EQ(profile.workers.size(), 4u);
+    size_t items = 0;
+    for (const auto &worker : profile.workers)
+    {
+        items += worker.items;
+    }
+    EXPECT_EQ(items, controller.getStudentTable().size());
+    EXPECT_GT(profile.wallMs, 0.0);
+    EXPECT_GE(profile.imbalance(), 1.0);
+    EXPECT_LE(profile.utilization(), 1.0);
+
+    // Без профиля и с одним потоком результат тот же
+    EXPECT_EQ(controller.calculateAverageGradesByGroupMultithreaded(1), averages);
+}
+
+TEST(StudentQueryTest, FiltersByCategoryDepartmentAndCommissionGrade)
+{
+    Controller controller;
+    auto &table = controller.getStudentTable();
+    table.insert(1, std::make_unique<SeniorStudent>("A", "IU7-31B", 105, std::vector<int>{5}, ResearchWork{5, 3, "T", "Google"}));
+    table.insert(2, std::make_unique<SeniorStudent>("B", "IU7-31B", 105, std::vector<int>{5}, ResearchWork{5, 5, "T", "Intel"}));
+    table.insert(3, std::make_unique<SeniorStudent>("C", "IU7-32B", 104, std::vector<int>{5}, ResearchWork{5, 2, "T", "Google"}));
+    table.insert(4, std::make_unique<GraduateStudent>("D", "IU7-81M", 105, DiplomaProject{5, 5, 3, "T", "MIT"}));
+    table.insert(5, std::make_unique<JuniorStudent>("E", "IU7-11B", 105, std::vector<int>{2, 2}));
+
+    using namespace query;
+    EXPECT_EQ(controller.findStudentIds(CategoryIs{StudentCategory::SENIOR} && DepartmentIs{105} && CommissionGradeBelow{4}),
+              std::vector<int>{1});
+    EXPECT_EQ(controller.findStudentIds(DepartmentIs{105} && CommissionGradeBelow{4}), (std::vector<int>{1, 4}));
+    EXPECT_EQ(controller.findStudentIds(ResearchPlaceIs{"Google"} || AverageGradeBelow{3.0}), (std::vector<int>{1, 3, 5}));
+    EXPECT_EQ(controller.findStudentIds(!DepartmentIs{105}), std::vector<int>{3});
+
+    std::vector<std::string> names;
+    size_t streamed = controller.forEachMatchingStudent(GroupIs{"IU7-31B"}, [&](int, const Student &student)
+                                                        { names.push_back(student.getName()); });
+    EXPECT_EQ(streamed, 2u);
+    EXPECT_EQ(names, (std::vector<std::string>{"A", "B"}));
+}
+
+TEST(StudentQueryTest, CheapConditionsAreCheckedFirst)
+{
+    Controller controller;
+    auto &table = controller.getStudentTable();
+    for (int id = 1; id <= 30; ++id)
+    {
+        table.insert(id, std::make_unique<JuniorStudent>("S", "G", 100 + id % 3, std::vector<int>{4}));
+    }
+
+    int calls = 0;
+    auto ids = controller.findStudentIds(CountingPredicate{&calls} && query::DepartmentIs{100});
+    EXPECT_EQ(ids.size(), 10u);
+    EXPECT_EQ(calls, 10);
+}
+
+// --- Тесты рейтинга по средней оценке ---
+
+TEST(TopStudentsTest, GlobalAndPerGroupRanking)
+{
+    Controller controller;
+    fillSampleRegistry(controller);
+
+    // Средние: 1 -> 4.0, 2 -> 2.0, 3 -> 4.25, 4 -> 4.0
+    auto top = controller.calculateTopStudentsByAverage(3);
+    EXPECT_EQ(top, (std::vector<RankedStudent>{{3, 4.25}, {1, 4.0}, {4, 4.0}}));
+    EXPECT_TRUE(controller.calculateTopStudentsByAverage(0).empty());
+    EXPECT_EQ(controller.calculateTopStudentsByAverage(10).size(), 4u);
+
+    auto byGroup = controller.calculateTopStudentsByAverageByGroup(1);
+    ASSERT_EQ(byGroup.size(), 3u);
+    EXPECT_EQ(byGroup["IU7-11B"], (std::vector<RankedStudent>{{3, 4.25}}));
+    EXPECT_EQ(byGroup["IU7-12B"], (std::vector<RankedStudent>{{2, 2.0}}));
+    EXPECT_EQ(byGroup["IU5-81M"], (std::vector<RankedStudent>{{4, 4.0}}));
+}
+
+TEST(TopStudentsTest, ParallelMergeMatchesFullSort)
+{
+    Controller controller;
+    std::vector<RankedStudent> all;
+    for (int id = 1; id <= 20000; ++id)
+    {
+        std::vector<int> grades = {2 + id % 4, 2 + (id / 7) % 4, 2 + (id / 13) % 4};
+        controller.getStudentTable().insert(id, std::make_unique<JuniorStudent>("S", "G", 100, grades));
+        all.push_back({id, (grades[0] + grades[1] + grades[2]) / 3.0});
+    }
+    std::sort(all.begin(), all.end(), rankedBefore);
+    all.resize(25);
+
+    EXPECT_EQ(controller.calculateTopStudentsByAverage(25), all);
+}
+
+// --- Тесты снимков таблицы ---
+
+TEST(SnapshotTest, SnapshotIsIsolatedFromLaterWrites)
+{
+    Controller controller;
+    int first = controller.insertStudent(std::make_unique<JuniorStudent>("A", "G1", 101, std::vector<int>{5}));
+    int second = controller.insertStudent(std::make_unique<SeniorStudent>("B", "G1", 101, std::vector<int>{4}, ResearchWork{5, 5, "T", "P"}));
+
+    auto snapshot = controller.takeSnapshot();
+    controller.setStudentGroup(first, "G2");
+    controller.setStudentResearchWork(second, ResearchWork{3, 3, "Новая", "Место"});
+    controller.eraseStudent(second);
+    controller.insertStudent(std::make_unique<JuniorStudent>("C", "G3", 102, std::vector<int>{3}));
+
+    EXPECT_EQ(snapshot.size(), 2u);
+    EXPECT_EQ(snapshot.find(first)->getGroupIndex(), "G1");
+    ASSERT_NE(snapshot.find(second), nullptr);
+    EXPECT_EQ(dynamic_cast<const SeniorStudent &>(*snapshot.find(second)).getResearchWork().topic, "T");
+
+    EXPECT_EQ(controller.getStudent(first)->getGroupIndex(), "G2");
+    EXPECT_EQ(controller.getStudent(second), nullptr);
+    EXPECT_EQ(controller.getTableVersion(), snapshot.version() + 4);
+    EXPECT_EQ(controller.takeSnapshot().size(), 2u);
+}
+
+TEST(SnapshotTest, OldVersionsAreReclaimedWhenSnapshotsAreReleased)
+{
+    Controller controller;
+    int id = controller.insertStudent(std::make_unique<JuniorStudent>("A", "G1", 101, std::vector<int>{5}));
+
+    std::weak_ptr<const Student> removed;
+    {
+        auto snapshot = controller.takeSnapshot();
+        removed = snapshot.find(id);
+        controller.eraseStudent(id);
+        EXPECT_FALSE(removed.expired());
+    }
+    EXPECT_TRUE(removed.expired());
+}
+
+TEST(SnapshotTest, AggregationRunsWhileWritersContinue)
+{
+    Controller controller;
+    for (int i = 0; i < 5000; ++i)
+    {
+        controller.insertStudent(std::make_unique<JuniorStudent>("S", "G" + std::to_string(i % 10), 100, std::vector<int>{4}));
+    }
+
+    auto snapshot = controller.takeSnapshot();
+    std::thread writer([&controller]()
+                       {
+        for (int i = 0; i < 2000; ++i)
+        {
+            controller.insertStudent(std::make_unique<JuniorStudent>("W", "G0", 100, std::vector<int>{2}));
+            controller.eraseStudent(i + 1);
+        } });
+    auto averages = controller.calculateAverageGradesByGroup();
+    writer.join();
+
+    // Средние вычислены по одной согласованной версии таблицы
+    for (const auto &[group, average] : averages)
+    {
+        EXPECT_TRUE(average <= 4.0 && average >= 2.0) << group;
+    }
+    size_t inSnapshot = 0;
+    snapshot.table().forEachInRange(0, snapshot.table().bucketCount(), [&](int, const auto &)
+                                    { ++inSnapshot; });
+    EXPECT_EQ(inSnapshot, 5000u);
+    EXPECT_EQ(controller.takeSnapshot().size(), 5000u);
+}
+
+TEST(QueryCacheTest, RepeatedQueriesHitUntilTableChanges)
+{
+    Controller controller;
+    fillSampleRegistry(controller);
+
+    auto first = controller.getAverageGradesByGroupCached();
+    auto second = controller.getAverageGradesByGroupCached();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(*first, controller.calculateAverageGradesByGroup());
+
+    auto stats = controller.getQueryCacheStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+
+    // Параметры запроса входят в ключ: другой K — отдельная запись
+    EXPECT_EQ(controller.getTopStudentsByAverageCached(1)->size(), 1u);
+    EXPECT_EQ(controller.getTopStudentsByAverageCached(2)->size(), 2u);
+    EXPECT_EQ(controller.getQueryCacheStats().misses, 3u);
+
+    controller.setStudentGroup(2, "IU7-12");
+    auto afterWrite = controller.getAverageGradesByGroupCached();
+    EXPECT_NE(afterWrite, first);
+    EXPECT_EQ(*afterWrite, controller.calculateAverageGradesByGroup());
+    EXPECT_EQ(controller.getQueryCacheStats().misses, 4u);
+}
+
+TEST(QueryCacheTest, CacheHitDoesNotHoldSnapshot)
+{
+    auto &copies = metrics::registry().counter("university_table_copies_total", "");
+    Controller controller;
+    fillSampleRegistry(controller);
+
+    // Живой снимок заставляет изменение скопировать таблицу
+    {
+        auto snapshot = controller.takeSnapshot();
+        uint64_t before = copies.value();
+        controller.setStudentGroup(1, "IU7-13");
+        EXPECT_EQ(copies.value() - before, 1u);
+    }
+
+    controller.getAverageGradesByGroupCached();
+    uint64_t before = copies.value();
+    auto hit = controller.getAverageGradesByGroupCached();
+    EXPECT_EQ(controller.getQueryCacheStats().hits, 1u);
+    // Результат из кэша не ссылается на таблицу: изменение после попадания выполняется на месте
+    controller.setStudentGroup(2, "IU7-12");
+    EXPECT_EQ(copies.value(), before);
+    EXPECT_NE(controller.getAverageGradesByGroupCached(), hit);
+}
+
+TEST(QueryCacheTest, StaleEntriesAreDroppedOnNewVersion)
+{
+    Controller controller;
+    fillSampleRegistry(controller);
+
+    controller.getTopStudentsByAverageCached(3);
+    controller.getAverageGradesByGroupCached();
+    EXPECT_EQ(controller.getQueryCacheStats().entries, 2u);
+
+    controller.eraseStudent(1);
+    auto top = controller.getTopStudentsByAverageCached(3);
+    EXPECT_EQ(*top, controller.calculateTopStudentsByAverage(3));
+    EXPECT_EQ(controller.getQueryCacheStats().entries, 1u);
+}
+
+TEST(BinarySnapshotTest, SaveAndLoadRoundTrip)
+{
+    Controller source;
+    fillSampleRegistry(source);
+    // Оценки вне диапазона 0..15 хранятся без упаковки
+    source.getStudentTable().insert(5, std::make_unique<JuniorStudent>("Orlov", "IU7-11B", 0, std::vector<int>{20, -1, 3}));
+
+    auto path = std::filesystem::temp_directory_path() / "registry_roundtrip.bin";
+    source.save(path);
+
+    Controller loaded;
+    loaded.load(path);
+    std::filesystem::remove(path);
+
+    auto expected = source.takeSnapshot();
+    auto actual = loaded.takeSnapshot();
+    ASSERT_EQ(actual.size(), expected.size());
+    EXPECT_EQ(loaded.calculateAverageGradesByGroup(), source.calculateAverageGradesByGroup());
+
+    auto senior = std::dynamic_pointer_cast<const SeniorStudent>(actual.find(3));
+    ASSERT_NE(senior, nullptr);
+    EXPECT_EQ(senior->getName(), "Sidorov");
+    EXPECT_EQ(senior->getSessionGrades(), (std::vector<int>{5, 5}));
+    EXPECT_EQ(senior->getResearchWork().place, "Место");
+
+    auto junior = std::dynamic_pointer_cast<const JuniorStudent>(actual.find(5));
+    ASSERT_NE(junior, nullptr);
+    EXPECT_EQ(junior->getSessionGrades(), (std::vector<int>{20, -1, 3}));
+
+    // Следующий ID не меньше максимального загруженного ID + 1
+    EXPECT_EQ(loaded.insertStudent(std::make_unique<JuniorStudent>("New", "G", 1, std::vector<int>{})), 6);
+}
+
+TEST(BinarySnapshotTest, CorruptedFileIsRejectedAndRegistryKept)
+{
+    Controller source;
+    fillSampleRegistry(source);
+    auto path = std::filesystem::temp_directory_path() / "registry_truncated.bin";
+    source.save(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+
+    Controller target;
+    fillSampleRegistry(target);
+    EXPECT_THROW(target.load(path), std::runtime_error);
+    EXPECT_EQ(target.takeSnapshot().size(), 4u);
+
+    {
+        std::ofstream garbage(path, std::ios::binary | std::ios::trunc);
+        garbage << "not a snapshot";
+    }
+    EXPECT_THROW(storage::readSnapshot(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedRegistryTest, ReadOnlyControllerAnswersFromMappedFile)
+{
+    Controller source;
+    fillSampleRegistry(source);
+    auto path = std::filesystem::temp_directory_path() / "registry_mapped.bin";
+    source.saveMapped(path);
+
+    Controller reader;
+    reader.openReadOnly(path);
+    EXPECT_TRUE(reader.isReadOnly());
+    EXPECT_EQ(reader.takeSnapshot().size(), 4u);
+
+    auto graduate = std::dynamic_pointer_cast<const GraduateStudent>(reader.getStudent(4));
+    ASSERT_NE(graduate, nullptr);
+    EXPECT_EQ(graduate->getName(), "Kuznetsov");
+    EXPECT_EQ(graduate->getGroupIndex(), "IU5-81M");
+    EXPECT_EQ(graduate->getDiplomaProject().reviewerGrade, 4);
+    EXPECT_EQ(reader.getStudent(42), nullptr);
+
+    std::vector<int> grades;
+    EXPECT_TRUE(reader.visitStudent(1, [&grades](const Student &student)
+                                    { grades = dynamic_cast<const JuniorStudent &>(student).getSessionGrades(); }));
+    EXPECT_EQ(grades, (std::vector<int>{5, 4, 3}));
+
+    auto expected = source.calculateAverageGradesByGroup();
+    EXPECT_EQ(reader.calculateAverageGradesByGroup(), expected);
+    EXPECT_EQ(reader.calculateAverageGradesByGroupMultithreaded(), expected);
+    EXPECT_EQ(*reader.getAverageGradesByGroupCached(), expected);
+
+    // Запросы, не реализованные над отображаемым файлом, отклоняются, а не возвращают пустой результат
+    std::vector<GroupingDimension> groupingSets = {GroupingDimension::GROUP};
+    EXPECT_THROW(reader.calculateAverageGradesCube(groupingSets), std::logic_error);
+    EXPECT_THROW(reader.getAverageGradesCubeCached(groupingSets), std::logic_error);
+    EXPECT_THROW(reader.calculateTopStudentsByAverage(2), std::logic_error);
+    EXPECT_THROW(reader.getTopStudentsByAverageCached(2), std::logic_error);
+    EXPECT_THROW(reader.calculateTopStudentsByAverageByGroup(2), std::logic_error);
+    EXPECT_THROW(reader.getTopStudentsByAverageByGroupCached(2), std::logic_error);
+    EXPECT_THROW(reader.findStudentIds(query::DepartmentIs{101}), std::logic_error);
+    EXPECT_THROW(reader.forEachMatchingStudent(query::DepartmentIs{101}, [](int, const Student &) {}), std::logic_error);
+
+    EXPECT_THROW(reader.insertStudent(std::make_unique<JuniorStudent>("X", "G", 1, std::vector<int>{})), std::logic_error);
+    EXPECT_THROW(reader.eraseStudent(1), std::logic_error);
+
+    // Очистка реестра возвращает его в режим записи
+    reader.clearStudentTable();
+    EXPECT_FALSE(reader.isReadOnly());
+    std::filesystem::remove(path);
+}
+
+TEST(MappedRegistryTest, TruncatedFileIsRejected)
+{
+    Controller source;
+    fillSampleRegistry(source);
+    auto path = std::filesystem::temp_directory_path() / "registry_mapped_truncated.bin";
+    source.saveMapped(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+    Controller reader;
+    EXPECT_THROW(reader.openReadOnly(path), std::runtime_error);
+    EXPECT_FALSE(reader.isReadOnly());
+    std::filesystem::remove(path);
+}
+
+// --- Тесты журнала упреждающей записи ---
+
+namespace
+{
+    // Применяет к контроллеру все виды изменений, попадающих в журнал
+    void applySampleMutations(Controller &controller)
+    {
+        controller.insertStudent(std::make_unique<JuniorStudent>("Ivanov", "IU7-11B", 101, std::vector<int>{5, 4, 3}));
+        controller.insertStudent(std::make_unique<SeniorStudent>("Sidorov", "IU7-41B", 102, std::vector<int>{5, 5},
+                                                                 ResearchWork{4, 3, "Тема", "Место"}));
+        controller.insertStudent(std::make_unique<JuniorStudent>("Petrov", "IU7-12B", 101, std::vector<int>{2}));
+        controller.eraseStudent(3);
+        controller.setStudentGroup(1, "IU7-21B");
+        controller.setStudentResearchWork(2, ResearchWork{5, 5, "Новая тема", "Кафедра"});
+        controller.replaceStudent(1, std::make_unique<GraduateStudent>("Ivanov", "IU7-21B", 101,
+                                                                      DiplomaProject{5, 4, 5, "Диплом", "НИИ"}));
+    }
+
+    void expectSampleMutationsApplied(const Controller &controller)
+    {
+        auto snapshot = controller.takeSnapshot();
+        EXPECT_EQ(snapshot.size(), 2u);
+        EXPECT_EQ(snapshot.find(3), nullptr);
+
+        auto graduate = std::dynamic_pointer_cast<const GraduateStudent>(snapshot.find(1));
+        ASSERT_NE(graduate, nullptr);
+        EXPECT_EQ(graduate->getGroupIndex(), "IU7-21B");
+        EXPECT_EQ(graduate->getDiplomaProject().place, "НИИ");
+
+        auto senior = std::dynamic_pointer_cast<const SeniorStudent>(snapshot.find(2));
+        ASSERT_NE(senior, nullptr);
+        EXPECT_EQ(senior->getResearchWork().topic, "Новая тема");
+    }
+}
+
+TEST(WriteAheadLogTest, MutationsSurviveReopen)
+{
+    auto directory = std::filesystem::temp_directory_path() / "registry_wal_reopen";
+    std::filesystem::remove_all(directory);
+    {
+        Controller controller;
+        controller.openStorage(directory, {storage::Durability::EVERY_OPERATION});
+        applySampleMutations(controller);
+        auto stats = controller.getWalStats();
+        EXPECT_EQ(stats.records, 7u);
+        EXPECT_GE(stats.syncs, 1u);
+    }
+
+    Controller reopened;
+    reopened.openStorage(directory, {storage::Durability::NONE});
+    expectSampleMutationsApplied(reopened);
+    // Следующий ID восстанавливается и после удаления последнего студента
+    EXPECT_EQ(reopened.insertStudent(std::make_unique<JuniorStudent>("New", "G", 1, std::vector<int>{})), 4);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(WriteAheadLogTest, CheckpointTruncatesLogAndTornTailIsIgnored)
+{
+    auto directory = std::filesystem::temp_directory_path() / "registry_wal_checkpoint";
+    std::filesystem::remove_all(directory);
+    {
+        Controller controller;
+        controller.openStorage(directory, {storage::Durability::INTERVAL, std::chrono::milliseconds(1)});
+        applySampleMutations(controller);
+        controller.checkpoint();
+        auto remaining = storage::WriteAheadLog::replay(directory / "registry.wal", [](const storage::WalEntry &) {});
+        EXPECT_EQ(remaining, 0u);
+
+        controller.setStudentGroup(2, "IU7-51B");
+    }
+
+    // Недописанная запись после сбоя: длина больше оставшихся данных
+    {
+        std::ofstream log(directory / "registry.wal", std::ios::binary | std::ios::app);
+        log.write("\x40\x00\x00\x00\x01\x02", 6);
+    }
+
+    Controller reopened;
+    reopened.openStorage(directory);
+    EXPECT_EQ(reopened.getStudent(2)->getGroupIndex(), "IU7-51B");
+    EXPECT_EQ(reopened.takeSnapshot().size(), 2u);
+
+    // Хвост обрезан при открытии: новые записи читаются после повторного открытия
+    reopened.eraseStudent(2);
+    reopened.checkpoint();
+    Controller last;
+    last.openStorage(directory);
+    EXPECT_EQ(last.takeSnapshot().size(), 1u);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(WriteAheadLogTest, CorruptionBeforeLastRecordIsAnError)
+{
+    auto path = std::filesystem::temp_directory_path() / "registry_wal_corrupt.wal";
+    std::filesystem::remove(path);
+    std::vector<uintmax_t> recordEnds;
+    {
+        storage::WriteAheadLog log(path, {storage::Durability::EVERY_OPERATION});
+        for (int id = 1; id <= 3; ++id)
+        {
+            log.commit(log.append(storage::WalEntry::setGroup(id, "GROUP")));
+            recordEnds.push_back(std::filesystem::file_size(path));
+        }
+    }
+    auto flipByte = [&path](uintmax_t offset)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(static_cast<std::streamoff>(offset));
+        char byte = 0;
+        file.read(&byte, 1);
+        file.seekp(static_cast<std::streamoff>(offset));
+        byte = static_cast<char>(byte ^ 0x55);
+        file.write(&byte, 1);
+    };
+
+    // Последняя запись с неверной контрольной суммой — оборванный хвост: отбрасывается
+    flipByte(recordEnds[2] - 1);
+    size_t records = storage::WriteAheadLog::replay(path, [](const storage::WalEntry &) {});
+    EXPECT_EQ(records, 2u);
+    {
+        storage::WriteAheadLog log(path, {storage::Durability::NONE});
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), recordEnds[1]);
+
+    // Повреждение перед последней записью не может быть оборванной дозаписью: журнал не открывается и не изменяется
+    flipByte(recordEnds[0] - 1);
+    EXPECT_THROW(storage::WriteAheadLog::replay(path, [](const storage::WalEntry &) {}), std::runtime_error);
+    EXPECT_THROW(storage::WriteAheadLog(path, {storage::Durability::NONE}), std::runtime_error);
+    EXPECT_EQ(std::filesystem::file_size(path), recordEnds[1]);
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, DiscardKeepsRecordsAppendedDuringCopy)
+{
+    auto path = std::filesystem::temp_directory_path() / "registry_wal_discard.wal";
+    std::filesystem::remove(path);
+    uint64_t lsn = 0;
+    {
+        storage::WriteAheadLog log(path, {storage::Durability::INTERVAL, std::chrono::milliseconds(1)});
+        for (int id = 1; id <= 2000; ++id)
+        {
+            lsn = log.append(storage::WalEntry::setGroup(id, "OLD"));
+        }
+        // Записи добавляются, пока хвост журнала копируется в новый файл
+        std::thread writer([&log]()
+                           {
+            for (int id = 1; id <= 2000; ++id)
+            {
+                log.append(storage::WalEntry::setGroup(id, "NEW"));
+            } });
+        log.discardBefore(lsn);
+        writer.join();
+    }
+
+    size_t records = 0;
+    storage::WriteAheadLog::replay(path, [&records](const storage::WalEntry &entry)
+                                   {
+        EXPECT_EQ(entry.groupIndex, "NEW");
+        EXPECT_EQ(entry.id, static_cast<int>(++records)); });
+    EXPECT_EQ(records, 2000u);
+    std::filesystem::remove(path);
+}
+
+// --- Тесты импорта CSV ---
+
+TEST(CsvImportTest, ImportsAllCategoriesAndReportsMalformedRows)
+{
+    auto path = std::filesystem::temp_directory_path() / "registry_import.csv";
+    {
+        std::ofstream csv(path, std::ios::binary);
+        csv << "category,name,group,department,grades,topic,place,supervisor_grade,second_grade,state_commission_grade\n"
+            << "junior,Ivanov,IU7-11B,101,5 4 3\n"
+            << "senior,\"Sidorov, \"\"Jr\"\"\",IU7-41B,102,5 5,Тема,Место,4,3,\r\n"
+            << "graduate,Kuznetsov,IU5-81M,102,,Диплом,НИИ,5,4,3\n"
+            << "\n"
+            << "junior,Petrov,IU7-12B,abc,5\n"
+            << "postgraduate,Orlov,IU7-11B,101,5\n"
+            << "junior,Too,Many,101,5 5 5 5 5 5\n"
+            << "senior,Smirnov,IU7-41B,102,5";
+    }
+
+    Controller controller;
+    auto report = controller.importCsv(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(report.rowsRead, 7u);
+    EXPECT_EQ(report.rowsImported, 3u);
+    EXPECT_EQ(report.malformedRows, 4u);
+    ASSERT_EQ(report.errors.size(), 4u);
+    EXPECT_EQ(report.errors[0].line, 6u);
+    EXPECT_EQ(report.errors[1].line, 7u);
+    EXPECT_EQ(report.errors[2].line, 8u);
+    EXPECT_EQ(report.errors[3].line, 9u);
+
+    auto senior = std::dynamic_pointer_cast<const SeniorStudent>(controller.getStudent(2));
+    ASSERT_NE(senior, nullptr);
+    EXPECT_EQ(senior->getName(), "Sidorov, \"Jr\"");
+    EXPECT_EQ(senior->getResearchWork().place, "Место");
+    auto graduate = std::dynamic_pointer_cast<const GraduateStudent>(controller.getStudent(3));
+    ASSERT_NE(graduate, nullptr);
+    EXPECT_EQ(graduate->getDiplomaProject().stateCommissionGrade, 3);
+}
+
+TEST(CsvImportTest, ParallelChunkedImportPreservesRowOrder)
+{
+    auto path = std::filesystem::temp_directory_path() / "registry_import.tsv";
+    {
+        std::ofstream tsv(path, std::ios::binary);
+        for (int i = 0; i < 1000; ++i)
+        {
+            tsv << "junior\tStudent" << i << "\tG" << i % 7 << "\t" << 100 + i % 3 << "\t" << i % 5 << " 5\n";
+        }
+    }
+
+    storage::CsvImportOptions options;
+    options.delimiter = '\t';
+    options.hasHeader = false;
+    options.threads = 4;
+    options.chunkSize = 100; // Меньше нескольких строк: блоки режутся посреди строк
+    Controller controller;
+    auto report = controller.importCsv(path, options);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(report.rowsImported, 1000u);
+    EXPECT_EQ(report.malformedRows, 0u);
+    ASSERT_EQ(controller.takeSnapshot().size(), 1000u);
+    for (int i : {0, 1, 499, 999})
+    {
+        EXPECT_EQ(controller.getStudent(i + 1)->getName(), "Student" + std::to_string(i));
+    }
+}
+
+// --- Тесты выгрузки ---
+
+namespace
+{
+    std::string readWholeFile(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST(RegistryExportTest, CsvExportRoundTripsThroughImport)
+{
+    Controller source;
+    fillSampleRegistry(source);
+    source.getStudentTable().insert(5, std::make_unique<JuniorStudent>("Orlov, \"Jr\"", "IU7-11B", 101, std::vector<int>{5}));
+
+    auto path = std::filesystem::temp_directory_path() / "registry_export.csv";
+    auto report = source.exportStudents(path);
+    EXPECT_EQ(report.rows, 5u);
+    EXPECT_EQ(report.bytes, std::filesystem::file_size(path));
+
+    Controller imported;
+    auto importReport = imported.importCsv(path);
+    std::filesystem::remove(path);
+    EXPECT_EQ(importReport.malformedRows, 0u);
+    EXPECT_EQ(imported.takeSnapshot().size(), 5u);
+    EXPECT_EQ(imported.calculateAverageGradesByGroup(), source.calculateAverageGradesByGroup());
+}
+
+TEST(RegistryExportTest, ParallelJsonExportMatchesSequential)
+{
+    Controller controller;
+    auto &table = controller.getStudentTable();
+    for (int id = 1; id <= 5000; ++id)
+    {
+        table.insert(id, std::make_unique<SeniorStudent>("Student\t" + std::to_string(id), "G" + std::to_string(id % 9), 100,
+                                                         std::vector<int>{id % 5, 4}, ResearchWork{5, 4, "Тема \"A\"", "Место"}));
+    }
+
+    auto sequentialPath = std::filesystem::temp_directory_path() / "registry_export_1.json";
+    auto parallelPath = std::filesystem::temp_directory_path() / "registry_export_4.json";
+    storage::ExportOptions options;
+    options.format = storage::ExportFormat::JSON;
+    controller.exportStudents(sequentialPath, options);
+    options.threads = 4;
+    options.bufferSize = 4096; // Много фрагментов
+    auto report = controller.exportStudents(parallelPath, options);
+
+    auto sequential = readWholeFile(sequentialPath);
+    EXPECT_EQ(report.rows, 5000u);
+    EXPECT_EQ(readWholeFile(parallelPath), sequential);
+    EXPECT_EQ(sequential.substr(0, 9), "[\n{\"id\":1");
+    EXPECT_NE(sequential.find("\"name\":\"Student\\u00092\""), std::string::npos);
+    EXPECT_NE(sequential.find("\"topic\":\"Тема \\\"A\\\"\""), std::string::npos);
+    EXPECT_EQ(sequential.substr(sequential.size() - 3), "\n]\n");
+
+    auto averagesPath = std::filesystem::temp_directory_path() / "registry_averages.json";
+    EXPECT_EQ(controller.exportAverageGradesByGroup(averagesPath, options).rows, 9u);
+    EXPECT_EQ(readWholeFile(averagesPath).front(), '{');
+    std::filesystem::remove(sequentialPath);
+    std::filesystem::remove(parallelPath);
+    std::filesystem::remove(averagesPath);
+}
+
+// --- Тесты постраничного просмотра ---
+
+TEST(StudentCursorTest, PagesCoverSnapshotOnceWhileWritersProceed)
+{
+    Controller controller;
+    std::vector<std::unique_ptr<Student>> students;
+    for (int i = 0; i < 103; ++i)
+    {
+        students.push_back(std::make_unique<JuniorStudent>("Student" + std::to_string(i), "G1", 100, std::vector<int>{4}));
+    }
+    controller.insertStudents(std::move(students));
+
+    auto cursor = controller.openStudentCursor();
+    std::set<int> seen;
+    size_t pages = 0;
+    while (!cursor.done())
+    {
+        auto page = cursor.next(10);
+        ASSERT_FALSE(page.empty());
+        EXPECT_LE(page.size(), 10u);
+        ++pages;
+        for (const auto &[id, student] : page)
+        {
+            EXPECT_TRUE(seen.insert(id).second);
+            EXPECT_EQ(student->getName(), "Student" + std::to_string(id - 1));
+        }
+
+        // Между страницами курсор не удерживает блокировку: изменения проходят и в курсоре не видны
+        std::vector<std::unique_ptr<Student>> extra;
+        extra.push_back(std::make_unique<JuniorStudent>("Late", "G2", 100, std::vector<int>{5}));
+        controller.insertStudents(std::move(extra));
+    }
+    EXPECT_EQ(pages, 11u);
+    EXPECT_EQ(seen.size(), 103u);
+    EXPECT_EQ(*seen.rbegin(), 103);
+    EXPECT_TRUE(cursor.next(10).empty());
+    EXPECT_EQ(controller.takeSnapshot().size(), 103u + pages);
+}
+
+TEST(StudentCursorTest, PagesMappedRegistry)
+{
+    Controller source;
+    fillSampleRegistry(source);
+    auto path = std::filesystem::temp_directory_path() / "registry_cursor.bin";
+    source.saveMapped(path);
+
+    Controller reader;
+    reader.openReadOnly(path);
+    auto cursor = reader.openStudentCursor();
+    auto first = cursor.next(3);
+    auto second = cursor.next(3);
+    EXPECT_EQ(first.size(), 3u);
+    EXPECT_EQ(second.size(), 1u);
+    EXPECT_TRUE(cursor.done());
+    EXPECT_EQ(cursor.returned(), 4u);
+    EXPECT_EQ(reader.getStudent(second[0].first)->getName(), second[0].second->getName());
+    std::filesystem::remove(path);
+}
+
+// --- Тесты генератора данных ---
+
+TEST(StudentGeneratorTest, OutputDoesNotDependOnThreadCount)
+{
+    datagen::GeneratorOptions single;
+    single.threads = 1;
+    datagen::GeneratorOptions parallel;
+    parallel.threads = 3;
+    const size_t count = 3 * datagen::GENERATOR_BLOCK_SIZE + 17; // Неполный последний блок
+
+    auto expected = datagen::generateStudents(count, 1, single);
+    auto actual = datagen::generateStudents(count, 1, parallel);
+    ASSERT_EQ(actual.size(), count);
+    std::set<StudentCategory> categories;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ASSERT_NE(actual[i], nullptr);
+        EXPECT_EQ(actual[i]->getCategory(), expected[i]->getCategory());
+        EXPECT_EQ(actual[i]->getName(), expected[i]->getName());
+        EXPECT_EQ(actual[i]->getGroupIndex(), expected[i]->getGroupIndex());
+        EXPECT_EQ(actual[i]->getDepartmentNumber(), 100 + static_cast<int>(i + 1) % 20);
+        categories.insert(actual[i]->getCategory());
+    }
+    EXPECT_EQ(categories.size(), 3u);
+
+    single.seed = 7;
+    auto reseeded = datagen::generateStudents(64, 1, single);
+    EXPECT_FALSE(std::equal(reseeded.begin(), reseeded.end(), expected.begin(), [](const auto &a, const auto &b)
+                            { return a->getName() == b->getName(); }));
+}
+
+TEST(StudentGeneratorTest, PopulateTableMatchesGeneratedStudents)
+{
+    Controller generated;
+    datagen::populateTable(generated.getStudentTable(), 10000);
+    EXPECT_EQ(generated.takeSnapshot().size(), 10000u);
+
+    // Тот же реестр через пакетное добавление в контроллер
+    Controller inserted;
+    EXPECT_EQ(inserted.insertStudents(datagen::generateStudents(10000)), 1);
+    for (int id : {1, 4096, 4097, 10000})
+    {
+        EXPECT_EQ(generated.getStudent(id)->getName(), inserted.getStudent(id)->getName());
+    }
+    EXPECT_EQ(generated.calculateAverageGradesByGroup(), inserted.calculateAverageGradesByGroup());
+}
+
+// --- Тесты средств бенчмарка ---
+
+TEST(BenchHarnessTest, SummarizeComputesOrderStatistics)
+{
+    std::vector<double> samples;
+    for (int i = 20; i >= 1; --i)
+    {
+        samples.push_back(i);
+    }
+    auto stats = bench::summarize(samples);
+    EXPECT_EQ(stats.samples, samples);
+    EXPECT_DOUBLE_EQ(stats.min, 1.0);
+    EXPECT_DOUBLE_EQ(stats.max, 20.0);
+    EXPECT_DOUBLE_EQ(stats.median, 10.5);
+    EXPECT_DOUBLE_EQ(stats.p95, 19.0);
+    EXPECT_DOUBLE_EQ(stats.mean, 10.5);
+    EXPECT_NEAR(stats.stddev, 5.916, 1e-3);
+    EXPECT_DOUBLE_EQ(bench::summarize({}).median, 0.0);
+
+    int calls = 0;
+    auto measurement = bench::measure({3, 5}, [&]() { ++calls; });
+    EXPECT_EQ(calls, 8);
+    EXPECT_EQ(measurement.wallMs.samples.size(), 5u);
+    EXPECT_GE(measurement.cpuMs.min, 0.0);
+}
+
+TEST(BenchHarnessTest, SetupRunsBeforeEveryRepetition)
+{
+    std::vector<int> data;
+    size_t setups = 0;
+    auto measurement = bench::measure({1, 4}, [&]()
+                                      {
+                                          ++setups;
+                                          data.assign(100, 1);
+                                      },
+                                      [&]()
+                                      {
+                                          EXPECT_EQ(data.size(), 100u);
+                                          data.clear();
+                                      });
+    EXPECT_EQ(setups, 5u);
+    EXPECT_TRUE(data.empty());
+    EXPECT_EQ(measurement.wallMs.samples.size(), 4u);
+}
+
+TEST(BenchHarnessTest, ParsesCommandLineSelection)
+{
+    const std::vector<std::string> suites = {"averages", "export"};
+    const std::vector<std::string> modes = {"single", "multi"};
+    const char *argv[] = {"benchmark", "--sizes", "100,2000", "--modes", "multi", "--threads", "1,4",
+                          "--seeds", "7", "--suites", "export", "--repetitions", "3", "--output", "out"};
+    auto options = bench::parseBenchOptions(15, argv, {}, suites, modes);
+    EXPECT_EQ(options.sizes, (std::vector<size_t>{100, 2000}));
+    EXPECT_EQ(options.modes, std::vector<std::string>{"multi"});
+    EXPECT_EQ(options.threadCounts(), (std::vector<unsigned>{1, 4}));
+    EXPECT_EQ(options.seeds, std::vector<uint64_t>{7});
+    EXPECT_TRUE(options.selected("export"));
+    EXPECT_FALSE(options.selected("averages"));
+    EXPECT_EQ(options.run.repetitions, 3u);
+    EXPECT_EQ(options.outputDirectory, "out");
+
+    const char *unknownMode[] = {"benchmark", "--modes", "gpu"};
+    EXPECT_THROW(bench::parseBenchOptions(3, unknownMode, {}, suites, modes), std::invalid_argument);
+    const char *missingValue[] = {"benchmark", "--sizes"};
+    EXPECT_THROW(bench::parseBenchOptions(2, missingValue, {}, suites, modes), std::invalid_argument);
+    EXPECT_TRUE(bench::parseBenchOptions(1, argv, {}, suites, modes).selected("averages"));
+}
+
+TEST(LatencyHistogramTest, PercentilesStayWithinRelativeError)
+{
+    bench::LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value)
+    {
+        histogram.record(value * 1000);
+    }
+    EXPECT_EQ(histogram.count(), 100000u);
+    EXPECT_EQ(histogram.min(), 1000u);
+    EXPECT_EQ(histogram.max(), 100000000u);
+    EXPECT_NEAR(histogram.mean(), 50000500.0, 1e-6);
+    for (double percentile : {50.0, 99.0, 99.9})
+    {
+        double exact = percentile * 1000.0 * 1000.0;
+        auto value = static_cast<double>(histogram.percentile(percentile));
+        EXPECT_GE(value, exact);
+        EXPECT_LE(value, exact * (1.0 + 1.0 / bench::LatencyHistogram::SUB_BUCKETS));
+    }
+    EXPECT_EQ(histogram.percentile(100.0), histogram.max());
+
+    bench::LatencyHistogram small;
+    small.record(7);
+    small.record(0);
+    EXPECT_EQ(small.percentile(50.0), 0u);
+    EXPECT_EQ(small.percentile(99.0), 7u);
+    EXPECT_EQ(bench::LatencyHistogram().percentile(99.0), 0u);
+}
+
+TEST(LatencyHistogramTest, MergeMatchesSingleHistogram)
+{
+    bench::LatencyHistogram combined;
+    std::vector<bench::LatencyHistogram> perThread(4);
+    std::mt19937_64 gen(3);
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint64_t value = gen() % 5000000;
+        combined.record(value);
+        perThread[static_cast<size_t>(i) % perThread.size()].record(value);
+    }
+    bench::LatencyHistogram merged;
+    for (const auto &histogram : perThread)
+    {
+        merged.merge(histogram);
+    }
+    EXPECT_EQ(merged.count(), combined.count());
+    EXPECT_EQ(merged.min(), combined.min());
+    EXPECT_EQ(merged.max(), combined.max());
+    for (double percentile : {1.0, 50.0, 99.0, 99.9})
+    {
+        EXPECT_EQ(merged.percentile(percentile), combined.percentile(percentile));
+    }
+}
+
+TEST(MemoryAccountingTest, ScopeCountsAllocationsOfAllThreads)
+{
+    bench::AllocationScope scope;
+    auto buffer = std::make_unique<std::vector<char>>(100000);
+    std::thread([]()
+                { std::vector<int> local(1000); })
+        .join();
+    auto delta = scope.delta();
+    EXPECT_GE(delta.allocations, 3u);
+    EXPECT_GE(delta.bytesAllocated, 100000u + 4000u);
+    EXPECT_GE(delta.liveBytes(), 100000);
+
+    buffer.reset();
+    EXPECT_LT(scope.delta().liveBytes(), delta.liveBytes() - 99999);
+    EXPECT_GT(bench::processMemory().peakRssBytes, 0u);
+}
+
+TEST(MemoryAccountingTest, FootprintSplitsStudentByComponent)
+{
+    JuniorStudent junior(std::string(100, 'N'), "G1", 101, std::vector<int>{5, 4, 3});
+    auto footprint = footprintOf(junior);
+    EXPECT_EQ(footprint.object, sizeof(JuniorStudent));
+    EXPECT_GE(footprint.strings, 101u); // Короткий индекс группы хранится в самой строке
+    EXPECT_EQ(footprint.grades, junior.getSessionGrades().capacity() * sizeof(int));
+    EXPECT_EQ(footprint.heapAllocations, 3u);
+
+    GraduateStudent graduate("Ivanov", "G1", 101, DiplomaProject{5, 4, 5, "T", "P"});
+    auto graduateFootprint = footprintOf(graduate);
+    EXPECT_EQ(graduateFootprint.object, sizeof(GraduateStudent));
+    EXPECT_EQ(graduateFootprint.strings, 0u);
+    EXPECT_EQ(graduateFootprint.grades, 0u);
+
+    HashTable<int, int> table;
+    table.reserve(1000);
+    EXPECT_GE(table.slotBytes(), table.bucketCount() * sizeof(int));
+}
+
+TEST(PerfCountersTest, MeasureCollectsCountersOrDegradesGracefully)
+{
+    bench::PerfCounters counters;
+    bench::RunConfig config{0, 3, &counters};
+    std::vector<int> values(100000, 1);
+    long sum = 0;
+    auto measurement = bench::measure(config, [&]()
+                                      { sum = std::accumulate(values.begin(), values.end(), sum); });
+    EXPECT_EQ(sum, 300000);
+    EXPECT_EQ(measurement.wallMs.samples.size(), 3u);
+    if (counters.available())
+    {
+        EXPECT_TRUE(measurement.counters.any());
+    }
+    else
+    {
+        // Без прав на perf_event_open замер выполняется как обычно
+        EXPECT_FALSE(counters.unavailableReason().empty());
+        EXPECT_FALSE(measurement.counters.any());
+        EXPECT_EQ(bench::formatPerfCounts(measurement.counters, values.size()), "аппаратные счётчики недоступны");
+    }
+}
+
+TEST(PerfCountersTest, AverageKeepsOnlyCountersValidInEveryRun)
+{
+    bench::PerfCounts first;
+    first.values = {1000, 2000, 10, 4, 6};
+    first.valid = {true, true, true, false, true};
+    bench::PerfCounts second = first;
+    second.values = {3000, 6000, 30, 0, 2};
+    second.valid[static_cast<size_t>(bench::PerfEvent::BRANCH_MISSES)] = false;
+
+    auto average = bench::averageCounts({first, second});
+    EXPECT_EQ(average.get(bench::PerfEvent::CYCLES), 2000u);
+    EXPECT_EQ(average.get(bench::PerfEvent::INSTRUCTIONS), 4000u);
+    EXPECT_DOUBLE_EQ(average.ipc(), 2.0);
+    EXPECT_DOUBLE_EQ(average.perItem(bench::PerfEvent::L1D_MISSES, 10), 2.0);
+    EXPECT_FALSE(average.has(bench::PerfEvent::LLC_MISSES));
+    EXPECT_FALSE(average.has(bench::PerfEvent::BRANCH_MISSES));
+    EXPECT_DOUBLE_EQ(average.perItem(bench::PerfEvent::BRANCH_MISSES, 10), -1.0);
+    EXPECT_FALSE(bench::averageCounts({}).any());
+}
+
+TEST(TraceTest, RingBufferKeepsNewestSpansAndIgnoresDisabledTracing)
+{
+    trace::start(4);
+    for (int i = 0; i < 10; ++i)
+    {
+        trace::Span span("test", "step", "i", i);
+    }
+    trace::stop();
+    {
+        trace::Span ignored("test", "after_stop");
+    }
+
+    auto events = trace::collect();
+    ASSERT_EQ(events.size(), 4u);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        EXPECT_STREQ(events[i].name, "step");
+        EXPECT_EQ(events[i].argValue, static_cast<int64_t>(6 + i));
+    }
+    EXPECT_EQ(trace::droppedEvents(), 6u);
+}
+
+TEST(TraceTest, ControllerOperationsExportAsChromeTrace)
+{
+#if UNIVERSITY_TRACING
+    Controller controller;
+    trace::start();
+    controller.insertStudents(datagen::generateStudents(20000, 1, {}));
+    controller.calculateAverageGradesByGroupMultithreaded(2);
+    trace::stop();
+
+    std::set<std::string> names;
+    for (const auto &event : trace::collect())
+    {
+        names.insert(event.name);
+    }
+    EXPECT_TRUE(names.count("insert_batch"));
+    EXPECT_TRUE(names.count("rehash"));
+    EXPECT_TRUE(names.count("averages_multithreaded"));
+    EXPECT_TRUE(names.count("worker"));
+
+    std::ostringstream json;
+    trace::writeChromeTrace(json);
+    EXPECT_NE(json.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\": \"rehash\", \"cat\": \"hashtable\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"args\": {\"slots\": "), std::string::npos);
+#else
+    GTEST_SKIP() << "Трассировка отключена при сборке (ENABLE_TRACING=OFF)";
+#endif
+}
+
+TEST(MetricsTest, ShardedMetricsSumAcrossThreadsInPrometheusFormat)
+{
+    metrics::Registry registry;
+    auto &counter = registry.counter("test_ops_total", "Операции");
+    auto &histogram = registry.histogram("test_latency_seconds", "Задержка", "kind=\"a\"");
+    EXPECT_EQ(&registry.counter("test_ops_total", "Операции"), &counter);
+    EXPECT_THROW(registry.gauge("test_ops_total", "Операции"), std::invalid_argument);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int i = 0; i < 1000; ++i)
+            {
+                counter.add();
+            }
+            histogram.observe(100); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    histogram.observe(1000000);
+    EXPECT_EQ(counter.value(), 4000u);
+
+    EXPECT_EQ(metrics::Histogram::bucketIndex(0), 0u);
+    EXPECT_EQ(metrics::Histogram::bucketIndex(256), 0u);
+    EXPECT_EQ(metrics::Histogram::bucketIndex(257), 1u);
+    EXPECT_EQ(metrics::Histogram::bucketIndex(UINT64_MAX), metrics::Histogram::BUCKETS);
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 5u);
+    EXPECT_EQ(snapshot.buckets[0], 4u);
+    EXPECT_EQ(snapshot.sumNs, 1000400u);
+
+    std::ostringstream text;
+    registry.writePrometheus(text);
+    EXPECT_NE(text.str().find("# TYPE test_ops_total counter\ntest_ops_total 4000\n"), std::string::npos);
+    EXPECT_NE(text.str().find("# TYPE test_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.str().find("test_latency_seconds_bucket{kind=\"a\",le=\"2.56e-07\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.str().find("test_latency_seconds_bucket{kind=\"a\",le=\"+Inf\"} 5\n"), std::string::npos);
+    EXPECT_NE(text.str().find("test_latency_seconds_count{kind=\"a\"} 5\n"), std::string::npos);
+}
+
+TEST(MetricsTest, ControllerOperationsUpdateRegistryAndExporterDumpsOnRequest)
+{
+    auto &registry = metrics::registry();
+    auto &added = registry.counter("university_students_added_total", "");
+    auto &removed = registry.counter("university_students_removed_total", "");
+    auto &hits = registry.counter("university_student_finds_total", "", "result=\"hit\"");
+    auto &misses = registry.counter("university_student_finds_total", "", "result=\"miss\"");
+    auto &aggregations = registry.counter("university_aggregations_total", "");
+    auto &rehashes = registry.counter("university_hashtable_rehashes_total", "");
+    uint64_t addedBefore = added.value();
+    uint64_t removedBefore = removed.value();
+    uint64_t hitsBefore = hits.value();
+    uint64_t missesBefore = misses.value();
+    uint64_t aggregationsBefore = aggregations.value();
+    uint64_t rehashesBefore = rehashes.value();
+    auto &findLatency = registry.histogram("university_operation_duration_seconds", "", "operation=\"find\"");
+    uint64_t findsBefore = findLatency.snapshot().count;
+
+    Controller controller;
+    int firstId = controller.insertStudents(datagen::generateStudents(5000, 1, {}));
+    EXPECT_TRUE(controller.getStudent(firstId));
+    EXPECT_FALSE(controller.getStudent(-1));
+    EXPECT_TRUE(controller.visitStudent(firstId, [](const Student &) {}));
+    EXPECT_TRUE(controller.eraseStudent(firstId));
+    controller.calculateAverageGradesByGroup();
+    controller.getAverageGradesByGroupCached();
+    controller.getAverageGradesByGroupCached();
+
+    EXPECT_EQ(added.value() - addedBefore, 5000u);
+    EXPECT_EQ(removed.value() - removedBefore, 1u);
+    EXPECT_EQ(hits.value() - hitsBefore, 2u);
+    EXPECT_EQ(misses.value() - missesBefore, 1u);
+    EXPECT_EQ(findLatency.snapshot().count - findsBefore, 3u); // visitStudent замеряется как getStudent
+    EXPECT_EQ(aggregations.value() - aggregationsBefore, 2u); // Второй запрос из кэша
+    EXPECT_GT(rehashes.value(), rehashesBefore);
+    EXPECT_EQ(registry.gauge("university_students", "").value(), 4999);
+
+    auto path = std::filesystem::temp_directory_path() / "university_metrics_test.prom";
+    {
+        metrics::MetricsExporter exporter(path, std::chrono::milliseconds(0));
+        metrics::MetricsExporter::requestDump();
+        for (int i = 0; i < 100 && exporter.dumps() == 0; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        EXPECT_GE(exporter.dumps(), 1u);
+        EXPECT_TRUE(exporter.lastError().empty());
+    }
+    std::ifstream file(path);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(contents.find("\nuniversity_students 4999\n"), std::string::npos);
+    EXPECT_NE(contents.find("university_operation_duration_seconds_count{operation=\"insert_batch\"}"), std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST(MutationBatchTest, AppliesCommandsInOrderAndSurvivesReopen)
+{
+    auto directory = std::filesystem::temp_directory_path() / "registry_batch_reopen";
+    std::filesystem::remove_all(directory);
+    {
+        Controller controller;
+        controller.openStorage(directory, {storage::Durability::EVERY_OPERATION});
+        controller.insertStudent(std::make_unique<JuniorStudent>("A", "G1", 1, std::vector<int>{5}));
+        controller.insertStudent(std::make_unique<SeniorStudent>("B", "G1", 1, std::vector<int>{4}, ResearchWork{5, 5, "T", "P"}));
+
+        std::vector<MutationCommand> commands;
+        commands.push_back(MutationCommand::add(std::make_unique<JuniorStudent>("C", "G2", 1, std::vector<int>{3})));
+        commands.push_back(MutationCommand::setGroup(3, "G3")); // Студент, добавленный этим же пакетом
+        commands.push_back(MutationCommand::setResearchWork(2, ResearchWork{4, 4, "New", "Lab"}));
+        commands.push_back(MutationCommand::remove(1));
+        commands.push_back(MutationCommand::replace(2, std::make_unique<JuniorStudent>("B", "G4", 1, std::vector<int>{2})));
+        auto &researchWorkChanges = metrics::registry().counter("university_student_research_work_changes_total", "");
+        uint64_t researchWorkChangesBefore = researchWorkChanges.value();
+        auto batch = controller.applyBatch(commands);
+        EXPECT_EQ(researchWorkChanges.value() - researchWorkChangesBefore, 1u);
+
+        ASSERT_TRUE(batch.applied);
+        ASSERT_EQ(batch.results.size(), 5u);
+        for (const auto &result : batch.results)
+        {
+            EXPECT_EQ(result.status, MutationStatus::APPLIED);
+        }
+        EXPECT_EQ(batch.results[0].id, 3);
+        EXPECT_EQ(controller.getWalStats().records, 3u); // Пакет — одна запись журнала
+    }
+
+    Controller reopened;
+    reopened.openStorage(directory, {storage::Durability::NONE});
+    EXPECT_FALSE(reopened.getStudent(1));
+    EXPECT_EQ(reopened.getStudent(2)->getCategory(), StudentCategory::JUNIOR);
+    EXPECT_EQ(reopened.getStudent(2)->getGroupIndex(), "G4");
+    EXPECT_EQ(reopened.getStudent(3)->getGroupIndex(), "G3");
+    EXPECT_EQ(reopened.insertStudent(std::make_unique<JuniorStudent>("D", "G", 1, std::vector<int>{})), 4);
+    reopened.insertStudent(std::make_unique<SeniorStudent>("E", "G", 1, std::vector<int>{4}, ResearchWork{5, 5, "T", "P"}));
+    auto &researchWorkChanges = metrics::registry().counter("university_student_research_work_changes_total", "");
+    uint64_t researchWorkChangesBefore = researchWorkChanges.value();
+    EXPECT_TRUE(reopened.setStudentResearchWork(5, ResearchWork{3, 3, "Other", "Lab"}));
+    EXPECT_FALSE(reopened.setStudentResearchWork(4, ResearchWork{3, 3, "Other", "Lab"})); // Не старшекурсник
+    EXPECT_EQ(researchWorkChanges.value() - researchWorkChangesBefore, 1u);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(MutationBatchTest, TornBatchRecordIsDiscardedWhole)
+{
+    auto directory = std::filesystem::temp_directory_path() / "registry_batch_torn";
+    std::filesystem::remove_all(directory);
+    uintmax_t sizeBeforeBatch = 0;
+    {
+        Controller controller;
+        controller.openStorage(directory, {storage::Durability::EVERY_OPERATION});
+        controller.insertStudent(std::make_unique<JuniorStudent>("A", "G1", 1, std::vector<int>{5}));
+        sizeBeforeBatch = std::filesystem::file_size(directory / "registry.wal");
+
+        std::vector<MutationCommand> commands;
+        commands.push_back(MutationCommand::setGroup(1, "G2"));
+        commands.push_back(MutationCommand::add(std::make_unique<JuniorStudent>("B", "G1", 1, std::vector<int>{4})));
+        commands.push_back(MutationCommand::remove(1));
+        ASSERT_TRUE(controller.applyBatch(commands).applied);
+    }
+
+    // Сбой при записи пакета: на диск попала только часть записи
+    auto path = directory / "registry.wal";
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    ASSERT_GT(std::filesystem::file_size(path), sizeBeforeBatch);
+
+    Controller reopened;
+    reopened.openStorage(directory, {storage::Durability::NONE});
+    ASSERT_TRUE(reopened.getStudent(1));
+    EXPECT_EQ(reopened.getStudent(1)->getGroupIndex(), "G1");
+    EXPECT_FALSE(reopened.getStudent(2));
+    EXPECT_EQ(reopened.takeSnapshot().size(), 1u);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(MutationBatchTest, InvalidCommandRejectsWholeBatch)
+{
+    Controller controller;
+    controller.insertStudent(std::make_unique<JuniorStudent>("A", "G1", 1, std::vector<int>{5}));
+    auto versionBefore = controller.takeSnapshot().version();
+
+    std::vector<MutationCommand> commands;
+    commands.push_back(MutationCommand::add(std::make_unique<JuniorStudent>("B", "G2", 1, std::vector<int>{4})));
+    commands.push_back(MutationCommand::setGroup(1, "G9"));
+    commands.push_back(MutationCommand::remove(1));
+    commands.push_back(MutationCommand::remove(1)); // Уже удалён предыдущей командой
+    commands.push_back(MutationCommand::setResearchWork(2, ResearchWork{5, 5, "T", "P"}));
+    commands.push_back(MutationCommand::add(nullptr));
+    auto batch = controller.applyBatch(commands);
+
+    EXPECT_FALSE(batch.applied);
+    std::vector<MutationStatus> statuses;
+    for (const auto &result : batch.results)
+    {
+        statuses.push_back(result.status);
+    }
+    EXPECT_EQ(statuses, (std::vector<MutationStatus>{MutationStatus::NOT_APPLIED, MutationStatus::NOT_APPLIED,
+                                                      MutationStatus::NOT_APPLIED, MutationStatus::NOT_FOUND,
+                                                      MutationStatus::NOT_SENIOR, MutationStatus::INVALID}));
+    EXPECT_EQ(batch.results[0].id, 0);
+    EXPECT_EQ(controller.takeSnapshot().version(), versionBefore);
+    EXPECT_EQ(controller.getStudent(1)->getGroupIndex(), "G1");
+    EXPECT_FALSE(controller.getStudent(2));
+    EXPECT_EQ(controller.insertStudent(std::make_unique<JuniorStudent>("C", "G", 1, std::vector<int>{})), 2);
+}
+
+TEST(CommandScriptTest, ParsesCommandsAndRejectsMalformedOnes)
+{
+    auto group = parseScriptCommand("GROUP 12 IU7-31B");
+    EXPECT_EQ(group.type, ScriptCommandType::GROUP);
+    EXPECT_EQ(group.id, 12);
+    EXPECT_EQ(group.argument, "IU7-31B");
+    auto add = parseScriptCommand("ADD junior,Иванов Иван,IU7-11B,101,5 4");
+    EXPECT_EQ(add.type, ScriptCommandType::ADD);
+    EXPECT_EQ(add.argument, "junior,Иванов Иван,IU7-11B,101,5 4");
+    EXPECT_EQ(parseScriptCommand("FIND 7").id, 7);
+
+    EXPECT_THROW(parseScriptCommand("FIND x"), std::invalid_argument);
+    EXPECT_THROW(parseScriptCommand("REMOVE 1 2"), std::invalid_argument);
+    EXPECT_THROW(parseScriptCommand("AVG"), std::invalid_argument);
+    EXPECT_THROW(parseScriptCommand("DROP 1"), std::invalid_argument);
+
+    auto work = parseScriptCommand("WORK 3 5,4,Тема,Кафедра");
+    EXPECT_EQ(work.type, ScriptCommandType::WORK);
+    EXPECT_EQ(work.id, 3);
+    auto research = parseResearchWork(work.argument);
+    EXPECT_EQ(research.supervisorGrade, 5);
+    EXPECT_EQ(research.commissionGrade, 4);
+    EXPECT_EQ(research.place, "Кафедра");
+    EXPECT_THROW(parseResearchWork("5,4,Тема"), std::invalid_argument);
+    EXPECT_THROW(parseResearchWork("5,x,Тема,Место"), std::invalid_argument);
+}
+
+TEST(CommandScriptTest, RejectedChangeAnswersErrorWithReason)
+{
+    std::istringstream script(
+        "ADD junior,A,G1,101,5\n"
+        "ADD senior,B,G1,101,3,Тема,Место,4,4\n"
+        "WORK 1 5,5,Новая,Лаб\n"
+        "WORK 2 5,5,Новая,Лаб\n"
+        "WORK 7 5,5,Новая,Лаб\n");
+    std::ostringstream out;
+    Controller controller;
+    auto report = runCommandScript(controller, script, out);
+
+    // Отклонённая команда не отменяет соседние и не отвечает OK
+    EXPECT_EQ(out.str(), "OK\t1\n"
+                         "OK\t2\n"
+                         "ERROR 3: not senior\n"
+                         "OK\n"
+                         "NOT_FOUND\n");
+    EXPECT_EQ(report.errors, 1u);
+    auto senior = std::dynamic_pointer_cast<const SeniorStudent>(controller.getStudent(2));
+    ASSERT_NE(senior, nullptr);
+    EXPECT_EQ(senior->getResearchWork().topic, "Новая");
+}
+
+TEST(CommandScriptTest, ExecutesScriptInOrderAcrossChunks)
+{
+    std::istringstream script(
+        "# комментарий\n"
+        "ADD junior,A,G1,101,5 5\n"
+        "ADD senior,B,G1,101,3,Тема,Место,4,4\r\n"
+        "AVG G1\n"
+        "\n"
+        "GROUP 1 G2\n"
+        "REMOVE 9\n"
+        "FIND 1\n"
+        "ADD unknown,C,G1,101,5\n"
+        "REMOVE 2\n"
+        "FIND 2\n"
+        "AVG G1");
+    std::ostringstream out;
+    Controller controller;
+    ScriptOptions options;
+    options.chunkSize = 16; // Строки длиннее блока и разрезанные между блоками
+    auto report = runCommandScript(controller, script, out, options);
+
+    EXPECT_EQ(out.str(), "OK\t1\n"
+                         "OK\t2\n"
+                         "OK\t4.2\n"
+                         "OK\n"
+                         "NOT_FOUND\n"
+                         "OK\t1\tjunior\tA\tG2\t101\t5\n"
+                         "ERROR 9: неизвестная категория студента\n"
+                         "OK\n"
+                         "NOT_FOUND\n"
+                         "NOT_FOUND\n");
+    EXPECT_EQ(report.commands, 10u);
+    EXPECT_EQ(report.errors, 1u);
+}
+
+TEST(RegistryServerTest, ParsesAddresses)
+{
+    using university::server::ServerAddress;
+    auto unixAddress = ServerAddress::parse("unix:/tmp/registry.sock");
+    EXPECT_EQ(unixAddress.unixPath, "/tmp/registry.sock");
+    EXPECT_EQ(ServerAddress::parse("/tmp/registry.sock").unixPath, "/tmp/registry.sock");
+    auto tcpAddress = ServerAddress::parse("tcp:7400");
+    EXPECT_TRUE(tcpAddress.unixPath.empty());
+    EXPECT_EQ(tcpAddress.tcpPort, 7400);
+    EXPECT_EQ(tcpAddress.toString(), "tcp:7400");
+    EXPECT_EQ(unixAddress.toString(), "unix:/tmp/registry.sock");
+
+    EXPECT_THROW(ServerAddress::parse(""), std::invalid_argument);
+    EXPECT_THROW(ServerAddress::parse("tcp:"), std::invalid_argument);
+    EXPECT_THROW(ServerAddress::parse("tcp:70000"), std::invalid_argument);
+}
+
+TEST(RegistryServerTest, AnswersPipelinedRequestsInOrder)
+{
+    using namespace university::server;
+    auto path = std::filesystem::temp_directory_path() / "registry_server_test.sock";
+    Controller controller;
+    {
+        ServerOptions options;
+        options.address.unixPath = path.string();
+        options.workers = 2;
+        RegistryServer server(controller, options);
+        std::thread loop([&server]() { server.run(); });
+
+        RegistryClient writer(server.address());
+        RegistryClient reader(server.address());
+        for (int i = 0; i < 200; ++i)
+        {
+            writer.send("ADD junior,Student" + std::to_string(i) + ",G1,101,5 4");
+        }
+        writer.send("# комментарий без ответа");
+        writer.send("GROUP 1 G2");
+        writer.send("FIND 1");
+        writer.send("FIND x");
+        for (int i = 0; i < 200; ++i)
+        {
+            EXPECT_EQ(writer.receive(), "OK\t" + std::to_string(i + 1));
+        }
+        EXPECT_EQ(writer.receive(), "OK");
+        EXPECT_EQ(writer.receive(), "OK\t1\tjunior\tStudent0\tG2\t101\t4.5");
+        EXPECT_EQ(writer.receive().rfind("ERROR 204: ", 0), 0u);
+
+        // Второе соединение видит изменения первого
+        EXPECT_EQ(reader.request("AVG G1"), "OK\t4.5");
+        EXPECT_EQ(reader.request("REMOVE 200"), "OK");
+        EXPECT_EQ(reader.request("FIND 200"), "NOT_FOUND");
+
+        server.stop();
+        loop.join();
+    }
+    EXPECT_TRUE(controller.getStudent(199));
+    EXPECT_FALSE(controller.getStudent(200));
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(RegistryServerTest, RejectsRequestLongerThanBuffer)
+{
+    using namespace university::server;
+    Controller controller;
+    ServerOptions options;
+    options.address.unixPath = (std::filesystem::temp_directory_path() / "registry_server_long.sock").string();
+    options.workers = 1;
+    options.maxBufferedBytes = 1024;
+    RegistryServer server(controller, options);
+    std::thread loop([&server]() { server.run(); });
+
+    RegistryClient client(server.address());
+    EXPECT_EQ(client.request("FIND 1"), "NOT_FOUND");
+    // Строка длиннее одного чтения сервера: буфер заполняется раньше, чем приходит перевод строки
+    client.send("FIND 1 " + std::string(100000, 'x'));
+    EXPECT_EQ(client.receive(), "ERROR 2: request too long");
+    EXPECT_THROW(client.receive(), std::runtime_error);
+
+    server.stop();
+    loop.join();
+}
+
+TEST(RegistryServerTest, StopSignalWakesBlockedLoop)
+{
+    using namespace university::server;
+    Controller controller;
+    ServerOptions options;
+    options.address.unixPath = (std::filesystem::temp_directory_path() / "registry_server_signal.sock").string();
+    options.workers = 1;
+    RegistryServer server(controller, options);
+    RegistryServer::installStopSignalHandler(SIGUSR2);
+    auto loop = std::async(std::launch::async, [&server]() { server.run(); });
+
+    {
+        // Ответ означает, что цикл запущен и ждёт в epoll_wait
+        RegistryClient client(server.address());
+        EXPECT_EQ(client.request("FIND 1"), "NOT_FOUND");
+    }
+    std::raise(SIGUSR2);
+    bool stopped = loop.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    if (!stopped)
+    {
+        server.stop();
+    }
+    loop.get();
+    std::signal(SIGUSR2, SIG_DFL);
+    EXPECT_TRUE(stopped);
+}
+
+namespace
+{
+    // Условие, которое ждёт открытия ворот и может запросить остановку при первом вызове
+    struct GatePredicate
+    {
+        static constexpr int COST = query::COST_PAYLOAD;
+        std::shared_future<void> gate;
+        std::stop_source *stopOnCall = nullptr;
+        std::atomic<int> *calls = nullptr;
+
+        bool operator()(const Student &) const
+        {
+            if (gate.valid())
+            {
+                gate.wait();
+            }
+            if (calls)
+            {
+                ++*calls;
+            }
+            if (stopOnCall)
+            {
+                stopOnCall->request_stop();
+            }
+            return true;
+        }
+    };
+}
+
+TEST(AsyncControllerTest, OperationsCompleteThroughFutures)
+{
+    Controller controller;
+    AsyncController async(controller, 2);
+    std::vector<std::future<int>> added;
+    for (int i = 0; i < 20; ++i)
+    {
+        added.push_back(async.addAsync(std::make_unique<JuniorStudent>("S" + std::to_string(i), i % 2 ? "G1" : "G2", 101,
+                                                                       std::vector<int>{i % 2 ? 5 : 3})));
+    }
+    std::set<int> ids;
+    for (auto &future : added)
+    {
+        ids.insert(future.get());
+    }
+    EXPECT_EQ(ids.size(), 20u);
+
+    EXPECT_TRUE(async.setGroupAsync(1, "G3").get());
+    EXPECT_FALSE(async.removeAsync(100).get());
+    EXPECT_EQ(async.findAsync(1).get()->getGroupIndex(), "G3");
+    EXPECT_EQ(async.findAsync(100).get(), nullptr);
+    auto averages = async.averagesByGroupAsync().get();
+    EXPECT_DOUBLE_EQ(averages->at("G2"), 3.0);
+    EXPECT_EQ(async.findIdsAsync(query::GroupIs{"G3"}).get(), std::vector<int>{1});
+    EXPECT_EQ(async.topStudentsAsync(3).get()->size(), 3u);
+
+    auto batch = async.applyBatchAsync({MutationCommand::remove(1), MutationCommand::remove(1)}).get();
+    EXPECT_EQ(batch.applied, 0u);
+    EXPECT_THROW(async.addAsync(nullptr).get(), std::invalid_argument);
+
+    // Над отображаемым реестром поиск по ID работает, а сканирование по предикату отклоняется
+    auto path = std::filesystem::temp_directory_path() / "registry_async_mapped.bin";
+    controller.saveMapped(path);
+    Controller reader;
+    reader.openReadOnly(path);
+    AsyncController readerAsync(reader, 1);
+    EXPECT_EQ(readerAsync.findAsync(1).get()->getGroupIndex(), "G3");
+    EXPECT_THROW(readerAsync.findIdsAsync(query::GroupIs{"G3"}).get(), std::logic_error);
+    std::filesystem::remove(path);
+}
+
+TEST(AsyncControllerTest, CancelsQueuedAndRunningOperations)
+{
+    Controller controller;
+    auto &table = controller.getStudentTable();
+    for (int id = 1; id <= 20000; ++id)
+    {
+        table.insert(id, std::make_unique<JuniorStudent>("S", "G", 101, std::vector<int>{4}));
+    }
+    AsyncController async(controller, 1);
+
+    // Единственный поток пула занят, пока ворота закрыты
+    std::promise<void> open;
+    auto blocker = async.findIdsAsync(GatePredicate{open.get_future().share()});
+    std::stop_source source;
+    auto cancelled = async.findAsync(1, source.get_token());
+    source.request_stop();
+    auto dropped = async.findAsync(2);
+    async.cancelAll();
+    auto kept = async.findAsync(3);
+    open.set_value();
+
+    EXPECT_THROW(blocker.get(), OperationCancelled); // cancelAll прерывает и начатое сканирование
+    EXPECT_THROW(cancelled.get(), OperationCancelled);
+    EXPECT_THROW(dropped.get(), OperationCancelled);
+    EXPECT_NE(kept.get(), nullptr);
+
+    // Остановка по токену вызывающего во время сканирования
+    std::stop_source scanStop;
+    std::atomic<int> calls{0};
+    auto scan = async.findIdsAsync(GatePredicate{{}, &scanStop, &calls}, scanStop.get_token());
+    EXPECT_THROW(scan.get(), OperationCancelled);
+    EXPECT_LT(calls.load(), 20000);
+}